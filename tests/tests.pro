@@ -29,3 +29,9 @@ trikKernelTests.depends = thirdparty testUtils
 trikScriptRunnerTests.depends = thirdparty testUtils
 trikCommunicatorTests.depends = thirdparty testUtils
 selftest.depends = thirdparty testUtils
+
+!win32 {
+	# HAL tests cover Linux implementation of devices.
+	SUBDIRS += trikHalTests
+	trikHalTests.depends = thirdparty testUtils
+}
@@ -0,0 +1,303 @@
+/* Copyright 2016 CyberTech Labs Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License. */
+
+#include <errno.h>
+#include <stdarg.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <linux/i2c-dev.h>
+#include <linux/i2c.h>
+
+#include <QtCore/QVector>
+
+#include <trikHal/mspBatchOperation.h>
+#include <trikHal/mspCommand.h>
+
+#include <stub/stubMspI2c.h>
+#include <stub/stubMspUsb.h>
+#include <trik/trikMspI2c.h>
+
+#include <gtest/gtest.h>
+
+using namespace trikHal;
+
+namespace {
+
+/// I2C adapter with MSP behind it, serves I2C ioctls of TrikMspI2c. Registers are plain memory: a write stores its
+/// payload, a read returns stored value.
+struct FakeI2cAdapter
+{
+	/// True if adapter reports plain I2C messages support, so combined transactions are tried.
+	bool plainI2c = true;
+
+	/// Error of every I2C_RDWR call, 0 if combined transactions succeed.
+	int combinedError = 0;
+
+	int combinedCalls = 0;
+	int separateCalls = 0;
+
+	/// Largest number of messages in one combined transaction.
+	int maxMessages = 0;
+
+	quint32 registers[256] = {};
+};
+
+/// Adapter used by the test in progress, nullptr if ioctls shall go to the kernel.
+FakeI2cAdapter *adapter = nullptr;
+
+int smbusAccess(FakeI2cAdapter &fake, const i2c_smbus_ioctl_data &access)
+{
+	++fake.separateCalls;
+	quint32 &value = fake.registers[access.command];
+	if (access.read_write == I2C_SMBUS_WRITE) {
+		value = access.size == I2C_SMBUS_BYTE_DATA ? access.data->byte : access.data->word;
+	} else if (access.size == I2C_SMBUS_WORD_DATA) {
+		access.data->word = value & 0xFFFF;
+	} else {
+		for (int i = 1; i <= access.data->block[0]; ++i) {
+			access.data->block[i] = (value >> ((i - 1) * 8)) & 0xFF;
+		}
+	}
+
+	return 0;
+}
+
+int combinedAccess(FakeI2cAdapter &fake, const i2c_rdwr_ioctl_data &transaction)
+{
+	++fake.combinedCalls;
+	fake.maxMessages = qMax(fake.maxMessages, static_cast<int>(transaction.nmsgs));
+	if (fake.combinedError != 0) {
+		errno = fake.combinedError;
+		return -1;
+	}
+
+	// Write message selects a register and optionally stores a value, read message reads selected register.
+	int selected = 0;
+	for (unsigned i = 0; i < transaction.nmsgs; ++i) {
+		const i2c_msg &message = transaction.msgs[i];
+		if (message.flags & I2C_M_RD) {
+			for (int byte = 0; byte < message.len; ++byte) {
+				message.buf[byte] = (fake.registers[selected] >> (byte * 8)) & 0xFF;
+			}
+		} else {
+			selected = message.buf[0];
+			if (message.len == 2) {
+				fake.registers[selected] = message.buf[1];
+			} else if (message.len == 3) {
+				fake.registers[selected] = message.buf[2] << 8 | message.buf[1];
+			}
+		}
+	}
+
+	return static_cast<int>(transaction.nmsgs);
+}
+
+/// Returns a batch of "size" operations: word write, read of the same register, byte write and long read of another
+/// register, repeated.
+MspBatch mixedBatch(int size)
+{
+	MspBatch batch;
+	for (int i = 0; i < size; ++i) {
+		const int slot = i / 4;
+		switch (i % 4) {
+		case 0:
+			batch << MspBatchOperation{MspCommand::writeWord(0x20 + slot, 1000 + i), 0};
+			break;
+		case 1:
+			batch << MspBatchOperation{MspCommand::readWord(0x20 + slot), 0};
+			break;
+		case 2:
+			batch << MspBatchOperation{MspCommand::writeByte(0x20 + slot, i), 0};
+			break;
+		default:
+			batch << MspBatchOperation{MspCommand::readLong(0x80 + slot), 0};
+			break;
+		}
+	}
+
+	return batch;
+}
+
+/// Long value preset in register read by long read number "slot" of the mixed batch.
+quint32 longValue(int slot)
+{
+	return 0x12345678u + slot;
+}
+
+}
+
+/// Replaces ioctl() of glibc so that I2C requests go to the fake adapter when a test has one. Other requests, and
+/// everything when there is no fake adapter, are passed to the kernel.
+extern "C" int ioctl(int descriptor, unsigned long request, ...)
+{
+	va_list arguments;
+	va_start(arguments, request);
+	void * const argument = va_arg(arguments, void *);
+	va_end(arguments);
+
+	if (adapter) {
+		switch (request) {
+		case I2C_SLAVE:
+			return 0;
+		case I2C_FUNCS:
+			*static_cast<unsigned long *>(argument) = I2C_FUNC_SMBUS_WORD_DATA | I2C_FUNC_SMBUS_I2C_BLOCK
+					| (adapter->plainI2c ? I2C_FUNC_I2C : 0);
+			return 0;
+		case I2C_SMBUS:
+			return smbusAccess(*adapter, *static_cast<i2c_smbus_ioctl_data *>(argument));
+		case I2C_RDWR:
+			return combinedAccess(*adapter, *static_cast<i2c_rdwr_ioctl_data *>(argument));
+		default:
+			break;
+		}
+	}
+
+	return static_cast<int>(syscall(SYS_ioctl, descriptor, request, argument));
+}
+
+namespace {
+
+/// Test fixture for batched transactions of MSP buses.
+class MspBatchTest : public testing::Test
+{
+protected:
+	void SetUp() override
+	{
+		for (int slot = 0; slot < 64; ++slot) {
+			mAdapter.registers[0x80 + slot] = longValue(slot);
+		}
+
+		adapter = &mAdapter;
+	}
+
+	void TearDown() override
+	{
+		adapter = nullptr;
+	}
+
+	/// Executes the batch through a bus connected to the fake adapter.
+	void execute(MspBatch &batch)
+	{
+		trik::TrikMspI2c bus;
+		ASSERT_TRUE(bus.connect("/dev/null", 0x48));
+		bus.transaction(batch);
+	}
+
+	/// Checks results of a mixed batch: reads shall see writes queued before them in the same batch.
+	static void checkResults(const MspBatch &batch)
+	{
+		for (int i = 0; i < batch.size(); ++i) {
+			if (i % 4 == 1) {
+				EXPECT_EQ(1000 + i - 1, batch[i].result) << "operation " << i;
+			} else if (i % 4 == 3) {
+				EXPECT_EQ(static_cast<int>(longValue(i / 4)), batch[i].result) << "operation " << i;
+			}
+		}
+	}
+
+	/// Executes a mixed batch through a stub bus. Stubs read 0 from every register and leave results of writes as
+	/// they were.
+	template<typename Bus>
+	static void checkStubResults(Bus &bus)
+	{
+		MspBatch batch = mixedBatch(8);
+		for (MspBatchOperation &operation : batch) {
+			operation.result = -1;
+		}
+
+		bus.transaction(batch);
+		for (int i = 0; i < batch.size(); ++i) {
+			EXPECT_EQ(batch[i].command.isRead() ? 0 : -1, batch[i].result) << "operation " << i;
+		}
+	}
+
+	FakeI2cAdapter mAdapter;
+};
+
+}
+
+TEST_F(MspBatchTest, stubTransactionTest)
+{
+	stub::StubMspI2C i2c;
+	checkStubResults(i2c);
+
+	stub::StubMspUsb usb;
+	checkStubResults(usb);
+}
+
+TEST_F(MspBatchTest, combinedTransactionTest)
+{
+	// Each operation takes up to two messages, so 50 operations are split into three transactions.
+	MspBatch batch = mixedBatch(50);
+	execute(batch);
+
+	checkResults(batch);
+	EXPECT_EQ(3, mAdapter.combinedCalls);
+	EXPECT_EQ(0, mAdapter.separateCalls);
+	EXPECT_LE(mAdapter.maxMessages, I2C_RDWR_IOCTL_MAX_MSGS);
+	EXPECT_EQ(46u, mAdapter.registers[0x20 + 46 / 4]);
+}
+
+TEST_F(MspBatchTest, adapterWithoutI2cTest)
+{
+	mAdapter.plainI2c = false;
+	MspBatch batch = mixedBatch(50);
+	execute(batch);
+
+	checkResults(batch);
+	EXPECT_EQ(0, mAdapter.combinedCalls);
+	EXPECT_EQ(50, mAdapter.separateCalls);
+}
+
+TEST_F(MspBatchTest, unsupportedCombinedTransactionTest)
+{
+	// Adapter claims plain I2C support but rejects I2C_RDWR, combined transactions are not tried again.
+	mAdapter.combinedError = EOPNOTSUPP;
+	trik::TrikMspI2c bus;
+	ASSERT_TRUE(bus.connect("/dev/null", 0x48));
+
+	MspBatch batch = mixedBatch(50);
+	bus.transaction(batch);
+	checkResults(batch);
+	EXPECT_EQ(1, mAdapter.combinedCalls);
+	EXPECT_EQ(50, mAdapter.separateCalls);
+
+	mAdapter.combinedError = 0;
+	batch = mixedBatch(50);
+	bus.transaction(batch);
+	checkResults(batch);
+	EXPECT_EQ(1, mAdapter.combinedCalls);
+	EXPECT_EQ(100, mAdapter.separateCalls);
+}
+
+TEST_F(MspBatchTest, failedCombinedTransactionTest)
+{
+	// Bus error fails only current transaction, each part of the batch is retried as separate accesses.
+	mAdapter.combinedError = EIO;
+	trik::TrikMspI2c bus;
+	ASSERT_TRUE(bus.connect("/dev/null", 0x48));
+
+	MspBatch batch = mixedBatch(50);
+	bus.transaction(batch);
+	checkResults(batch);
+	EXPECT_EQ(3, mAdapter.combinedCalls);
+	EXPECT_EQ(50, mAdapter.separateCalls);
+
+	mAdapter.combinedError = 0;
+	batch = mixedBatch(50);
+	bus.transaction(batch);
+	checkResults(batch);
+	EXPECT_EQ(6, mAdapter.combinedCalls);
+	EXPECT_EQ(50, mAdapter.separateCalls);
+}
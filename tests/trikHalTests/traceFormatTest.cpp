@@ -0,0 +1,187 @@
+/* Copyright 2016 CyberTech Labs Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License. */
+
+#include <QtCore/QFile>
+#include <QtCore/QHash>
+#include <QtCore/QPair>
+#include <QtCore/QTemporaryDir>
+#include <QtCore/QVector>
+
+#include <mspCommand.h>
+#include <trace/traceFormat.h>
+#include <trace/traceReader.h>
+#include <trace/traceWriter.h>
+
+#include <gtest/gtest.h>
+
+using namespace trikHal;
+using namespace trikHal::trace;
+
+namespace {
+
+/// Checks that two records are the same.
+void expectEqual(const TraceRecord &expected, const TraceRecord &actual)
+{
+	EXPECT_EQ(static_cast<int>(expected.type), static_cast<int>(actual.type));
+	EXPECT_EQ(expected.timestamp, actual.timestamp);
+	EXPECT_EQ(expected.duration, actual.duration);
+	EXPECT_EQ(expected.value, actual.value);
+	EXPECT_EQ(expected.data, actual.data);
+}
+
+/// Fixture with a trace file in temporary directory.
+class TraceFormatTest : public testing::Test
+{
+protected:
+	void SetUp() override
+	{
+		ASSERT_TRUE(mDirectory.isValid());
+		mFileName = mDirectory.path() + "/hardware.trace";
+	}
+
+	QTemporaryDir mDirectory;
+
+	/// Records written by writeTrace(), by channel name.
+	QHash<QString, QVector<TraceRecord>> mRecords;
+
+	/// Name of a trace file.
+	QString mFileName;
+
+	/// Writes a trace with records of several channels, interleaved like records of devices working concurrently.
+	void writeTrace()
+	{
+		const QString usb = channels::mspUsb;
+		const QString events = channels::eventFile("/dev/input/event1");
+		const QString fifo = channels::fifo("/tmp/dsp-detector.out.fifo");
+		const QString output = channels::outputDeviceFile("/sys/class/pwm/ehrpwm.1:0/duty_ns");
+		const int integers[] = {-1, 0, 2147483647};
+
+		const QVector<QPair<QString, TraceRecord>> records = {
+			{usb, {TraceRecordType::mspRead, 0, 10, 250, 1023, MspCommand::readWord(0x25).toByteArray()}}
+			, {events, {TraceRecordType::events, 0, 11, 0, 0
+					, packEvents({{3, 0, -15, trikKernel::Timestamp(1000)}, {0, 0, 0, trikKernel::Timestamp(1001)}})}}
+			, {usb, {TraceRecordType::mspSend, 0, 20, 120, 0, MspCommand::writeByte(0x10, -100).toByteArray()}}
+			, {fifo, {TraceRecordType::fifoLine, 0, 21, 0, 0, QByteArray("line: 1 2 3")}}
+			, {output, {TraceRecordType::outputWrite, 0, 22, 3, 0, QByteArray("1500000")}}
+			, {usb, {TraceRecordType::mspRead, 0, 4294967296ull, 4000000000u, -1
+					, MspCommand::readLong(0x30).toByteArray()}}
+			, {fifo, {TraceRecordType::inputRead, 0, 30, 5, 3, packIntegers(integers, 3)}}
+		};
+
+		TraceWriter writer(mFileName);
+		for (const auto &record : records) {
+			writer.write(record.second.type, writer.channel(record.first), record.second.timestamp
+					, record.second.duration, record.second.value, record.second.data);
+			mRecords[record.first].append(record.second);
+		}
+	}
+};
+
+}
+
+TEST_F(TraceFormatTest, eventsRoundTripTest)
+{
+	const QVector<InputEvent> events = {
+		{0x03, 0x00, -32768, trikKernel::Timestamp(0)}
+		, {0x03, 0x01, 2147483647, trikKernel::Timestamp(1234567890123456789ll)}
+		, {0x00, 0x00, 0, trikKernel::Timestamp(-5)}
+	};
+
+	const QVector<InputEvent> unpacked = unpackEvents(packEvents(events));
+	ASSERT_EQ(events.size(), unpacked.size());
+	for (int i = 0; i < events.size(); ++i) {
+		EXPECT_EQ(events[i].eventType, unpacked[i].eventType);
+		EXPECT_EQ(events[i].code, unpacked[i].code);
+		EXPECT_EQ(events[i].value, unpacked[i].value);
+		EXPECT_EQ(events[i].eventTime.toNsec(), unpacked[i].eventTime.toNsec());
+	}
+
+	EXPECT_TRUE(unpackEvents(packEvents({})).isEmpty());
+
+	// Truncated payload gives only complete events.
+	EXPECT_EQ(2, unpackEvents(packEvents(events).left(packEvents(events).size() - 1)).size());
+}
+
+TEST_F(TraceFormatTest, integersRoundTripTest)
+{
+	const int values[] = {1, -2, 2147483647, -2147483647 - 1};
+	const QByteArray data = packIntegers(values, 4);
+
+	int unpacked[4] = {0};
+	ASSERT_EQ(4, unpackIntegers(data, unpacked, 4));
+	for (int i = 0; i < 4; ++i) {
+		EXPECT_EQ(values[i], unpacked[i]);
+	}
+
+	// Receiver with smaller buffer gets only the first values.
+	int first[2] = {0};
+	EXPECT_EQ(2, unpackIntegers(data, first, 2));
+	EXPECT_EQ(-2, first[1]);
+}
+
+TEST_F(TraceFormatTest, mspCommandRoundTripTest)
+{
+	const MspCommand commands[] = {
+		MspCommand::readWord(0x25)
+		, MspCommand::readLong(0x30)
+		, MspCommand::writeByte(0x10, -100)
+		, MspCommand::writeWord(0x14, 0xABCD)
+	};
+
+	for (const MspCommand &command : commands) {
+		EXPECT_TRUE(command == MspCommand::fromByteArray(command.toByteArray(), command.isRead()));
+	}
+}
+
+TEST_F(TraceFormatTest, traceFileRoundTripTest)
+{
+	writeTrace();
+	const TraceReader reader(mFileName);
+	for (const QString &channel : mRecords.keys()) {
+		const QVector<TraceRecord> expected = mRecords.value(channel);
+		const QVector<TraceRecord> actual = reader.records(channel);
+		ASSERT_EQ(expected.size(), actual.size()) << channel.toStdString();
+		for (int i = 0; i < expected.size(); ++i) {
+			expectEqual(expected[i], actual[i]);
+		}
+	}
+
+	EXPECT_TRUE(reader.records(channels::mspI2c).isEmpty());
+}
+
+TEST_F(TraceFormatTest, truncatedTraceTest)
+{
+	writeTrace();
+
+	// Trace of a crashed session, the last record is written partially.
+	QFile file(mFileName);
+	ASSERT_TRUE(file.resize(file.size() - 3));
+
+	const TraceReader reader(mFileName);
+	const QVector<TraceRecord> fifo = reader.records(channels::fifo("/tmp/dsp-detector.out.fifo"));
+	ASSERT_EQ(1, fifo.size());
+	expectEqual(mRecords.value(channels::fifo("/tmp/dsp-detector.out.fifo")).first(), fifo.first());
+	EXPECT_EQ(3, reader.records(channels::mspUsb).size());
+}
+
+TEST_F(TraceFormatTest, wrongFileTest)
+{
+	QFile file(mFileName);
+	ASSERT_TRUE(file.open(QIODevice::WriteOnly));
+	file.write("not a trace, but a long enough text file");
+	file.close();
+
+	EXPECT_TRUE(TraceReader(mFileName).records(channels::mspUsb).isEmpty());
+	EXPECT_TRUE(TraceReader(mDirectory.path() + "/missing.trace").records(channels::mspUsb).isEmpty());
+}
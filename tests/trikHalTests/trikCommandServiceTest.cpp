@@ -0,0 +1,52 @@
+/* Copyright 2016 CyberTech Labs Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License. */
+
+#include <atomic>
+
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QScopedPointer>
+
+#include <trik/trikCommandService.h>
+
+#include <gtest/gtest.h>
+
+using namespace trikHal::trik;
+
+/// Tests that commands get exit codes and do not see our end of the socket.
+TEST(TrikCommandServiceTest, executeTest)
+{
+	TrikCommandService service;
+	ASSERT_TRUE(service.launch());
+
+	EXPECT_EQ(0, service.execute("true"));
+	EXPECT_EQ(3, service.execute("exit 3"));
+	EXPECT_EQ(0, service.execute("[ ! -e /proc/self/fd/3 ]"));
+	EXPECT_EQ(0, service.execute("read line; [ -z \"$line\" ]"));
+}
+
+/// Tests that destruction of a service does not wait for long running commands forever.
+TEST(TrikCommandServiceTest, boundedShutdownTest)
+{
+	std::atomic<int> exitCode(0);
+	QElapsedTimer timer;
+	{
+		QScopedPointer<TrikCommandService> service(new TrikCommandService());
+		ASSERT_TRUE(service->launch());
+		ASSERT_TRUE(service->executeAsync("sleep 30", [&exitCode](int code) { exitCode = code; }));
+		timer.start();
+	}
+
+	EXPECT_LT(timer.elapsed(), 10000);
+	EXPECT_EQ(-1, exitCode);
+}
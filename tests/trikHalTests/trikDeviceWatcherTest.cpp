@@ -0,0 +1,153 @@
+/* Copyright 2016 CyberTech Labs Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License. */
+
+#include <stdio.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include <thread>
+
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QEventLoop>
+#include <QtCore/QTemporaryDir>
+#include <QtCore/QThread>
+#include <QtCore/QTimer>
+
+#include <trik/trikDeviceWatcher.h>
+#include <trik/trikEventFile.h>
+
+#include <gtest/gtest.h>
+
+using namespace trikHal::trik;
+
+namespace {
+
+/// Time to wait for a change notification, in milliseconds.
+const int changeTimeout = 2000;
+
+/// Time to make sure that there is no change notification, in milliseconds.
+const int quietTime = 200;
+
+/// Time after which simulated driver creates event file, in milliseconds.
+const int creationDelay = 100;
+
+/// Runs event loop until watcher reports a change or timeout expires, returns number of reported changes.
+int waitForChanges(TrikDeviceWatcher &watcher, int timeout)
+{
+	int changes = 0;
+	QEventLoop loop;
+	const QMetaObject::Connection connection = QObject::connect(&watcher, &TrikDeviceWatcher::changed
+			, [&changes, &loop]() {
+				++changes;
+				loop.quit();
+			});
+
+	QTimer::singleShot(timeout, &loop, SLOT(quit()));
+	loop.exec();
+	QObject::disconnect(connection);
+	return changes;
+}
+
+/// Creates a FIFO in place of a device file.
+void makeFifo(const QString &fileName)
+{
+	ASSERT_EQ(0, mkfifo(fileName.toLocal8Bit().constData(), 0600));
+}
+
+/// Fixture with temporary directory for device files.
+class TrikDeviceWatcherTest : public testing::Test
+{
+protected:
+	void SetUp() override
+	{
+		ASSERT_TRUE(mDirectory.isValid());
+	}
+
+	/// Returns full name of a file in temporary directory.
+	QString path(const QString &fileName) const
+	{
+		return mDirectory.path() + "/" + fileName;
+	}
+
+private:
+	QTemporaryDir mDirectory;
+};
+
+}
+
+TEST_F(TrikDeviceWatcherTest, createdFileTest)
+{
+	TrikDeviceWatcher watcher(path("event0"));
+	ASSERT_TRUE(watcher.isValid());
+
+	makeFifo(path("event0"));
+	EXPECT_GE(waitForChanges(watcher, changeTimeout), 1);
+}
+
+TEST_F(TrikDeviceWatcherTest, unrelatedFileTest)
+{
+	TrikDeviceWatcher watcher(path("event0"));
+	ASSERT_TRUE(watcher.isValid());
+
+	makeFifo(path("event1"));
+	EXPECT_EQ(0, waitForChanges(watcher, quietTime));
+}
+
+TEST_F(TrikDeviceWatcherTest, movedFileTest)
+{
+	TrikDeviceWatcher watcher(path("event0"));
+	ASSERT_TRUE(watcher.isValid());
+
+	// udev creates nodes under temporary names and renames them.
+	makeFifo(path(".event0.tmp"));
+	ASSERT_EQ(0, rename(path(".event0.tmp").toLocal8Bit().constData(), path("event0").toLocal8Bit().constData()));
+	EXPECT_GE(waitForChanges(watcher, changeTimeout), 1);
+}
+
+TEST_F(TrikDeviceWatcherTest, attributesChangedTest)
+{
+	makeFifo(path("event0"));
+	TrikDeviceWatcher watcher(path("event0"));
+	ASSERT_TRUE(watcher.isValid());
+
+	ASSERT_EQ(0, chmod(path("event0").toLocal8Bit().constData(), 0660));
+	EXPECT_GE(waitForChanges(watcher, changeTimeout), 1);
+}
+
+TEST_F(TrikDeviceWatcherTest, missingDirectoryTest)
+{
+	TrikDeviceWatcher watcher(path("missing/event0"));
+	EXPECT_FALSE(watcher.isValid());
+}
+
+TEST_F(TrikDeviceWatcherTest, eventFileWaitTest)
+{
+	// Event file is opened as soon as the driver creates it, not after a polling step or open timeout.
+	TrikEventFile eventFile(path("event0"), *QThread::currentThread(), nullptr);
+	std::thread driver([this]() {
+		QThread::msleep(creationDelay);
+		makeFifo(path("event0"));
+	});
+
+	QElapsedTimer timer;
+	timer.start();
+	const bool isOpened = eventFile.open();
+	const qint64 elapsed = timer.elapsed();
+	driver.join();
+
+	ASSERT_TRUE(isOpened);
+	EXPECT_GE(elapsed, creationDelay - 10);
+	EXPECT_LT(elapsed, creationDelay + 500);
+	eventFile.close();
+}
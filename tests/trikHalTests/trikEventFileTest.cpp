@@ -0,0 +1,201 @@
+/* Copyright 2016 CyberTech Labs Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License. */
+
+#include <fcntl.h>
+#include <limits.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <linux/input.h>
+
+#include <atomic>
+#include <iostream>
+
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QMutex>
+#include <QtCore/QMutexLocker>
+#include <QtCore/QTemporaryDir>
+#include <QtCore/QThread>
+#include <QtCore/QVector>
+
+#include <trik/trikEventFile.h>
+#include <trik/trikIoReactor.h>
+
+#include <gtest/gtest.h>
+
+using namespace trikHal;
+using namespace trikHal::trik;
+
+namespace {
+
+/// Number of events that fit into one atomic write to a FIFO.
+const int eventsPerWrite = PIPE_BUF / sizeof(struct input_event);
+
+/// Time to wait for events to be delivered, in milliseconds.
+const int deliveryTimeout = 2000;
+
+/// Makes a burst of events: pairs of absolute axis value and synchronization, values are numbered from "firstValue".
+QVector<struct input_event> makeEvents(int count, int firstValue)
+{
+	QVector<struct input_event> events(count);
+	for (int i = 0; i < count; ++i) {
+		events[i].time.tv_sec = 0;
+		events[i].time.tv_usec = 0;
+		events[i].type = i % 2 == 0 ? EV_ABS : EV_SYN;
+		events[i].code = i % 2 == 0 ? ABS_X : SYN_REPORT;
+		events[i].value = firstValue + i;
+	}
+
+	return events;
+}
+
+/// Fixture with event file opened on a FIFO in temporary directory. Events written to the FIFO are delivered by I/O
+/// reactor thread and collected by the fixture.
+class TrikEventFileTest : public testing::Test
+{
+protected:
+	void SetUp() override
+	{
+		ASSERT_TRUE(mDirectory.isValid());
+		const QString fifoName = mDirectory.path() + "/event0";
+		ASSERT_EQ(0, mkfifo(fifoName.toLocal8Bit().constData(), 0600));
+
+		mEventFile.reset(new TrikEventFile(fifoName, *QThread::currentThread(), &mReactor));
+		QObject::connect(mEventFile.data(), &EventFileInterface::newEvents
+				, [this](const QVector<InputEvent> &events) {
+					QMutexLocker lock(&mLock);
+					mEvents += events;
+					++mBatches;
+					mReceived = mEvents.size();
+				});
+
+		ASSERT_TRUE(mEventFile->open());
+
+		// Opened after reader, otherwise non-blocking open of FIFO for writing fails.
+		mWriter = ::open(fifoName.toLocal8Bit().constData(), O_WRONLY | O_NONBLOCK);
+		ASSERT_NE(-1, mWriter);
+	}
+
+	void TearDown() override
+	{
+		mEventFile.reset();
+		if (mWriter != -1) {
+			::close(mWriter);
+		}
+	}
+
+	/// Writes events to the FIFO at once.
+	void write(const QVector<struct input_event> &events)
+	{
+		const ssize_t size = events.size() * sizeof(struct input_event);
+		ASSERT_EQ(size, ::write(mWriter, events.constData(), size));
+	}
+
+	/// Waits until given total number of events is delivered, returns false on timeout.
+	bool waitForEvents(int count)
+	{
+		QElapsedTimer timer;
+		timer.start();
+		while (mReceived < count) {
+			if (timer.elapsed() > deliveryTimeout) {
+				return false;
+			}
+
+			QThread::usleep(50);
+		}
+
+		return true;
+	}
+
+	QMutex mLock;
+	QVector<InputEvent> mEvents;
+	int mBatches = 0;
+	std::atomic<int> mReceived {0};
+
+private:
+	QTemporaryDir mDirectory;
+	TrikIoReactor mReactor;
+	QScopedPointer<TrikEventFile> mEventFile;
+	int mWriter = -1;
+};
+
+}
+
+TEST_F(TrikEventFileTest, batchDeliveryTest)
+{
+	write(makeEvents(10, 100));
+	ASSERT_TRUE(waitForEvents(10));
+
+	QMutexLocker lock(&mLock);
+	EXPECT_EQ(1, mBatches);
+	for (int i = 0; i < mEvents.size(); ++i) {
+		EXPECT_EQ(i % 2 == 0 ? EV_ABS : EV_SYN, mEvents[i].eventType);
+		EXPECT_EQ(100 + i, mEvents[i].value);
+	}
+}
+
+TEST_F(TrikEventFileTest, burstLargerThanReadTest)
+{
+	// Burst takes several reads of event file, but is still delivered as one batch, in order.
+	write(makeEvents(eventsPerWrite, 0));
+	ASSERT_TRUE(waitForEvents(eventsPerWrite));
+
+	QMutexLocker lock(&mLock);
+	EXPECT_EQ(1, mBatches);
+	for (int i = 0; i < mEvents.size(); ++i) {
+		ASSERT_EQ(i, mEvents[i].value);
+	}
+}
+
+TEST_F(TrikEventFileTest, eventBatchBenchmark)
+{
+	const int bursts = 200;
+	const QVector<struct input_event> burst = makeEvents(eventsPerWrite, 0);
+
+	QElapsedTimer timer;
+	timer.start();
+	for (int i = 1; i <= bursts; ++i) {
+		write(burst);
+		ASSERT_TRUE(waitForEvents(i * eventsPerWrite));
+	}
+
+	const qint64 batched = timer.nsecsElapsed();
+
+	// Reference: the same bursts read with one system call per event, as event files were read before batching.
+	int pipeDescriptors[2];
+	ASSERT_EQ(0, pipe(pipeDescriptors));
+	struct input_event event;
+	int perEventReads = 0;
+	timer.restart();
+	for (int i = 0; i < bursts; ++i) {
+		const ssize_t size = burst.size() * sizeof(struct input_event);
+		ASSERT_EQ(size, ::write(pipeDescriptors[1], burst.constData(), size));
+		for (int j = 0; j < burst.size(); ++j) {
+			perEventReads += ::read(pipeDescriptors[0], &event, sizeof(event)) == sizeof(event) ? 1 : 0;
+		}
+	}
+
+	const qint64 perEvent = timer.nsecsElapsed();
+	::close(pipeDescriptors[0]);
+	::close(pipeDescriptors[1]);
+
+	const int events = bursts * eventsPerWrite;
+	EXPECT_EQ(events, perEventReads);
+
+	QMutexLocker lock(&mLock);
+	std::cout << "[          ] " << events << " events in bursts of " << eventsPerWrite << ": delivered in "
+			<< mBatches << " batches, " << batched / events << " ns per event including delivery; "
+			<< "reading one event per system call alone takes " << perEvent / events << " ns per event" << std::endl;
+
+	EXPECT_LE(mBatches, bursts);
+}
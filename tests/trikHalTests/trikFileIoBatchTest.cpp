@@ -0,0 +1,369 @@
+/* Copyright 2016 CyberTech Labs Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License. */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <iostream>
+#include <string>
+
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QSharedPointer>
+#include <QtCore/QStringList>
+#include <QtCore/QTemporaryDir>
+#include <QtCore/QVector>
+
+#include <sequentialFileIoBatch.h>
+
+#include <trik/trikFileIoBatch.h>
+#include <trik/trikInputDeviceFile.h>
+#include <trik/trikIoUring.h>
+#include <trik/trikOutputDeviceFile.h>
+
+#include <gtest/gtest.h>
+
+using namespace trikHal::trik;
+
+namespace {
+
+/// Number of operations a ring can take at once, as in hardware abstraction.
+const int ringEntries = 32;
+
+/// Reads whole contents of a file.
+std::string contents(const QString &fileName)
+{
+	std::string result;
+	const int descriptor = ::open(fileName.toLocal8Bit().constData(), O_RDONLY);
+	char buffer[64];
+	ssize_t size = 0;
+	while ((size = ::read(descriptor, buffer, sizeof(buffer))) > 0) {
+		result.append(buffer, size);
+	}
+
+	::close(descriptor);
+	return result;
+}
+
+/// Replaces contents of a file.
+void overwrite(const QString &fileName, const std::string &data)
+{
+	const int descriptor = ::open(fileName.toLocal8Bit().constData(), O_WRONLY | O_CREAT | O_TRUNC, 0600);
+	ASSERT_EQ(static_cast<ssize_t>(data.size()), ::write(descriptor, data.data(), data.size()));
+	::close(descriptor);
+}
+
+/// Returns number of read system calls made by the process so far, from "syscr" of /proc/self/io, or -1 if kernel
+/// does not account it. Does not count io_uring operations.
+qint64 readSystemCalls()
+{
+	const std::string io = contents("/proc/self/io");
+	const std::string key = "syscr: ";
+	const size_t position = io.find(key);
+	return position == std::string::npos ? -1 : std::stoll(io.substr(position + key.size()));
+}
+
+/// Output device file that records writes into a journal shared by several files.
+class JournalOutputFile : public trikHal::OutputDeviceFileInterface
+{
+public:
+	JournalOutputFile(const QString &fileName, QStringList &journal)
+		: mFileName(fileName)
+		, mJournal(journal)
+	{
+	}
+
+	bool open() override
+	{
+		return true;
+	}
+
+	void close() override
+	{
+	}
+
+	void write(const QString &data) override
+	{
+		mJournal << mFileName + "=" + data;
+	}
+
+	void write(int value) override
+	{
+		write(QString::number(value));
+	}
+
+	QString fileName() const override
+	{
+		return mFileName;
+	}
+
+private:
+	QString mFileName;
+	QStringList &mJournal;
+};
+
+/// Queues the same writes to a batch: repeated writes to one file interleaved with writes to another file.
+void queueWrites(trikHal::FileIoBatchInterface &batch, trikHal::OutputDeviceFileInterface &run
+		, trikHal::OutputDeviceFileInterface &duty)
+{
+	batch.write(run, 0);
+	batch.write(duty, 1500000);
+	batch.write(run, 1);
+	batch.write(duty, 1500000);
+	batch.write(run, 0);
+}
+
+/// Fixture with temporary directory for device files and a ring shared by batches. Tests that need io_uring pass
+/// without checks if kernel does not support it.
+class TrikFileIoBatchTest : public testing::Test
+{
+protected:
+	void SetUp() override
+	{
+		ASSERT_TRUE(mDirectory.isValid());
+		if (!mRing->isValid()) {
+			std::cout << "[          ] io_uring is not supported by kernel" << std::endl;
+		}
+	}
+
+	/// Returns full name of a file in temporary directory.
+	QString path(int index) const
+	{
+		return mDirectory.path() + "/attribute" + QString::number(index);
+	}
+
+	QSharedPointer<TrikIoUring> mRing {new TrikIoUring(ringEntries)};
+
+private:
+	QTemporaryDir mDirectory;
+};
+
+}
+
+TEST_F(TrikFileIoBatchTest, linkedWritesTest)
+{
+	if (!mRing->isValid()) {
+		return;
+	}
+
+	// The second write lands on top of the first one only if it is started after the first one completes.
+	overwrite(path(0), "");
+	const int descriptor = ::open(path(0).toLocal8Bit().constData(), O_WRONLY);
+	ASSERT_NE(-1, descriptor);
+	const int rounds = 100;
+	for (int i = 0; i < rounds; ++i) {
+		ASSERT_EQ(0, ftruncate(descriptor, 0));
+		ASSERT_TRUE(mRing->prepareWrite(descriptor, "111", 3, 0, true));
+		ASSERT_TRUE(mRing->prepareWrite(descriptor, "2", 1, 1));
+		QVector<int> results(2, 0);
+		ASSERT_TRUE(mRing->submitAndWait([&results](quint64 userData, int result) { results[userData] = result; }));
+		EXPECT_EQ(3, results[0]);
+		EXPECT_EQ(1, results[1]);
+		ASSERT_EQ("211", contents(path(0)));
+	}
+
+	::close(descriptor);
+}
+
+TEST_F(TrikFileIoBatchTest, brokenLinkTest)
+{
+	if (!mRing->isValid()) {
+		return;
+	}
+
+	// Write that follows a failed one is cancelled, batch executes it directly then.
+	overwrite(path(0), "");
+	const int descriptor = ::open(path(0).toLocal8Bit().constData(), O_WRONLY);
+	ASSERT_NE(-1, descriptor);
+	ASSERT_TRUE(mRing->prepareWrite(-1, "1", 1, 0, true));
+	ASSERT_TRUE(mRing->prepareWrite(descriptor, "2", 1, 1));
+	QVector<int> results(2, 0);
+	ASSERT_TRUE(mRing->submitAndWait([&results](quint64 userData, int result) { results[userData] = result; }));
+	EXPECT_EQ(-EBADF, results[0]);
+	EXPECT_EQ(-ECANCELED, results[1]);
+	EXPECT_EQ("", contents(path(0)));
+	::close(descriptor);
+}
+
+TEST_F(TrikFileIoBatchTest, readTest)
+{
+	overwrite(path(0), "12 34\n");
+	overwrite(path(1), "-5\n");
+	TrikInputDeviceFile first(path(0));
+	TrikInputDeviceFile second(path(1));
+	ASSERT_TRUE(first.open());
+	ASSERT_TRUE(second.open());
+
+	TrikFileIoBatch batch(mRing);
+	EXPECT_EQ(mRing->isValid(), batch.isValid());
+
+	QVector<int> firstValues;
+	QVector<int> secondValues;
+	int firstParsed = -1;
+	int secondParsed = -1;
+	batch.read(first, 3, [&](int parsed, const QVector<int> &values) {
+		firstParsed = parsed;
+		firstValues = values;
+	});
+
+	batch.read(second, 1, [&](int parsed, const QVector<int> &values) {
+		secondParsed = parsed;
+		secondValues = values;
+	});
+
+	batch.submit();
+
+	EXPECT_EQ(2, firstParsed);
+	ASSERT_EQ(3, firstValues.size());
+	EXPECT_EQ(12, firstValues[0]);
+	EXPECT_EQ(34, firstValues[1]);
+	EXPECT_EQ(0, firstValues[2]);
+	EXPECT_EQ(1, secondParsed);
+	ASSERT_EQ(1, secondValues.size());
+	EXPECT_EQ(-5, secondValues[0]);
+}
+
+TEST_F(TrikFileIoBatchTest, ordinaryFileWriteTest)
+{
+	// Ordinary files are written directly, so a shorter value does not leave a tail of a longer one.
+	overwrite(path(0), "");
+	overwrite(path(1), "");
+	TrikOutputDeviceFile duty(path(0));
+	TrikOutputDeviceFile run(path(1));
+	ASSERT_TRUE(duty.open());
+	ASSERT_TRUE(run.open());
+	EXPECT_FALSE(duty.isSysfsAttribute());
+
+	TrikFileIoBatch batch(mRing);
+	batch.write(duty, 1500000);
+	batch.write(run, 1);
+	batch.submit();
+	EXPECT_EQ("1500000", contents(path(0)));
+	EXPECT_EQ("1", contents(path(1)));
+
+	batch.write(duty, 7);
+	batch.write(run, 0);
+	batch.write(duty, 5);
+	batch.submit();
+	EXPECT_EQ("5", contents(path(0)));
+	EXPECT_EQ("0", contents(path(1)));
+}
+
+TEST_F(TrikFileIoBatchTest, sameOrderAsSequentialBatchTest)
+{
+	// Batch executes writes exactly as sequential one does, repeated writes are not folded into the first one.
+	QStringList sequentialJournal;
+	JournalOutputFile sequentialRun("run", sequentialJournal);
+	JournalOutputFile sequentialDuty("duty", sequentialJournal);
+	trikHal::SequentialFileIoBatch sequentialBatch;
+	queueWrites(sequentialBatch, sequentialRun, sequentialDuty);
+	sequentialBatch.submit();
+
+	QStringList journal;
+	JournalOutputFile run("run", journal);
+	JournalOutputFile duty("duty", journal);
+	TrikFileIoBatch batch(mRing);
+	queueWrites(batch, run, duty);
+	batch.submit();
+
+	EXPECT_EQ(QStringList({"run=0", "duty=1500000", "run=1", "duty=1500000", "run=0"}), sequentialJournal);
+	EXPECT_EQ(sequentialJournal, journal);
+
+	// The same for device files, where repeated value is not written again.
+	overwrite(path(0), "");
+	overwrite(path(1), "");
+	overwrite(path(2), "");
+	overwrite(path(3), "");
+	TrikOutputDeviceFile sequentialRunFile(path(0));
+	TrikOutputDeviceFile sequentialDutyFile(path(1));
+	TrikOutputDeviceFile runFile(path(2));
+	TrikOutputDeviceFile dutyFile(path(3));
+	ASSERT_TRUE(sequentialRunFile.open());
+	ASSERT_TRUE(sequentialDutyFile.open());
+	ASSERT_TRUE(runFile.open());
+	ASSERT_TRUE(dutyFile.open());
+	queueWrites(sequentialBatch, sequentialRunFile, sequentialDutyFile);
+	sequentialBatch.submit();
+	queueWrites(batch, runFile, dutyFile);
+	batch.submit();
+	EXPECT_EQ("0", contents(path(0)));
+	EXPECT_EQ("1500000", contents(path(1)));
+	EXPECT_EQ(contents(path(0)), contents(path(2)));
+	EXPECT_EQ(contents(path(1)), contents(path(3)));
+}
+
+TEST_F(TrikFileIoBatchTest, fileIoBatchBenchmark)
+{
+	// One control tick reads a set of sensor attributes, compared with one pread() per attribute.
+	const int files = 16;
+	const int ticks = 5000;
+	QVector<QSharedPointer<TrikInputDeviceFile>> inputFiles;
+	for (int i = 0; i < files; ++i) {
+		overwrite(path(i), std::to_string(i * 1000) + "\n");
+		inputFiles.append(QSharedPointer<TrikInputDeviceFile>(new TrikInputDeviceFile(path(i))));
+		ASSERT_TRUE(inputFiles.last()->open());
+	}
+
+	long long sum = 0;
+	TrikFileIoBatch batch(mRing);
+	const quint64 ringCallsBefore = mRing->systemCalls();
+	const qint64 batchedReadsBefore = readSystemCalls();
+	QElapsedTimer timer;
+	timer.start();
+	for (int tick = 0; tick < ticks; ++tick) {
+		for (const QSharedPointer<TrikInputDeviceFile> &file : inputFiles) {
+			batch.read(*file, 1, [&sum](int, const QVector<int> &values) { sum += values[0]; });
+		}
+
+		batch.submit();
+	}
+
+	const qint64 batched = timer.nsecsElapsed();
+	const qint64 batchedReads = readSystemCalls() - batchedReadsBefore;
+	const quint64 ringCalls = mRing->systemCalls() - ringCallsBefore;
+
+	const qint64 sequentialReadsBefore = readSystemCalls();
+	timer.restart();
+	for (int tick = 0; tick < ticks; ++tick) {
+		for (const QSharedPointer<TrikInputDeviceFile> &file : inputFiles) {
+			int value = 0;
+			file->readIntegers(&value, 1);
+			sum -= value;
+		}
+	}
+
+	const qint64 sequential = timer.nsecsElapsed();
+	const qint64 sequentialReads = readSystemCalls() - sequentialReadsBefore;
+	EXPECT_EQ(0, sum);
+
+	if (batch.isValid()) {
+		EXPECT_EQ(static_cast<quint64>(ticks), ringCalls);
+	}
+
+	// Read system calls are not accounted by some kernels, then only io_uring submissions are reported.
+	const bool accounted = batchedReadsBefore >= 0;
+	std::cout << "[          ] " << files << " reads per tick in " << (batch.isValid() ? "io_uring" : "direct")
+			<< " batch: " << static_cast<double>(ringCalls) / ticks << " io_uring submits";
+	if (accounted) {
+		std::cout << " and " << static_cast<double>(batchedReads) / ticks << " reads";
+	}
+
+	std::cout << ", " << batched / ticks << " ns per tick" << std::endl;
+	std::cout << "[          ] " << files << " reads per tick with one system call per read: ";
+	if (accounted) {
+		std::cout << static_cast<double>(sequentialReads) / ticks << " reads, ";
+	}
+
+	std::cout << sequential / ticks << " ns per tick" << std::endl;
+}
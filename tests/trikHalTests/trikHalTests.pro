@@ -0,0 +1,41 @@
+# Copyright 2016 CyberTech Labs Ltd.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+
+#     http://www.apache.org/licenses/LICENSE-2.0
+
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+
+include(../common.pri)
+
+SOURCES += \
+	$$PWD/mspBatchTest.cpp \
+	$$PWD/traceFormatTest.cpp \
+	$$PWD/trikCommandServiceTest.cpp \
+	$$PWD/trikDeviceWatcherTest.cpp \
+	$$PWD/trikEventFileTest.cpp \
+	$$PWD/trikFileIoBatchTest.cpp \
+	$$PWD/trikOutputDeviceFileTest.cpp \
+	$$PWD/usbMsp430AllocationTest.cpp \
+	$$PWD/usbMsp430CodecTest.cpp \
+	$$PWD/usbMsp430ShadowTest.cpp \
+	$$PWD/usbMsp430TransportTest.cpp \
+	$$PWD/usbMsp430Urm04Test.cpp \
+
+# Tests use internal classes of HAL, they are linked from trikHal library.
+INCLUDEPATH += \
+	$$PWD/../../trikHal/src \
+	$$PWD/../../trikHal/include/trikHal \
+
+implementationIncludes(trikKernel trikHal)
+links(trikKernel trikHal)
+
+# Transport tests use pseudo terminal in place of USB device.
+LIBS += -lutil
@@ -0,0 +1,199 @@
+/* Copyright 2016 CyberTech Labs Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License. */
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include <iostream>
+#include <string>
+
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QSharedPointer>
+#include <QtCore/QTemporaryDir>
+#include <QtCore/QVector>
+
+#include <trik/trikOutputDeviceFile.h>
+
+#include <gtest/gtest.h>
+
+using namespace trikHal::trik;
+
+namespace {
+
+/// Reads whole contents of a file.
+std::string contents(const QString &fileName)
+{
+	std::string result;
+	const int descriptor = ::open(fileName.toLocal8Bit().constData(), O_RDONLY);
+	char buffer[64];
+	ssize_t size = 0;
+	while ((size = ::read(descriptor, buffer, sizeof(buffer))) > 0) {
+		result.append(buffer, size);
+	}
+
+	::close(descriptor);
+	return result;
+}
+
+/// Replaces contents of a file, bypassing output device file.
+void overwrite(const QString &fileName, const std::string &data)
+{
+	const int descriptor = ::open(fileName.toLocal8Bit().constData(), O_WRONLY | O_CREAT | O_TRUNC, 0600);
+	ASSERT_EQ(static_cast<ssize_t>(data.size()), ::write(descriptor, data.data(), data.size()));
+	::close(descriptor);
+}
+
+/// Fixture with temporary directory for device files.
+class TrikOutputDeviceFileTest : public testing::Test
+{
+protected:
+	void SetUp() override
+	{
+		ASSERT_TRUE(mDirectory.isValid());
+		mFileName = mDirectory.path() + "/duty_ns";
+		overwrite(mFileName, "0");
+	}
+
+	QTemporaryDir mDirectory;
+	QString mFileName;
+};
+
+}
+
+TEST_F(TrikOutputDeviceFileTest, writeValueTest)
+{
+	TrikOutputDeviceFile file(mFileName);
+	ASSERT_TRUE(file.open());
+	EXPECT_TRUE(file.isSeekable());
+	EXPECT_FALSE(file.isSysfsAttribute());
+
+	file.write(1500000);
+	EXPECT_EQ("1500000", contents(mFileName));
+
+	// Shorter value replaces the whole old one.
+	file.write(-7);
+	EXPECT_EQ("-7", contents(mFileName));
+
+	file.write(QString("enable"));
+	EXPECT_EQ("enable", contents(mFileName));
+}
+
+TEST_F(TrikOutputDeviceFileTest, deduplicationTest)
+{
+	TrikOutputDeviceFile file(mFileName);
+	ASSERT_TRUE(file.open());
+	file.write(42);
+
+	// Same value is not written again, so a change made by someone else survives.
+	overwrite(mFileName, "x");
+	file.write(42);
+	EXPECT_EQ("x", contents(mFileName));
+
+	file.write(43);
+	EXPECT_EQ("43", contents(mFileName));
+
+	// String write may be anything, value is written after it even if it is the same as before.
+	file.write(QString("x"));
+	file.write(43);
+	EXPECT_EQ("43", contents(mFileName));
+
+	// Reopened file may have been changed while it was closed.
+	file.close();
+	overwrite(mFileName, "x");
+	ASSERT_TRUE(file.open());
+	file.write(43);
+	EXPECT_EQ("43", contents(mFileName));
+}
+
+TEST_F(TrikOutputDeviceFileTest, fifoTest)
+{
+	const QString fifoName = mDirectory.path() + "/fifo";
+	ASSERT_EQ(0, mkfifo(fifoName.toLocal8Bit().constData(), 0600));
+	const int reader = ::open(fifoName.toLocal8Bit().constData(), O_RDONLY | O_NONBLOCK);
+	ASSERT_NE(-1, reader);
+
+	TrikOutputDeviceFile file(fifoName);
+	ASSERT_TRUE(file.open());
+	EXPECT_FALSE(file.isSeekable());
+	file.write(1);
+	file.write(1);
+	file.write(2);
+	file.write(QString("cmd"));
+
+	char buffer[64];
+	const ssize_t size = ::read(reader, buffer, sizeof(buffer));
+	::close(reader);
+	ASSERT_GT(size, 0);
+	EXPECT_EQ("12cmd", std::string(buffer, size));
+}
+
+TEST_F(TrikOutputDeviceFileTest, notOpenedTest)
+{
+	TrikOutputDeviceFile file(mDirectory.path() + "/missing/duty_ns");
+	EXPECT_FALSE(file.open());
+	EXPECT_EQ(-1, file.fileDescriptor());
+
+	// Writes to not opened file are reported and ignored.
+	file.write(1);
+	file.write(QString("1"));
+}
+
+TEST_F(TrikOutputDeviceFileTest, writeBenchmark)
+{
+	// Six servo channels updated at 100 Hz for a minute.
+	const int channels = 6;
+	const int ticks = 6000;
+	QVector<QSharedPointer<TrikOutputDeviceFile>> files;
+	for (int i = 0; i < channels; ++i) {
+		const QString fileName = mDirectory.path() + "/duty_ns" + QString::number(i);
+		overwrite(fileName, "0");
+		files.append(QSharedPointer<TrikOutputDeviceFile>(new TrikOutputDeviceFile(fileName)));
+		ASSERT_TRUE(files.last()->open());
+	}
+
+	QElapsedTimer timer;
+	timer.start();
+	for (int tick = 0; tick < ticks; ++tick) {
+		for (const auto &file : files) {
+			file->write(QString::number(1000000 + tick));
+		}
+	}
+
+	const qint64 strings = timer.nsecsElapsed();
+
+	timer.restart();
+	for (int tick = 0; tick < ticks; ++tick) {
+		for (const auto &file : files) {
+			file->write(1000000 + tick);
+		}
+	}
+
+	const qint64 changed = timer.nsecsElapsed();
+
+	timer.restart();
+	for (int tick = 0; tick < ticks; ++tick) {
+		for (const auto &file : files) {
+			file->write(1500000);
+		}
+	}
+
+	const qint64 unchanged = timer.nsecsElapsed();
+
+	const int writes = channels * ticks;
+	std::cout << "[          ] Output device file, ns per write: string " << strings / writes
+			<< ", changed integer " << changed / writes << ", unchanged integer " << unchanged / writes << std::endl;
+
+	EXPECT_LT(unchanged, changed);
+}
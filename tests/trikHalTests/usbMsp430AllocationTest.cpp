@@ -0,0 +1,355 @@
+/* Copyright 2016 CyberTech Labs Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License. */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <malloc.h>
+#include <poll.h>
+#include <pty.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <iostream>
+#include <thread>
+
+#include <QtCore/QByteArray>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QVector>
+
+#include <trikHal/mspBatchOperation.h>
+#include <trikHal/mspCommand.h>
+
+#include <trik/trikMspUsb.h>
+#include <trik/usbMsp/usbMSP430Defines.h>
+#include <trik/usbMsp/usbMSP430Interface.h>
+#include <trik/usbMsp/usbMSP430Transport.h>
+
+#include <gtest/gtest.h>
+
+/// Globals of USB MSP430 driver, defined in usbMSP430Interface.cpp.
+extern int usb_out_descr;
+extern volatile uint8_t usb_protocol;
+
+// Allocations are counted by replacing allocation functions of glibc. With address sanitizer that would override
+// its allocator too, and blocks of glibc would be freed by sanitizer, so the test is built only without it.
+#if defined(__has_feature)
+#if __has_feature(address_sanitizer)
+#define TRIK_ALLOCATIONS_NOT_COUNTED
+#endif
+#endif
+
+#if defined(__SANITIZE_ADDRESS__)
+#define TRIK_ALLOCATIONS_NOT_COUNTED
+#endif
+
+#ifndef TRIK_ALLOCATIONS_NOT_COUNTED
+
+/// Number of heap allocations made by current thread. Every allocation function of glibc is replaced, Qt containers
+/// call malloc() directly, operator new goes through malloc() or aligned_alloc().
+static thread_local int allocations = 0;
+
+extern "C" {
+
+void *__libc_malloc(size_t size);
+void *__libc_calloc(size_t count, size_t size);
+void *__libc_realloc(void *pointer, size_t size);
+void *__libc_memalign(size_t alignment, size_t size);
+void *__libc_valloc(size_t size);
+void *__libc_pvalloc(size_t size);
+
+void *malloc(size_t size)
+{
+	++allocations;
+	return __libc_malloc(size);
+}
+
+void *calloc(size_t count, size_t size)
+{
+	++allocations;
+	return __libc_calloc(count, size);
+}
+
+void *realloc(void *pointer, size_t size)
+{
+	++allocations;
+	return __libc_realloc(pointer, size);
+}
+
+void *reallocarray(void *pointer, size_t count, size_t size)
+{
+	++allocations;
+	if (size != 0 && count > SIZE_MAX / size) {
+		errno = ENOMEM;
+		return nullptr;
+	}
+
+	return __libc_realloc(pointer, count * size);
+}
+
+void *memalign(size_t alignment, size_t size)
+{
+	++allocations;
+	return __libc_memalign(alignment, size);
+}
+
+void *aligned_alloc(size_t alignment, size_t size)
+{
+	++allocations;
+	return __libc_memalign(alignment, size);
+}
+
+int posix_memalign(void **pointer, size_t alignment, size_t size)
+{
+	++allocations;
+	if (alignment % sizeof(void *) != 0 || (alignment & (alignment - 1)) != 0) {
+		return EINVAL;
+	}
+
+	void * const result = __libc_memalign(alignment, size);
+	if (!result) {
+		return ENOMEM;
+	}
+
+	*pointer = result;
+	return 0;
+}
+
+void *valloc(size_t size)
+{
+	++allocations;
+	return __libc_valloc(size);
+}
+
+void *pvalloc(size_t size)
+{
+	++allocations;
+	return __libc_pvalloc(size);
+}
+
+}
+
+namespace {
+
+/// Number of control ticks to measure.
+const int ticks = 200;
+
+/// Motor power registers, in order of ports.
+const quint16 motors[] = {i2cMOT1, i2cMOT2, i2cMOT3, i2cMOT4};
+
+/// Analog sensor registers, in order of ports.
+const quint16 sensors[] = {i2cSENS1, i2cSENS2, i2cSENS3, i2cSENS4, i2cSENS5, i2cSENS6};
+
+/// Encoder registers, in order of ports.
+const quint16 encoders[] = {i2cENC1, i2cENC2, i2cENC3, i2cENC4};
+
+/// Fills batch with MSP commands of one control tick: powers of all motors, then reads of all sensors and encoders.
+void fillTick(trikHal::MspBatch &batch, int tick)
+{
+	batch.clear();
+	for (const quint16 motor : motors) {
+		batch << trikHal::MspBatchOperation{trikHal::MspCommand::writeByte(motor, tick % 100), 0};
+	}
+
+	for (const quint16 sensor : sensors) {
+		batch << trikHal::MspBatchOperation{trikHal::MspCommand::readWord(sensor), 0};
+	}
+
+	for (const quint16 encoder : encoders) {
+		batch << trikHal::MspBatchOperation{trikHal::MspCommand::readLong(encoder), 0};
+	}
+}
+
+/// Fixture with pseudo terminal in place of USB device. Fake MSP430 on the master side answers every binary request
+/// with the register address as a value.
+class UsbMsp430AllocationTest : public testing::Test
+{
+protected:
+	void SetUp() override
+	{
+		int slave = -1;
+		ASSERT_EQ(0, openpty(&mMaster, &slave, nullptr, nullptr, nullptr));
+		struct termios attributes;
+		tcgetattr(slave, &attributes);
+		cfmakeraw(&attributes);
+		tcsetattr(slave, TCSANOW, &attributes);
+		tcgetattr(mMaster, &attributes);
+		cfmakeraw(&attributes);
+		tcsetattr(mMaster, TCSANOW, &attributes);
+		fcntl(slave, F_SETFL, fcntl(slave, F_GETFL) | O_NONBLOCK);
+		usb_out_descr = slave;
+		usb_protocol = PROTOCOL_BINARY;
+		invalidate_shadow_regs();
+		mFakeMsp = std::thread([this]() { serve(); });
+	}
+
+	void TearDown() override
+	{
+		mStop = true;
+		if (mFakeMsp.joinable()) {
+			mFakeMsp.join();
+		}
+
+		close(usb_out_descr);
+		close(mMaster);
+		usb_out_descr = -1;
+		usb_protocol = PROTOCOL_ASCII;
+		invalidate_shadow_regs();
+	}
+
+private:
+	/// Fake MSP430 loop: assembles binary requests and answers them.
+	void serve()
+	{
+		QByteArray requests;
+		while (!mStop) {
+			struct pollfd descriptor = {mMaster, POLLIN, 0};
+			if (poll(&descriptor, 1, 10) <= 0) {
+				continue;
+			}
+
+			char chunk[RECV_CHUNK_LEN];
+			const ssize_t received = read(mMaster, chunk, sizeof(chunk));
+			if (received <= 0) {
+				continue;
+			}
+
+			requests.append(chunk, received);
+			while (requests.size() >= 2 && requests.size() >= uint8_t(requests[1])) {
+				const uint8_t *request = reinterpret_cast<const uint8_t *>(requests.constData());
+				uint8_t reply[BIN_RECV_PACK_LEN];
+				makeWriteRegBinaryPacket(reply, request[2], request[4], request[4]);
+				reply[3] = request[3];
+				reply[BIN_RECV_PACK_LEN - 1] = crc8(reply + 1, BIN_RECV_PACK_LEN - 2);
+				requests.remove(0, request[1]);
+				if (write(mMaster, reply, sizeof(reply)) != sizeof(reply)) {
+					return;
+				}
+			}
+		}
+	}
+
+	int mMaster = -1;
+	std::atomic<bool> mStop {false};
+	std::thread mFakeMsp;
+};
+
+}
+
+TEST_F(UsbMsp430AllocationTest, allocationCounterTest)
+{
+	// Counter sees every way to allocate, otherwise zero allocations below would prove nothing. Blocks are kept in
+	// volatile pointer, so that compiler can not drop allocation and deallocation pair.
+	void * volatile block = nullptr;
+	void *aligned = nullptr;
+	allocations = 0;
+	block = malloc(16);
+	free(block);
+	block = calloc(2, 16);
+	free(block);
+	block = realloc(nullptr, 16);
+	free(block);
+	ASSERT_EQ(0, posix_memalign(&aligned, 64, 16));
+	block = aligned;
+	free(block);
+	block = aligned_alloc(64, 64);
+	free(block);
+	block = memalign(64, 16);
+	free(block);
+	int * volatile number = new int(0);
+	delete number;
+	char * volatile buffer = new char[16];
+	delete[] buffer;
+	EXPECT_EQ(8, allocations);
+}
+
+TEST_F(UsbMsp430AllocationTest, commandAllocationTest)
+{
+	// Commands of a tick are built without heap, unlike legacy byte arrays.
+	trikHal::MspBatch batch;
+	batch.reserve(16);
+	fillTick(batch, 0);
+
+	allocations = 0;
+	for (int tick = 0; tick < ticks; ++tick) {
+		fillTick(batch, tick);
+	}
+
+	const int commandAllocations = allocations;
+
+	allocations = 0;
+	for (int tick = 0; tick < ticks; ++tick) {
+		for (const trikHal::MspBatchOperation &operation : batch) {
+			const QByteArray legacy = operation.command.toByteArray();
+			ASSERT_FALSE(legacy.isEmpty());
+		}
+	}
+
+	const int legacyAllocations = allocations;
+
+	EXPECT_EQ(0, commandAllocations);
+	std::cout << "[          ] Allocations per tick of " << batch.size() << " MSP commands: "
+			<< commandAllocations / ticks << ", as legacy byte arrays " << legacyAllocations / ticks << std::endl;
+}
+
+TEST_F(UsbMsp430AllocationTest, tickAllocationBenchmark)
+{
+	trikHal::trik::TrikMspUsb usb;
+	trikHal::MspBatch batch;
+	batch.reserve(16);
+
+	// First tick configures devices and fills shadow registers.
+	fillTick(batch, 0);
+	usb.transaction(batch);
+
+	QElapsedTimer timer;
+	timer.start();
+	allocations = 0;
+	for (int tick = 0; tick < ticks; ++tick) {
+		fillTick(batch, tick);
+		usb.transaction(batch);
+	}
+
+	const int tickAllocations = allocations;
+	const qint64 elapsed = timer.nsecsElapsed();
+
+	for (int i = 0; i < 6; ++i) {
+		EXPECT_EQ(SSVAL, batch[4 + i].result);
+	}
+
+	EXPECT_EQ(0, tickAllocations);
+	std::cout << "[          ] USB MSP tick of " << batch.size() << " commands over pty: "
+			<< static_cast<double>(tickAllocations) / ticks << " allocations, " << elapsed / ticks / 1000
+			<< " us per tick" << std::endl;
+}
+
+TEST_F(UsbMsp430AllocationTest, longBatchTest)
+{
+	// Reads that do not fit into one exchange are split, results still go to their commands.
+	trikHal::trik::TrikMspUsb usb;
+	trikHal::MspBatch batch;
+	for (int i = 0; i < 3 * MAX_READ_PLANS + 1; ++i) {
+		batch << trikHal::MspBatchOperation{trikHal::MspCommand::readWord(sensors[i % 6]), 0};
+	}
+
+	usb.transaction(batch);
+
+	for (const trikHal::MspBatchOperation &operation : batch) {
+		EXPECT_EQ(SSVAL, operation.result);
+	}
+}
+
+#endif
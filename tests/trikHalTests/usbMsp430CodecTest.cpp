@@ -0,0 +1,211 @@
+/* Copyright 2016 CyberTech Labs Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License. */
+
+
+#include <stdio.h>
+#include <string.h>
+
+#include <iostream>
+
+#include <QtCore/QElapsedTimer>
+
+#include <trik/usbMsp/usbMSP430Defines.h>
+#include <trik/usbMsp/usbMSP430Interface.h>
+
+#include <gtest/gtest.h>
+
+/// Wire protocol used by makeWriteRegPacket and makeReadRegPacket, defined in usbMSP430Interface.cpp.
+extern volatile uint8_t usb_protocol;
+
+namespace {
+
+/// Error codes of decoder, typed as its result to be compared without sign conversion.
+const uint32_t noError = NO_ERROR;
+const uint32_t lengthError = LENGTH_ERROR;
+const uint32_t crcError = CRC_ERROR;
+const uint32_t startError = START_ERROR;
+
+/// Makes binary reply of MSP430 to a register access, it has the same layout as binary write request.
+uint16_t makeBinaryReply(uint8_t *packet, uint8_t devAddr, uint8_t funcCode, uint8_t regAddr, uint32_t regVal)
+{
+	makeWriteRegBinaryPacket(packet, devAddr, regAddr, regVal);
+	packet[3] = funcCode;
+	packet[BIN_RECV_PACK_LEN - 1] = crc8(packet + 1, BIN_RECV_PACK_LEN - 2);
+	return BIN_RECV_PACK_LEN;
+}
+
+/// Makes ASCII reply of MSP430 to a register access, it has the same layout as ASCII write request.
+uint16_t makeAsciiReply(char *packet, uint8_t devAddr, uint8_t funcCode, uint8_t regAddr, uint32_t regVal)
+{
+	const uint8_t crc = (0xFF - (devAddr + funcCode + regAddr + uint8_t(regVal & 0xFF) + uint8_t((regVal >> 8) & 0xFF)
+			+ uint8_t((regVal >> 16) & 0xFF) + uint8_t((regVal >> 24) & 0xFF)) + 1) & 0xFF;
+	sprintf(packet, ":%02X%02X%02X%08X%02X\n", devAddr, funcCode, regAddr, regVal, crc);
+	return strlen(packet);
+}
+
+/// Restores ASCII protocol after a test that switches it.
+class ProtocolGuard
+{
+public:
+	explicit ProtocolGuard(uint8_t protocol)
+	{
+		usb_protocol = protocol;
+	}
+
+	~ProtocolGuard()
+	{
+		usb_protocol = PROTOCOL_ASCII;
+	}
+};
+
+}
+
+TEST(usbMsp430CodecTest, crc8Test)
+{
+	// CRC-8 with polynomial 0x07 of "123456789" is a standard check value.
+	const uint8_t data[] = {'1', '2', '3', '4', '5', '6', '7', '8', '9'};
+	EXPECT_EQ(0xF4, crc8(data, sizeof(data)));
+	EXPECT_EQ(0x00, crc8(data, 0));
+}
+
+TEST(usbMsp430CodecTest, binaryRequestsTest)
+{
+	uint8_t packet[MAX_STRING_LENGTH] = {0};
+	ASSERT_EQ(BIN_WRITE_PACK_LEN, makeWriteRegBinaryPacket(packet, 0x12, 0x03, 0xA1B2C3D4));
+	const uint8_t expectedWrite[] = {BIN_START, BIN_WRITE_PACK_LEN, 0x12, WRITE_FUNC, 0x03, 0xD4, 0xC3, 0xB2, 0xA1};
+	EXPECT_EQ(0, memcmp(expectedWrite, packet, sizeof(expectedWrite)));
+	EXPECT_EQ(crc8(packet + 1, BIN_WRITE_PACK_LEN - 2), packet[BIN_WRITE_PACK_LEN - 1]);
+	EXPECT_EQ(BIN_WRITE_PACK_LEN, packetLength(reinterpret_cast<char *>(packet)));
+
+	ASSERT_EQ(BIN_READ_PACK_LEN, makeReadRegBinaryPacket(packet, 0x12, 0x04));
+	const uint8_t expectedRead[] = {BIN_START, BIN_READ_PACK_LEN, 0x12, READ_FUNC, 0x04};
+	EXPECT_EQ(0, memcmp(expectedRead, packet, sizeof(expectedRead)));
+	EXPECT_EQ(crc8(packet + 1, BIN_READ_PACK_LEN - 2), packet[BIN_READ_PACK_LEN - 1]);
+	EXPECT_EQ(BIN_READ_PACK_LEN, packetLength(reinterpret_cast<char *>(packet)));
+}
+
+TEST(usbMsp430CodecTest, binaryRoundTripTest)
+{
+	const ProtocolGuard guard(PROTOCOL_BINARY);
+	char packet[MAX_STRING_LENGTH] = {0};
+	makeWriteRegPacket(packet, 0x05, 0x01, 0x12345678);
+	EXPECT_EQ(BIN_START, uint8_t(packet[0]));
+
+	const uint16_t length = makeBinaryReply(reinterpret_cast<uint8_t *>(packet), 0x05, READ_FUNC, 0x01, 0xFFFF0001);
+	uint8_t devAddr = 0;
+	uint8_t funcCode = 0;
+	uint8_t regAddr = 0;
+	uint32_t regVal = 0;
+	ASSERT_EQ(noError, decodeReceivedPacket(packet, length, devAddr, funcCode, regAddr, regVal));
+	EXPECT_EQ(0x05, devAddr);
+	EXPECT_EQ(READ_FUNC, funcCode);
+	EXPECT_EQ(0x01, regAddr);
+	EXPECT_EQ(0xFFFF0001u, regVal);
+}
+
+TEST(usbMsp430CodecTest, binaryErrorsTest)
+{
+	char packet[MAX_STRING_LENGTH] = {0};
+	uint8_t * const bytes = reinterpret_cast<uint8_t *>(packet);
+	const uint16_t length = makeBinaryReply(bytes, 0x05, READ_FUNC, 0x01, 42);
+	uint8_t devAddr = 0;
+	uint8_t funcCode = 0;
+	uint8_t regAddr = 0;
+	uint32_t regVal = 0;
+
+	// Packet is cut short, though its length byte is correct.
+	EXPECT_EQ(lengthError, decodeReceivedPacket(packet, length - 3, devAddr, funcCode, regAddr, regVal));
+	EXPECT_EQ(lengthError, decodeReceivedPacket(packet, 0, devAddr, funcCode, regAddr, regVal));
+
+	// Length byte does not match packet size.
+	bytes[1] = BIN_READ_PACK_LEN;
+	EXPECT_EQ(lengthError, decodeReceivedPacket(packet, length, devAddr, funcCode, regAddr, regVal));
+	bytes[1] = BIN_RECV_PACK_LEN;
+
+	// Corrupted value.
+	bytes[6] ^= 0x10;
+	EXPECT_EQ(crcError, decodeReceivedPacket(packet, length, devAddr, funcCode, regAddr, regVal));
+	bytes[6] ^= 0x10;
+
+	bytes[0] = 0x00;
+	EXPECT_EQ(startError, decodeReceivedPacket(packet, length, devAddr, funcCode, regAddr, regVal));
+}
+
+TEST(usbMsp430CodecTest, asciiRoundTripTest)
+{
+	const ProtocolGuard guard(PROTOCOL_ASCII);
+	char packet[MAX_STRING_LENGTH] = {0};
+	makeWriteRegPacket(packet, 0x05, 0x01, 0x12345678);
+	EXPECT_STREQ(":05030112345678E3\n", packet);
+	makeReadRegPacket(packet, 0x05, 0x01);
+	EXPECT_STREQ(":050501F5\n", packet);
+	EXPECT_EQ(strlen(packet), packetLength(packet));
+
+	const uint16_t length = makeAsciiReply(packet, 0x1C, READ_FUNC, 0x04, 0x000003FF);
+	uint8_t devAddr = 0;
+	uint8_t funcCode = 0;
+	uint8_t regAddr = 0;
+	uint32_t regVal = 0;
+	ASSERT_EQ(noError, decodeReceivedPacket(packet, length, devAddr, funcCode, regAddr, regVal));
+	EXPECT_EQ(0x1C, devAddr);
+	EXPECT_EQ(READ_FUNC, funcCode);
+	EXPECT_EQ(0x04, regAddr);
+	EXPECT_EQ(0x3FFu, regVal);
+
+	// Truncated reply.
+	EXPECT_EQ(lengthError, decodeReceivedPacket(packet, length - 5, devAddr, funcCode, regAddr, regVal));
+
+	// Corrupted value.
+	packet[10] = packet[10] == '0' ? '1' : '0';
+	EXPECT_EQ(crcError, decodeReceivedPacket(packet, length, devAddr, funcCode, regAddr, regVal));
+}
+
+TEST(usbMsp430CodecTest, throughputBenchmark)
+{
+	const int iterations = 200000;
+	char request[MAX_STRING_LENGTH] = {0};
+	char reply[MAX_STRING_LENGTH] = {0};
+	uint8_t devAddr = 0;
+	uint8_t funcCode = 0;
+	uint8_t regAddr = 0;
+	uint32_t regVal = 0;
+	qint64 elapsed[2] = {0, 0};
+	uint32_t bytes[2] = {0, 0};
+	uint32_t checksum = 0;
+
+	for (const uint8_t protocol : {PROTOCOL_ASCII, PROTOCOL_BINARY}) {
+		const ProtocolGuard guard(protocol);
+		QElapsedTimer timer;
+		timer.start();
+		for (int i = 0; i < iterations; ++i) {
+			makeReadRegPacket(request, SENSOR1, 0x04);
+			const uint16_t length = protocol == PROTOCOL_BINARY
+					? makeBinaryReply(reinterpret_cast<uint8_t *>(reply), SENSOR1, READ_FUNC, 0x04, i)
+					: makeAsciiReply(reply, SENSOR1, READ_FUNC, 0x04, i);
+			ASSERT_EQ(noError, decodeReceivedPacket(reply, length, devAddr, funcCode, regAddr, regVal));
+			checksum += regVal;
+			bytes[protocol] = packetLength(request) + length;
+		}
+
+		elapsed[protocol] = timer.nsecsElapsed();
+	}
+
+	std::cout << "[          ] Read request and reply codec, ns per read: ASCII "
+			<< elapsed[PROTOCOL_ASCII] / iterations << " (" << bytes[PROTOCOL_ASCII] << " bytes on wire), binary "
+			<< elapsed[PROTOCOL_BINARY] / iterations << " (" << bytes[PROTOCOL_BINARY] << " bytes on wire)"
+			<< std::endl;
+
+	EXPECT_NE(0u, checksum);
+	EXPECT_LT(bytes[PROTOCOL_BINARY], bytes[PROTOCOL_ASCII]);
+}
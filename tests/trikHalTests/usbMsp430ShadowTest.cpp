@@ -0,0 +1,117 @@
+/* Copyright 2016 CyberTech Labs Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License. */
+
+#include <mspCommand.h>
+
+#include <trik/usbMsp/usbMSP430Defines.h>
+#include <trik/usbMsp/usbMSP430Interface.h>
+
+#include <gtest/gtest.h>
+
+using namespace trikHal;
+
+namespace {
+
+/// Makes read plan of analog or DHTxx sensor.
+ReadPlan sensorPlan(quint16 registerNumber)
+{
+	ReadPlan plan;
+	EXPECT_TRUE(makeSensorReadPlan(MspCommand::readWord(registerNumber), plan));
+	return plan;
+}
+
+/// Makes read plan of an encoder.
+ReadPlan encoderPlan(quint16 registerNumber)
+{
+	ReadPlan plan;
+	EXPECT_TRUE(makeEncoderReadPlan(MspCommand::readLong(registerNumber), plan));
+	return plan;
+}
+
+/// Switches device to function of a plan and remembers its configuration, as executeReadPlans does.
+void configure(const ReadPlan &plan)
+{
+	switch_alt_func(plan.dev_addr, plan.alt_func);
+	for (uint8_t i = 0; i < plan.conf_count; ++i) {
+		update_shadow_reg(plan.dev_addr, plan.conf_regs[i], plan.conf_vals[i]);
+	}
+}
+
+/// Checks that device is known to have configuration of a plan.
+bool isConfigured(const ReadPlan &plan)
+{
+	for (uint8_t i = 0; i < plan.conf_count; ++i) {
+		if (!shadow_reg_matches(plan.dev_addr, plan.conf_regs[i], plan.conf_vals[i])) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+}
+
+TEST(usbMsp430ShadowTest, switchInvalidatesOnlySwitchedDeviceTest)
+{
+	invalidate_shadow_regs();
+	const ReadPlan analog1 = sensorPlan(i2cSENS1);
+	const ReadPlan analog2 = sensorPlan(i2cSENS2);
+	const ReadPlan encoder = encoderPlan(i2cENC1);
+	configure(analog1);
+	configure(analog2);
+	configure(encoder);
+	ASSERT_TRUE(isConfigured(analog1));
+	ASSERT_TRUE(isConfigured(analog2));
+	ASSERT_TRUE(isConfigured(encoder));
+
+	// DHTxx sensor on the port of the first analog sensor.
+	const ReadPlan dht = sensorPlan(TEMP_DHT11_1 + analog1.dev_addr - SENSOR1);
+	ASSERT_EQ(analog1.dev_addr, dht.dev_addr);
+	ASSERT_NE(analog1.alt_func, dht.alt_func);
+	configure(dht);
+	EXPECT_TRUE(isConfigured(dht));
+	EXPECT_TRUE(isConfigured(analog2));
+	EXPECT_TRUE(isConfigured(encoder));
+
+	// Switching back reconfigures the port.
+	switch_alt_func(analog1.dev_addr, analog1.alt_func);
+	EXPECT_FALSE(isConfigured(analog1));
+	EXPECT_TRUE(isConfigured(analog2));
+
+	// Repeated switch to the same function keeps configuration.
+	configure(analog1);
+	switch_alt_func(analog1.dev_addr, analog1.alt_func);
+	EXPECT_TRUE(isConfigured(analog1));
+}
+
+TEST(usbMsp430ShadowTest, deviceWithoutAltFunctionTest)
+{
+	invalidate_shadow_regs();
+	const ReadPlan battery = sensorPlan(i2cBATT);
+	EXPECT_EQ(ALT_NOTHING, battery.alt_func);
+	configure(battery);
+	ASSERT_TRUE(isConfigured(battery));
+
+	// Reading battery between reads of other sensors does not toggle anything.
+	const ReadPlan analog = sensorPlan(i2cSENS1);
+	configure(analog);
+	configure(battery);
+	switch_alt_func(analog.dev_addr, analog.alt_func);
+	EXPECT_TRUE(isConfigured(analog));
+	EXPECT_TRUE(isConfigured(battery));
+
+	invalidate_shadow_regs();
+	EXPECT_FALSE(isConfigured(analog));
+	EXPECT_FALSE(isConfigured(battery));
+}
@@ -0,0 +1,250 @@
+/* Copyright 2016 CyberTech Labs Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License. */
+
+#include <fcntl.h>
+#include <poll.h>
+#include <pty.h>
+#include <string.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <iostream>
+#include <thread>
+
+#include <QtCore/QByteArray>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QVector>
+
+#include <trik/usbMsp/usbMSP430Defines.h>
+#include <trik/usbMsp/usbMSP430Interface.h>
+#include <trik/usbMsp/usbMSP430Transport.h>
+
+#include <gtest/gtest.h>
+
+namespace {
+
+const uint32_t noError = NO_ERROR;
+const uint32_t packetError = PACKET_ERROR;
+
+/// Value fake MSP430 reports for a register.
+uint32_t registerValue(uint8_t devAddr, uint8_t regAddr)
+{
+	return 0xC0DE0000 | (devAddr << 8) | regAddr;
+}
+
+/// Makes binary reply of MSP430 with given value register content.
+QByteArray binaryReply(uint8_t devAddr, uint8_t regAddr, uint32_t regVal)
+{
+	uint8_t packet[BIN_RECV_PACK_LEN];
+	makeWriteRegBinaryPacket(packet, devAddr, regAddr, regVal);
+	packet[3] = READ_FUNC;
+	packet[BIN_RECV_PACK_LEN - 1] = crc8(packet + 1, BIN_RECV_PACK_LEN - 2);
+	return QByteArray(reinterpret_cast<char *>(packet), BIN_RECV_PACK_LEN);
+}
+
+/// Fixture with pseudo terminal in place of USB device. Fake MSP430 on the master side answers binary read requests,
+/// prepending each reply with configured noise, the code under test works with the slave side.
+class UsbMsp430TransportTest : public testing::Test
+{
+protected:
+	void SetUp() override
+	{
+		ASSERT_EQ(0, openpty(&mMaster, &mSlave, nullptr, nullptr, nullptr));
+		struct termios attributes;
+		tcgetattr(mSlave, &attributes);
+		cfmakeraw(&attributes);
+		tcsetattr(mSlave, TCSANOW, &attributes);
+		tcgetattr(mMaster, &attributes);
+		cfmakeraw(&attributes);
+		tcsetattr(mMaster, TCSANOW, &attributes);
+		fcntl(mSlave, F_SETFL, fcntl(mSlave, F_GETFL) | O_NONBLOCK);
+		mFakeMsp = std::thread([this]() { serve(); });
+	}
+
+	void TearDown() override
+	{
+		mStop = true;
+		if (mFakeMsp.joinable()) {
+			mFakeMsp.join();
+		}
+
+		close(mSlave);
+		close(mMaster);
+	}
+
+	/// Sends binary read requests of given registers of a device and checks that replies are decoded.
+	void exchange(uint8_t devAddr, uint8_t regCount)
+	{
+		QVector<PacketBuffer> packets(regCount);
+		QVector<char *> pointers;
+		for (uint8_t reg = 0; reg < regCount; ++reg) {
+			makeReadRegBinaryPacket(reinterpret_cast<uint8_t *>(packets[reg].data), devAddr, reg);
+			pointers.append(packets[reg].data);
+		}
+
+		QVector<uint16_t> lengths(regCount);
+		ASSERT_EQ(noError, exchangeUSBPackets(mSlave, pointers.data(), pointers.data(), regCount, lengths.data()));
+		for (uint8_t reg = 0; reg < regCount; ++reg) {
+			uint8_t replyDev = 0;
+			uint8_t funcCode = 0;
+			uint8_t replyReg = 0;
+			uint32_t value = 0;
+			ASSERT_EQ(noError, decodeReceivedPacket(packets[reg].data, lengths[reg], replyDev, funcCode, replyReg
+					, value));
+			EXPECT_EQ(devAddr, replyDev);
+			EXPECT_EQ(reg, replyReg);
+			EXPECT_EQ(registerValue(devAddr, reg), value);
+		}
+	}
+
+	int mSlave = -1;
+
+	/// Bytes written before every reply.
+	QByteArray mNoise;
+
+	/// Fake MSP430 does not answer when set.
+	std::atomic<bool> mSilent {false};
+
+private:
+	/// Fake MSP430 loop: assembles binary read requests and answers them.
+	void serve()
+	{
+		QByteArray request;
+		while (!mStop) {
+			struct pollfd descriptor = {mMaster, POLLIN, 0};
+			if (poll(&descriptor, 1, 10) <= 0) {
+				continue;
+			}
+
+			char chunk[RECV_CHUNK_LEN];
+			const ssize_t received = read(mMaster, chunk, sizeof(chunk));
+			if (received <= 0) {
+				continue;
+			}
+
+			if (mSilent) {
+				continue;
+			}
+
+			request.append(chunk, received);
+			while (request.size() >= BIN_READ_PACK_LEN) {
+				const QByteArray reply = mNoise + binaryReply(request[2], request[4]
+						, registerValue(request[2], request[4]));
+				request.remove(0, BIN_READ_PACK_LEN);
+				if (write(mMaster, reply.constData(), reply.size()) != reply.size()) {
+					return;
+				}
+			}
+		}
+	}
+
+	int mMaster = -1;
+	std::atomic<bool> mStop {false};
+	std::thread mFakeMsp;
+};
+
+}
+
+TEST_F(UsbMsp430TransportTest, cleanRepliesTest)
+{
+	exchange(SENSOR1, 1);
+	exchange(SENSOR2, 2 * MAX_IN_FLIGHT + 3);
+}
+
+TEST_F(UsbMsp430TransportTest, garbageBetweenRepliesTest)
+{
+	mNoise = QByteArray("\x00\xFF\x13", 3);
+	exchange(SENSOR1, MAX_IN_FLIGHT);
+}
+
+TEST_F(UsbMsp430TransportTest, asciiStartInGarbageTest)
+{
+	// ':' starts ASCII packet which is broken by binary start byte of the real reply.
+	mNoise = QByteArray(":0A05");
+	exchange(SENSOR1, MAX_IN_FLIGHT);
+}
+
+TEST_F(UsbMsp430TransportTest, truncatedReplyTest)
+{
+	// Beginning of a reply whose tail was lost, the real reply starts inside the bytes taken for its body.
+	mNoise = binaryReply(SENSOR3, 0x01, 0).left(5);
+	exchange(SENSOR1, MAX_IN_FLIGHT);
+}
+
+TEST_F(UsbMsp430TransportTest, wrongLengthTest)
+{
+	mNoise = binaryReply(SENSOR1, 0x00, 0);
+	mNoise[1] = BIN_READ_PACK_LEN;
+	exchange(SENSOR1, MAX_IN_FLIGHT);
+}
+
+TEST_F(UsbMsp430TransportTest, wrongCrcTest)
+{
+	// Corrupted reply from the same register with a wrong value shall not be taken for the real one.
+	mNoise = binaryReply(SENSOR1, 0x00, 0);
+	mNoise[BIN_RECV_PACK_LEN - 1] = mNoise[BIN_RECV_PACK_LEN - 1] ^ 0x01;
+	exchange(SENSOR1, 1);
+}
+
+TEST_F(UsbMsp430TransportTest, startWithoutBodyTest)
+{
+	// Start and length bytes followed by the real reply, which is taken for the body of the first packet.
+	mNoise = QByteArray(1, char(BIN_START));
+	mNoise.append(char(BIN_RECV_PACK_LEN));
+	exchange(SENSOR1, MAX_IN_FLIGHT);
+}
+
+TEST_F(UsbMsp430TransportTest, timeoutTest)
+{
+	mSilent = true;
+	uint8_t request[MAX_STRING_LENGTH] = {0};
+	makeReadRegBinaryPacket(request, SENSOR1, 0x00);
+	char reply[MAX_STRING_LENGTH] = {0};
+	char *in = reinterpret_cast<char *>(request);
+	char *out = reply;
+	uint16_t length = 1;
+	EXPECT_EQ(packetError, exchangeUSBPackets(mSlave, &in, &out, 1, &length));
+	EXPECT_EQ(0, length);
+}
+
+TEST_F(UsbMsp430TransportTest, exchangeBenchmark)
+{
+	const int batches = 500;
+	QElapsedTimer timer;
+	timer.start();
+	for (int i = 0; i < batches; ++i) {
+		exchange(SENSOR1, MAX_IN_FLIGHT);
+		if (HasFatalFailure()) {
+			return;
+		}
+	}
+
+	const qint64 clean = timer.nsecsElapsed();
+
+	mNoise = binaryReply(SENSOR3, 0x01, 0).left(5);
+	timer.restart();
+	for (int i = 0; i < batches; ++i) {
+		exchange(SENSOR1, MAX_IN_FLIGHT);
+		if (HasFatalFailure()) {
+			return;
+		}
+	}
+
+	const qint64 noisy = timer.nsecsElapsed();
+
+	std::cout << "[          ] Pipelined exchange over pty, us per request: clean "
+			<< clean / 1000 / (batches * MAX_IN_FLIGHT) << ", with truncated packet before each reply "
+			<< noisy / 1000 / (batches * MAX_IN_FLIGHT) << std::endl;
+}
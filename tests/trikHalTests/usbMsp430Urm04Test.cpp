@@ -0,0 +1,245 @@
+/* Copyright 2016 CyberTech Labs Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License. */
+
+#include <fcntl.h>
+#include <poll.h>
+#include <pty.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+
+#include <QtCore/QByteArray>
+#include <QtCore/QElapsedTimer>
+
+#include <trik/usbMsp/usbMSP430Defines.h>
+#include <trik/usbMsp/usbMSP430Interface.h>
+#include <trik/usbMsp/usbMSP430Transport.h>
+
+#include <gtest/gtest.h>
+
+/// Globals of USB MSP430 driver, defined in usbMSP430Interface.cpp.
+extern int usb_out_descr;
+extern volatile uint8_t usb_protocol;
+extern URM04Channel urm04_channels[URM04_USARTS];
+
+namespace {
+
+/// Maximal time for a sensor to get measured: its own measurement may wait for the one already in progress.
+const int measureTimeout = 2 * URM04_MEASURE_TIME + 200;
+
+/// Period of URM04 polling in tests, ms.
+const int pollPeriod = 10;
+
+/// Distance fake URM04 sensor reports.
+uint16_t sensorDistance(uint8_t urm04Addr)
+{
+	return 100 + urm04Addr;
+}
+
+/// Fixture with pseudo terminal in place of USB device. Fake MSP430 on the master side answers binary requests and
+/// emulates URM04 sensors on RS-485 bus of USART1: "read distance" command written byte by byte to UUDAT queues
+/// sensor reply, which is then read from UUDAT.
+class UsbMsp430Urm04Test : public testing::Test
+{
+protected:
+	void SetUp() override
+	{
+		int slave = -1;
+		ASSERT_EQ(0, openpty(&mMaster, &slave, nullptr, nullptr, nullptr));
+		struct termios attributes;
+		tcgetattr(slave, &attributes);
+		cfmakeraw(&attributes);
+		tcsetattr(slave, TCSANOW, &attributes);
+		tcgetattr(mMaster, &attributes);
+		cfmakeraw(&attributes);
+		tcsetattr(mMaster, TCSANOW, &attributes);
+		fcntl(slave, F_SETFL, fcntl(slave, F_GETFL) | O_NONBLOCK);
+		usb_out_descr = slave;
+		usb_protocol = PROTOCOL_BINARY;
+		reset_URM04();
+		mFakeMsp = std::thread([this]() { serve(); });
+	}
+
+	void TearDown() override
+	{
+		mStop = true;
+		if (mFakeMsp.joinable()) {
+			mFakeMsp.join();
+		}
+
+		close(usb_out_descr);
+		close(mMaster);
+		usb_out_descr = -1;
+		usb_protocol = PROTOCOL_ASCII;
+		reset_URM04();
+	}
+
+	/// Reads distance like a sensor worker does while poll timer of communicator advances ranging, until the
+	/// distance is there or timeout passes.
+	static uint32_t readWhilePolling(uint8_t urm04Addr, int timeout)
+	{
+		QElapsedTimer timer;
+		timer.start();
+		uint32_t distance = read_URM04_dist(USART1, urm04Addr);
+		while (distance == URM04_ERROR && timer.elapsed() < timeout) {
+			usleep(pollPeriod * 1000);
+			poll_URM04();
+			distance = read_URM04_dist(USART1, urm04Addr);
+		}
+
+		return distance;
+	}
+
+	/// Address of URM04 sensor which does not answer.
+	std::atomic<int> mSilentSensor {-1};
+
+private:
+	/// Handles one request and returns reply value.
+	uint32_t handle(uint8_t devAddr, uint8_t funcCode, uint8_t regAddr, uint32_t regVal)
+	{
+		if (devAddr != USART1 || regAddr != UUDAT) {
+			return 0;
+		}
+
+		if (funcCode == READ_FUNC) {
+			if (mSensorReply.isEmpty()) {
+				return 0xFF;
+			}
+
+			const uint8_t byte = mSensorReply[0];
+			mSensorReply.remove(0, 1);
+			return byte;
+		}
+
+		mSensorCommand.append(char(regVal));
+		if (mSensorCommand.size() < URM04_TRIG_LEN) {
+			return 0;
+		}
+
+		const uint8_t urm04Addr = mSensorCommand[2];
+		if (mSensorCommand[4] == 0x02 && urm04Addr != mSilentSensor) {
+			const uint16_t distance = sensorDistance(urm04Addr);
+			const uint8_t reply[URM04_REPLY_LEN - 1] = {0x55, 0xAA, urm04Addr, 0x02, 0x02
+					, uint8_t(distance >> 8), uint8_t(distance & 0xFF)};
+			uint8_t crc = 0;
+			for (const uint8_t byte : reply) {
+				crc += byte;
+			}
+
+			mSensorReply = QByteArray(reinterpret_cast<const char *>(reply), sizeof(reply));
+			mSensorReply.append(char(crc));
+		}
+
+		mSensorCommand.clear();
+		return 0;
+	}
+
+	/// Fake MSP430 loop: assembles binary requests and answers them.
+	void serve()
+	{
+		QByteArray requests;
+		while (!mStop) {
+			struct pollfd descriptor = {mMaster, POLLIN, 0};
+			if (poll(&descriptor, 1, 10) <= 0) {
+				continue;
+			}
+
+			char chunk[RECV_CHUNK_LEN];
+			const ssize_t received = read(mMaster, chunk, sizeof(chunk));
+			if (received <= 0) {
+				continue;
+			}
+
+			requests.append(chunk, received);
+			while (requests.size() >= 2 && requests.size() >= uint8_t(requests[1])) {
+				const uint8_t *request = reinterpret_cast<const uint8_t *>(requests.constData());
+				const uint32_t value = request[1] == BIN_WRITE_PACK_LEN
+						? request[5] | (request[6] << 8) | (request[7] << 16) | (uint32_t(request[8]) << 24)
+						: 0;
+				uint8_t reply[BIN_RECV_PACK_LEN];
+				makeWriteRegBinaryPacket(reply, request[2], request[4]
+						, handle(request[2], request[3], request[4], value));
+				reply[3] = request[3];
+				reply[BIN_RECV_PACK_LEN - 1] = crc8(reply + 1, BIN_RECV_PACK_LEN - 2);
+				requests.remove(0, request[1]);
+				if (write(mMaster, reply, sizeof(reply)) != sizeof(reply)) {
+					return;
+				}
+			}
+		}
+	}
+
+	int mMaster = -1;
+	std::atomic<bool> mStop {false};
+	std::thread mFakeMsp;
+	QByteArray mSensorCommand;
+	QByteArray mSensorReply;
+};
+
+}
+
+TEST_F(UsbMsp430Urm04Test, readDoesNotWaitForMeasurementTest)
+{
+	// There is no distance before the first measurement, and read does not wait for it.
+	QElapsedTimer timer;
+	timer.start();
+	EXPECT_EQ(URM04_ERROR, read_URM04_dist(USART1, 0x11));
+	EXPECT_LT(timer.elapsed(), pollPeriod);
+
+	EXPECT_EQ(sensorDistance(0x11), readWhilePolling(0x11, measureTimeout));
+	EXPECT_GE(timer.elapsed(), URM04_MEASURE_TIME);
+
+	// Second sensor on the same bus goes before round robin measurements of the first one.
+	timer.restart();
+	EXPECT_EQ(URM04_ERROR, read_URM04_dist(USART1, 0x12));
+	EXPECT_EQ(sensorDistance(0x12), readWhilePolling(0x12, measureTimeout));
+	EXPECT_LT(timer.elapsed(), measureTimeout);
+
+	// Measured sensors are read from cache.
+	timer.restart();
+	EXPECT_EQ(sensorDistance(0x11), read_URM04_dist(USART1, 0x11));
+	EXPECT_EQ(sensorDistance(0x12), read_URM04_dist(USART1, 0x12));
+	EXPECT_LT(timer.elapsed(), pollPeriod);
+}
+
+TEST_F(UsbMsp430Urm04Test, silentSensorTest)
+{
+	mSilentSensor = 0x13;
+	EXPECT_EQ(URM04_ERROR, readWhilePolling(0x13, measureTimeout));
+	EXPECT_TRUE(urm04_channels[0].measured & (1 << 2));
+}
+
+TEST_F(UsbMsp430Urm04Test, idleSensorIsDroppedTest)
+{
+	URM04Channel &channel = urm04_channels[0];
+	ASSERT_EQ(sensorDistance(0x11), readWhilePolling(0x11, measureTimeout));
+	EXPECT_TRUE(channel.requested & 1);
+	EXPECT_TRUE(channel.measured & 1);
+
+	// Sensor has not been read for a long time, for example, its port was reconfigured.
+	channel.last_read[0] -= URM04_IDLE_TIME + 1;
+	poll_URM04();
+	EXPECT_EQ(0, channel.requested);
+	EXPECT_EQ(0, channel.measured);
+
+	// Stale distance is not returned, next read gets fresh one.
+	EXPECT_EQ(URM04_ERROR, read_URM04_dist(USART1, 0x11));
+	QElapsedTimer timer;
+	timer.start();
+	EXPECT_EQ(sensorDistance(0x11), readWhilePolling(0x11, measureTimeout));
+	EXPECT_GE(timer.elapsed(), URM04_MEASURE_TIME - 100);
+}
@@ -0,0 +1,130 @@
+/* Copyright 2016 CyberTech Labs Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License. */
+
+#include "lineBufferTest.h"
+
+#include <string.h>
+
+#include <QtCore/QElapsedTimer>
+
+#include <trikKernel/lineBuffer.h>
+
+using namespace tests;
+using namespace trikKernel;
+
+TEST_F(LineBufferTest, linesTest)
+{
+	LineBuffer buffer;
+	buffer.append("loc: 1 2 3\nhsv: 4", 17);
+
+	QByteArray line;
+	ASSERT_TRUE(buffer.takeLine(line));
+	EXPECT_EQ(QByteArray("loc: 1 2 3"), line);
+	EXPECT_FALSE(buffer.takeLine(line));
+
+	buffer.append(" 5 6\n\n", 6);
+	ASSERT_TRUE(buffer.takeLine(line));
+	EXPECT_EQ(QByteArray("hsv: 4 5 6"), line);
+	ASSERT_TRUE(buffer.takeLine(line));
+	EXPECT_TRUE(line.isEmpty());
+	EXPECT_FALSE(buffer.takeLine(line));
+	EXPECT_EQ(0, buffer.size());
+}
+
+TEST_F(LineBufferTest, wrapAroundTest)
+{
+	LineBuffer buffer(8);
+	QByteArray line;
+
+	buffer.append("abcde\n", 6);
+	ASSERT_TRUE(buffer.takeLine(line));
+
+	// Next line starts near the end of storage and continues from its beginning.
+	buffer.append("fghij\n", 6);
+	EXPECT_EQ(8, buffer.capacity());
+	ASSERT_TRUE(buffer.takeLine(line));
+	EXPECT_EQ(QByteArray("fghij"), line);
+}
+
+TEST_F(LineBufferTest, growTest)
+{
+	LineBuffer buffer(4);
+	QByteArray longLine(1000, 'x');
+	buffer.append(longLine.constData(), longLine.size());
+	buffer.append("\nshort\n", 7);
+
+	QByteArray line;
+	ASSERT_TRUE(buffer.takeLine(line));
+	EXPECT_EQ(longLine, line);
+	ASSERT_TRUE(buffer.takeLine(line));
+	EXPECT_EQ(QByteArray("short"), line);
+	EXPECT_GE(buffer.capacity(), 1007);
+}
+
+TEST_F(LineBufferTest, writeRegionTest)
+{
+	LineBuffer buffer(16);
+	const char data[] = "color: 1 2 3 4 5 6 7 8 9\nsound: 1 2 3\n";
+	const int dataSize = sizeof(data) - 1;
+
+	// Simulating reads from a file descriptor directly into buffer, by short chunks.
+	int written = 0;
+	while (written < dataSize) {
+		int free = 0;
+		char * const region = buffer.writeRegion(free);
+		ASSERT_GT(free, 0);
+		const int chunk = qMin(qMin(free, 5), dataSize - written);
+		memcpy(region, data + written, chunk);
+		buffer.commitWrite(chunk);
+		written += chunk;
+	}
+
+	QByteArray line;
+	ASSERT_TRUE(buffer.takeLine(line));
+	EXPECT_EQ(QByteArray("color: 1 2 3 4 5 6 7 8 9"), line);
+	ASSERT_TRUE(buffer.takeLine(line));
+	EXPECT_EQ(QByteArray("sound: 1 2 3"), line);
+	EXPECT_FALSE(buffer.takeLine(line));
+}
+
+TEST_F(LineBufferTest, throughputTest)
+{
+	const QByteArray sensorLine("color: 16711680 65280 255 16711680 65280 255 16711680 65280 255\n");
+	const int chunkSize = 4000;
+	const int chunks = 16000;
+	const int totalSize = chunkSize * chunks;
+
+	// Stream of lines cut into chunks at arbitrary positions, as it comes from FIFO.
+	QByteArray stream;
+	while (stream.size() < chunkSize + sensorLine.size()) {
+		stream.append(sensorLine.constData(), sensorLine.size());
+	}
+
+	LineBuffer buffer;
+	QByteArray line;
+	int lines = 0;
+	QElapsedTimer timer;
+	timer.start();
+	for (int processed = 0; processed < totalSize; processed += chunkSize) {
+		buffer.append(stream.constData() + processed % sensorLine.size(), chunkSize);
+		while (buffer.takeLine(line)) {
+			++lines;
+		}
+	}
+
+	const qint64 elapsed = qMax(timer.elapsed(), static_cast<qint64>(1));
+	EXPECT_EQ(totalSize / sensorLine.size(), lines);
+	RecordProperty("MBytesPerSecond", static_cast<int>(totalSize / 1024 / 1024 * 1000 / elapsed));
+	RecordProperty("linesPerSecond", static_cast<int>(lines * 1000 / elapsed));
+}
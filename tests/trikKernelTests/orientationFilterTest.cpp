@@ -0,0 +1,160 @@
+/* Copyright 2016 CyberTech Labs Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License. */
+
+#include <cmath>
+
+#include <QtCore/qmath.h>
+
+#include <trikKernel/orientationFilter.h>
+
+#include <gtest/gtest.h>
+
+using namespace trikKernel;
+
+namespace {
+
+/// Period of synthetic gyroscope stream, in nanoseconds (1 kHz).
+const qint64 period = 1000000;
+
+qreal degrees(qreal radians)
+{
+	return radians * 180 / M_PI;
+}
+
+qreal radians(qreal degrees)
+{
+	return degrees * M_PI / 180;
+}
+
+/// Feeds filter with "count" identical gyroscope readings in radians per second, one period apart.
+void feedGyroscope(OrientationFilter &filter, qint64 &time, int count, qreal x, qreal y, qreal z)
+{
+	for (int i = 0; i < count; ++i) {
+		time += period;
+		filter.updateGyroscope(Timestamp(time), x, y, z);
+	}
+}
+
+}
+
+TEST(orientationFilterTest, restTest)
+{
+	OrientationFilter filter;
+	qint64 time = 0;
+	filter.updateAccelerometer(0, 0, 4096);
+	feedGyroscope(filter, time, 5000, 0, 0, 0);
+
+	const OrientationFilter::Quaternion q = filter.orientation();
+	EXPECT_NEAR(1.0, q.w, 1e-9);
+	EXPECT_NEAR(0.0, q.x, 1e-9);
+	EXPECT_NEAR(0.0, q.y, 1e-9);
+	EXPECT_NEAR(0.0, q.z, 1e-9);
+}
+
+TEST(orientationFilterTest, yawIntegrationTest)
+{
+	OrientationFilter filter;
+	qint64 time = 0;
+	filter.updateAccelerometer(0, 0, 1);
+
+	// 45 degrees per second around vertical axis for two seconds.
+	feedGyroscope(filter, time, 2001, 0, 0, radians(45));
+	EXPECT_NEAR(90.0, degrees(filter.eulerAngles().yaw), 0.1);
+	EXPECT_NEAR(0.0, degrees(filter.eulerAngles().roll), 0.1);
+	EXPECT_NEAR(0.0, degrees(filter.eulerAngles().pitch), 0.1);
+
+	filter.resetHeading();
+	EXPECT_NEAR(0.0, degrees(filter.heading()), 1e-9);
+
+	// Another 135 degrees, heading wraps over 180 relative to new zero.
+	feedGyroscope(filter, time, 5000, 0, 0, radians(-45));
+	EXPECT_NEAR(135.0, degrees(filter.heading()), 0.1);
+}
+
+TEST(orientationFilterTest, tiltConvergenceTest)
+{
+	OrientationFilter filter(0.1);
+	qint64 time = 0;
+
+	// Board is rolled by 30 degrees, but filter starts level, so it shall converge to accelerometer.
+	filter.updateAccelerometer(0, std::sin(radians(30)), std::cos(radians(30)));
+	feedGyroscope(filter, time, 10000, 0, 0, 0);
+	EXPECT_NEAR(30.0, degrees(filter.eulerAngles().roll), 0.5);
+	EXPECT_NEAR(0.0, degrees(filter.eulerAngles().pitch), 0.5);
+
+	// Pitched by 20 degrees, nose up.
+	filter.updateAccelerometer(-std::sin(radians(20)), 0, std::cos(radians(20)));
+	feedGyroscope(filter, time, 10000, 0, 0, 0);
+	EXPECT_NEAR(0.0, degrees(filter.eulerAngles().roll), 0.5);
+	EXPECT_NEAR(20.0, degrees(filter.eulerAngles().pitch), 0.5);
+
+	// Reset levels orientation immediately.
+	filter.updateAccelerometer(0, std::sin(radians(-45)), std::cos(radians(-45)));
+	filter.reset();
+	EXPECT_NEAR(-45.0, degrees(filter.eulerAngles().roll), 1e-6);
+	EXPECT_NEAR(0.0, degrees(filter.eulerAngles().pitch), 1e-6);
+	EXPECT_NEAR(0.0, degrees(filter.eulerAngles().yaw), 1e-6);
+}
+
+TEST(orientationFilterTest, biasCalibrationTest)
+{
+	const qreal bias[3] = {radians(0.5), radians(-1.0), radians(2.0)};
+
+	OrientationFilter uncalibrated;
+	OrientationFilter calibrated;
+	qint64 time = 0;
+	uncalibrated.updateAccelerometer(0, 0, 1);
+	calibrated.updateAccelerometer(0, 0, 1);
+
+	calibrated.startCalibration();
+	EXPECT_TRUE(calibrated.isCalibrating());
+	qint64 calibrationTime = 0;
+	feedGyroscope(calibrated, calibrationTime, 1000, bias[0], bias[1], bias[2]);
+	EXPECT_TRUE(calibrated.finishCalibration());
+	EXPECT_FALSE(calibrated.isCalibrating());
+	for (int axis = 0; axis < 3; ++axis) {
+		EXPECT_NEAR(bias[axis], calibrated.bias(axis), 1e-12);
+	}
+
+	// Ten seconds at rest with biased gyroscope.
+	for (int i = 0; i < 10000; ++i) {
+		time += period;
+		uncalibrated.updateGyroscope(Timestamp(time), bias[0], bias[1], bias[2]);
+		calibrated.updateGyroscope(Timestamp(calibrationTime + time), bias[0], bias[1], bias[2]);
+	}
+
+	EXPECT_NEAR(20.0, degrees(uncalibrated.heading()), 0.5);
+	EXPECT_NEAR(0.0, degrees(calibrated.heading()), 1e-6);
+	EXPECT_NEAR(0.0, degrees(calibrated.eulerAngles().roll), 1e-6);
+	EXPECT_NEAR(0.0, degrees(calibrated.eulerAngles().pitch), 1e-6);
+
+	// Calibration without readings keeps previous bias.
+	calibrated.startCalibration();
+	EXPECT_FALSE(calibrated.finishCalibration());
+	EXPECT_NEAR(bias[2], calibrated.bias(2), 1e-12);
+}
+
+TEST(orientationFilterTest, pauseTest)
+{
+	OrientationFilter filter;
+	filter.updateAccelerometer(0, 0, 1);
+
+	// Readings separated by more than a second are not integrated, rotation during pause is unknown.
+	filter.updateGyroscope(Timestamp(0), 0, 0, 1);
+	filter.updateGyroscope(Timestamp(2000000000), 0, 0, 1);
+	EXPECT_NEAR(0.0, filter.eulerAngles().yaw, 1e-9);
+
+	filter.updateGyroscope(Timestamp(2100000000), 0, 0, 1);
+	EXPECT_NEAR(0.1, filter.eulerAngles().yaw, 1e-3);
+}
@@ -0,0 +1,111 @@
+/* Copyright 2016 CyberTech Labs Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License. */
+
+#include <trikKernel/sampleHistory.h>
+
+#include <gtest/gtest.h>
+
+using namespace trikKernel;
+
+namespace {
+
+/// Fills one-dimensional history with given values, one millisecond apart.
+void fill(SampleHistory &history, const QVector<int> &values)
+{
+	for (const int value : values) {
+		const QVector<Timestamp> last = history.times(1);
+		const qint64 time = last.isEmpty() ? 0 : last.first().toNsec();
+		history.append(Timestamp(time + 1000000), value);
+	}
+}
+
+}
+
+TEST(sampleHistoryTest, emptyTest)
+{
+	const SampleHistory history(4);
+	EXPECT_EQ(0, history.size());
+	EXPECT_TRUE(history.values(10).isEmpty());
+	EXPECT_EQ(0, history.median(3));
+	EXPECT_EQ(0.0, history.average(3));
+	EXPECT_EQ(0, history.minimum(3));
+	EXPECT_EQ(0, history.maximum(3));
+	EXPECT_EQ(0.0, history.exponential(0.5));
+}
+
+TEST(sampleHistoryTest, wrapAroundTest)
+{
+	SampleHistory history(4);
+	fill(history, {1, 2, 3, 4, 5, 6});
+
+	EXPECT_EQ(4, history.size());
+	EXPECT_EQ(QVector<int>({3, 4, 5, 6}), history.values(10));
+	EXPECT_EQ(QVector<int>({5, 6}), history.values(2));
+
+	const QVector<Timestamp> times = history.times(2);
+	ASSERT_EQ(2, times.size());
+	EXPECT_TRUE(times[0] < times[1]);
+}
+
+TEST(sampleHistoryTest, filtersTest)
+{
+	SampleHistory history(8);
+	fill(history, {10, 100, 12, 11, -50, 13});
+
+	// Median drops spikes in both directions.
+	EXPECT_EQ(12, history.median(5));
+	EXPECT_EQ(13, history.median(2));
+	EXPECT_DOUBLE_EQ(-18.5, history.average(2));
+	EXPECT_DOUBLE_EQ(16.0, history.average(6));
+	EXPECT_EQ(-50, history.minimum(6));
+	EXPECT_EQ(13, history.minimum(1));
+	EXPECT_EQ(100, history.maximum(6));
+	EXPECT_EQ(13, history.maximum(2));
+}
+
+TEST(sampleHistoryTest, exponentialTest)
+{
+	SampleHistory history(8);
+	fill(history, {0, 10, 10});
+
+	EXPECT_DOUBLE_EQ(10.0, history.exponential(1.0));
+	EXPECT_DOUBLE_EQ(7.5, history.exponential(0.5));
+	EXPECT_DOUBLE_EQ(0.0, history.exponential(0.0));
+}
+
+TEST(sampleHistoryTest, multidimensionalTest)
+{
+	SampleHistory history(3, 3);
+	const int first[] = {1, 2, 3};
+	const int second[] = {4, 5, 6};
+	history.append(Timestamp(1), first);
+	history.append(Timestamp(2), second);
+
+	EXPECT_EQ(QVector<int>({1, 2, 3, 4, 5, 6}), history.values(2));
+	EXPECT_DOUBLE_EQ(2.5, history.average(2, 0));
+	EXPECT_EQ(6, history.maximum(2, 2));
+	EXPECT_EQ(0, history.maximum(2, 3));
+}
+
+TEST(sampleHistoryTest, scalarIntoMultidimensionalTest)
+{
+	SampleHistory history(2, 3);
+	const int reading[] = {1, 2, 3};
+	history.append(Timestamp(1), reading);
+	history.append(Timestamp(2), 7);
+	history.append(Timestamp(3), 8);
+
+	// Scalar reading goes to the first axis, other axes are zeroed, not left from the overwritten reading.
+	EXPECT_EQ(QVector<int>({7, 0, 0, 8, 0, 0}), history.values(2));
+}
@@ -0,0 +1,214 @@
+/* Copyright 2016 CyberTech Labs Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License. */
+
+#include "seqLockTest.h"
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include <QtCore/QElapsedTimer>
+
+#include <trikKernel/seqLock.h>
+#include <trikKernel/synchronizedVar.h>
+
+using namespace tests;
+using namespace trikKernel;
+
+namespace {
+
+/// Sensor-like reading, all fields of a consistent reading are derived from "sequence".
+struct Reading
+{
+	int sequence;
+	int x;
+	int y;
+	int z;
+	qint64 timestamp;
+};
+
+Reading makeReading(int sequence)
+{
+	return {sequence, sequence * 2, -sequence, sequence ^ 0x5555, static_cast<qint64>(sequence) * 1000};
+}
+
+bool isConsistent(const Reading &reading)
+{
+	const Reading expected = makeReading(reading.sequence);
+	return reading.x == expected.x && reading.y == expected.y && reading.z == expected.z
+			&& reading.timestamp == expected.timestamp;
+}
+
+const int readerCount = 4;
+const int benchmarkDuration = 200;
+
+/// Pause between writes in microseconds, about the rate of IMU events.
+const int writerPeriod = 1000;
+
+/// Runs one writer updating a value every "writerPeriod" microseconds and several readers polling it for
+/// "benchmarkDuration" milliseconds, returns total number of reads done.
+template<typename Set, typename Get>
+quint64 runContention(const Set &set, const Get &get)
+{
+	std::atomic<bool> stop(false);
+	std::atomic<quint64> reads(0);
+	std::vector<std::thread> readers;
+	for (int i = 0; i < readerCount; ++i) {
+		readers.emplace_back([&]() {
+			quint64 count = 0;
+			while (!stop) {
+				get();
+				++count;
+			}
+
+			reads += count;
+		});
+	}
+
+	std::thread writer([&]() {
+		int sequence = 0;
+		while (!stop) {
+			set(makeReading(++sequence));
+			std::this_thread::sleep_for(std::chrono::microseconds(writerPeriod));
+		}
+	});
+
+	QElapsedTimer timer;
+	timer.start();
+	while (timer.elapsed() < benchmarkDuration) {
+		std::this_thread::yield();
+	}
+
+	stop = true;
+	writer.join();
+	for (std::thread &reader : readers) {
+		reader.join();
+	}
+
+	return reads;
+}
+
+}
+
+TEST_F(SeqLockTest, setGetTest)
+{
+	SeqLock<Reading> lock;
+	EXPECT_EQ(0, lock.get().sequence);
+	EXPECT_EQ(0u, lock.version());
+
+	lock.set(makeReading(10));
+	EXPECT_EQ(10, lock.get().sequence);
+	EXPECT_TRUE(isConsistent(lock.get()));
+	EXPECT_EQ(1u, lock.version());
+
+	lock.set(makeReading(20));
+	EXPECT_EQ(20, lock.get().sequence);
+	EXPECT_EQ(2u, lock.version());
+}
+
+TEST_F(SeqLockTest, oddSizeTest)
+{
+	// Size is not a multiple of a word, tail shall survive copying.
+	struct Bytes
+	{
+		char data[7];
+	};
+
+	SeqLock<Bytes> lock(Bytes{{1, 2, 3, 4, 5, 6, 7}});
+	EXPECT_EQ(7, lock.get().data[6]);
+	lock.set(Bytes{{7, 6, 5, 4, 3, 2, 1}});
+	EXPECT_EQ(7, lock.get().data[0]);
+	EXPECT_EQ(1, lock.get().data[6]);
+}
+
+TEST_F(SeqLockTest, stressTest)
+{
+	SeqLock<Reading> lock(makeReading(0));
+	std::atomic<bool> stop(false);
+	std::atomic<int> torn(0);
+	std::atomic<int> wentBack(0);
+
+	std::vector<std::thread> readers;
+	for (int i = 0; i < readerCount; ++i) {
+		readers.emplace_back([&]() {
+			int last = 0;
+			while (!stop) {
+				const Reading reading = lock.get();
+				if (!isConsistent(reading)) {
+					++torn;
+				}
+
+				if (reading.sequence < last) {
+					++wentBack;
+				}
+
+				last = reading.sequence;
+			}
+		});
+	}
+
+	const int writes = 1000000;
+	for (int i = 1; i <= writes; ++i) {
+		lock.set(makeReading(i));
+	}
+
+	stop = true;
+	for (std::thread &reader : readers) {
+		reader.join();
+	}
+
+	EXPECT_EQ(0, torn);
+	EXPECT_EQ(0, wentBack);
+	EXPECT_EQ(writes, lock.get().sequence);
+	EXPECT_EQ(static_cast<quint32>(writes), lock.version());
+}
+
+TEST_F(SeqLockTest, contentionBenchmark)
+{
+	SeqLock<Reading> lock(makeReading(0));
+	std::atomic<int> tornSeqLock(0);
+	const quint64 seqLockReads = runContention(
+			[&lock](const Reading &reading) { lock.set(reading); }
+			, [&lock, &tornSeqLock]() {
+				if (!isConsistent(lock.get())) {
+					++tornSeqLock;
+				}
+			});
+
+	SynchronizedVar<Reading> var;
+	*var.operator->() = makeReading(0);
+	var.sync();
+	std::atomic<int> tornVar(0);
+	const quint64 synchronizedVarReads = runContention(
+			[&var](const Reading &reading) {
+				// Writes the whole buffer, as sensor workers do.
+				*var.operator->() = reading;
+				var.sync();
+			}
+			, [&var, &tornVar]() {
+				if (!isConsistent(var.get())) {
+					++tornVar;
+				}
+			});
+
+	std::cout << "[          ] Reads in " << benchmarkDuration << " ms by " << readerCount
+			<< " readers, writer at 1 kHz: SeqLock " << seqLockReads
+			<< ", SynchronizedVar " << synchronizedVarReads << std::endl;
+
+	EXPECT_EQ(0, tornSeqLock);
+	EXPECT_EQ(0, tornVar);
+	EXPECT_GT(seqLockReads, 0u);
+}
@@ -0,0 +1,56 @@
+/* Copyright 2016 CyberTech Labs Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License. */
+
+
+#include <trikKernel/timestamp.h>
+#include <trikKernel/timeVal.h>
+
+#include <gtest/gtest.h>
+
+using namespace trikKernel;
+
+TEST(timestampTest, monotonicityTest)
+{
+	Timestamp previous = Timestamp::now();
+	for (int i = 0; i < 1000; ++i) {
+		const Timestamp current = Timestamp::now();
+		ASSERT_FALSE(current < previous);
+		previous = current;
+	}
+}
+
+TEST(timestampTest, conversionTest)
+{
+	const Timestamp timestamp = Timestamp::fromTimeval(3600, 250000);
+	ASSERT_EQ(3600250000000LL, timestamp.toNsec());
+	ASSERT_EQ(3600250000LL, timestamp.toMcSec());
+	ASSERT_EQ(Timestamp(3600250000000LL), timestamp);
+}
+
+TEST(timestampTest, noWrapTest)
+{
+	// Legacy TimeVal wraps after a few minutes, timestamp shall not.
+	const Timestamp start = Timestamp::fromTimeval(1000000, 0);
+	const Timestamp end = Timestamp::fromTimeval(1000600, 500);
+	ASSERT_EQ(600000500LL, (end - start).toMcSec());
+}
+
+TEST(timestampTest, timeValShimTest)
+{
+	const Timestamp start = Timestamp::fromTimeval(10, 0);
+	const Timestamp end = Timestamp::fromTimeval(10, 512000);
+
+	// TimeVal has 256 microseconds resolution.
+	ASSERT_EQ(512000, (end.toTimeVal() - start.toTimeVal()).toMcSec());
+}
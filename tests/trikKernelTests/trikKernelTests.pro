@@ -17,10 +17,17 @@ include(../../global.pri)
 include(../common.pri)
 
 HEADERS += \
+	$$PWD/lineBufferTest.h \
+	$$PWD/seqLockTest.h \
 	$$PWD/synchronizedVarTest.h \
 
 SOURCES += \
+	$$PWD/lineBufferTest.cpp \
+	$$PWD/orientationFilterTest.cpp \
+	$$PWD/sampleHistoryTest.cpp \
+	$$PWD/seqLockTest.cpp \
 	$$PWD/synchronizedVarTest.cpp \
+	$$PWD/timestampTest.cpp \
 	$$PWD/differentOwnedPointerTest.cpp \
 
 implementationIncludes(trikKernel)
@@ -27,12 +27,22 @@ class TRIKCONTROL_EXPORT BatteryInterface : public QObject, public DeviceInterfa
 {
 	Q_OBJECT
 
+signals:
+	/// Emitted when reading requested by readAsync() is ready.
+	/// @param requestId - id of a request returned by readAsync().
+	/// @param voltage - battery voltage in volts, as returned by readVoltage().
+	void readFinished(int requestId, float voltage);
+
 public slots:
 	/// Returns current battery voltage in volts.
 	virtual float readVoltage() = 0;
 
 	/// Returns current raw reading of battery.
 	virtual float readRawDataVoltage() = 0;
+
+	/// Requests battery voltage without waiting for MSP bus, result is reported by readFinished() signal.
+	/// Returns id of a request.
+	virtual int readAsync() = 0;
 };
 
 }
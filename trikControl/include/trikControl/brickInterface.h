@@ -15,6 +15,7 @@
 #pragma once
 
 #include <QtCore/QStringList>
+#include <QtCore/QVariantMap>
 
 #include "batteryInterface.h"
 #include "colorSensorInterface.h"
@@ -25,8 +26,10 @@
 #include "keysInterface.h"
 #include "ledInterface.h"
 #include "lineSensorInterface.h"
+#include "motorGroupInterface.h"
 #include "motorInterface.h"
 #include "objectSensorInterface.h"
+#include "orientationInterface.h"
 #include "pwmCaptureInterface.h"
 #include "sensorInterface.h"
 #include "soundSensorInterface.h"
@@ -53,6 +56,10 @@ public:
 	/// Returns version of system configuration file.
 	virtual QString configVersion() const = 0;
 
+	/// Executes given sh command on a robot without forking runtime process.
+	/// @param synchronously - if true, waits for command to finish.
+	virtual void system(const QString &command, bool synchronously) = 0;
+
 public slots:
 	/// Configures given device on given port. Port must be listed in model-config.xml, device shall be listed
 	/// in system-config.xml, and device shall be able to be configured on a port (it is also described
@@ -77,6 +84,11 @@ public slots:
 	/// Returns reference to motor of a given type on a given port
 	virtual MotorInterface *motor(const QString &port) = 0;
 
+	/// Returns group of power motors on given ports that are updated together in one bus transaction. Group is
+	/// created on first request and then reused, it is destroyed when one of its motors is reconfigured. Returns
+	/// nullptr if some port does not have power motor on it or is listed twice. Ownership retained by brick.
+	virtual MotorGroupInterface *motorGroup(const QStringList &ports) = 0;
+
 	/// Returns reference to PWM signal capture device on a given port.
 	virtual PwmCaptureInterface *pwmCapture(const QString &port) = 0;
 
@@ -101,6 +113,10 @@ public slots:
 	/// Returns on-board gyroscope.
 	virtual VectorSensorInterface *gyroscope() = 0;
 
+	/// Returns orientation of a brick estimated from accelerometer and gyroscope, or nullptr if orientation
+	/// estimation is disabled in config or one of these sensors is not available.
+	virtual OrientationInterface *orientation() = 0;
+
 	/// Returns high-level line detector sensor using camera on given port (video0 or video1).
 	virtual LineSensorInterface *lineSensor(const QString &port) = 0;
 
@@ -143,6 +159,11 @@ signals:
 	/// Emitted when all deferred deinitialization is completed and brick completely stopped. Note that if there is no
 	/// deferred deinitialization (no video sensors are on, for example), signal will NOT be emitted.
 	void stopped();
+
+	/// Emitted once after brick construction when all devices are brought up.
+	/// @param initializationTimes - maps port or device name (and also "initScripts", "mspBus" and "total" for
+	///        corresponding initialization stages) to time spent on its initialization, in milliseconds.
+	void ready(const QVariantMap &initializationTimes);
 };
 
 }
@@ -17,6 +17,7 @@
 #include <QtCore/QObject>
 
 #include "deviceInterface.h"
+#include "historyInterface.h"
 
 #include "declSpec.h"
 
@@ -27,6 +28,12 @@ class TRIKCONTROL_EXPORT EncoderInterface : public QObject, public DeviceInterfa
 {
 	Q_OBJECT
 
+signals:
+	/// Emitted when reading requested by readAsync() is ready.
+	/// @param requestId - id of a request returned by readAsync().
+	/// @param value - encoder reading in degrees, as returned by read().
+	void readFinished(int requestId, int value);
+
 public slots:
 	/// Returns current encoder reading (in degrees).
 	virtual int read() = 0;
@@ -34,8 +41,16 @@ public slots:
 	/// Returns current raw reading of encoder.
 	virtual int readRawData() = 0;
 
+	/// Requests encoder reading without waiting for MSP bus, result is reported by readFinished() signal.
+	/// Returns id of a request.
+	virtual int readAsync() = 0;
+
 	/// Resets encoder by setting current reading to 0.
 	virtual void reset() = 0;
+
+	/// Returns history of latest readings in degrees with filters over it, or nullptr if history is not enabled for
+	/// this encoder by "historySize" attribute in config. Ownership retained by encoder.
+	virtual HistoryInterface *history() = 0;
 };
 
 }
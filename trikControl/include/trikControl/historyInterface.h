@@ -0,0 +1,68 @@
+/* Copyright 2016 CyberTech Labs Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License. */
+
+#pragma once
+
+#include <QtCore/QObject>
+#include <QtCore/QVector>
+
+#include "declSpec.h"
+
+namespace trikControl {
+
+/// Fixed-size history of latest timestamped readings of a sensor, with filters over it. Readings are recorded by
+/// the sensor itself, so filters do not depend on how often a script polls the sensor. Multi-axis sensors record
+/// all axes of a reading, filters take an axis as a parameter.
+class TRIKCONTROL_EXPORT HistoryInterface : public QObject
+{
+	Q_OBJECT
+
+public slots:
+	/// Returns number of readings in history.
+	virtual int size() const = 0;
+
+	/// Returns maximal number of readings kept in history.
+	virtual int capacity() const = 0;
+
+	/// Returns number of values (axes) in one reading.
+	virtual int dimensions() const = 0;
+
+	/// Returns up to "count" latest readings, oldest first. Values of a multi-axis reading go one after another.
+	virtual QVector<int> values(int count) const = 0;
+
+	/// Returns times of up to "count" latest readings, oldest first, in microseconds relative to the latest one (so
+	/// the last time is always 0). Readings older than about 35 minutes do not fit into int, their time is clamped
+	/// to the minimal int value.
+	virtual QVector<int> times(int count) const = 0;
+
+	/// Returns median of up to "window" latest readings, suppresses spikes.
+	virtual int median(int window, int axis = 0) const = 0;
+
+	/// Returns moving average of up to "window" latest readings.
+	virtual qreal average(int window, int axis = 0) const = 0;
+
+	/// Returns exponentially smoothed reading over whole history, "alpha" in (0; 1] is a weight of a new reading.
+	virtual qreal exponential(qreal alpha, int axis = 0) const = 0;
+
+	/// Returns minimal value among up to "window" latest readings.
+	virtual int minimum(int window, int axis = 0) const = 0;
+
+	/// Returns maximal value among up to "window" latest readings.
+	virtual int maximum(int window, int axis = 0) const = 0;
+
+	/// Drops all readings.
+	virtual void clear() = 0;
+};
+
+}
@@ -0,0 +1,54 @@
+/* Copyright 2016 CyberTech Labs Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License. */
+
+
+#pragma once
+
+#include <QtCore/QObject>
+#include <QtCore/QStringList>
+#include <QtCore/QVector>
+
+#include "deviceInterface.h"
+
+#include "declSpec.h"
+
+namespace trikControl {
+
+/// Group of power motors that are updated together, in one bus transaction, for example, wheels of a differential
+/// drive. Powers are linearised by each motor according to its own config. Writes that would not change anything
+/// since last write to a motor are not sent at all.
+class TRIKCONTROL_EXPORT MotorGroupInterface : public QObject, public DeviceInterface
+{
+	Q_OBJECT
+
+public slots:
+	/// Returns ports of motors in a group, in the order in which powers are passed and returned.
+	virtual QStringList ports() const = 0;
+
+	/// Sets powers of all motors in a group at once.
+	/// @param powers - power of each motor from -100 to 100, in the order of ports(), values out of range are
+	///        constrained. Shall have exactly one value per motor, otherwise nothing is sent.
+	virtual void setPower(const QVector<int> &powers) = 0;
+
+	/// Returns currently set powers of motors, in the order of ports().
+	virtual QVector<int> power() const = 0;
+
+	/// Sets PWM period of all motors in a group at once.
+	virtual void setPeriod(int period) = 0;
+
+	/// Turns off all motors in a group. Unlike setPower(), always writes to all motors.
+	virtual void powerOff() = 0;
+};
+
+}
@@ -0,0 +1,62 @@
+/* Copyright 2016 CyberTech Labs Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License. */
+
+
+#pragma once
+
+#include <QtCore/QObject>
+#include <QtCore/QVector>
+
+#include "deviceInterface.h"
+
+#include "declSpec.h"
+
+namespace trikControl {
+
+/// Orientation of a brick estimated natively from on-board gyroscope and accelerometer. Estimate is updated on every
+/// gyroscope reading, so scripts only read the result. Accelerometer corrects roll and pitch, heading is integrated
+/// from gyroscope only, so gyroscope shall be calibrated at rest to keep heading drift low.
+class TRIKCONTROL_EXPORT OrientationInterface : public QObject, public DeviceInterface
+{
+	Q_OBJECT
+
+signals:
+	/// Emitted when gyroscope bias calibration started by calibrate() is finished.
+	/// @param success - false if there were no gyroscope readings during calibration, previous bias is kept then.
+	void calibrationFinished(bool success);
+
+public slots:
+	/// Returns orientation as a unit quaternion, in (w, x, y, z) order.
+	virtual QVector<qreal> quaternion() const = 0;
+
+	/// Returns orientation as (roll, pitch, yaw) angles in degrees.
+	virtual QVector<qreal> eulerAngles() const = 0;
+
+	/// Returns heading in degrees from -180 to 180, relative to heading at last calibration or resetHeading() call.
+	/// Positive direction is counterclockwise when viewed from above.
+	virtual qreal heading() const = 0;
+
+	/// Makes current heading zero.
+	virtual void resetHeading() = 0;
+
+	/// Starts gyroscope bias calibration. Brick shall stay still for given time, then bias is updated, orientation
+	/// is leveled by accelerometer, heading is reset and "calibrationFinished" is emitted.
+	/// @param msec - calibration duration in milliseconds.
+	virtual void calibrate(int msec) = 0;
+
+	/// Returns true if gyroscope calibration is in progress.
+	virtual bool isCalibrating() const = 0;
+};
+
+}
@@ -17,6 +17,7 @@
 #include <QtCore/QObject>
 
 #include "deviceInterface.h"
+#include "historyInterface.h"
 
 #include "declSpec.h"
 
@@ -46,6 +47,10 @@ public slots:
 
 	/// Returns current raw reading of a sensor.
 	virtual int readRawData() = 0;
+
+	/// Returns history of latest readings (as returned by read()) with filters over it, or nullptr if history is not
+	/// enabled for this sensor by "historySize" attribute in config. Ownership retained by sensor.
+	virtual HistoryInterface *history() = 0;
 };
 
 }
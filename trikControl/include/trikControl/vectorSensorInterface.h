@@ -18,11 +18,12 @@
 #include <QtCore/QVector>
 
 #include "deviceInterface.h"
+#include "historyInterface.h"
 
 #include "declSpec.h"
 
 namespace trikKernel {
-class TimeVal;
+class Timestamp;
 }
 
 namespace trikControl {
@@ -34,11 +35,17 @@ class TRIKCONTROL_EXPORT VectorSensorInterface : public QObject, public DeviceIn
 
 signals:
 	/// Emitted when new sensor reading is ready.
-	void newData(QVector<int> reading, const trikKernel::TimeVal &eventTime);
+	/// @param reading - new sensor reading.
+	/// @param eventTime - time of a reading by monotonic clock, with nanosecond resolution.
+	void newData(QVector<int> reading, const trikKernel::Timestamp &eventTime);
 
 public slots:
 	/// Returns current raw reading of a sensor.
 	virtual QVector<int> read() const = 0;
+
+	/// Returns history of latest readings with filters over it, one axis per dimension, or nullptr if history is not
+	/// enabled for this sensor by "historySize" attribute in config. Ownership retained by sensor.
+	virtual HistoryInterface *history() = 0;
 };
 
 }
@@ -86,9 +86,10 @@ void AbstractVirtualSensorWorker::init()
 	mState.ready();
 }
 
-void AbstractVirtualSensorWorker::onNewDataInOutputFifo(const QString &data)
+void AbstractVirtualSensorWorker::onNewDataInOutputFifo(const QByteArray &line)
 {
-	onNewData(data);
+	// Sensor output is plain ASCII, so the cheapest conversion is enough.
+	onNewData(QString::fromLatin1(line));
 }
 
 bool AbstractVirtualSensorWorker::launchSensorScript(const QString &command)
@@ -126,7 +127,7 @@ void AbstractVirtualSensorWorker::openFifos()
 
 	QLOG_INFO() << "Opening" << mOutputFifo->fileName();
 
-	connect(mOutputFifo.data(), SIGNAL(newData(QString)), this, SLOT(onNewDataInOutputFifo(QString)));
+	connect(mOutputFifo.data(), SIGNAL(newLine(QByteArray)), this, SLOT(onNewDataInOutputFifo(QByteArray)));
 
 	if (!mOutputFifo->open()) {
 		mState.fail();
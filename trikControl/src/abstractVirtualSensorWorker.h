@@ -69,7 +69,7 @@ protected:
 
 private slots:
 	/// Updates current reading when new value is ready.
-	void onNewDataInOutputFifo(const QString &data);
+	void onNewDataInOutputFifo(const QByteArray &line);
 
 private:
 	/// Provides user-friendly name of a sensor used in debug output.
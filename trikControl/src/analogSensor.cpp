@@ -15,6 +15,8 @@
 #include "analogSensor.h"
 
 #include <trikKernel/configurer.h>
+#include <trikKernel/exceptions/malformedConfigException.h>
+#include <trikKernel/timestamp.h>
 #include <QsLog.h>
 
 #include "mspCommunicatorInterface.h"
@@ -23,7 +25,7 @@
 using namespace trikControl;
 
 AnalogSensor::AnalogSensor(const QString &port, const trikKernel::Configurer &configurer
-		, MspCommunicatorInterface &communicator)
+		, MspCommunicatorInterface &communicator, MspSensorSampler *sampler)
 	: mCommunicator(communicator)
 	, mState("Analog Sensor on" + port)
 {
@@ -47,6 +49,29 @@ AnalogSensor::AnalogSensor(const QString &port, const trikKernel::Configurer &co
 	}
 
 	mState.ready();
+
+	mHistory.reset(SensorHistory::createForPort(configurer, port));
+
+	if (sampler != nullptr && mState.isReady()) {
+		try {
+			const int period = configurer.attributeByPort(port, "samplingPeriod").toInt();
+			mSample = sampler->addSource(mCommunicator, readCommand(), period
+					, [this](const MspSensorSampler::Sample &sample) { record(sample.value, sample.timestamp); });
+			mSampler = sampler;
+		} catch (trikKernel::MalformedConfigException &) {
+			// Sampling period is not configured, sensor is read on request.
+		}
+	}
+}
+
+AnalogSensor::~AnalogSensor()
+{
+	// Reads queued on bus thread may complete while the device is being destroyed.
+	mAsyncReads.cancel();
+
+	if (mSampler != nullptr) {
+		mSampler->removeSource(mSample);
+	}
 }
 
 AnalogSensor::Status AnalogSensor::status() const
@@ -56,14 +81,7 @@ AnalogSensor::Status AnalogSensor::status() const
 
 int AnalogSensor::read()
 {
-	const auto raw = readRawData();
-	if (mIRType == Type::sharpGP2) {
-		const auto quotient = raw + mL;
-		const auto result = quotient != 0 ? mS / quotient + mN : 0;
-		return result;
-	}
-
-	return mK * raw + mB;
+	return normalize(readRawData());
 }
 
 int AnalogSensor::readRawData()
@@ -72,11 +90,66 @@ int AnalogSensor::readRawData()
 		return 0;
 	}
 
-	QByteArray command(2, '\0');
-	command[0] = static_cast<char>(mI2cCommandNumber & 0xFF);
-	command[1] = static_cast<char>((mI2cCommandNumber >> 8) & 0xFF);
+	if (mSample != nullptr && mSample->hasSample()) {
+		return mSample->latest().value;
+	}
+
+	const trikKernel::Timestamp time = trikKernel::Timestamp::now();
+	const int rawData = mCommunicator.read(readCommand());
+	record(rawData, time);
+	return rawData;
+}
+
+int AnalogSensor::readAsync()
+{
+	const int requestId = mLastRequestId.fetchAndAddOrdered(1) + 1;
+	const auto report = [this, requestId](int rawData) {
+		// Reported through event loop, so the result is never delivered before readAsync() returns.
+		QMetaObject::invokeMethod(this, "readFinished", Qt::QueuedConnection
+				, Q_ARG(int, requestId), Q_ARG(int, normalize(rawData)));
+	};
 
-	return mCommunicator.read(command);
+	if (!mState.isReady() || mCommunicator.status() != DeviceInterface::Status::ready) {
+		report(0);
+	} else if (mSample != nullptr && mSample->hasSample()) {
+		report(mSample->latest().value);
+	} else {
+		const trikKernel::Timestamp time = trikKernel::Timestamp::now();
+		mCommunicator.readAsync(readCommand(), mAsyncReads.guard([this, time, report](int rawData) {
+			record(rawData, time);
+			report(rawData);
+		}));
+	}
+
+	return requestId;
+}
+
+HistoryInterface *AnalogSensor::history()
+{
+	return mHistory.data();
+}
+
+trikHal::MspCommand AnalogSensor::readCommand() const
+{
+	return trikHal::MspCommand::readWord(mI2cCommandNumber);
+}
+
+int AnalogSensor::normalize(int rawData) const
+{
+	if (mIRType == Type::sharpGP2) {
+		const auto quotient = rawData + mL;
+		const auto result = quotient != 0 ? mS / quotient + mN : 0;
+		return result;
+	}
+
+	return mK * rawData + mB;
+}
+
+void AnalogSensor::record(int rawData, const trikKernel::Timestamp &time)
+{
+	if (mHistory) {
+		mHistory->samples().append(time, normalize(rawData));
+	}
 }
 
 void AnalogSensor::calculateLNS(const QString &port, const trikKernel::Configurer &configurer)
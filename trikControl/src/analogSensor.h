@@ -15,15 +15,23 @@
 #pragma once
 
 #include <QtCore/QObject>
+#include <QtCore/QAtomicInt>
 #include <QtCore/QString>
 
 #include "sensorInterface.h"
+#include "asyncReadOwner.h"
 #include "deviceState.h"
+#include "mspSensorSampler.h"
+#include "sensorHistory.h"
 
 namespace trikKernel {
 class Configurer;
 }
 
+namespace trikHal {
+class MspCommand;
+}
+
 namespace trikControl {
 
 class MspCommunicatorInterface;
@@ -38,7 +46,12 @@ public:
 	/// @param port - port on which this sensor is configured.
 	/// @param configurer - configurer object containing preparsed XML files with sensor parameters.
 	/// @param communicator - I2C communicator used to query sensor.
-	AnalogSensor(const QString &port, const trikKernel::Configurer &configurer, MspCommunicatorInterface &communicator);
+	/// @param sampler - sampler that polls the sensor in background if its port has "samplingPeriod" configured,
+	///        or nullptr to query the bus on every read.
+	AnalogSensor(const QString &port, const trikKernel::Configurer &configurer, MspCommunicatorInterface &communicator
+			, MspSensorSampler *sampler = nullptr);
+
+	~AnalogSensor() override;
 
 	Status status() const override;
 
@@ -46,13 +59,25 @@ public:
 
 	int maxValue() const override;
 
+signals:
+	/// Emitted when reading requested by readAsync() is ready.
+	/// @param requestId - id of a request returned by readAsync().
+	/// @param value - sensor reading, as returned by read().
+	void readFinished(int requestId, int value);
+
 public slots:
 	/// Returns current reading of a sensor.
 	int read();
 
-	/// Returns current raw reading of a sensor.
+	/// Returns current raw reading of a sensor. If the sensor is sampled in background, returns latest sample.
 	int readRawData() override;
 
+	/// Requests sensor reading without waiting for MSP bus, result is reported by readFinished() signal.
+	/// Returns id of a request.
+	int readAsync();
+
+	HistoryInterface *history() override;
+
 private:
 	enum class Type
 	{
@@ -63,10 +88,26 @@ private:
 		, analog
 	};
 
+	/// Returns MSP command for reading the sensor.
+	trikHal::MspCommand readCommand() const;
+
+	/// Converts raw reading into normalized value.
+	int normalize(int rawData) const;
+
+	/// Records raw reading just received from the bus into history, if it is enabled.
+	void record(int rawData, const trikKernel::Timestamp &time);
+
 	void calculateLNS(const QString &port, const trikKernel::Configurer &configurer);
 	void calculateKB(const QString &port, const trikKernel::Configurer &configurer);
 
 	MspCommunicatorInterface &mCommunicator;
+
+	/// Sampler polling this sensor, or nullptr if the sensor is read on request.
+	MspSensorSampler *mSampler = nullptr;
+
+	/// Latest reading published by sampler. Owned by sampler.
+	MspSensorSampler::Source *mSample = nullptr;
+
 	int mI2cCommandNumber = 0;
 	Type mIRType;
 
@@ -96,6 +137,15 @@ private:
 
 	/// State of a device.
 	DeviceState mState;
+
+	/// Id of last asynchronous read request.
+	QAtomicInt mLastRequestId;
+
+	/// Cancels callbacks of asynchronous reads that are still queued when the device is destroyed.
+	AsyncReadOwner mAsyncReads;
+
+	/// History of normalized readings, null if disabled in config.
+	QScopedPointer<SensorHistory> mHistory;
 };
 
 }
@@ -0,0 +1,47 @@
+/* Copyright 2016 CyberTech Labs Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License. */
+
+#include "asyncReadOwner.h"
+
+#include <QtCore/QMutexLocker>
+
+using namespace trikControl;
+
+AsyncReadOwner::AsyncReadOwner()
+	: mState(new State())
+{
+}
+
+AsyncReadOwner::~AsyncReadOwner()
+{
+	cancel();
+}
+
+MspCommunicatorInterface::ReadCallback AsyncReadOwner::guard(
+		const MspCommunicatorInterface::ReadCallback &callback) const
+{
+	const QSharedPointer<State> state = mState;
+	return [state, callback](int value) {
+		QMutexLocker locker(&state->mutex);
+		if (!state->cancelled) {
+			callback(value);
+		}
+	};
+}
+
+void AsyncReadOwner::cancel()
+{
+	QMutexLocker locker(&mState->mutex);
+	mState->cancelled = true;
+}
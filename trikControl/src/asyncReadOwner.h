@@ -0,0 +1,56 @@
+/* Copyright 2016 CyberTech Labs Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License. */
+
+#pragma once
+
+#include <QtCore/QMutex>
+#include <QtCore/QSharedPointer>
+
+#include "mspCommunicatorInterface.h"
+
+namespace trikControl {
+
+/// Owner token of asynchronous MSP reads of a device. Read callbacks are wrapped by the token and do nothing after
+/// it is cancelled, so a device destroyed while its reads are still queued on bus thread is never touched by them.
+/// Thread-safe.
+class AsyncReadOwner
+{
+public:
+	AsyncReadOwner();
+
+	/// Cancels wrapped callbacks.
+	~AsyncReadOwner();
+
+	/// Returns callback that calls a given one only if the token is not cancelled yet.
+	MspCommunicatorInterface::ReadCallback guard(const MspCommunicatorInterface::ReadCallback &callback) const;
+
+	/// Cancels all wrapped callbacks, waits for a callback that is running now to return. Shall be called at the
+	/// beginning of device destructor, before any device data is destroyed.
+	void cancel();
+
+private:
+	/// State shared with wrapped callbacks, outlives the token while callbacks are queued.
+	struct State
+	{
+		/// Held while a callback runs.
+		QMutex mutex;
+
+		/// True if owner is being destroyed.
+		bool cancelled = false;
+	};
+
+	QSharedPointer<State> mState;
+};
+
+}
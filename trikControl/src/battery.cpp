@@ -18,30 +18,70 @@
 
 using namespace trikControl;
 
-Battery::Battery(MspCommunicatorInterface &communicator)
+/// Command reading battery voltage register, encoded at compile time.
+static constexpr trikHal::MspCommand readVoltageCommand = trikHal::MspCommand::readWord(0x26);
+
+/// Converts raw battery reading to volts.
+static float toVoltage(int parrot)
+{
+	/// @todo: Remove these arcane numbers, or Something may be unexpectedly summoned by them.
+	return (static_cast<float>(parrot) / 1023.0) * 3.3 * (7.15 + 2.37) / 2.37;
+}
+
+Battery::Battery(MspCommunicatorInterface &communicator, MspSensorSampler *sampler, int samplingPeriod)
 	: mCommunicator(communicator)
 {
+	if (sampler != nullptr) {
+		mSample = sampler->addSource(mCommunicator, readVoltageCommand, samplingPeriod);
+		mSampler = sampler;
+	}
 }
 
-float Battery::readVoltage()
+Battery::~Battery()
 {
-	QByteArray command(2, '\0');
-	command[0] = static_cast<char>(0x26);
-	command[1] = static_cast<char>(0x00);
+	// Reads queued on bus thread may complete while the device is being destroyed.
+	mAsyncReads.cancel();
 
-	const int parrot = mCommunicator.read(command);
+	if (mSampler != nullptr) {
+		mSampler->removeSource(mSample);
+	}
+}
 
-	/// @todo: Remove these arcane numbers, or Something may be unexpectedly summoned by them.
-	return (static_cast<float>(parrot) / 1023.0) * 3.3 * (7.15 + 2.37) / 2.37;
+float Battery::readVoltage()
+{
+	return toVoltage(readRaw());
 }
 
 float Battery::readRawDataVoltage()
 {
-	QByteArray command(2, '\0');
-	command[0] = static_cast<char>(0x26);
-	command[1] = static_cast<char>(0x00);
+	return readRaw();
+}
+
+int Battery::readAsync()
+{
+	const int requestId = mLastRequestId.fetchAndAddOrdered(1) + 1;
+	const auto report = [this, requestId](int parrot) {
+		// Reported through event loop, so the result is never delivered before readAsync() returns.
+		QMetaObject::invokeMethod(this, "readFinished", Qt::QueuedConnection
+				, Q_ARG(int, requestId), Q_ARG(float, toVoltage(parrot)));
+	};
+
+	if (mSample != nullptr && mSample->hasSample()) {
+		report(mSample->latest().value);
+	} else {
+		mCommunicator.readAsync(readVoltageCommand, mAsyncReads.guard(report));
+	}
+
+	return requestId;
+}
+
+int Battery::readRaw()
+{
+	if (mSample != nullptr && mSample->hasSample()) {
+		return mSample->latest().value;
+	}
 
-	return mCommunicator.read(command);
+	return mCommunicator.read(readVoltageCommand);
 }
 
 Battery::Status Battery::status() const
@@ -15,8 +15,11 @@
 #pragma once
 
 #include <QtCore/QObject>
+#include <QtCore/QAtomicInt>
 
 #include "batteryInterface.h"
+#include "asyncReadOwner.h"
+#include "mspSensorSampler.h"
 
 namespace trikControl {
 
@@ -30,7 +33,11 @@ class Battery : public BatteryInterface
 public:
 	/// Constructor.
 	/// @param communicator - I2C communicator to use to query battery status.
-	Battery(MspCommunicatorInterface &communicator);
+	/// @param sampler - sampler that polls battery in background, or nullptr to query the bus on every read.
+	/// @param samplingPeriod - sampling period in milliseconds, used if sampler is given.
+	Battery(MspCommunicatorInterface &communicator, MspSensorSampler *sampler = nullptr, int samplingPeriod = 0);
+
+	~Battery() override;
 
 	Status status() const override;
 
@@ -39,8 +46,25 @@ public slots:
 
 	float readRawDataVoltage() override;
 
+	int readAsync() override;
+
 private:
+	/// Returns raw reading, latest sample if battery is sampled in background.
+	int readRaw();
+
 	MspCommunicatorInterface &mCommunicator;
+
+	/// Sampler polling the battery, or nullptr if the battery is read on request.
+	MspSensorSampler *mSampler = nullptr;
+
+	/// Latest reading published by sampler. Owned by sampler.
+	MspSensorSampler::Source *mSample = nullptr;
+
+	/// Id of last asynchronous read request.
+	QAtomicInt mLastRequestId;
+
+	/// Cancels callbacks of asynchronous reads that are still queued when the device is destroyed.
+	AsyncReadOwner mAsyncReads;
 };
 
 }
@@ -20,11 +20,23 @@
 	#include <QtWidgets/QApplication>
 #endif
 
-#include <QtCore/QFileInfo>
+#include <exception>
+#include <functional>
 
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QFileInfo>
+#include <QtCore/QMutexLocker>
+#include <QtCore/QRunnable>
+#include <QtCore/QSemaphore>
+#include <QtCore/QThread>
+#include <QtCore/QThreadPool>
+
+#include <trikHal/eventFileInterface.h>
+#include <trikHal/fileIoBatchInterface.h>
 #include <trikHal/hardwareAbstractionInterface.h>
 #include <trikHal/hardwareAbstractionFactory.h>
 #include <trikKernel/exceptions/malformedConfigException.h>
+#include <trikKernel/timestamp.h>
 #include <trikKernel/timeVal.h>
 
 #include "analogSensor.h"
@@ -37,8 +49,10 @@
 #include "fifo.h"
 #include "keys.h"
 #include "led.h"
+#include "motorGroup.h"
 #include "lineSensor.h"
 #include "objectSensor.h"
+#include "orientation.h"
 #include "powerMotor.h"
 #include "pwmCapture.h"
 #include "rangeSensor.h"
@@ -48,6 +62,8 @@
 #include "vectorSensor.h"
 
 #include "mspBusAutoDetector.h"
+#include "mspBusScheduler.h"
+#include "mspSensorSampler.h"
 #include "moduleLoader.h"
 
 #include <QsLog.h>
@@ -56,6 +72,40 @@ using namespace trikControl;
 using namespace trikKernel;
 using namespace trikHal;
 
+namespace {
+
+/// Runs slow steps of device initialization on a thread pool. Exception thrown by a step is stored to be rethrown in
+/// brick thread.
+class DevicePreparation : public QRunnable
+{
+public:
+	DevicePreparation(const std::function<void()> &prepare, std::exception_ptr &error, QMutex &errorMutex)
+		: mPrepare(prepare)
+		, mError(error)
+		, mErrorMutex(errorMutex)
+	{
+	}
+
+	void run() override
+	{
+		try {
+			mPrepare();
+		} catch (...) {
+			QMutexLocker locker(&mErrorMutex);
+			if (!mError) {
+				mError = std::current_exception();
+			}
+		}
+	}
+
+private:
+	std::function<void()> mPrepare;
+	std::exception_ptr &mError;
+	QMutex &mErrorMutex;
+};
+
+}
+
 Brick::Brick(trikHal::HardwareAbstractionInterface &hardwareAbstraction
 		, const QString &systemConfig, const QString &modelConfig, const QString &mediaPath)
 	: Brick(createDifferentOwnerPointer(hardwareAbstraction), systemConfig, modelConfig, mediaPath)
@@ -63,7 +113,8 @@ Brick::Brick(trikHal::HardwareAbstractionInterface &hardwareAbstraction
 }
 
 Brick::Brick(const QString &systemConfig, const QString &modelConfig, const QString &mediaPath)
-	: Brick(createDifferentOwnerPointer(HardwareAbstractionFactory::create()), systemConfig, modelConfig, mediaPath)
+	: Brick(createDifferentOwnerPointer(HardwareAbstractionFactory::create(Configurer(systemConfig, modelConfig)))
+			, systemConfig, modelConfig, mediaPath)
 {
 }
 
@@ -76,8 +127,19 @@ Brick::Brick(const trikKernel::DifferentOwnerPointer<trikHal::HardwareAbstractio
 	, mMediaPath(mediaPath)
 	, mConfigurer(systemConfig, modelConfig)
 {
+	QElapsedTimer totalTimer;
+	totalTimer.start();
+
 	qRegisterMetaType<QVector<int>>("QVector<int>");
 	qRegisterMetaType<trikKernel::TimeVal>("trikKernel::TimeVal");
+	qRegisterMetaType<trikKernel::Timestamp>("trikKernel::Timestamp");
+	qRegisterMetaType<QVector<trikHal::InputEvent>>("QVector<trikHal::InputEvent>");
+
+	try {
+		mHardwareAbstraction->setIoReactorEnabled(mConfigurer.attributeByDevice("ioReactor", "enabled") == "true");
+	} catch (MalformedConfigException &) {
+		// Older configs do not have I/O reactor settings, thread per device model is used then.
+	}
 
 	const bool hasGui = (qobject_cast<QApplication *>(QCoreApplication::instance()) != nullptr);
 
@@ -87,41 +149,138 @@ Brick::Brick(const trikKernel::DifferentOwnerPointer<trikHal::HardwareAbstractio
 		QLOG_INFO() << "Running in no GUI mode";
 	}
 
-	for (const QString &initScript : mConfigurer.initScripts()) {
-		if (mHardwareAbstraction->systemConsole().system(initScript) != 0) {
-			QLOG_ERROR() << "Init script failed";
-		}
-	}
+	runInitScripts();
 
-	mMspCommunicator.reset(MspBusAutoDetector::createCommunicator(mConfigurer, *mHardwareAbstraction));
 	mModuleLoader.reset(new ModuleLoader(mHardwareAbstraction->systemConsole()));
 
+	// Range sensors load kernel modules and vector sensors wait for drivers to create their event files, these are the
+	// slowest steps of bringing devices up. They do not depend on each other and on MSP bus, so only these steps run
+	// on a thread pool while the rest of devices is created here. Sensors themselves are constructed in brick thread
+	// afterwards, so all their objects live in a thread that keeps running.
+	QList<std::function<void()>> preparations;
+	QStringList ports;
+	QStringList rangeSensorPorts;
 	for (const QString &port : mConfigurer.ports()) {
-		createDevice(port);
+		bool isRangeSensor = false;
+		try {
+			isRangeSensor = mConfigurer.deviceClass(port) == "rangeSensor";
+		} catch (MalformedConfigException &) {
+			// Will be reported by createDevice.
+		}
+
+		if (!isRangeSensor) {
+			ports << port;
+			continue;
+		}
+
+		rangeSensorPorts << port;
+		try {
+			const QStringList modules = {mConfigurer.attributeByPort(port, "module")
+					, mConfigurer.attributeByDevice("rangeSensor", "commonModule")};
+			preparations << [this, modules]() {
+				for (const QString &module : modules) {
+					mModuleLoader->load(module);
+				}
+			};
+		} catch (MalformedConfigException &) {
+			// Will be reported by createDevice.
+		}
 	}
 
-	mBattery.reset(new Battery(*mMspCommunicator));
+	const QStringList vectorSensors = {"accelerometer", "gyroscope"};
+	for (const QString &vectorSensor : vectorSensors) {
+		if (mConfigurer.isEnabled(vectorSensor)) {
+			const QString eventFile = mConfigurer.attributeByDevice(vectorSensor, "deviceFile");
+			preparations << [this, eventFile]() { waitForEventFile(eventFile); };
+		}
+	}
 
-	if (mConfigurer.isEnabled("accelerometer")) {
-		mAccelerometer.reset(new VectorSensor("accelerometer", mConfigurer, *mHardwareAbstraction));
+	std::exception_ptr preparationError;
+	QMutex preparationErrorMutex;
+	QThreadPool devicePool;
+
+	// Preparation is mostly waiting for kernel and file system, so pool size is not limited by number of cores.
+	devicePool.setMaxThreadCount(qMax(preparations.size(), 1));
+	for (const std::function<void()> &preparation : preparations) {
+		devicePool.start(new DevicePreparation(preparation, preparationError, preparationErrorMutex));
 	}
 
-	if (mConfigurer.isEnabled("gyroscope")) {
-		mGyroscope.reset(new VectorSensor("gyroscope", mConfigurer, *mHardwareAbstraction));
+	QElapsedTimer mspBusTimer;
+	mspBusTimer.start();
+	mMspBus.reset(new MspBusScheduler(MspBusAutoDetector::createCommunicator(mConfigurer, *mHardwareAbstraction)));
+	recordInitializationTime("mspBus", mspBusTimer);
+
+	int batterySamplingPeriod = 0;
+	try {
+		if (mConfigurer.attributeByDevice("sensorSampler", "enabled") == "true") {
+			mSensorSampler.reset(new MspSensorSampler());
+			batterySamplingPeriod = mConfigurer.attributeByDevice("sensorSampler", "batteryPeriod").toInt();
+		}
+	} catch (MalformedConfigException &) {
+		// Older configs do not have sampler settings, sensors are read on request then.
+	}
+
+	for (const QString &port : ports) {
+		createDevice(port);
 	}
 
+	mBattery.reset(new Battery(mMspBus->channel(MspBusScheduler::RequestClass::background)
+			, batterySamplingPeriod > 0 ? mSensorSampler.data() : nullptr, batterySamplingPeriod));
+
 	mKeys.reset(new Keys(mConfigurer, *mHardwareAbstraction));
 
 	mLed.reset(new Led(mConfigurer, *mHardwareAbstraction));
 
 	mPlayWavFileCommand = mConfigurer.attributeByDevice("playWavFile", "command");
 	mPlayMp3FileCommand = mConfigurer.attributeByDevice("playMp3File", "command");
+
+	devicePool.waitForDone();
+	if (preparationError) {
+		std::rethrow_exception(preparationError);
+	}
+
+	for (const QString &port : rangeSensorPorts) {
+		createDevice(port);
+	}
+
+	if (mConfigurer.isEnabled("accelerometer")) {
+		mAccelerometer.reset(createVectorSensor("accelerometer"));
+	}
+
+	if (mConfigurer.isEnabled("gyroscope")) {
+		mGyroscope.reset(createVectorSensor("gyroscope"));
+	}
+
+	try {
+		if (mAccelerometer && mGyroscope && mConfigurer.attributeByDevice("orientation", "enabled") == "true") {
+			mOrientation.reset(new Orientation(mConfigurer, *mAccelerometer, *mGyroscope));
+		}
+	} catch (MalformedConfigException &) {
+		// Older configs do not have orientation settings, orientation is not estimated then.
+	}
+
+	recordInitializationTime("total", totalTimer);
+	QLOG_INFO() << "Brick is ready in" << mInitializationTimes["total"].toLongLong() << "ms";
+
+	// Emitted asynchronously so clients have a chance to connect to it after construction.
+	QMetaObject::invokeMethod(this, "ready", Qt::QueuedConnection, Q_ARG(QVariantMap, mInitializationTimes));
 }
 
 Brick::~Brick()
 {
+	// Devices may have asynchronous MSP requests in flight, they shall be completed before devices are deleted.
+	if (mMspBus) {
+		mMspBus->finishAsyncRequests();
+	}
+
+	// Sampler is stopped but kept alive, devices unregister their sources from it when deleted.
+	if (mSensorSampler) {
+		mSensorSampler->stop();
+	}
+
 	qDeleteAll(mServoMotors);
 	qDeleteAll(mPwmCaptures);
+	qDeleteAll(mMotorGroups);
 	qDeleteAll(mPowerMotors);
 	qDeleteAll(mEncoders);
 	qDeleteAll(mAnalogSensors);
@@ -135,15 +294,18 @@ Brick::~Brick()
 	qDeleteAll(mEventDevices);
 
 	// Clean up devices before killing hardware abstraction since their finalization may depend on it.
-	mMspCommunicator.reset();
+	mMspBus.reset();
 	mModuleLoader.reset();
 
+	mOrientation.reset();
 	mAccelerometer.reset();
 	mGyroscope.reset();
 	mBattery.reset();
 	mKeys.reset();
 	mDisplay.reset();
 	mLed.reset();
+
+	mSensorSampler.reset();
 }
 
 DisplayWidgetInterface *Brick::graphicsWidget()
@@ -201,9 +363,16 @@ void Brick::playSound(const QString &soundFileName)
 		command = mPlayMp3FileCommand.arg(fileInfo.absoluteFilePath());
 	}
 
-	if (command.isEmpty() || mHardwareAbstraction->systemConsole().system(command) != 0) {
+	if (command.isEmpty()) {
 		QLOG_ERROR() << "Play sound failed";
+		return;
 	}
+
+	mHardwareAbstraction->systemConsole().systemAsync(command, [](int result) {
+		if (result != 0) {
+			QLOG_ERROR() << "Play sound failed";
+		}
+	});
 }
 
 
@@ -224,16 +393,31 @@ void Brick::say(const QString &text)
 	mHardwareAbstraction->systemConsole().startProcess("sh", args);
 }
 
+void Brick::system(const QString &command, bool synchronously)
+{
+	if (synchronously) {
+		QLOG_INFO() << "Running synchronously: " << command;
+		mHardwareAbstraction->systemConsole().system(command);
+	} else {
+		QLOG_INFO() << "Running: " << command;
+		mHardwareAbstraction->systemConsole().systemAsync(command);
+	}
+}
+
 void Brick::stop()
 {
 	QLOG_INFO() << "Stopping brick";
 
 	mTonePlayer->stop();
 
+	// All servo motors are stopped with one submit of a batch.
+	const QScopedPointer<trikHal::FileIoBatchInterface> servoBatch(mHardwareAbstraction->createFileIoBatch());
 	for (ServoMotor * const servoMotor : mServoMotors.values()) {
-		servoMotor->powerOff();
+		servoMotor->powerOff(*servoBatch);
 	}
 
+	servoBatch->submit();
+
 	for (PowerMotor * const powerMotor : mPowerMotors.values()) {
 		powerMotor->powerOff();
 	}
@@ -286,6 +470,32 @@ MotorInterface *Brick::motor(const QString &port)
 	}
 }
 
+MotorGroupInterface *Brick::motorGroup(const QStringList &ports)
+{
+	const QString key = ports.join(",");
+	if (mMotorGroups.contains(key)) {
+		return mMotorGroups[key];
+	}
+
+	QList<PowerMotor *> motors;
+	for (const QString &port : ports) {
+		PowerMotor * const motor = mPowerMotors.value(port, nullptr);
+		if (!motor || motors.contains(motor)) {
+			QLOG_ERROR() << "Can not create motor group" << ports << ", port" << port
+					<< "does not have power motor or is listed twice";
+			return nullptr;
+		}
+
+		motors << motor;
+	}
+
+	// All power motors use actuator channel, so group commands have the same priority as commands of single motors.
+	MotorGroup * const group = new MotorGroup(ports, motors
+			, mMspBus->channel(MspBusScheduler::RequestClass::actuator));
+	mMotorGroups.insert(key, group);
+	return group;
+}
+
 PwmCaptureInterface *Brick::pwmCapture(const QString &port)
 {
 	return mPwmCaptures.value(port, nullptr);
@@ -361,6 +571,11 @@ VectorSensorInterface *Brick::gyroscope()
 	return mGyroscope.data();
 }
 
+OrientationInterface *Brick::orientation()
+{
+	return mOrientation.data();
+}
+
 LineSensorInterface *Brick::lineSensor(const QString &port)
 {
 	return mLineSensors.contains(port) ? mLineSensors[port] : nullptr;
@@ -437,9 +652,17 @@ void Brick::shutdownDevice(const QString &port)
 		delete mPwmCaptures[port];
 		mPwmCaptures.remove(port);
 	} else if (deviceClass == "powerMotor") {
-		mPowerMotors[port]->powerOff();
-		delete mPowerMotors[port];
-		mPowerMotors.remove(port);
+		PowerMotor * const powerMotor = mPowerMotors.take(port);
+
+		// Groups keep pointers to their motors, so groups with this motor are no longer valid.
+		for (const QString &group : mMotorGroups.keys()) {
+			if (mMotorGroups[group]->contains(powerMotor)) {
+				delete mMotorGroups.take(group);
+			}
+		}
+
+		powerMotor->powerOff();
+		delete powerMotor;
 	} else if (deviceClass == "analogSensor") {
 		delete mAnalogSensors[port];
 		mAnalogSensors.remove(port);
@@ -473,6 +696,9 @@ void Brick::shutdownDevice(const QString &port)
 
 void Brick::createDevice(const QString &port)
 {
+	QElapsedTimer timer;
+	timer.start();
+
 	try {
 		const QString &deviceClass = mConfigurer.deviceClass(port);
 		if (deviceClass == "servoMotor") {
@@ -480,18 +706,23 @@ void Brick::createDevice(const QString &port)
 		} else if (deviceClass == "pwmCapture") {
 			mPwmCaptures.insert(port, new PwmCapture(port, mConfigurer, *mHardwareAbstraction));
 		} else if (deviceClass == "powerMotor") {
-			mPowerMotors.insert(port, new PowerMotor(port, mConfigurer, *mMspCommunicator));
+			mPowerMotors.insert(port, new PowerMotor(port, mConfigurer
+					, mMspBus->channel(MspBusScheduler::RequestClass::actuator)));
 		} else if (deviceClass == "analogSensor") {
-			mAnalogSensors.insert(port, new AnalogSensor(port, mConfigurer, *mMspCommunicator));
+			mAnalogSensors.insert(port, new AnalogSensor(port, mConfigurer
+					, mMspBus->channel(MspBusScheduler::RequestClass::controlLoop), mSensorSampler.data()));
 		} else if (deviceClass == "digitalSensor") {
 			mDigitalSensors.insert(port, new DigitalSensor(port, mConfigurer, *mHardwareAbstraction));
 		} else if (deviceClass == "rangeSensor") {
-			mRangeSensors.insert(port, new RangeSensor(port, mConfigurer, *mModuleLoader, *mHardwareAbstraction));
+			RangeSensor * const rangeSensor = new RangeSensor(port, mConfigurer, *mModuleLoader, *mHardwareAbstraction);
 
 			/// @todo Range sensor shall be turned on only when needed.
-			mRangeSensors[port]->init();
+			rangeSensor->init();
+
+			mRangeSensors.insert(port, rangeSensor);
 		} else if (deviceClass == "encoder") {
-			mEncoders.insert(port, new Encoder(port, mConfigurer, *mMspCommunicator));
+			mEncoders.insert(port, new Encoder(port, mConfigurer
+					, mMspBus->channel(MspBusScheduler::RequestClass::controlLoop), mSensorSampler.data()));
 		} else if (deviceClass == "lineSensor") {
 			mLineSensors.insert(port, new LineSensor(port, mConfigurer, *mHardwareAbstraction));
 
@@ -519,4 +750,66 @@ void Brick::createDevice(const QString &port)
 		QLOG_ERROR() << "Config for port" << port << "is malformed:" << e.errorMessage();
 		QLOG_ERROR() << "Ignoring device";
 	}
+
+	recordInitializationTime(port, timer);
+}
+
+void Brick::runInitScripts()
+{
+	QElapsedTimer timer;
+	timer.start();
+
+	SystemConsoleInterface &console = mHardwareAbstraction->systemConsole();
+	QSemaphore finishedScripts;
+	int startedScripts = 0;
+
+	for (const Configurer::InitScript &initScript : mConfigurer.initScriptsWithOrdering()) {
+		if (initScript.parallel) {
+			++startedScripts;
+			console.systemAsync(initScript.script, [&finishedScripts](int result) {
+				if (result != 0) {
+					QLOG_ERROR() << "Init script failed";
+				}
+
+				finishedScripts.release();
+			});
+		} else {
+			finishedScripts.acquire(startedScripts);
+			startedScripts = 0;
+
+			if (console.system(initScript.script) != 0) {
+				QLOG_ERROR() << "Init script failed";
+			}
+		}
+	}
+
+	finishedScripts.acquire(startedScripts);
+
+	recordInitializationTime("initScripts", timer);
+}
+
+VectorSensor *Brick::createVectorSensor(const QString &deviceName)
+{
+	QElapsedTimer timer;
+	timer.start();
+
+	VectorSensor * const sensor = new VectorSensor(deviceName, mConfigurer, *mHardwareAbstraction);
+
+	recordInitializationTime(deviceName, timer);
+	return sensor;
+}
+
+void Brick::waitForEventFile(const QString &fileName) const
+{
+	// Opening waits for a driver to create the file, sensor constructed afterwards opens it at once.
+	const QScopedPointer<EventFileInterface> eventFile(
+			mHardwareAbstraction->createEventFile(fileName, *QThread::currentThread()));
+	if (eventFile->open()) {
+		eventFile->close();
+	}
+}
+
+void Brick::recordInitializationTime(const QString &name, const QElapsedTimer &timer)
+{
+	mInitializationTimes.insert(name, timer.elapsed());
 }
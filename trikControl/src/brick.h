@@ -22,6 +22,8 @@
 
 #include "brickInterface.h"
 
+class QElapsedTimer;
+
 namespace trikHal {
 class HardwareAbstractionInterface;
 }
@@ -36,12 +38,15 @@ class Display;
 class Encoder;
 class EventDevice;
 class Fifo;
-class MspCommunicatorInterface;
+class MspBusScheduler;
+class MspSensorSampler;
 class Keys;
 class Led;
 class LineSensor;
 class ModuleLoader;
+class MotorGroup;
 class ObjectSensor;
+class Orientation;
 class SoundSensor;
 class PowerMotor;
 class PwmCapture;
@@ -79,6 +84,8 @@ public:
 
 	QString configVersion() const override;
 
+	void system(const QString &command, bool synchronously) override;
+
 public slots:
 	void configure(const QString &portName, const QString &deviceName) override;
 
@@ -92,6 +99,8 @@ public slots:
 
 	MotorInterface *motor(const QString &port) override;
 
+	MotorGroupInterface *motorGroup(const QStringList &ports) override;
+
 	PwmCaptureInterface *pwmCapture(const QString &port) override;
 
 	SensorInterface *sensor(const QString &port) override;
@@ -108,6 +117,8 @@ public slots:
 
 	VectorSensorInterface *gyroscope() override;
 
+	OrientationInterface *orientation() override;
+
 	LineSensorInterface *lineSensor(const QString &port) override;
 
 	ColorSensorInterface *colorSensor(const QString &port) override;
@@ -144,15 +155,38 @@ private:
 	/// Creates and configures a device on a given port.
 	void createDevice(const QString &port);
 
+	/// Runs init scripts from config. Scripts marked as parallel are started at once, non-parallel script waits for
+	/// all previous scripts to finish and is executed alone.
+	void runInitScripts();
+
+	/// Creates vector sensor with given name.
+	VectorSensor *createVectorSensor(const QString &deviceName);
+
+	/// Waits in current thread until event file is created by a driver or opening it times out.
+	void waitForEventFile(const QString &fileName) const;
+
+	/// Remembers time elapsed since given timer start as initialization time of a given device or stage.
+	void recordInitializationTime(const QString &name, const QElapsedTimer &timer);
+
 	/// Hardware absraction object that is used to provide communication with real robot hardware or to simulate it.
 	/// Has or hasn't ownership depending on whether it was created by Brick itself or passed from outside.
 	trikKernel::DifferentOwnerPointer<trikHal::HardwareAbstractionInterface> mHardwareAbstraction;
 
-	QScopedPointer<MspCommunicatorInterface> mMspCommunicator;
+	/// Access to MSP bus, shared by power motors, analog sensors, encoders and battery with different priorities.
+	QScopedPointer<MspBusScheduler> mMspBus;
+
+	/// Polls analog sensors, encoders and battery in background, so reads do not touch the bus. Null if disabled
+	/// in config.
+	QScopedPointer<MspSensorSampler> mSensorSampler;
+
 	QScopedPointer<ModuleLoader> mModuleLoader;
 
 	QScopedPointer<VectorSensor> mAccelerometer;
 	QScopedPointer<VectorSensor> mGyroscope;
+
+	/// Orientation estimator fed by accelerometer and gyroscope. Null if disabled in config.
+	QScopedPointer<Orientation> mOrientation;
+
 	QScopedPointer<Battery> mBattery;
 	QScopedPointer<Keys> mKeys;
 	QScopedPointer<Display> mDisplay;
@@ -162,6 +196,7 @@ private:
 	QHash<QString, ServoMotor *> mServoMotors;  // Has ownership.
 	QHash<QString, PwmCapture *> mPwmCaptures;  // Has ownership.
 	QHash<QString, PowerMotor *> mPowerMotors;  // Has ownership.
+	QHash<QString, MotorGroup *> mMotorGroups;  // Has ownership. Keys are comma-separated lists of ports.
 	QHash<QString, AnalogSensor *> mAnalogSensors;  // Has ownership.
 	QHash<QString, Encoder *> mEncoders;  // Has ownership.
 	QHash<QString, DigitalSensor *> mDigitalSensors;  // Has ownership.
@@ -178,6 +213,9 @@ private:
 	QString mMediaPath;
 
 	trikKernel::Configurer mConfigurer;
+
+	/// Initialization times of devices and stages in milliseconds, reported by "ready" signal.
+	QVariantMap mInitializationTimes;
 };
 
 }
@@ -30,6 +30,12 @@ DigitalSensor::DigitalSensor(const QString &port, const trikKernel::Configurer &
 	mMin = ConfigurerHelper::configureInt(configurer, mState, port, "min");
 	mMax = ConfigurerHelper::configureInt(configurer, mState, port, "max");
 
+	// Device file is kept open, every read just rereads it from the beginning.
+	if (!mDeviceFile->open()) {
+		mState.fail();
+		return;
+	}
+
 	mState.ready();
 
 	// Testing availability of a device.
@@ -38,6 +44,7 @@ DigitalSensor::DigitalSensor(const QString &port, const trikKernel::Configurer &
 
 DigitalSensor::~DigitalSensor()
 {
+	mDeviceFile->close();
 }
 
 int DigitalSensor::read()
@@ -46,24 +53,13 @@ int DigitalSensor::read()
 		return 0;
 	}
 
-	int value = readRawData();
+	const int value = readRawData();
 
 	if (mState.isFailed()) {
 		return 0;
 	}
 
-	if (mMax == mMin) {
-		return mMin;
-	}
-
-	value = qMin(value, mMax);
-	value = qMax(value, mMin);
-
-	const qreal scale = 100.0 / (static_cast<qreal>(mMax - mMin));
-
-	value = (value - mMin) * scale;
-
-	return value;
+	return scale(value);
 }
 
 int DigitalSensor::readRawData()
@@ -72,17 +68,32 @@ int DigitalSensor::readRawData()
 		return 0;
 	}
 
-	if (!mDeviceFile->open()) {
+	int value = 0;
+	if (mDeviceFile->readIntegers(&value, 1) < 0) {
 		mState.fail();
 		return 0;
 	}
 
-	int value = 0;
-	mDeviceFile->stream() >> value;
+	return value;
+}
 
-	mDeviceFile->close();
+HistoryInterface *DigitalSensor::history()
+{
+	return nullptr;
+}
 
-	return value;
+int DigitalSensor::scale(int rawValue) const
+{
+	if (mMax == mMin) {
+		return mMin;
+	}
+
+	rawValue = qMin(rawValue, mMax);
+	rawValue = qMax(rawValue, mMin);
+
+	const qreal scale = 100.0 / (static_cast<qreal>(mMax - mMin));
+
+	return (rawValue - mMin) * scale;
 }
 
 DigitalSensor::Status DigitalSensor::status() const
@@ -54,9 +54,15 @@ public slots:
 
 	int readRawData() override;
 
+	/// Digital sensors do not keep history, returns nullptr.
+	HistoryInterface *history() override;
+
 	Status status() const override;
 
 private:
+	/// Scales raw reading into [0, 100] range using configured min and max values.
+	int scale(int rawValue) const;
+
 	int mMin;
 	int mMax;
 	QScopedPointer<trikHal::InputDeviceFileInterface> mDeviceFile;
@@ -15,6 +15,8 @@
 #include "encoder.h"
 
 #include <trikKernel/configurer.h>
+#include <trikKernel/exceptions/malformedConfigException.h>
+#include <trikKernel/timestamp.h>
 #include <QsLog.h>
 
 #include "mspI2cCommunicator.h"
@@ -22,7 +24,8 @@
 
 using namespace trikControl;
 
-Encoder::Encoder(const QString &port, const trikKernel::Configurer &configurer, MspCommunicatorInterface &communicator)
+Encoder::Encoder(const QString &port, const trikKernel::Configurer &configurer, MspCommunicatorInterface &communicator
+		, MspSensorSampler *sampler)
 	: mCommunicator(communicator)
 	, mInvert(configurer.attributeByPort(port, "invert") == "false")
 	, mState("Encoder on" + port)
@@ -37,17 +40,36 @@ Encoder::Encoder(const QString &port, const trikKernel::Configurer &configurer,
 	}
 
 	mState.ready();
+
+	mHistory.reset(SensorHistory::createForPort(configurer, port));
+
+	if (sampler != nullptr && mState.isReady()) {
+		try {
+			const int period = configurer.attributeByPort(port, "samplingPeriod").toInt();
+			mSample = sampler->addSource(mCommunicator, readCommand(), period
+					, [this](const MspSensorSampler::Sample &sample) { record(sample.value, sample.timestamp); });
+			mSampler = sampler;
+		} catch (trikKernel::MalformedConfigException &) {
+			// Sampling period is not configured, encoder is read on request.
+		}
+	}
+}
+
+Encoder::~Encoder()
+{
+	// Reads queued on bus thread may complete while the device is being destroyed.
+	mAsyncReads.cancel();
+
+	if (mSampler != nullptr) {
+		mSampler->removeSource(mSample);
+	}
 }
 
 void Encoder::reset()
 {
 	if (status() == DeviceInterface::Status::ready) {
-		QByteArray command(3, '\0');
-		command[0] = static_cast<char>(mI2cCommandNumber & 0xFF);
-		command[1] = static_cast<char>((mI2cCommandNumber >> 8) & 0xFF);
-		command[2] = static_cast<char>(0x00);
-
-		mCommunicator.send(command);
+		mCommunicator.send(trikHal::MspCommand::writeByte(mI2cCommandNumber, 0));
+		mResetTime.storeRelease(trikKernel::Timestamp::now().toNsec());
 	}
 }
 
@@ -58,19 +80,74 @@ Encoder::Status Encoder::status() const
 
 int Encoder::read()
 {
-	return readRawData() * mPassedDegrees / mPassedTicks * (mInvert ? -1 : 1);
+	return toDegrees(readRawData());
 }
 
 int Encoder::readRawData()
 {
-	if (status() == DeviceInterface::Status::ready) {
-		QByteArray command(3, '\0');
-		command[0] = static_cast<char>(mI2cCommandNumber & 0xFF);
-		command[1] = static_cast<char>((mI2cCommandNumber >> 8) & 0xFF);
-		command[2] = static_cast<char>(0x00);
+	if (status() != DeviceInterface::Status::ready) {
+		return 0;
+	}
+
+	if (hasFreshSample()) {
+		return mSample->latest().value;
+	}
+
+	const trikKernel::Timestamp time = trikKernel::Timestamp::now();
+	const int rawData = mCommunicator.read(readCommand());
+	record(rawData, time);
+	return rawData;
+}
+
+int Encoder::readAsync()
+{
+	const int requestId = mLastRequestId.fetchAndAddOrdered(1) + 1;
+	const auto report = [this, requestId](int rawData) {
+		// Reported through event loop, so the result is never delivered before readAsync() returns.
+		QMetaObject::invokeMethod(this, "readFinished", Qt::QueuedConnection
+				, Q_ARG(int, requestId), Q_ARG(int, toDegrees(rawData)));
+	};
 
-		return mCommunicator.read(command);
+	if (status() != DeviceInterface::Status::ready) {
+		report(0);
+	} else if (hasFreshSample()) {
+		report(mSample->latest().value);
 	} else {
-		return 0;
+		const trikKernel::Timestamp time = trikKernel::Timestamp::now();
+		mCommunicator.readAsync(readCommand(), mAsyncReads.guard([this, time, report](int rawData) {
+			record(rawData, time);
+			report(rawData);
+		}));
+	}
+
+	return requestId;
+}
+
+HistoryInterface *Encoder::history()
+{
+	return mHistory.data();
+}
+
+trikHal::MspCommand Encoder::readCommand() const
+{
+	return trikHal::MspCommand::readLong(mI2cCommandNumber);
+}
+
+int Encoder::toDegrees(int rawData) const
+{
+	return rawData * mPassedDegrees / mPassedTicks * (mInvert ? -1 : 1);
+}
+
+void Encoder::record(int rawData, const trikKernel::Timestamp &time)
+{
+	if (mHistory) {
+		mHistory->samples().append(time, toDegrees(rawData));
 	}
 }
+
+bool Encoder::hasFreshSample() const
+{
+	// Sample taken before reset still has old tick count, so the bus is read until sampler catches up.
+	return mSample != nullptr && mSample->hasSample()
+			&& mResetTime.loadAcquire() < mSample->latest().timestamp.toNsec();
+}
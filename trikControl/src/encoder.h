@@ -15,13 +15,22 @@
 
 #pragma once
 
+#include <QtCore/QAtomicInt>
+
 #include "encoderInterface.h"
+#include "asyncReadOwner.h"
 #include "deviceState.h"
+#include "mspSensorSampler.h"
+#include "sensorHistory.h"
 
 namespace trikKernel {
 class Configurer;
 }
 
+namespace trikHal {
+class MspCommand;
+}
+
 namespace trikControl {
 
 class MspCommunicatorInterface;
@@ -36,8 +45,12 @@ public:
 	/// @param port - port on which this encoder is configured.
 	/// @param configurer - configurer object containing preparsed XML files with encoder parameters.
 	/// @param communicator - I2C communicator to use to query encoder.
+	/// @param sampler - sampler that polls the encoder in background if its port has "samplingPeriod" configured,
+	///        or nullptr to query the bus on every read.
 	Encoder(const QString &port, const trikKernel::Configurer &configurer
-			, trikControl::MspCommunicatorInterface &communicator);
+			, trikControl::MspCommunicatorInterface &communicator, MspSensorSampler *sampler = nullptr);
+
+	~Encoder() override;
 
 	Status status() const override;
 
@@ -48,13 +61,48 @@ public slots:
 
 	void reset() override;
 
+	int readAsync() override;
+
+	HistoryInterface *history() override;
+
 private:
+	/// Returns MSP command for reading the encoder.
+	trikHal::MspCommand readCommand() const;
+
+	/// Converts raw reading into degrees.
+	int toDegrees(int rawData) const;
+
+	/// Returns true if there is a sample taken after last reset.
+	bool hasFreshSample() const;
+
+	/// Records raw reading just received from the bus into history, if it is enabled.
+	void record(int rawData, const trikKernel::Timestamp &time);
+
 	MspCommunicatorInterface &mCommunicator;
+
+	/// Sampler polling this encoder, or nullptr if the encoder is read on request.
+	MspSensorSampler *mSampler = nullptr;
+
+	/// Latest reading published by sampler. Owned by sampler.
+	MspSensorSampler::Source *mSample = nullptr;
+
+	/// Time of last reset in nanoseconds, samples taken before it are stale.
+	QAtomicInteger<qint64> mResetTime;
+
 	int mI2cCommandNumber;
 	int mPassedTicks;
 	int mPassedDegrees;
 	const bool mInvert;
 	DeviceState mState;
+
+	/// Id of last asynchronous read request.
+	QAtomicInt mLastRequestId;
+
+	/// Cancels callbacks of asynchronous reads that are still queued when the device is destroyed.
+	AsyncReadOwner mAsyncReads;
+
+	/// History of readings in degrees, null if disabled in config.
+	QScopedPointer<SensorHistory> mHistory;
 };
 
 }
@@ -30,11 +30,14 @@ EventDeviceWorker::EventDeviceWorker(const QString &deviceFilePath, DeviceState
 		return;
 	}
 
-	connect(mEventFile.data(), SIGNAL(newEvent(int, int, int, trikKernel::TimeVal))
-			, this, SLOT(onNewEvent(int, int, int, trikKernel::TimeVal)));
+	connect(mEventFile.data(), SIGNAL(newEvents(QVector<trikHal::InputEvent>))
+			, this, SLOT(onNewEvents(QVector<trikHal::InputEvent>)));
 }
 
-void EventDeviceWorker::onNewEvent(int eventType, int code, int value, const trikKernel::TimeVal &eventTime)
+void EventDeviceWorker::onNewEvents(const QVector<trikHal::InputEvent> &events)
 {
-	emit newEvent(eventType, code, value, eventTime.toMcSec());
+	for (const trikHal::InputEvent &event : events) {
+		// Event device API reports time as legacy integer microseconds.
+		emit newEvent(event.eventType, event.code, event.value, event.eventTime.toTimeVal().toMcSec());
+	}
 }
@@ -45,8 +45,8 @@ signals:
 	void newEvent(int onEvent, int code, int value, int eventTime);
 
 private slots:
-	/// Called every time underlying event file produces an event.
-	void onNewEvent(int eventType, int code, int value, const trikKernel::TimeVal &eventTime);
+	/// Called every time underlying event file produces a batch of events.
+	void onNewEvents(const QVector<trikHal::InputEvent> &events);
 
 private:
 	/// Underlying event file that watches actual event file from operating system.
@@ -32,7 +32,7 @@ Fifo::Fifo(const QString &virtualPort, const trikKernel::Configurer &configurer
 {
 	mState.start();
 
-	connect(mFifo.data(), SIGNAL(newData(QString)), this, SLOT(onNewData(QString)));
+	connect(mFifo.data(), SIGNAL(newLine(QByteArray)), this, SLOT(onNewLine(QByteArray)));
 	connect(mFifo.data(), SIGNAL(readError()), this, SLOT(onReadError()));
 
 	if (mFifo->open()) {
@@ -72,10 +72,10 @@ bool Fifo::hasData() const
 	return mCurrent != "";
 }
 
-void Fifo::onNewData(const QString &data)
+void Fifo::onNewLine(const QByteArray &line)
 {
-	QString buffer = data;
-	mCurrent.swap(buffer);
+	QString data = QString::fromUtf8(line);
+	mCurrent = data;
 	emit newData(data);
 }
 
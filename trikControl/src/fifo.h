@@ -55,7 +55,7 @@ public slots:
 	bool hasData() const override;
 
 private slots:
-	void onNewData(const QString &data);
+	void onNewLine(const QByteArray &line);
 	void onReadError();
 
 private:
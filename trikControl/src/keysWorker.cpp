@@ -33,36 +33,40 @@ KeysWorker::KeysWorker(const QString &keysPath, DeviceState &state
 		return;
 	}
 
-	connect(mEventFile.data(), SIGNAL(newEvent(int, int, int, trikKernel::TimeVal))
-			, this, SLOT(readKeysEvent(int, int, int, trikKernel::TimeVal)));
+	connect(mEventFile.data(), SIGNAL(newEvents(QVector<trikHal::InputEvent>))
+			, this, SLOT(readKeysEvents(QVector<trikHal::InputEvent>)));
 }
 
 void KeysWorker::reset()
 {
-	mLock.lockForWrite();
-	mWasPressed.clear();
+	for (QAtomicInteger<quint32> &word : mWasPressed) {
+		word.storeRelease(0);
+	}
+
 	mButtonCode = 0;
 	mButtonValue = 0;
-	mLock.unlock();
 }
 
 bool KeysWorker::wasPressed(int code)
 {
-	mLock.lockForRead();
-	const bool result = mWasPressed.contains(code);
-	mLock.unlock();
-
-	if (result) {
-		mLock.lockForWrite();
-		mWasPressed.remove(code);
-		mLock.unlock();
+	if (code < 0 || code >= keyCount) {
+		return false;
 	}
 
-	return result;
+	// Tests and clears the bit at once, so a press is reported only once even if several threads ask for it.
+	const quint32 bit = 1u << (code % wordBits);
+	return mWasPressed[code / wordBits].fetchAndAndOrdered(~bit) & bit;
+}
+
+void KeysWorker::readKeysEvents(const QVector<trikHal::InputEvent> &events)
+{
+	for (const trikHal::InputEvent &event : events) {
+		readKeysEvent(event.eventType, event.code, event.value, event.eventTime);
+	}
 }
 
 void KeysWorker::readKeysEvent(int eventType, int code, int value
-		, const trikKernel::TimeVal &eventTime)
+		, const trikKernel::Timestamp &eventTime)
 {
 	Q_UNUSED(eventTime);
 
@@ -73,10 +77,8 @@ void KeysWorker::readKeysEvent(int eventType, int code, int value
 		mButtonValue = value;
 		break;
 	case evSyn:
-		if (mButtonCode && mButtonValue) {
-			mLock.lockForWrite();
-			mWasPressed.insert(mButtonCode);
-			mLock.unlock();
+		if (mButtonCode > 0 && mButtonCode < keyCount && mButtonValue) {
+			mWasPressed[mButtonCode / wordBits].fetchAndOrOrdered(1u << (mButtonCode % wordBits));
 		}
 
 		emit buttonPressed(mButtonCode, mButtonValue);
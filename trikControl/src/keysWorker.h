@@ -14,10 +14,9 @@
 
 #pragma once
 
+#include <QtCore/QAtomicInteger>
 #include <QtCore/QObject>
 #include <QtCore/QScopedPointer>
-#include <QtCore/QSet>
-#include <QtCore/QReadWriteLock>
 
 #include <trikHal/hardwareAbstractionInterface.h>
 
@@ -42,11 +41,13 @@ public:
 	void reset();
 
 public slots:
-	/// Returns true if a key with given code was pressed.
+	/// Returns true if a key with given code was pressed, and forgets the press. Does not lock, so it may be called
+	/// from any thread.
 	bool wasPressed(int code);
 
 private slots:
-	void readKeysEvent(int eventType, int code, int value, const trikKernel::TimeVal &eventTime);
+	/// Processes a batch of events from keys event file.
+	void readKeysEvents(const QVector<trikHal::InputEvent> &events);
 
 signals:
 	/// Triggered when button state changed (pressed or released).
@@ -55,11 +56,21 @@ signals:
 	void buttonPressed(int code, int value);
 
 private:
+	/// Number of key codes, as KEY_CNT in linux/input.h.
+	static const int keyCount = 0x300;
+
+	/// Number of bits in one word of mWasPressed.
+	static const int wordBits = 32;
+
+	void readKeysEvent(int eventType, int code, int value, const trikKernel::Timestamp &eventTime);
+
 	QScopedPointer<trikHal::EventFileInterface> mEventFile;
 	int mButtonCode = 0;
 	int mButtonValue = 0;
-	QSet<int> mWasPressed;
-	QReadWriteLock mLock;
+
+	/// Bit set of keys that were pressed since they were last checked by wasPressed(). Written by worker thread and
+	/// cleared by readers, so it is updated by atomic bit operations instead of a lock.
+	QAtomicInteger<quint32> mWasPressed[keyCount / wordBits];
 
 	/// Device state object, shared between worker and proxy.
 	DeviceState &mState;
@@ -24,6 +24,7 @@ using namespace trikControl;
 Led::Led(const trikKernel::Configurer &configurer, const trikHal::HardwareAbstractionInterface &hardwareAbstraction)
 	: mRedDeviceFile(hardwareAbstraction.createOutputDeviceFile(configurer.attributeByDevice("led", "red")))
 	, mGreenDeviceFile(hardwareAbstraction.createOutputDeviceFile(configurer.attributeByDevice("led", "green")))
+	, mBatch(hardwareAbstraction.createFileIoBatch())
 	, mState("Led")
 {
 	if (!mRedDeviceFile->open()) {
@@ -50,32 +51,29 @@ Led::Status Led::status() const
 
 void Led::red()
 {
-	if (mState.isReady()) {
-		mRedDeviceFile->write("1");
-		mGreenDeviceFile->write("0");
-	}
+	setColor(1, 0);
 }
 
 void Led::green()
 {
-	if (mState.isReady()) {
-		mRedDeviceFile->write("0");
-		mGreenDeviceFile->write("1");
-	}
+	setColor(0, 1);
 }
 
 void Led::orange()
 {
-	if (mState.isReady()) {
-		mRedDeviceFile->write("1");
-		mGreenDeviceFile->write("1");
-	}
+	setColor(1, 1);
 }
 
 void Led::off()
+{
+	setColor(0, 0);
+}
+
+void Led::setColor(int red, int green)
 {
 	if (mState.isReady()) {
-		mRedDeviceFile->write("0");
-		mGreenDeviceFile->write("0");
+		mBatch->write(*mRedDeviceFile, red);
+		mBatch->write(*mGreenDeviceFile, green);
+		mBatch->submit();
 	}
 }
@@ -28,6 +28,7 @@ class Configurer;
 namespace trikHal {
 class HardwareAbstractionInterface;
 class OutputDeviceFileInterface;
+class FileIoBatchInterface;
 }
 
 namespace trikControl {
@@ -56,8 +57,12 @@ public slots:
 	void off() override;
 
 private:
+	/// Writes both LED device files in one batch.
+	void setColor(int red, int green);
+
 	QScopedPointer<trikHal::OutputDeviceFileInterface> mRedDeviceFile;
 	QScopedPointer<trikHal::OutputDeviceFileInterface> mGreenDeviceFile;
+	QScopedPointer<trikHal::FileIoBatchInterface> mBatch;
 	int mOn;
 	int mOff;
 	DeviceState mState;
@@ -14,6 +14,8 @@
 
 #include "src/moduleLoader.h"
 
+#include <QtCore/QMutexLocker>
+
 #include <QsLog.h>
 
 using namespace trikControl;
@@ -25,8 +27,11 @@ ModuleLoader::ModuleLoader(trikHal::SystemConsoleInterface &console)
 
 bool ModuleLoader::load(const QString &module)
 {
-	if (mLoadedModules.contains(module)) {
-		return true;
+	{
+		QMutexLocker locker(&mLoadedModulesMutex);
+		if (mLoadedModules.contains(module)) {
+			return true;
+		}
 	}
 
 	if (mConsole.system(QString("modprobe %1").arg(module)) != 0) {
@@ -36,6 +41,7 @@ bool ModuleLoader::load(const QString &module)
 
 	QLOG_INFO() << "Module" << module << "loaded";
 
+	QMutexLocker locker(&mLoadedModulesMutex);
 	mLoadedModules.insert(module);
 
 	return true;
@@ -16,13 +16,15 @@
 
 #include <QtCore/QString>
 #include <QtCore/QSet>
+#include <QtCore/QMutex>
 
 #include <trikHal/systemConsoleInterface.h>
 
 namespace trikControl {
 
 /// Some devices like range sensor require kernel modules to work. This class keeps track of loaded kernel modules and
-/// loads them if needed.
+/// loads them if needed. Can be used from several threads at once, for example, by devices constructed concurrently
+/// during brick initialization.
 class ModuleLoader
 {
 public:
@@ -35,6 +37,10 @@ public:
 
 private:
 	QSet<QString> mLoadedModules;
+
+	/// Guards mLoadedModules. Not held during modprobe, loading already loaded module is harmless.
+	QMutex mLoadedModulesMutex;
+
 	trikHal::SystemConsoleInterface &mConsole;
 };
 
@@ -0,0 +1,108 @@
+/* Copyright 2016 CyberTech Labs Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License. */
+
+
+#include "motorGroup.h"
+
+#include <QsLog.h>
+
+#include "mspCommunicatorInterface.h"
+#include "powerMotor.h"
+
+using namespace trikControl;
+
+MotorGroup::MotorGroup(const QStringList &ports, const QList<PowerMotor *> &motors
+		, MspCommunicatorInterface &communicator)
+	: mPorts(ports)
+	, mMotors(motors)
+	, mCommunicator(communicator)
+{
+}
+
+MotorGroup::Status MotorGroup::status() const
+{
+	for (const PowerMotor * const motor : mMotors) {
+		if (motor->status() != Status::ready) {
+			return motor->status();
+		}
+	}
+
+	return Status::ready;
+}
+
+bool MotorGroup::contains(PowerMotor *motor) const
+{
+	return mMotors.contains(motor);
+}
+
+QStringList MotorGroup::ports() const
+{
+	return mPorts;
+}
+
+void MotorGroup::setPower(const QVector<int> &powers)
+{
+	if (powers.size() != mMotors.size()) {
+		QLOG_ERROR() << "Motor group" << mPorts << "got" << powers.size() << "powers instead of" << mMotors.size();
+		return;
+	}
+
+	trikHal::MspBatch batch;
+	batch.reserve(mMotors.size());
+	for (int i = 0; i < mMotors.size(); ++i) {
+		mMotors[i]->appendPowerCommand(powers[i], batch, true);
+	}
+
+	send(batch);
+}
+
+QVector<int> MotorGroup::power() const
+{
+	QVector<int> result;
+	result.reserve(mMotors.size());
+	for (const PowerMotor * const motor : mMotors) {
+		result << motor->power();
+	}
+
+	return result;
+}
+
+void MotorGroup::setPeriod(int period)
+{
+	trikHal::MspBatch batch;
+	batch.reserve(mMotors.size());
+	for (PowerMotor * const motor : mMotors) {
+		motor->appendPeriodCommand(period, batch, true);
+	}
+
+	send(batch);
+}
+
+void MotorGroup::powerOff()
+{
+	trikHal::MspBatch batch;
+	batch.reserve(mMotors.size());
+	for (PowerMotor * const motor : mMotors) {
+		motor->appendPowerCommand(0, batch, false);
+	}
+
+	send(batch);
+}
+
+void MotorGroup::send(trikHal::MspBatch &batch)
+{
+	if (!batch.isEmpty()) {
+		mCommunicator.transaction(batch);
+	}
+}
@@ -0,0 +1,67 @@
+/* Copyright 2016 CyberTech Labs Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License. */
+
+
+#pragma once
+
+#include <QtCore/QList>
+
+#include <trikHal/mspBatchOperation.h>
+
+#include "motorGroupInterface.h"
+
+namespace trikControl {
+
+class MspCommunicatorInterface;
+class PowerMotor;
+
+/// Implementation of a group of power motors sharing one MSP communicator.
+class MotorGroup : public MotorGroupInterface
+{
+	Q_OBJECT
+
+public:
+	/// Constructor.
+	/// @param ports - ports of motors, in the same order as "motors".
+	/// @param motors - motors in a group, shall outlive the group.
+	/// @param communicator - communicator used by motors, all commands of one update are sent through it as one
+	///        transaction.
+	MotorGroup(const QStringList &ports, const QList<PowerMotor *> &motors, MspCommunicatorInterface &communicator);
+
+	Status status() const override;
+
+	/// Returns true if given motor is in a group.
+	bool contains(PowerMotor *motor) const;
+
+public slots:
+	QStringList ports() const override;
+
+	void setPower(const QVector<int> &powers) override;
+
+	QVector<int> power() const override;
+
+	void setPeriod(int period) override;
+
+	void powerOff() override;
+
+private:
+	/// Sends batch as one transaction if it is not empty.
+	void send(trikHal::MspBatch &batch);
+
+	const QStringList mPorts;
+	const QList<PowerMotor *> mMotors;  // Does not have ownership.
+	MspCommunicatorInterface &mCommunicator;
+};
+
+}
@@ -0,0 +1,359 @@
+/* Copyright 2016 CyberTech Labs Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License. */
+
+
+#include "mspBusScheduler.h"
+
+#include <QtCore/QThread>
+
+#include <trikKernel/timestamp.h>
+
+#include <QsLog.h>
+
+using namespace trikControl;
+
+namespace {
+
+/// Number of request classes.
+const int classCount = 3;
+
+/// Maximal queueing delay of requests of each class, in nanoseconds. Motor commands shall reach the bus within
+/// a few milliseconds, control loops tolerate about one tick, background polling may wait much longer.
+const qint64 deadlines[classCount] = { 5000000, 20000000, 200000000 };
+
+/// Number of consecutive grants to other classes after which a waiting class is served out of priority order.
+const int fairnessLimit = 8;
+
+/// Maximal number of asynchronous requests sent as one bus transaction.
+const int maxAsyncBatch = 16;
+
+/// Names of classes for logging.
+const char * const classNames[classCount] = { "actuator", "control loop", "background" };
+
+qint64 now()
+{
+	return trikKernel::Timestamp::now().toNsec();
+}
+
+}
+
+/// Holds the bus while alive.
+class MspBusScheduler::Grant
+{
+public:
+	Grant(MspBusScheduler &scheduler, RequestClass requestClass)
+		: mScheduler(scheduler)
+	{
+		mScheduler.acquire(requestClass);
+	}
+
+	~Grant()
+	{
+		mScheduler.release();
+	}
+
+private:
+	MspBusScheduler &mScheduler;
+};
+
+/// Thread that executes asynchronous requests, highest class first.
+class MspBusScheduler::AsyncWorker : public QThread
+{
+public:
+	explicit AsyncWorker(MspBusScheduler &scheduler)
+		: mScheduler(scheduler)
+		, mQueues(classCount)
+	{
+	}
+
+	/// Queues request, returns false if the worker is stopped.
+	bool enqueue(RequestClass requestClass, const trikHal::MspCommand &command
+			, const MspCommunicatorInterface::ReadCallback &onRead)
+	{
+		QMutexLocker locker(&mMutex);
+		if (mStopping) {
+			return false;
+		}
+
+		mQueues[static_cast<int>(requestClass)].append({command, onRead});
+		mQueued.wakeOne();
+		return true;
+	}
+
+	/// Executes pending requests and waits for thread to finish.
+	void finish()
+	{
+		{
+			QMutexLocker locker(&mMutex);
+			mStopping = true;
+			mQueued.wakeOne();
+		}
+
+		wait();
+	}
+
+protected:
+	void run() override
+	{
+		forever {
+			trikHal::MspBatch batch;
+			QList<MspCommunicatorInterface::ReadCallback> callbacks;
+			RequestClass requestClass = RequestClass::background;
+
+			{
+				QMutexLocker locker(&mMutex);
+				int index = 0;
+				while ((index = nonEmptyQueue()) < 0 && !mStopping) {
+					mQueued.wait(&mMutex);
+				}
+
+				if (index < 0) {
+					return;
+				}
+
+				requestClass = static_cast<RequestClass>(index);
+				QList<Request> &queue = mQueues[index];
+				while (!queue.isEmpty() && batch.size() < maxAsyncBatch) {
+					const Request request = queue.takeFirst();
+					batch << trikHal::MspBatchOperation{request.command, 0};
+					callbacks << request.onRead;
+				}
+			}
+
+			{
+				Grant grant(mScheduler, requestClass);
+				mScheduler.mCommunicator->transaction(batch);
+			}
+
+			for (int i = 0; i < batch.size(); ++i) {
+				if (callbacks[i]) {
+					callbacks[i](batch[i].result);
+				}
+			}
+		}
+	}
+
+private:
+	struct Request
+	{
+		trikHal::MspCommand command;
+		MspCommunicatorInterface::ReadCallback onRead;
+	};
+
+	/// Returns index of highest priority class having pending requests, or -1. Shall be called with mMutex locked.
+	int nonEmptyQueue() const
+	{
+		for (int i = 0; i < classCount; ++i) {
+			if (!mQueues[i].isEmpty()) {
+				return i;
+			}
+		}
+
+		return -1;
+	}
+
+	MspBusScheduler &mScheduler;
+	QMutex mMutex;
+	QWaitCondition mQueued;
+	QVector<QList<Request>> mQueues;
+	bool mStopping = false;
+};
+
+/// Communicator that executes requests through the scheduler with a given request class.
+class MspBusScheduler::Channel : public MspCommunicatorInterface
+{
+public:
+	Channel(MspBusScheduler &scheduler, RequestClass requestClass)
+		: mScheduler(scheduler)
+		, mRequestClass(requestClass)
+	{
+	}
+
+	void send(const trikHal::MspCommand &command) override
+	{
+		Grant grant(mScheduler, mRequestClass);
+		mScheduler.mCommunicator->send(command);
+	}
+
+	int read(const trikHal::MspCommand &command) override
+	{
+		Grant grant(mScheduler, mRequestClass);
+		return mScheduler.mCommunicator->read(command);
+	}
+
+	void transaction(trikHal::MspBatch &batch) override
+	{
+		Grant grant(mScheduler, mRequestClass);
+		mScheduler.mCommunicator->transaction(batch);
+	}
+
+	void readAsync(const trikHal::MspCommand &command, const ReadCallback &onRead) override
+	{
+		if (!mScheduler.mAsyncWorker->enqueue(mRequestClass, command, onRead)) {
+			onRead(read(command));
+		}
+	}
+
+	void sendAsync(const trikHal::MspCommand &command) override
+	{
+		if (!mScheduler.mAsyncWorker->enqueue(mRequestClass, command, ReadCallback())) {
+			send(command);
+		}
+	}
+
+	Status status() const override
+	{
+		return mScheduler.mCommunicator->status();
+	}
+
+private:
+	MspBusScheduler &mScheduler;
+	const RequestClass mRequestClass;
+};
+
+MspBusScheduler::MspBusScheduler(MspCommunicatorInterface *communicator)
+	: mCommunicator(communicator)
+	, mQueues(classCount)
+	, mBypassed(classCount, 0)
+	, mMetrics(classCount)
+{
+	for (int i = 0; i < classCount; ++i) {
+		mChannels << new Channel(*this, static_cast<RequestClass>(i));
+	}
+
+	mAsyncWorker.reset(new AsyncWorker(*this));
+	mAsyncWorker->start();
+}
+
+MspBusScheduler::~MspBusScheduler()
+{
+	finishAsyncRequests();
+
+	for (int i = 0; i < classCount; ++i) {
+		const ClassMetrics &metrics = mMetrics[i];
+		if (metrics.requests > 0) {
+			QLOG_INFO() << "MSP bus," << classNames[i] << "requests:" << metrics.requests
+					<< "mean queueing delay" << metrics.totalQueueingDelay / metrics.requests / 1000 << "us,"
+					<< "max" << metrics.maxQueueingDelay / 1000 << "us,"
+					<< "deadline misses" << metrics.deadlineMisses;
+		}
+	}
+
+	qDeleteAll(mChannels);
+}
+
+MspCommunicatorInterface &MspBusScheduler::channel(RequestClass requestClass)
+{
+	return *mChannels[static_cast<int>(requestClass)];
+}
+
+MspBusScheduler::ClassMetrics MspBusScheduler::metrics(RequestClass requestClass) const
+{
+	QMutexLocker locker(&mMutex);
+	return mMetrics[static_cast<int>(requestClass)];
+}
+
+void MspBusScheduler::finishAsyncRequests()
+{
+	mAsyncWorker->finish();
+}
+
+void MspBusScheduler::acquire(RequestClass requestClass)
+{
+	const int index = static_cast<int>(requestClass);
+	const qint64 enqueued = now();
+	Ticket ticket{requestClass, enqueued, enqueued + deadlines[index]};
+
+	QMutexLocker locker(&mMutex);
+	mQueues[index].append(&ticket);
+
+	if (!mBusy && mGranted == nullptr) {
+		// Bus is free and nobody is waiting for it.
+		mGranted = &ticket;
+	}
+
+	while (mGranted != &ticket) {
+		mBusFreed.wait(&mMutex);
+	}
+
+	mQueues[index].removeFirst();
+	mGranted = nullptr;
+	mBusy = true;
+
+	for (int i = 0; i < classCount; ++i) {
+		if (i == index) {
+			mBypassed[i] = 0;
+		} else if (!mQueues[i].isEmpty()) {
+			++mBypassed[i];
+		}
+	}
+
+	const qint64 granted = now();
+	const qint64 delay = granted - enqueued;
+	ClassMetrics &metrics = mMetrics[index];
+	++metrics.requests;
+	metrics.totalQueueingDelay += delay;
+	metrics.maxQueueingDelay = qMax(metrics.maxQueueingDelay, delay);
+	if (granted > ticket.deadline) {
+		++metrics.deadlineMisses;
+	}
+}
+
+void MspBusScheduler::release()
+{
+	QMutexLocker locker(&mMutex);
+	mBusy = false;
+	mGranted = next(now());
+
+	// Every waiter checks whether it is the selected one, so all of them shall be woken up. There are only a few
+	// threads talking to the bus, so it is cheap.
+	mBusFreed.wakeAll();
+}
+
+MspBusScheduler::Ticket *MspBusScheduler::next(qint64 now) const
+{
+	// Overdue requests first, earliest deadline first.
+	Ticket *overdue = nullptr;
+	for (const QList<Ticket *> &queue : mQueues) {
+		if (!queue.isEmpty() && queue.first()->deadline < now
+				&& (overdue == nullptr || queue.first()->deadline < overdue->deadline))
+		{
+			overdue = queue.first();
+		}
+	}
+
+	if (overdue != nullptr) {
+		return overdue;
+	}
+
+	const int actuator = static_cast<int>(RequestClass::actuator);
+	if (!mQueues[actuator].isEmpty()) {
+		return mQueues[actuator].first();
+	}
+
+	// Then a class that was bypassed too many times, to avoid starvation of background polling.
+	for (int i = classCount - 1; i > actuator; --i) {
+		if (!mQueues[i].isEmpty() && mBypassed[i] >= fairnessLimit) {
+			return mQueues[i].first();
+		}
+	}
+
+	for (const QList<Ticket *> &queue : mQueues) {
+		if (!queue.isEmpty()) {
+			return queue.first();
+		}
+	}
+
+	return nullptr;
+}
@@ -0,0 +1,130 @@
+/* Copyright 2016 CyberTech Labs Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License. */
+
+
+#pragma once
+
+#include <QtCore/QList>
+#include <QtCore/QMutex>
+#include <QtCore/QScopedPointer>
+#include <QtCore/QVector>
+#include <QtCore/QWaitCondition>
+
+#include "mspCommunicatorInterface.h"
+
+namespace trikControl {
+
+/// Arbitrates access to MSP bus between devices of different importance. Each device talks to the bus through
+/// a channel of its request class, and when the bus is busy, waiting requests are granted the bus by class
+/// priority instead of in order of arrival, so motor commands do not wait behind slow sensor reads or polling.
+///
+/// Every class has a deadline for queueing delay. Requests that waited longer than their deadline are served first,
+/// earliest deadline first, and a lower class that was bypassed too many times in a row is served before
+/// other non-actuator classes, so background polling is delayed but never starved.
+///
+/// Asynchronous requests of channels are executed on a dedicated bus thread. Pending requests of one class are
+/// sent as one bus transaction, so USB bus can pipeline them.
+class MspBusScheduler
+{
+public:
+	/// Classes of bus requests, in order of decreasing priority.
+	enum class RequestClass
+	{
+		/// Motor commands.
+		actuator
+
+		/// Sensor reads done by control loops: analog sensors, encoders.
+		, controlLoop
+
+		/// Battery polling, telemetry, GUI indicators.
+		, background
+	};
+
+	/// Queueing statistics of one request class.
+	struct ClassMetrics
+	{
+		/// Number of requests that were granted the bus.
+		quint64 requests = 0;
+
+		/// Number of requests that waited for the bus longer than class deadline.
+		quint64 deadlineMisses = 0;
+
+		/// Total time requests waited for the bus, in nanoseconds.
+		qint64 totalQueueingDelay = 0;
+
+		/// Maximal time a request waited for the bus, in nanoseconds.
+		qint64 maxQueueingDelay = 0;
+	};
+
+	/// Constructor.
+	/// @param communicator - communicator of actual bus. Takes ownership.
+	explicit MspBusScheduler(MspCommunicatorInterface *communicator);
+
+	~MspBusScheduler();
+
+	/// Returns communicator that executes requests of a given class through this scheduler. Channels are owned by
+	/// the scheduler and are valid while it is alive.
+	MspCommunicatorInterface &channel(RequestClass requestClass);
+
+	/// Returns queueing statistics of a given class since scheduler creation.
+	ClassMetrics metrics(RequestClass requestClass) const;
+
+	/// Executes pending asynchronous requests and stops bus thread, later asynchronous requests are executed
+	/// synchronously. Shall be called before destruction of devices that may have requests in flight.
+	void finishAsyncRequests();
+
+private:
+	class Channel;
+	class Grant;
+	class AsyncWorker;
+
+	/// Request waiting for the bus.
+	struct Ticket
+	{
+		RequestClass requestClass;
+		qint64 enqueued;
+		qint64 deadline;
+	};
+
+	/// Blocks until bus is granted to a request of a given class.
+	void acquire(RequestClass requestClass);
+
+	/// Frees the bus and wakes up waiting requests.
+	void release();
+
+	/// Selects request that shall get the bus next, or returns nullptr if there are no waiting requests. Shall be
+	/// called with mMutex locked.
+	Ticket *next(qint64 now) const;
+
+	QScopedPointer<MspCommunicatorInterface> mCommunicator;
+	QList<Channel *> mChannels;  // Has ownership.
+	QScopedPointer<AsyncWorker> mAsyncWorker;
+
+	mutable QMutex mMutex;
+	QWaitCondition mBusFreed;
+	bool mBusy = false;
+
+	/// Request that is selected to get the bus and is being woken up, bus is reserved for it.
+	Ticket *mGranted = nullptr;
+
+	/// Waiting requests of each class, in order of arrival.
+	QVector<QList<Ticket *>> mQueues;
+
+	/// Number of consecutive grants to other classes while class has waiting requests.
+	QVector<int> mBypassed;
+
+	QVector<ClassMetrics> mMetrics;
+};
+
+}
@@ -14,7 +14,10 @@
 
 #pragma once
 
-#include <QtCore/QByteArray>
+#include <functional>
+
+#include <trikHal/mspBatchOperation.h>
+#include <trikHal/mspCommand.h>
 
 #include "deviceInterface.h"
 #include "deviceState.h"
@@ -26,11 +29,32 @@ namespace trikControl {
 class MspCommunicatorInterface : public DeviceInterface
 {
 public:
-	/// Send data to current device, if it is connected.
-	virtual void send(const QByteArray &data) = 0;
+	/// Called with a result of asynchronous read.
+	typedef std::function<void(int value)> ReadCallback;
+
+	/// Executes write command on current device, if it is connected.
+	virtual void send(const trikHal::MspCommand &command) = 0;
+
+	/// Executes read command and returns the result.
+	virtual int read(const trikHal::MspCommand &command) = 0;
+
+	/// Executes a list of reads and writes as one bus transaction where bus supports it, holding the bus for the
+	/// whole batch. Results of reads are stored into corresponding operations.
+	virtual void transaction(trikHal::MspBatch &batch) = 0;
+
+	/// Queues read command and returns immediately. "onRead" is called with the result,
+	/// possibly from another thread. Default implementation reads synchronously, communicators having a bus thread
+	/// execute request there.
+	virtual void readAsync(const trikHal::MspCommand &command, const ReadCallback &onRead)
+	{
+		onRead(read(command));
+	}
 
-	/// Reads data by given I2C command number and returns the result.
-	virtual int read(const QByteArray &data) = 0;
+	/// Queues write command and returns immediately. Default implementation sends synchronously.
+	virtual void sendAsync(const trikHal::MspCommand &command)
+	{
+		send(command);
+	}
 };
 
 }
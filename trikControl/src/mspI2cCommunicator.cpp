@@ -49,7 +49,7 @@ MspI2cCommunicator::~MspI2cCommunicator()
 	}
 }
 
-void MspI2cCommunicator::send(const QByteArray &data)
+void MspI2cCommunicator::send(const trikHal::MspCommand &command)
 {
 	if (!mState.isReady()) {
 		QLOG_ERROR() << "Trying to send data through I2C communicator which is not ready, ignoring";
@@ -57,10 +57,10 @@ void MspI2cCommunicator::send(const QByteArray &data)
 	}
 
 	QMutexLocker lock(&mLock);
-	mI2c.send(data);
+	mI2c.send(command);
 }
 
-int MspI2cCommunicator::read(const QByteArray &data)
+int MspI2cCommunicator::read(const trikHal::MspCommand &command)
 {
 	if (!mState.isReady()) {
 		QLOG_ERROR() << "Trying to read data from I2C communicator which is not ready, ignoring";
@@ -68,7 +68,18 @@ int MspI2cCommunicator::read(const QByteArray &data)
 	}
 
 	QMutexLocker lock(&mLock);
-	return mI2c.read(data);
+	return mI2c.read(command);
+}
+
+void MspI2cCommunicator::transaction(trikHal::MspBatch &batch)
+{
+	if (!mState.isReady()) {
+		QLOG_ERROR() << "Trying to execute transaction through I2C communicator which is not ready, ignoring";
+		return;
+	}
+
+	QMutexLocker lock(&mLock);
+	mI2c.transaction(batch);
 }
 
 DeviceInterface::Status MspI2cCommunicator::status() const
@@ -39,11 +39,13 @@ public:
 
 	~MspI2cCommunicator() override;
 
-	/// Send data to current device, if it is connected.
-	void send(const QByteArray &data) override;
+	/// Executes write command on current device, if it is connected.
+	void send(const trikHal::MspCommand &command) override;
 
-	/// Reads data by given I2C command number and returns the result.
-	int read(const QByteArray &data) override;
+	/// Executes read command and returns the result.
+	int read(const trikHal::MspCommand &command) override;
+
+	void transaction(trikHal::MspBatch &batch) override;
 
 	Status status() const override;
 
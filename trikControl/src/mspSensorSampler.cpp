@@ -0,0 +1,176 @@
+/* Copyright 2016 CyberTech Labs Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License. */
+
+#include "mspSensorSampler.h"
+
+#include <QtCore/QMutexLocker>
+
+#include "mspCommunicatorInterface.h"
+
+using namespace trikControl;
+
+namespace {
+
+const qint64 nsecPerMsec = 1000000;
+
+}
+
+MspSensorSampler::Source::Source(MspCommunicatorInterface &communicator, const trikHal::MspCommand &command
+		, qint64 period, const SampleCallback &onSample)
+	: mCommunicator(communicator)
+	, mCommand(command)
+	, mPeriod(period)
+	, mOnSample(onSample)
+{
+}
+
+MspSensorSampler::Sample MspSensorSampler::Source::latest() const
+{
+	return mSample.get();
+}
+
+bool MspSensorSampler::Source::hasSample() const
+{
+	return mSample.version() != 0;
+}
+
+MspSensorSampler::~MspSensorSampler()
+{
+	stop();
+	qDeleteAll(mSources);
+}
+
+MspSensorSampler::Source *MspSensorSampler::addSource(MspCommunicatorInterface &communicator
+		, const trikHal::MspCommand &command, int period, const SampleCallback &onSample)
+{
+	Source * const source = new Source(communicator, command, qMax(period, 1) * nsecPerMsec, onSample);
+
+	QMutexLocker locker(&mMutex);
+	mSources << source;
+	mSourcesChanged.wakeOne();
+
+	if (!isRunning() && !mStopping) {
+		start();
+	}
+
+	return source;
+}
+
+void MspSensorSampler::removeSource(Source *source)
+{
+	QMutexLocker locker(&mMutex);
+	mSources.removeOne(source);
+
+	// Sampler thread reads sources with mMutex unlocked, so only a source from its current pass needs to be waited for.
+	while (source->mInUse) {
+		mSourcesReleased.wait(&mMutex);
+	}
+
+	delete source;
+}
+
+void MspSensorSampler::stop()
+{
+	{
+		QMutexLocker locker(&mMutex);
+		mStopping = true;
+		mSourcesChanged.wakeOne();
+	}
+
+	wait();
+}
+
+void MspSensorSampler::run()
+{
+	QMutexLocker locker(&mMutex);
+	while (!mStopping) {
+		const qint64 now = trikKernel::Timestamp::now().toNsec();
+		qint64 nextDue = -1;
+		const QList<Source *> due = takeDueSources(now, nextDue);
+		if (!due.isEmpty()) {
+			locker.unlock();
+			sampleSources(due);
+			locker.relock();
+
+			for (Source * const source : due) {
+				source->mInUse = false;
+			}
+
+			mSourcesReleased.wakeAll();
+		} else if (nextDue < 0) {
+			mSourcesChanged.wait(&mMutex);
+		} else {
+			// Rounded up, so the thread does not wake up just before the source becomes due.
+			mSourcesChanged.wait(&mMutex, (nextDue - now + nsecPerMsec - 1) / nsecPerMsec);
+		}
+	}
+}
+
+QList<MspSensorSampler::Source *> MspSensorSampler::takeDueSources(qint64 now, qint64 &nextDue)
+{
+	QList<Source *> due;
+	for (Source * const source : mSources) {
+		if (source->mNextDue <= now) {
+			source->mInUse = true;
+			due << source;
+		} else if (nextDue < 0 || source->mNextDue < nextDue) {
+			nextDue = source->mNextDue;
+		}
+	}
+
+	return due;
+}
+
+void MspSensorSampler::sampleSources(QList<Source *> sources)
+{
+	// Sources of one communicator are read as one transaction, in order of registration.
+	while (!sources.isEmpty()) {
+		MspCommunicatorInterface &communicator = sources.first()->mCommunicator;
+		QList<Source *> batchSources;
+		trikHal::MspBatch batch;
+		for (auto it = sources.begin(); it != sources.end(); ) {
+			if (&(*it)->mCommunicator == &communicator) {
+				batchSources << *it;
+				batch << trikHal::MspBatchOperation{(*it)->mCommand, 0};
+				it = sources.erase(it);
+			} else {
+				++it;
+			}
+		}
+
+		// Readings of a failed bus are not published, so readers do not mistake them for real values.
+		const bool ready = communicator.status() == DeviceInterface::Status::ready;
+		const qint64 sampled = trikKernel::Timestamp::now().toNsec();
+		if (ready) {
+			communicator.transaction(batch);
+		}
+
+		for (int i = 0; i < batchSources.size(); ++i) {
+			Source * const source = batchSources[i];
+			if (ready) {
+				const Sample sample{batch[i].result, trikKernel::Timestamp(sampled)};
+				source->mSample.set(sample);
+				if (source->mOnSample) {
+					source->mOnSample(sample);
+				}
+			}
+
+			// Keeps the rate when the thread was late for less than a period, otherwise skips missed samples.
+			// Written only by sampler thread, so it needs no lock.
+			source->mNextDue = source->mNextDue + source->mPeriod > sampled
+					? source->mNextDue + source->mPeriod
+					: sampled + source->mPeriod;
+		}
+	}
+}
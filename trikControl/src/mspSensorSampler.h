@@ -0,0 +1,124 @@
+/* Copyright 2016 CyberTech Labs Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License. */
+
+#pragma once
+
+#include <functional>
+
+#include <QtCore/QList>
+#include <QtCore/QMutex>
+#include <QtCore/QThread>
+#include <QtCore/QWaitCondition>
+
+#include <trikHal/mspCommand.h>
+#include <trikKernel/seqLock.h>
+#include <trikKernel/timestamp.h>
+
+namespace trikControl {
+
+class MspCommunicatorInterface;
+
+/// Polls MSP sensors on one thread, each with its own period, and publishes their latest readings. Readers get
+/// a reading without locking and without touching the bus, so scripts, GUI and telemetry reading the same sensor
+/// share one bus request. Sources that are due at the same time and use the same communicator are read as one
+/// bus transaction.
+class MspSensorSampler : public QThread
+{
+public:
+	/// Timestamped reading of a sensor.
+	struct Sample
+	{
+		/// Raw value read from the register.
+		int value = 0;
+
+		/// Time when the bus transaction that read the value started, zero if the source was not sampled yet.
+		/// Everything written to the bus before that time is reflected in the value.
+		trikKernel::Timestamp timestamp;
+	};
+
+	/// Called from sampler thread with every new sample of a source.
+	typedef std::function<void(const Sample &sample)> SampleCallback;
+
+	/// Register polled by the sampler.
+	class Source
+	{
+	public:
+		/// Returns the latest reading. Does not lock, so it may be called from any thread.
+		Sample latest() const;
+
+		/// Returns true if the source was sampled at least once.
+		bool hasSample() const;
+
+	private:
+		friend class MspSensorSampler;
+
+		Source(MspCommunicatorInterface &communicator, const trikHal::MspCommand &command, qint64 period
+				, const SampleCallback &onSample);
+
+
+		MspCommunicatorInterface &mCommunicator;
+		const trikHal::MspCommand mCommand;
+
+		/// Sampling period, in nanoseconds.
+		const qint64 mPeriod;
+
+		/// Time when the source shall be read next, in nanoseconds.
+		qint64 mNextDue = 0;
+
+		/// Latest reading, written only by sampler thread.
+		trikKernel::SeqLock<Sample> mSample;
+
+		/// True while sampler thread reads the source with mMutex unlocked. Guarded by mMutex.
+		bool mInUse = false;
+
+		const SampleCallback mOnSample;
+	};
+
+	~MspSensorSampler() override;
+
+	/// Registers a register to be read every "period" milliseconds. Returned source is owned by the sampler and is
+	/// valid until removeSource() is called. Starts the sampler thread if needed.
+	/// @param onSample - optional callback called from sampler thread with every new sample.
+	Source *addSource(MspCommunicatorInterface &communicator, const trikHal::MspCommand &command, int period
+			, const SampleCallback &onSample = SampleCallback());
+
+	/// Stops polling of a source and deletes it. When this method returns, the source is not being read anymore and
+	/// its callback is not running, so its communicator and callback owner may be deleted.
+	void removeSource(Source *source);
+
+	/// Stops the sampler thread. Sources keep their last readings.
+	void stop();
+
+protected:
+	void run() override;
+
+private:
+	/// Marks sources that are due as in use and returns them, puts time when the next source is due or -1 if there
+	/// are no other sources to "nextDue". Shall be called with mMutex locked.
+	QList<Source *> takeDueSources(qint64 now, qint64 &nextDue);
+
+	/// Reads given sources and publishes their readings. Called with mMutex unlocked, so adding and removing sources
+	/// does not wait for the bus.
+	static void sampleSources(QList<Source *> sources);
+
+	QList<Source *> mSources;  // Has ownership.
+	QMutex mMutex;
+	QWaitCondition mSourcesChanged;
+
+	/// Woken when sampler thread stops using sources read with mMutex unlocked.
+	QWaitCondition mSourcesReleased;
+	bool mStopping = false;
+};
+
+}
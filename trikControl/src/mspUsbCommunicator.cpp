@@ -21,12 +21,17 @@
 
 using namespace trikControl;
 
+/// Interval of bus polling, in ms. URM04 measurement takes 400 ms, so it is fine enough.
+static const int pollInterval = 50;
+
 MspUsbCommunicator::MspUsbCommunicator(trikHal::MspUsbInterface &usb)
 	: mUsb(usb)
 	, mState("MSP USB Communicator")
 {
 	if (mUsb.connect()) {
 		mState.ready();
+		connect(&mPollTimer, SIGNAL(timeout()), this, SLOT(poll()));
+		mPollTimer.start(pollInterval);
 	} else {
 		mState.fail();
 	}
@@ -39,7 +44,7 @@ MspUsbCommunicator::~MspUsbCommunicator()
 	}
 }
 
-void MspUsbCommunicator::send(const QByteArray &data)
+void MspUsbCommunicator::send(const trikHal::MspCommand &command)
 {
 	if (!mState.isReady()) {
 		QLOG_ERROR() << "Trying to send data through USB I2C communicator which is not ready, ignoring";
@@ -47,10 +52,10 @@ void MspUsbCommunicator::send(const QByteArray &data)
 	}
 
 	QMutexLocker lock(&mLock);
-	mUsb.send(data);
+	mUsb.send(command);
 }
 
-int MspUsbCommunicator::read(const QByteArray &data)
+int MspUsbCommunicator::read(const trikHal::MspCommand &command)
 {
 	if (!mState.isReady()) {
 		QLOG_ERROR() << "Trying to read data from USB I2C communicator which is not ready, ignoring";
@@ -58,7 +63,28 @@ int MspUsbCommunicator::read(const QByteArray &data)
 	}
 
 	QMutexLocker lock(&mLock);
-	return mUsb.read(data);
+	return mUsb.read(command);
+}
+
+void MspUsbCommunicator::transaction(trikHal::MspBatch &batch)
+{
+	if (!mState.isReady()) {
+		QLOG_ERROR() << "Trying to execute transaction through USB communicator which is not ready, ignoring";
+		return;
+	}
+
+	QMutexLocker lock(&mLock);
+	mUsb.transaction(batch);
+}
+
+void MspUsbCommunicator::poll()
+{
+	if (!mState.isReady()) {
+		return;
+	}
+
+	QMutexLocker lock(&mLock);
+	mUsb.poll();
 }
 
 DeviceInterface::Status MspUsbCommunicator::status() const
@@ -68,6 +94,7 @@ DeviceInterface::Status MspUsbCommunicator::status() const
 
 void MspUsbCommunicator::disconnect()
 {
+	mPollTimer.stop();
 	mState.stop();
 	QMutexLocker lock(&mLock);
 	mUsb.disconnect();
@@ -14,8 +14,10 @@
 
 #pragma once
 
+#include <QtCore/QObject>
 #include <QtCore/QString>
 #include <QtCore/QMutex>
+#include <QtCore/QTimer>
 
 #include "mspCommunicatorInterface.h"
 
@@ -29,9 +31,12 @@ class MspUsbInterface;
 
 namespace trikControl {
 
-/// Provides direct interaction with I2C device.
-class MspUsbCommunicator : public MspCommunicatorInterface
+/// Provides direct interaction with I2C device. Periodically polls the bus to advance long operations, like URM04
+/// ranging, without blocking readers.
+class MspUsbCommunicator : public QObject, public MspCommunicatorInterface
 {
+	Q_OBJECT
+
 public:
 	/// Constructor.
 	/// @param usb - USB bus communicator.
@@ -39,20 +44,29 @@ public:
 
 	~MspUsbCommunicator() override;
 
-	/// Send data to current device, if it is connected.
-	void send(const QByteArray &data) override;
+	/// Executes write command on current device, if it is connected.
+	void send(const trikHal::MspCommand &command) override;
+
+	/// Executes read command and returns the result.
+	int read(const trikHal::MspCommand &command) override;
 
-	/// Reads data by given I2C command number and returns the result.
-	int read(const QByteArray &data) override;
+	void transaction(trikHal::MspBatch &batch) override;
 
 	Status status() const override;
 
+private slots:
+	/// Advances long operations on the bus.
+	void poll();
+
 private:
 	void disconnect();
 
 	QMutex mLock;
 	trikHal::MspUsbInterface &mUsb;
 	DeviceState mState;
+
+	/// Timer for polling the bus.
+	QTimer mPollTimer;
 };
 
 }
@@ -0,0 +1,149 @@
+/* Copyright 2016 CyberTech Labs Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License. */
+
+#include "orientation.h"
+
+#include <QtCore/qmath.h>
+
+#include <trikKernel/configurer.h>
+#include <trikKernel/timestamp.h>
+#include <QsLog.h>
+
+#include "vectorSensorInterface.h"
+
+using namespace trikControl;
+
+static qreal toDegrees(qreal radians)
+{
+	return radians * 180 / M_PI;
+}
+
+Orientation::Orientation(const trikKernel::Configurer &configurer, VectorSensorInterface &accelerometer
+		, VectorSensorInterface &gyroscope)
+	: mAccelerometer(accelerometer)
+	, mGyroscope(gyroscope)
+{
+	// Gyroscope scale is configured in millidegrees per second per unit of raw reading.
+	mGyroscopeScale = configurer.attributeByDevice("orientation", "gyroscopeScale").toDouble() / 1000 * M_PI / 180;
+	mFilter.setGain(configurer.attributeByDevice("orientation", "gain").toDouble());
+
+	mCalibrationTimer.setSingleShot(true);
+	connect(&mCalibrationTimer, SIGNAL(timeout()), this, SLOT(finishCalibration()));
+
+	connect(&mAccelerometer, SIGNAL(newData(QVector<int>,trikKernel::Timestamp))
+			, this, SLOT(onAccelerometerData(QVector<int>)));
+	connect(&mGyroscope, SIGNAL(newData(QVector<int>,trikKernel::Timestamp))
+			, this, SLOT(onGyroscopeData(QVector<int>,trikKernel::Timestamp)));
+
+	const int calibrationTime = configurer.attributeByDevice("orientation", "calibrationTime").toInt();
+	if (calibrationTime > 0) {
+		calibrate(calibrationTime);
+	}
+}
+
+Orientation::Status Orientation::status() const
+{
+	return combine(mAccelerometer, mGyroscope.status());
+}
+
+QVector<qreal> Orientation::quaternion() const
+{
+	const trikKernel::OrientationFilter::Quaternion orientation = mEstimate.get().orientation;
+	return {orientation.w, orientation.x, orientation.y, orientation.z};
+}
+
+QVector<qreal> Orientation::eulerAngles() const
+{
+	const trikKernel::OrientationFilter::EulerAngles angles = mEstimate.get().angles;
+	return {toDegrees(angles.roll), toDegrees(angles.pitch), toDegrees(angles.yaw)};
+}
+
+qreal Orientation::heading() const
+{
+	return toDegrees(mEstimate.get().heading);
+}
+
+void Orientation::resetHeading()
+{
+	QMetaObject::invokeMethod(this, "doResetHeading", Qt::QueuedConnection);
+}
+
+void Orientation::calibrate(int msec)
+{
+	mCalibrating.storeRelease(1);
+	QMetaObject::invokeMethod(this, "startCalibration", Qt::QueuedConnection, Q_ARG(int, msec));
+}
+
+bool Orientation::isCalibrating() const
+{
+	return mCalibrating.loadAcquire() != 0;
+}
+
+void Orientation::onAccelerometerData(const QVector<int> &reading)
+{
+	if (reading.size() == 3) {
+		mFilter.updateAccelerometer(reading[0], reading[1], reading[2]);
+	}
+}
+
+void Orientation::onGyroscopeData(const QVector<int> &reading, const trikKernel::Timestamp &eventTime)
+{
+	if (reading.size() != 3) {
+		return;
+	}
+
+	mFilter.updateGyroscope(eventTime, reading[0] * mGyroscopeScale, reading[1] * mGyroscopeScale
+			, reading[2] * mGyroscopeScale);
+
+	if (!mFilter.isCalibrating()) {
+		publish();
+	}
+}
+
+void Orientation::startCalibration(int msec)
+{
+	QLOG_INFO() << "Calibrating gyroscope for" << msec << "ms";
+	mFilter.startCalibration();
+	mCalibrationTimer.start(msec);
+}
+
+void Orientation::finishCalibration()
+{
+	const bool success = mFilter.finishCalibration();
+	if (success) {
+		QLOG_INFO() << "Gyroscope calibrated, bias is" << mFilter.bias(0) << mFilter.bias(1) << mFilter.bias(2)
+				<< "rad/s";
+	} else {
+		QLOG_WARN() << "Gyroscope calibration failed, no readings from gyroscope";
+	}
+
+	publish();
+	mCalibrating.storeRelease(0);
+	emit calibrationFinished(success);
+}
+
+void Orientation::doResetHeading()
+{
+	mFilter.resetHeading();
+	publish();
+}
+
+void Orientation::publish()
+{
+	Estimate estimate;
+	estimate.orientation = mFilter.orientation();
+	estimate.angles = trikKernel::OrientationFilter::toEulerAngles(estimate.orientation);
+	estimate.heading = mFilter.heading();
+	mEstimate.set(estimate);
+}
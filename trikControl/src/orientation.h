@@ -0,0 +1,107 @@
+/* Copyright 2016 CyberTech Labs Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License. */
+
+
+#pragma once
+
+#include <QtCore/QAtomicInt>
+#include <QtCore/QTimer>
+
+#include <trikKernel/orientationFilter.h>
+#include <trikKernel/seqLock.h>
+
+#include "orientationInterface.h"
+
+namespace trikKernel {
+class Configurer;
+class Timestamp;
+}
+
+namespace trikControl {
+
+class VectorSensorInterface;
+
+/// Orientation estimator fed by accelerometer and gyroscope readings as soon as they arrive. Filter is updated in
+/// the thread of this object, results are published lock-free, so they can be read from any thread.
+class Orientation : public OrientationInterface
+{
+	Q_OBJECT
+
+public:
+	/// Constructor. Starts calibration at once if "calibrationTime" is configured and positive.
+	/// @param configurer - configurer object containing preparsed XML files with orientation parameters.
+	/// @param accelerometer - accelerometer, shall outlive this object.
+	/// @param gyroscope - gyroscope, shall outlive this object.
+	Orientation(const trikKernel::Configurer &configurer, VectorSensorInterface &accelerometer
+			, VectorSensorInterface &gyroscope);
+
+	Status status() const override;
+
+public slots:
+	QVector<qreal> quaternion() const override;
+
+	QVector<qreal> eulerAngles() const override;
+
+	qreal heading() const override;
+
+	void resetHeading() override;
+
+	void calibrate(int msec) override;
+
+	bool isCalibrating() const override;
+
+private slots:
+	void onAccelerometerData(const QVector<int> &reading);
+
+	void onGyroscopeData(const QVector<int> &reading, const trikKernel::Timestamp &eventTime);
+
+	/// Starts calibration in the thread of this object.
+	void startCalibration(int msec);
+
+	/// Called by calibration timer, finishes calibration and publishes new estimate.
+	void finishCalibration();
+
+	/// Resets heading in the thread of this object.
+	void doResetHeading();
+
+private:
+	/// Estimate published for readers.
+	struct Estimate
+	{
+		trikKernel::OrientationFilter::Quaternion orientation;
+		trikKernel::OrientationFilter::EulerAngles angles;
+		qreal heading = 0.0;
+	};
+
+	/// Copies current filter state to mEstimate.
+	void publish();
+
+	VectorSensorInterface &mAccelerometer;
+	VectorSensorInterface &mGyroscope;
+
+	/// Filter, used only from the thread of this object.
+	trikKernel::OrientationFilter mFilter;
+
+	/// Conversion factor from raw gyroscope reading to radians per second.
+	qreal mGyroscopeScale = 0.0;
+
+	trikKernel::SeqLock<Estimate> mEstimate;
+
+	/// Set when calibration is requested and cleared when it is finished.
+	QAtomicInt mCalibrating;
+
+	QTimer mCalibrationTimer;
+};
+
+}
@@ -59,24 +59,31 @@ void PowerMotor::setPower(int power, bool constrain)
 		throw trikKernel::InternalErrorException("Invalid argument");
 	}
 
-	if (power > maxControlValue) {
-		power = maxControlValue;
-	} else if (power < minControlValue) {
-		power = minControlValue;
-	}
-
-	mCurrentPower = power;
+	mLastPowerCommand = powerCommand(power);
+	mCommunicator.send(mLastPowerCommand);
+}
 
-	power = power <= 0 ? -mPowerMap[-power] : mPowerMap[power];
+void PowerMotor::appendPowerCommand(int power, trikHal::MspBatch &batch, bool dropUnchanged)
+{
+	const trikHal::MspCommand command = powerCommand(power);
+	if (dropUnchanged && command == mLastPowerCommand) {
+		return;
+	}
 
-	power = mInvert ? -power : power;
+	mLastPowerCommand = command;
+	batch << trikHal::MspBatchOperation{command, 0};
+}
 
-	QByteArray command(3, '\0');
-	command[0] = static_cast<char>(mMspCommandNumber & 0xFF);
-	command[1] = static_cast<char>((mMspCommandNumber >> 8) & 0xFF);
-	command[2] = static_cast<char>(power & 0xFF);
+void PowerMotor::appendPeriodCommand(int period, trikHal::MspBatch &batch, bool dropUnchanged)
+{
+	mCurrentPeriod = period;
+	const trikHal::MspCommand command = trikHal::MspCommand::writeWord((mMspCommandNumber - 4) & 0xFF, period);
+	if (dropUnchanged && command == mLastPeriodCommand) {
+		return;
+	}
 
-	mCommunicator.send(command);
+	mLastPeriodCommand = command;
+	batch << trikHal::MspBatchOperation{command, 0};
 }
 
 int PowerMotor::power() const
@@ -97,11 +104,8 @@ void PowerMotor::powerOff()
 void PowerMotor::setPeriod(int period)
 {
 	mCurrentPeriod = period;
-	QByteArray command(4, '\0');
-	command[0] = static_cast<char>((mMspCommandNumber - 4) & 0xFF);
-	command[2] = static_cast<char>(period & 0xFF);
-	command[3] = static_cast<char>(period >> 8);
-	mCommunicator.send(command);
+	mLastPeriodCommand = trikHal::MspCommand::writeWord((mMspCommandNumber - 4) & 0xFF, period);
+	mCommunicator.send(mLastPeriodCommand);
 }
 
 void PowerMotor::lineariseMotor(const QString &port, const trikKernel::Configurer &configurer)
@@ -147,6 +151,23 @@ void PowerMotor::lineariseMotor(const QString &port, const trikKernel::Configure
 	mPowerMap.append(maxControlValue);
 }
 
+trikHal::MspCommand PowerMotor::powerCommand(int power)
+{
+	if (power > maxControlValue) {
+		power = maxControlValue;
+	} else if (power < minControlValue) {
+		power = minControlValue;
+	}
+
+	mCurrentPower = power;
+
+	power = power <= 0 ? -mPowerMap[-power] : mPowerMap[power];
+
+	power = mInvert ? -power : power;
+
+	return trikHal::MspCommand::writeByte(mMspCommandNumber, power);
+}
+
 int PowerMotor::minControl() const
 {
 	return minControlValue;
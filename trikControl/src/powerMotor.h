@@ -18,6 +18,8 @@
 #include <QtCore/QString>
 #include <QtCore/QVector>
 
+#include <trikHal/mspBatchOperation.h>
+
 #include "motorInterface.h"
 #include "deviceState.h"
 
@@ -49,6 +51,15 @@ public:
 
 	int maxControl() const override;
 
+	/// Appends a command setting given power to a batch, so several motors can be updated in one bus transaction.
+	/// Power is constrained and linearised the same way as by setPower().
+	/// @param dropUnchanged - if true, command is not appended when it is the same as the last power write.
+	void appendPowerCommand(int power, trikHal::MspBatch &batch, bool dropUnchanged);
+
+	/// Appends a command setting given period to a batch.
+	/// @param dropUnchanged - if true, command is not appended when it is the same as the last period write.
+	void appendPeriodCommand(int period, trikHal::MspBatch &batch, bool dropUnchanged);
+
 public slots:
 	void setPower(int power, bool constrain = true) override;
 
@@ -66,6 +77,9 @@ public slots:
 private:
 	void lineariseMotor(const QString &port, const trikKernel::Configurer &configurer);
 
+	/// Constrains and linearises power, remembers it as current power and returns command that sets it.
+	trikHal::MspCommand powerCommand(int power);
+
 	MspCommunicatorInterface &mCommunicator;
 	int mMspCommandNumber;
 	const bool mInvert;
@@ -73,6 +87,10 @@ private:
 	int mCurrentPeriod;
 	DeviceState mState;
 	QVector<int> mPowerMap;
+
+	/// Last written power and period commands. Default command is a read, so it means that nothing was written yet.
+	trikHal::MspCommand mLastPowerCommand;
+	trikHal::MspCommand mLastPeriodCommand;
 };
 
 }
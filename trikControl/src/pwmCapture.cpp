@@ -15,7 +15,6 @@
 #include "pwmCapture.h"
 
 #include <QtCore/QByteArray>
-#include <QtCore/QTextStream>
 
 #include <trikKernel/configurer.h>
 #include <trikHal/hardwareAbstractionInterface.h>
@@ -56,10 +55,8 @@ QVector<int> PwmCapture::frequency()
 		return {};
 	}
 
-	mFrequencyFile->reset();
-	QVector<int> data(3);
-	char c = '\0';
-	mFrequencyFile->stream() >> data[0] >> c >> data[1] >> c >> data[2] >> c;
+	QVector<int> data(3, 0);
+	mFrequencyFile->readIntegers(data.data(), data.size());
 	return data;
 }
 
@@ -69,9 +66,7 @@ int PwmCapture::duty()
 		return {};
 	}
 
-	mDutyFile->reset();
 	int data = 0;
-	char c = '\0';
-	mDutyFile->stream() >> data >> c;
+	mDutyFile->readIntegers(&data, 1);
 	return data;
 }
@@ -17,7 +17,7 @@
 #include <QtCore/QThread>
 
 #include <trikKernel/configurer.h>
-#include <trikKernel/timeVal.h>
+#include <trikKernel/timestamp.h>
 #include <QsLog.h>
 
 #include "configurerHelper.h"
@@ -41,14 +41,16 @@ RangeSensor::RangeSensor(const QString &port, const trikKernel::Configurer &conf
 	mMinValue = ConfigurerHelper::configureInt(configurer, mState, port, "minValue");
 	mMaxValue = ConfigurerHelper::configureInt(configurer, mState, port, "maxValue");
 
+	mHistory.reset(SensorHistory::createForPort(configurer, port));
+
 	mSensorWorker.reset(new RangeSensorWorker(configurer.attributeByPort(port, "eventFile"), mState
-			, hardwareAbstraction));
+			, hardwareAbstraction, mHistory ? &mHistory->samples() : nullptr));
 
 	if (!mState.isFailed()) {
 		mSensorWorker->moveToThread(&mWorkerThread);
 
-		connect(mSensorWorker.data(), SIGNAL(newData(int, int, trikKernel::TimeVal))
-				, this, SIGNAL(newData(int, int, trikKernel::TimeVal)));
+		connect(mSensorWorker.data(), SIGNAL(newData(int, int, trikKernel::Timestamp))
+				, this, SIGNAL(newData(int, int, trikKernel::Timestamp)));
 
 		QLOG_INFO() << "Starting RangeSensor worker thread" << &mWorkerThread;
 
@@ -114,3 +116,8 @@ int RangeSensor::maxValue() const
 {
 	return mMaxValue;
 }
+
+HistoryInterface *RangeSensor::history()
+{
+	return mHistory.data();
+}
@@ -18,9 +18,10 @@
 
 #include "sensorInterface.h"
 #include "deviceState.h"
+#include "sensorHistory.h"
 
 namespace trikKernel {
-class TimeVal;
+class Timestamp;
 }
 
 namespace trikHal {
@@ -58,7 +59,7 @@ public:
 
 signals:
 	/// Emitted when new data is received from a sensor.
-	void newData(int distance, int rawDistance, const trikKernel::TimeVal &eventTime);
+	void newData(int distance, int rawDistance, const trikKernel::Timestamp &eventTime);
 
 public slots:
 	/// Initializes sensor and begins receiving events from it.
@@ -73,10 +74,15 @@ public slots:
 	/// Stops sensor until init() will be called again.
 	void stop();
 
+	HistoryInterface *history() override;
+
 private:
 	/// Device state, shared with worker.
 	DeviceState mState;
 
+	/// History of distances, null if disabled in config. Filled by worker, so it shall outlive it.
+	QScopedPointer<SensorHistory> mHistory;
+
 	/// Worker object that handles sensor in separate thread.
 	QScopedPointer<RangeSensorWorker> mSensorWorker;
 
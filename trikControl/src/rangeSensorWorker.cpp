@@ -15,6 +15,7 @@
 #include "src/rangeSensorWorker.h"
 
 #include <QtCore/QThread>
+#include <trikKernel/sampleHistory.h>
 #include <QsLog.h>
 
 static const int evSyn = 0;
@@ -25,10 +26,12 @@ static const int absMisc = 0x28;
 using namespace trikControl;
 
 RangeSensorWorker::RangeSensorWorker(const QString &eventFile, DeviceState &state
-		, const trikHal::HardwareAbstractionInterface &hardwareAbstraction)
+		, const trikHal::HardwareAbstractionInterface &hardwareAbstraction
+		, trikKernel::SampleHistory *history)
 	: mState(state)
 	, mHardwareAbstraction(hardwareAbstraction)
 	, mEventFileName(eventFile)
+	, mHistory(history)
 {
 }
 
@@ -69,8 +72,8 @@ void RangeSensorWorker::init()
 
 	mEventFile.reset(mHardwareAbstraction.createEventFile(mEventFileName, *QThread::currentThread()));
 
-	connect(mEventFile.data(), SIGNAL(newEvent(int, int, int, trikKernel::TimeVal))
-			, this, SLOT(onNewEvent(int, int, int, trikKernel::TimeVal)));
+	connect(mEventFile.data(), SIGNAL(newEvents(QVector<trikHal::InputEvent>))
+			, this, SLOT(onNewEvents(QVector<trikHal::InputEvent>)));
 
 	if (mEventFile->open()) {
 		mState.ready();
@@ -85,27 +88,39 @@ void RangeSensorWorker::init()
 	}
 }
 
-void RangeSensorWorker::onNewEvent(int eventType, int code, int value, const trikKernel::TimeVal &eventTime)
+void RangeSensorWorker::onNewEvents(const QVector<trikHal::InputEvent> &events)
 {
 	if (!mState.isReady()) {
 		return;
 	}
 
+	for (const trikHal::InputEvent &event : events) {
+		onNewEvent(event.eventType, event.code, event.value, event.eventTime);
+	}
+}
+
+void RangeSensorWorker::onNewEvent(int eventType, int code, int value, const trikKernel::Timestamp &eventTime)
+{
 	switch (eventType) {
 	case evAbs:
 		switch (code) {
 		case absDistance:
-			mDistance = value;
+			mReadingUnsynced.distance = value;
 			break;
 		case absMisc:
-			mRawDistance = value;
+			mReadingUnsynced.rawDistance = value;
 			break;
 		default:
 			QLOG_ERROR() << "Unknown event in range sensor event file:" << eventType << code << value;
 		}
 		break;
 	case evSyn:
-		emit newData(mDistance, mRawDistance, eventTime);
+		mReading.set(mReadingUnsynced);
+		if (mHistory) {
+			mHistory->append(eventTime, mReadingUnsynced.distance);
+		}
+
+		emit newData(mReadingUnsynced.distance, mReadingUnsynced.rawDistance, eventTime);
 		break;
 	default:
 		QLOG_ERROR() << "Unknown event in range sensor event file:" << eventType << code << value;
@@ -119,7 +134,7 @@ int RangeSensorWorker::read()
 		return -1;
 	}
 
-	return mDistance;
+	return mReading.get().distance;
 }
 
 int RangeSensorWorker::readRawData()
@@ -129,5 +144,5 @@ int RangeSensorWorker::readRawData()
 		return -1;
 	}
 
-	return mRawDistance;
+	return mReading.get().rawDistance;
 }
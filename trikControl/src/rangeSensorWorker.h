@@ -19,10 +19,15 @@
 #include <QtCore/QScopedPointer>
 
 #include <trikHal/hardwareAbstractionInterface.h>
-#include <trikKernel/timeVal.h>
+#include <trikKernel/seqLock.h>
+#include <trikKernel/timestamp.h>
 
 #include "deviceState.h"
 
+namespace trikKernel {
+class SampleHistory;
+}
+
 namespace trikControl {
 
 /// Worker object that processes range sensor output and updates stored reading. Meant to be executed in separate
@@ -34,39 +39,53 @@ class RangeSensorWorker : public QObject
 public:
 	/// Constructor.
 	/// @param eventFile - event file for this sensor.
+	/// @param history - history where distances are recorded, or nullptr if history is disabled.
 	RangeSensorWorker(const QString &eventFile, DeviceState &state
-			, const trikHal::HardwareAbstractionInterface &hardwareAbstraction);
+			, const trikHal::HardwareAbstractionInterface &hardwareAbstraction
+			, trikKernel::SampleHistory *history = nullptr);
 
 	~RangeSensorWorker() override;
 
 signals:
 	/// Emitted when new data is received from a sensor.
-	void newData(int distance, int rawDistance, const trikKernel::TimeVal &eventTime);
+	void newData(int distance, int rawDistance, const trikKernel::Timestamp &eventTime);
 
 public slots:
 	/// Initializes sensor and begins receiving events from it.
 	void init();
 
-	/// Returns current raw reading of a sensor.
+	/// Returns current raw reading of a sensor. Does not lock, so it may be called from any thread.
 	int read();
 
-	/// Returns current real raw reading of a sensor.
+	/// Returns current real raw reading of a sensor. Does not lock, so it may be called from any thread.
 	int readRawData();
 
 	/// Stops sensor until init() will be called again.
 	void stop();
 
 private slots:
-	/// Updates current reading when new value is ready in event file.
-	void onNewEvent(int eventType, int code, int value, const trikKernel::TimeVal &eventTime);
+	/// Updates current reading when new values are ready in event file.
+	void onNewEvents(const QVector<trikHal::InputEvent> &events);
 
 private:
+	/// Distance and raw distance reported by a driver between two SYNC events.
+	struct Reading
+	{
+		int distance;
+		int rawDistance;
+	};
+
+	/// Processes one event from event file.
+	void onNewEvent(int eventType, int code, int value, const trikKernel::Timestamp &eventTime);
+
 	/// Event file of a sensor driver.
 	QScopedPointer<trikHal::EventFileInterface> mEventFile;
 
-	int mDistance = -1;
+	/// Last complete reading, published on SYNC event.
+	trikKernel::SeqLock<Reading> mReading {{-1, -1}};
 
-	int mRawDistance = -1;
+	/// Reading being received from event file.
+	Reading mReadingUnsynced {-1, -1};
 
 	/// State of a sensor, shared with proxy.
 	DeviceState &mState;
@@ -74,6 +93,9 @@ private:
 	const trikHal::HardwareAbstractionInterface &mHardwareAbstraction;
 
 	const QString mEventFileName;
+
+	/// History of distances, may be null. Owned by sensor proxy.
+	trikKernel::SampleHistory * const mHistory;
 };
 
 }
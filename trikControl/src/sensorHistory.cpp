@@ -0,0 +1,131 @@
+/* Copyright 2016 CyberTech Labs Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License. */
+
+#include "sensorHistory.h"
+
+#include <limits>
+
+#include <trikKernel/configurer.h>
+#include <trikKernel/exceptions/malformedConfigException.h>
+
+#include <QsLog.h>
+
+using namespace trikControl;
+
+SensorHistory::SensorHistory(int capacity, int dimensions)
+	: mSamples(capacity, dimensions)
+{
+}
+
+SensorHistory *SensorHistory::createForPort(const trikKernel::Configurer &configurer, const QString &port
+		, int dimensions)
+{
+	try {
+		return create(configurer.attributeByPort(port, "historySize"), dimensions);
+	} catch (trikKernel::MalformedConfigException &) {
+		// History is not configured for this port.
+		return nullptr;
+	}
+}
+
+SensorHistory *SensorHistory::createForDevice(const trikKernel::Configurer &configurer, const QString &deviceName
+		, int dimensions)
+{
+	try {
+		return create(configurer.attributeByDevice(deviceName, "historySize"), dimensions);
+	} catch (trikKernel::MalformedConfigException &) {
+		// History is not configured for this device.
+		return nullptr;
+	}
+}
+
+trikKernel::SampleHistory &SensorHistory::samples()
+{
+	return mSamples;
+}
+
+int SensorHistory::size() const
+{
+	return mSamples.size();
+}
+
+int SensorHistory::capacity() const
+{
+	return mSamples.capacity();
+}
+
+int SensorHistory::dimensions() const
+{
+	return mSamples.dimensions();
+}
+
+QVector<int> SensorHistory::values(int count) const
+{
+	return mSamples.values(count);
+}
+
+QVector<int> SensorHistory::times(int count) const
+{
+	const QVector<trikKernel::Timestamp> times = mSamples.times(count);
+	QVector<int> result;
+	result.reserve(times.size());
+	for (const trikKernel::Timestamp &time : times) {
+		const qint64 offset = (time - times.last()).toMcSec();
+		result << static_cast<int>(qMax<qint64>(offset, std::numeric_limits<int>::min()));
+	}
+
+	return result;
+}
+
+int SensorHistory::median(int window, int axis) const
+{
+	return mSamples.median(window, axis);
+}
+
+qreal SensorHistory::average(int window, int axis) const
+{
+	return mSamples.average(window, axis);
+}
+
+qreal SensorHistory::exponential(qreal alpha, int axis) const
+{
+	return mSamples.exponential(alpha, axis);
+}
+
+int SensorHistory::minimum(int window, int axis) const
+{
+	return mSamples.minimum(window, axis);
+}
+
+int SensorHistory::maximum(int window, int axis) const
+{
+	return mSamples.maximum(window, axis);
+}
+
+void SensorHistory::clear()
+{
+	mSamples.clear();
+}
+
+SensorHistory *SensorHistory::create(const QString &historySize, int dimensions)
+{
+	bool ok = false;
+	const int capacity = historySize.toInt(&ok);
+	if (!ok || capacity < 0) {
+		QLOG_ERROR() << "Incorrect history size" << historySize << ", history is disabled";
+		return nullptr;
+	}
+
+	return capacity > 0 ? new SensorHistory(capacity, dimensions) : nullptr;
+}
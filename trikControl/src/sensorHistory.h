@@ -0,0 +1,81 @@
+/* Copyright 2016 CyberTech Labs Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License. */
+
+#pragma once
+
+#include <trikKernel/sampleHistory.h>
+
+#include "historyInterface.h"
+
+namespace trikKernel {
+class Configurer;
+}
+
+namespace trikControl {
+
+/// Implementation of sensor history over a ring buffer of readings.
+class SensorHistory : public HistoryInterface
+{
+	Q_OBJECT
+
+public:
+	/// Constructor.
+	/// @param capacity - maximal number of readings kept.
+	/// @param dimensions - number of values in one reading.
+	SensorHistory(int capacity, int dimensions);
+
+	/// Creates history for a sensor on a given port if its "historySize" attribute is configured and positive,
+	/// returns nullptr otherwise. Transfers ownership to a caller.
+	static SensorHistory *createForPort(const trikKernel::Configurer &configurer, const QString &port
+			, int dimensions = 1);
+
+	/// Creates history for a sensor without port (like accelerometer) if its "historySize" attribute is configured
+	/// and positive, returns nullptr otherwise. Transfers ownership to a caller.
+	static SensorHistory *createForDevice(const trikKernel::Configurer &configurer, const QString &deviceName
+			, int dimensions = 1);
+
+	/// Returns ring buffer where sensor records its readings. Thread-safe.
+	trikKernel::SampleHistory &samples();
+
+public slots:
+	int size() const override;
+
+	int capacity() const override;
+
+	int dimensions() const override;
+
+	QVector<int> values(int count) const override;
+
+	QVector<int> times(int count) const override;
+
+	int median(int window, int axis = 0) const override;
+
+	qreal average(int window, int axis = 0) const override;
+
+	qreal exponential(qreal alpha, int axis = 0) const override;
+
+	int minimum(int window, int axis = 0) const override;
+
+	int maximum(int window, int axis = 0) const override;
+
+	void clear() override;
+
+private:
+	/// Creates history of configured size, or returns nullptr if size is not positive.
+	static SensorHistory *create(const QString &historySize, int dimensions);
+
+	trikKernel::SampleHistory mSamples;
+};
+
+}
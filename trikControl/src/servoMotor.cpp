@@ -27,6 +27,7 @@ ServoMotor::ServoMotor(const QString &port, const trikKernel::Configurer &config
 	: mDutyFile(hardwareAbstraction.createOutputDeviceFile(configurer.attributeByPort(port, "deviceFile")))
 	, mPeriodFile(hardwareAbstraction.createOutputDeviceFile(configurer.attributeByPort(port, "periodFile")))
 	, mRunFile(hardwareAbstraction.createOutputDeviceFile(configurer.attributeByPort(port, "runFile")))
+	, mBatch(hardwareAbstraction.createFileIoBatch())
 	, mCurrentDutyPercent(0)
 	, mInvert(configurer.attributeByPort(port, "invert") == "true")
 	, mCurrentPower(0)
@@ -54,12 +55,10 @@ ServoMotor::ServoMotor(const QString &port, const trikKernel::Configurer &config
 		mState.fail();
 		return;
 	} else {
-		mRunFile->write(QString::number(mRun ? 1 : 0));
+		mRunFile->write(mRun ? 1 : 0);
 	}
 
-	const QString command = QString::number(mPeriod);
-
-	mPeriodFile->write(command);
+	mPeriodFile->write(mPeriod);
 	mPeriodFile->close();
 
 	if (!mDutyFile->open()) {
@@ -104,22 +103,32 @@ int ServoMotor::duty() const
 }
 
 void ServoMotor::powerOff()
+{
+	powerOff(*mBatch);
+	mBatch->submit();
+}
+
+void ServoMotor::powerOff(trikHal::FileIoBatchInterface &batch)
 {
 	if (!mState.isReady()) {
 		QLOG_ERROR() << "Trying to power off motor which is not ready, ignoring";
 		return;
 	}
 
-	mDutyFile->write(QString::number(mStop));
-	mRunFile->write(QString::number(0));
+	batch.write(*mDutyFile, mStop);
 	mRun = false;
 	mCurrentPower = 0;
 
-	mRun = false;
-	mRunFile->write(QString::number(mRun));
+	batch.write(*mRunFile, mRun ? 1 : 0);
 }
 
 void ServoMotor::setPower(int power, bool constrain)
+{
+	setPower(power, *mBatch, constrain);
+	mBatch->submit();
+}
+
+void ServoMotor::setPower(int power, trikHal::FileIoBatchInterface &batch, bool constrain)
 {
 	if (!mState.isReady()) {
 		QLOG_ERROR() << "Trying to turn on motor which is not ready, ignoring";
@@ -144,14 +153,12 @@ void ServoMotor::setPower(int power, bool constrain)
 
 	const qreal powerFactor = static_cast<qreal>(range) / (mMaxControlRange - mMinControlRange) * 2;
 	const int duty = static_cast<int>(mZero + (power - meanControlRange) * powerFactor);
-	const QString command = QString::number(duty);
-
 	mCurrentDutyPercent = 100 * duty / mPeriod;
 
-	mDutyFile->write(command);
+	batch.write(*mDutyFile, duty);
 
 	if (!mRun) {
 		mRun = true;
-		mRunFile->write(QString::number(mRun));
+		batch.write(*mRunFile, mRun ? 1 : 0);
 	}
 }
@@ -29,6 +29,7 @@ class Configurer;
 namespace trikHal {
 class HardwareAbstractionInterface;
 class OutputDeviceFileInterface;
+class FileIoBatchInterface;
 }
 
 namespace trikControl {
@@ -53,6 +54,10 @@ public:
 
 	int maxControl() const override;
 
+	/// Same as powerOff() slot, but only queues device file writes into a given batch, so several motors can be
+	/// stopped with one submit() of a batch.
+	void powerOff(trikHal::FileIoBatchInterface &batch);
+
 public slots:
 	int power() const override;
 
@@ -73,9 +78,16 @@ public slots:
 	void setPower(int power, bool constrain = true) override;
 
 private:
+	/// Queues device file writes of setPower() slot into a given batch.
+	void setPower(int power, trikHal::FileIoBatchInterface &batch, bool constrain);
+
 	QScopedPointer<trikHal::OutputDeviceFileInterface> mDutyFile;
 	QScopedPointer<trikHal::OutputDeviceFileInterface> mPeriodFile;
 	QScopedPointer<trikHal::OutputDeviceFileInterface> mRunFile;
+
+	/// Batch used by slots to write duty and run files together.
+	QScopedPointer<trikHal::FileIoBatchInterface> mBatch;
+
 	int mPeriod;
 	int mCurrentDutyPercent;
 	int mMin;
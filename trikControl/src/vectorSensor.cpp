@@ -15,7 +15,7 @@
 #include "vectorSensor.h"
 
 #include <trikKernel/configurer.h>
-#include <trikKernel/timeVal.h>
+#include <trikKernel/timestamp.h>
 #include <QsLog.h>
 
 #include "vectorSensorWorker.h"
@@ -26,13 +26,15 @@ VectorSensor::VectorSensor(const QString &deviceName, const trikKernel::Configur
 		, const trikHal::HardwareAbstractionInterface &hardwareAbstraction)
 	: mState(deviceName)
 {
+	mHistory.reset(SensorHistory::createForDevice(configurer, deviceName, 3));
+
 	mVectorSensorWorker.reset(new VectorSensorWorker(configurer.attributeByDevice(deviceName, "deviceFile"), mState
-			, hardwareAbstraction, mWorkerThread));
+			, hardwareAbstraction, mWorkerThread, mHistory ? &mHistory->samples() : nullptr));
 
 	if (!mState.isFailed()) {
-		qRegisterMetaType<trikKernel::TimeVal>("trikKernel::TimeVal");
-		connect(mVectorSensorWorker.data(), SIGNAL(newData(QVector<int>,trikKernel::TimeVal))
-				, this, SIGNAL(newData(QVector<int>,trikKernel::TimeVal)));
+		qRegisterMetaType<trikKernel::Timestamp>("trikKernel::Timestamp");
+		connect(mVectorSensorWorker.data(), SIGNAL(newData(QVector<int>,trikKernel::Timestamp))
+				, this, SIGNAL(newData(QVector<int>,trikKernel::Timestamp)));
 
 		QLOG_INFO() << "Starting VectorSensor worker thread" << &mWorkerThread;
 
@@ -58,3 +60,8 @@ QVector<int> VectorSensor::read() const
 {
 	return mVectorSensorWorker->read();
 }
+
+HistoryInterface *VectorSensor::history()
+{
+	return mHistory.data();
+}
@@ -19,6 +19,7 @@
 
 #include "vectorSensorInterface.h"
 #include "deviceState.h"
+#include "sensorHistory.h"
 
 namespace trikKernel {
 class Configurer;
@@ -51,10 +52,15 @@ public:
 public slots:
 	QVector<int> read() const override;
 
+	HistoryInterface *history() override;
+
 private:
 	/// Device state, shared with worker.
 	DeviceState mState;
 
+	/// History of readings, null if disabled in config. Filled by worker, so it shall outlive it.
+	QScopedPointer<SensorHistory> mHistory;
+
 	QScopedPointer<VectorSensorWorker> mVectorSensorWorker;
 	QThread mWorkerThread;
 };
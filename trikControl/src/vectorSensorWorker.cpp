@@ -14,10 +14,14 @@
 
 #include "src/vectorSensorWorker.h"
 
+#include <trikKernel/sampleHistory.h>
 #include <QsLog.h>
 
 static const int maxEventDelay = 1000;
-static const int reopenDelay = 1000;
+
+/// Pause between attempts to reopen device file. Each attempt waits for the file to appear by itself, so the pause
+/// only lets worker thread process other events.
+static const int reopenDelay = 100;
 
 static const int evSyn = 0;
 static const int evAbs = 3;
@@ -29,15 +33,14 @@ using namespace trikControl;
 
 VectorSensorWorker::VectorSensorWorker(const QString &eventFile, DeviceState &state
 		, const trikHal::HardwareAbstractionInterface &hardwareAbstraction
-		, QThread &thread)
+		, QThread &thread
+		, trikKernel::SampleHistory *history)
 	: mEventFile(hardwareAbstraction.createEventFile(eventFile, thread))
 	, mState(state)
+	, mHistory(history)
 {
 	mState.start();
 
-	mReading << 0 << 0 << 0;
-	mReadingUnsynced = mReading;
-
 	moveToThread(&thread);
 
 	mLastEventTimer.moveToThread(&thread);
@@ -46,10 +49,10 @@ VectorSensorWorker::VectorSensorWorker(const QString &eventFile, DeviceState &st
 
 	mTryReopenTimer.moveToThread(&thread);
 	mTryReopenTimer.setInterval(reopenDelay);
-	mTryReopenTimer.setSingleShot(false);
+	mTryReopenTimer.setSingleShot(true);
 
-	connect(mEventFile.data(), SIGNAL(newEvent(int, int, int, trikKernel::TimeVal))
-			, this, SLOT(onNewEvent(int, int, int, trikKernel::TimeVal)));
+	connect(mEventFile.data(), SIGNAL(newEvents(QVector<trikHal::InputEvent>))
+			, this, SLOT(onNewEvents(QVector<trikHal::InputEvent>)));
 
 	connect(&mLastEventTimer, SIGNAL(timeout()), this, SLOT(onSensorHanged()));
 	connect(&mTryReopenTimer, SIGNAL(timeout()), this, SLOT(onTryReopen()));
@@ -69,7 +72,7 @@ VectorSensorWorker::VectorSensorWorker(const QString &eventFile, DeviceState &st
 	}
 }
 
-void VectorSensorWorker::onNewEvent(int eventType, int code, int value, const trikKernel::TimeVal &eventTime)
+void VectorSensorWorker::onNewEvents(const QVector<trikHal::InputEvent> &events)
 {
 	mLastEventTimer.start();
 
@@ -78,6 +81,13 @@ void VectorSensorWorker::onNewEvent(int eventType, int code, int value, const tr
 		mState.ready();
 	}
 
+	for (const trikHal::InputEvent &event : events) {
+		onNewEvent(event.eventType, event.code, event.value, event.eventTime);
+	}
+}
+
+void VectorSensorWorker::onNewEvent(int eventType, int code, int value, const trikKernel::Timestamp &eventTime)
+{
 	const auto reportError = [&](){
 		QLOG_ERROR() << "Unknown event type in vector sensor event file" << mEventFile->fileName() << " :"
 				<< eventType << code << value;
@@ -100,19 +110,23 @@ void VectorSensorWorker::onNewEvent(int eventType, int code, int value, const tr
 			}
 			break;
 		case evSyn:
-			mReading.swap(mReadingUnsynced);
-			emit newData(mReading, eventTime);
+			mReading.set(mReadingUnsynced);
+			if (mHistory) {
+				mHistory->append(eventTime, mReadingUnsynced.data());
+			}
+
+			emit newData({mReadingUnsynced[0], mReadingUnsynced[1], mReadingUnsynced[2]}, eventTime);
 			break;
 		default:
 			reportError();
 	}
 }
 
-/// @todo: vector copying is not atomic, so we may receive evSyn right in the middle of "return mReading".
 QVector<int> VectorSensorWorker::read()
 {
 	if (mState.isReady()) {
-		return mReading;
+		const Reading reading = mReading.get();
+		return {reading[0], reading[1], reading[2]};
 	} else {
 		return {};
 	}
@@ -14,18 +14,21 @@
 
 #pragma once
 
+#include <array>
+
 #include <QtCore/QObject>
 #include <QtCore/QScopedPointer>
 #include <QtCore/QVector>
 #include <QtCore/QTimer>
-#include <QtCore/QReadWriteLock>
 
 #include <trikHal/hardwareAbstractionInterface.h>
+#include <trikKernel/seqLock.h>
 
 #include "deviceState.h"
 
 namespace trikKernel {
-class TimeVal;
+class Timestamp;
+class SampleHistory;
 }
 
 namespace trikControl {
@@ -40,24 +43,26 @@ public:
 	/// @param eventFile - device file for this sensor.
 	/// @param state - state of a device.
 	/// @param thread - background thread where all socket events will be processed.
+	/// @param history - three-dimensional history where readings are recorded on SYNC event, may be null.
 	VectorSensorWorker(const QString &eventFile, DeviceState &state
 			, const trikHal::HardwareAbstractionInterface &hardwareAbstraction
-			, QThread &thread);
+			, QThread &thread
+			, trikKernel::SampleHistory *history = nullptr);
 
 signals:
 	/// Emitted when new sensor reading is ready.
-	void newData(QVector<int> reading, const trikKernel::TimeVal &eventTime);
+	void newData(QVector<int> reading, const trikKernel::Timestamp &eventTime);
 
 public slots:
-	/// Returns current raw reading of a sensor.
+	/// Returns current raw reading of a sensor. Does not lock, so it may be called from any thread.
 	QVector<int> read();
 
 	/// Shuts down sensor.
 	void deinitialize();
 
 private slots:
-	/// Updates current reading when new value is ready in event file.
-	void onNewEvent(int eventType, int code, int value, const trikKernel::TimeVal &eventTime);
+	/// Updates current reading when new values are ready in event file.
+	void onNewEvents(const QVector<trikHal::InputEvent> &events);
 
 	/// Called when there are no events from event file for too long (1 second hardcoded). Attempts to reopen
 	/// event file.
@@ -68,22 +73,33 @@ private slots:
 	void onTryReopen();
 
 private:
+	/// Values of three axes.
+	typedef std::array<int, 3> Reading;
+
+	/// Processes one event from event file.
+	void onNewEvent(int eventType, int code, int value, const trikKernel::Timestamp &eventTime);
+
 	/// Event file for that sensor.
 	QScopedPointer<trikHal::EventFileInterface> mEventFile;
 
-	/// Current reading that will be returned on read() call.
-	QVector<int> mReading;
+	/// Current reading that will be returned on read() call, published on SYNC event.
+	trikKernel::SeqLock<Reading> mReading;
 
-	/// Current partial reading, will be copied to mReading on SYNC signal.
-	QVector<int> mReadingUnsynced;
+	/// Current partial reading, will be published to mReading on SYNC event. Axes that were not updated since
+	/// previous SYNC keep their values.
+	Reading mReadingUnsynced {{0, 0, 0}};
 
 	/// Device state, shared between worker and proxy.
 	DeviceState &mState;
 
+	/// History of readings, null if disabled. Does not have ownership.
+	trikKernel::SampleHistory * const mHistory;
+
 	/// Timer that reopens event file when there are no events for too long (1 second hardcoded).
 	QTimer mLastEventTimer;
 
-	/// Timer that initiates attempts to reopen device file if there is a hangup.
+	/// Timer that initiates next attempt to reopen device file if there is a hangup. Single shot, so attempts do not
+	/// pile up while event file waits for a device file to appear.
 	QTimer mTryReopenTimer;
 };
 
@@ -28,11 +28,14 @@ PUBLIC_HEADERS += \
 	$$PWD/include/trikControl/eventDeviceInterface.h \
 	$$PWD/include/trikControl/eventInterface.h \
 	$$PWD/include/trikControl/fifoInterface.h \
+	$$PWD/include/trikControl/historyInterface.h \
 	$$PWD/include/trikControl/keysInterface.h \
 	$$PWD/include/trikControl/ledInterface.h \
 	$$PWD/include/trikControl/lineSensorInterface.h \
+	$$PWD/include/trikControl/motorGroupInterface.h \
 	$$PWD/include/trikControl/motorInterface.h \
 	$$PWD/include/trikControl/objectSensorInterface.h \
+	$$PWD/include/trikControl/orientationInterface.h \
 	$$PWD/include/trikControl/pwmCaptureInterface.h \
 	$$PWD/include/trikControl/sensorInterface.h \
 	$$PWD/include/trikControl/vectorSensorInterface.h \
@@ -41,6 +44,7 @@ PUBLIC_HEADERS += \
 HEADERS += \
 	$$PWD/src/abstractVirtualSensorWorker.h \
 	$$PWD/src/analogSensor.h \
+	$$PWD/src/asyncReadOwner.h \
 	$$PWD/src/battery.h \
 	$$PWD/src/brick.h \
 	$$PWD/src/colorSensor.h \
@@ -59,6 +63,8 @@ HEADERS += \
 	$$PWD/src/guiWorker.h \
 	$$PWD/src/mspCommunicatorInterface.h \
 	$$PWD/src/mspBusAutoDetector.h \
+	$$PWD/src/mspBusScheduler.h \
+	$$PWD/src/mspSensorSampler.h \
 	$$PWD/src/mspI2cCommunicator.h \
 	$$PWD/src/mspUsbCommunicator.h \
 	$$PWD/src/keys.h \
@@ -67,14 +73,17 @@ HEADERS += \
 	$$PWD/src/lineSensor.h \
 	$$PWD/src/lineSensorWorker.h \
 	$$PWD/src/moduleLoader.h \
+	$$PWD/src/motorGroup.h \
 	$$PWD/src/objectSensor.h \
 	$$PWD/src/objectSensorWorker.h \
+	$$PWD/src/orientation.h \
 	$$PWD/src/soundSensor.h \
 	$$PWD/src/soundSensorWorker.h \
 	$$PWD/src/powerMotor.h \
 	$$PWD/src/pwmCapture.h \
 	$$PWD/src/rangeSensor.h \
 	$$PWD/src/rangeSensorWorker.h \
+	$$PWD/src/sensorHistory.h \
 	$$PWD/src/servoMotor.h \
 	$$PWD/src/vectorSensor.h \
 	$$PWD/src/vectorSensorWorker.h \
@@ -91,6 +100,7 @@ HEADERS += \
 
 SOURCES += \
 	$$PWD/src/analogSensor.cpp \
+	$$PWD/src/asyncReadOwner.cpp \
 	$$PWD/src/battery.cpp \
 	$$PWD/src/brick.cpp \
 	$$PWD/src/brickFactory.cpp \
@@ -112,18 +122,23 @@ SOURCES += \
 	$$PWD/src/lineSensor.cpp \
 	$$PWD/src/lineSensorWorker.cpp \
 	$$PWD/src/moduleLoader.cpp \
+	$$PWD/src/motorGroup.cpp \
 	$$PWD/src/objectSensor.cpp \
 	$$PWD/src/objectSensorWorker.cpp \
+	$$PWD/src/orientation.cpp \
 	$$PWD/src/soundSensor.cpp \
 	$$PWD/src/soundSensorWorker.cpp \
 	$$PWD/src/powerMotor.cpp \
 	$$PWD/src/pwmCapture.cpp \
 	$$PWD/src/rangeSensor.cpp \
+	$$PWD/src/sensorHistory.cpp \
 	$$PWD/src/servoMotor.cpp \
 	$$PWD/src/vectorSensor.cpp \
 	$$PWD/src/abstractVirtualSensorWorker.cpp \
 	$$PWD/src/fifo.cpp \
 	$$PWD/src/mspBusAutoDetector.cpp \
+	$$PWD/src/mspBusScheduler.cpp \
+	$$PWD/src/mspSensorSampler.cpp \
 	$$PWD/src/mspI2cCommunicator.cpp \
 	$$PWD/src/mspUsbCommunicator.cpp \
 	$$PWD/src/keysWorker.cpp \
@@ -16,13 +16,29 @@
 
 #include <QtCore/QString>
 #include <QtCore/QObject>
+#include <QtCore/QVector>
+#include <QtCore/QMetaType>
 
-namespace trikKernel {
-class TimeVal;
-}
+#include <trikKernel/timestamp.h>
 
 namespace trikHal {
 
+/// Low-level event from an event file.
+struct InputEvent
+{
+	/// Low-level type of an event.
+	int eventType;
+
+	/// Low-level event code.
+	int code;
+
+	/// Low-level event value.
+	int value;
+
+	/// Time stamp of an event, by monotonic clock.
+	trikKernel::Timestamp eventTime;
+};
+
 /// Event file abstraction. Can be opened or closed, when opened can emit signal containing event data.
 class EventFileInterface : public QObject
 {
@@ -49,7 +65,14 @@ signals:
 	/// @param eventType - low-level type of an event.
 	/// @param code - low-level event code.
 	/// @param value - low-level event value.
-	void newEvent(int eventType, int code, int value, const trikKernel::TimeVal &eventTime);
+	/// @param eventTime - time stamp of an event, by monotonic clock.
+	void newEvent(int eventType, int code, int value, const trikKernel::Timestamp &eventTime);
+
+	/// Emitted when there are new events in an event file, contains all events that were read at once, in order of
+	/// their arrival. Emitted before corresponding "newEvent" signals, consumers shall connect to only one of them.
+	void newEvents(const QVector<trikHal::InputEvent> &events);
 };
 
 }
+
+Q_DECLARE_METATYPE(trikHal::InputEvent)
@@ -15,6 +15,7 @@
 #pragma once
 
 #include <QtCore/QString>
+#include <QtCore/QByteArray>
 #include <QtCore/QObject>
 
 namespace trikHal {
@@ -37,8 +38,9 @@ public:
 	virtual QString fileName() = 0;
 
 signals:
-	/// Emitted when new data is read from FIFO.
-	void newData(const QString &data);
+	/// Emitted for each complete line read from FIFO.
+	/// @param line - raw bytes of a line, without line separator.
+	void newLine(const QByteArray &line);
 
 	/// Emitted when something is wrong with opened FIFO file and reading failed.
 	/// It may be caused, for example, by another process reading from the same FIFO, it may partially read data.
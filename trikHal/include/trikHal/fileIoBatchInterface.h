@@ -0,0 +1,54 @@
+/* Copyright 2016 CyberTech Labs Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License. */
+
+
+#pragma once
+
+#include <functional>
+
+#include <QtCore/QVector>
+
+#include "inputDeviceFileInterface.h"
+#include "outputDeviceFileInterface.h"
+
+namespace trikHal {
+
+/// Batch of integer reads and writes of device files (sysfs attributes) that are executed together, for example,
+/// all device file accesses of one control tick. Implementation may submit the whole batch with one system call.
+/// Files shall be opened and shall outlive submit() of a batch where they are used.
+class FileIoBatchInterface
+{
+public:
+	/// Called when read is completed.
+	/// @param parsed - number of parsed integers or -1 if file can not be read, as in
+	///        InputDeviceFileInterface::readIntegers().
+	/// @param values - parsed integers, has as many elements as requested, elements that were not parsed are 0.
+	typedef std::function<void(int parsed, const QVector<int> &values)> ReadCallback;
+
+	virtual ~FileIoBatchInterface() {}
+
+	/// Queues writing of an integer value to output device file, with the same semantics as
+	/// OutputDeviceFileInterface::write(int), including skipping of writes that do not change the value.
+	virtual void write(OutputDeviceFileInterface &file, int value) = 0;
+
+	/// Queues reading of up to "count" integers from input device file, as InputDeviceFileInterface::readIntegers().
+	virtual void read(InputDeviceFileInterface &file, int count, const ReadCallback &onCompleted) = 0;
+
+	/// Executes all queued operations and waits for their completion: writes in order of queueing, then reads. Then
+	/// calls read callbacks in order of queueing.
+	/// Batch is empty after that and can be reused, callbacks may queue operations for the next submit().
+	virtual void submit() = 0;
+};
+
+}
@@ -18,6 +18,10 @@
 
 #include "hardwareAbstractionInterface.h"
 
+namespace trikKernel {
+class Configurer;
+}
+
 namespace trikHal {
 
 /// Abstract factory that creates hardware abstraction object depending on whether we compile for real robot or for
@@ -27,6 +31,25 @@ class HardwareAbstractionFactory
 public:
 	/// Returns pointer to hardware abstraction object.
 	static QSharedPointer<HardwareAbstractionInterface> create();
+
+	/// Returns pointer to hardware abstraction object of a type selected by "type" attribute of "hardwareAbstraction"
+	/// element of system config: "default" for the one returned by create(), "simulation" for simulated hardware
+	/// configured by "simulation" element, "record" or "replay" for recording or playing back a trace file given by
+	/// "traceFile" attribute.
+	/// @param configurer - configurer object containing system config.
+	static QSharedPointer<HardwareAbstractionInterface> create(const trikKernel::Configurer &configurer);
+
+	/// Returns pointer to hardware abstraction object that works like one returned by create(), but also records all
+	/// communication with hardware to a binary trace file.
+	/// @param traceFileName - name of a trace file, existing file will be overwritten.
+	static QSharedPointer<HardwareAbstractionInterface> createRecording(const QString &traceFileName);
+
+	/// Returns pointer to hardware abstraction object that plays back a trace written by recording hardware
+	/// abstraction, so a session recorded on a robot can be reproduced on a desktop.
+	/// @param traceFileName - name of a trace file.
+	/// @param realTime - true to reproduce original timing of events and register reads, false to replay as fast as
+	///        possible.
+	static QSharedPointer<HardwareAbstractionInterface> createReplay(const QString &traceFileName, bool realTime);
 };
 
 }
@@ -14,6 +14,7 @@
 
 #pragma once
 
+#include "fileIoBatchInterface.h"
 #include "inputDeviceFileInterface.h"
 #include "outputDeviceFileInterface.h"
 #include "eventFileInterface.h"
@@ -39,6 +40,10 @@ public:
 	/// Returns system console wrapper, able to execute system command and launch processes.
 	virtual SystemConsoleInterface &systemConsole() = 0;
 
+	/// Enables or disables I/O reactor: a single thread that watches all event files and FIFOs, instead of a socket
+	/// notifier for each of them. Affects only files and FIFOs created after this call.
+	virtual void setIoReactorEnabled(bool enabled) = 0;
+
 	/// Creates new event file, passes ownership to a caller.
 	/// @param fileName - file name (with path, relative or absolute) of an event file.
 	/// @param thread - background thread where all socket events will be processed.
@@ -55,6 +60,10 @@ public:
 	/// Creates new output device file, passes ownership to a caller.
 	/// @param fileName - file name (with path, relative or absolute) of a device file.
 	virtual OutputDeviceFileInterface *createOutputDeviceFile(const QString &fileName) const = 0;
+
+	/// Creates new batch of device file reads and writes, passes ownership to a caller. Batch works with device files
+	/// created by this hardware abstraction.
+	virtual FileIoBatchInterface *createFileIoBatch() const = 0;
 };
 
 }
@@ -35,6 +35,13 @@ public:
 
 	/// Resets input file, moving file cursor to the beginning of the file.
 	virtual void reset() = 0;
+
+	/// Reads file contents from the beginning without reopening it and parses integers from it. Numbers may be
+	/// separated by any non-digit characters. Intended for sysfs attributes polled in tight loops.
+	/// @param values - array where parsed numbers will be stored.
+	/// @param count - maximal number of integers to parse.
+	/// @returns number of parsed integers or -1 if file can not be read.
+	virtual int readIntegers(int *values, int count) = 0;
 };
 
 }
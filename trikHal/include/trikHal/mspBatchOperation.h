@@ -0,0 +1,36 @@
+/* Copyright 2016 CyberTech Labs Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License. */
+
+#pragma once
+
+#include <QtCore/QVector>
+
+#include "mspCommand.h"
+
+namespace trikHal {
+
+/// One register access in a batched MSP transaction.
+struct MspBatchOperation
+{
+	/// Command to execute.
+	MspCommand command;
+
+	/// Value read from a register, filled by bus implementation for read commands.
+	int result = 0;
+};
+
+/// List of operations executed by MSP bus as one batch, in given order.
+typedef QVector<MspBatchOperation> MspBatch;
+
+}
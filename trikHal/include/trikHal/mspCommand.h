@@ -0,0 +1,127 @@
+/* Copyright 2016 CyberTech Labs Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License. */
+
+
+#pragma once
+
+#include <QtCore/QByteArray>
+#include <QtCore/qglobal.h>
+
+namespace trikHal {
+
+/// Register access command of MSP processor: kind of access, register (command) number and payload. Has fixed size
+/// and is passed by value, so commands are built on stack, or at compile time for constant registers, without heap
+/// allocations.
+class MspCommand
+{
+public:
+	/// Kinds of register access.
+	enum class Kind : quint8
+	{
+		/// Read of 16-bit register, like analog sensor or battery voltage.
+		readWord
+
+		/// Read of 32-bit register, like encoder.
+		, readLong
+
+		/// Write of 8-bit value, like motor power or encoder reset.
+		, writeByte
+
+		/// Write of 16-bit value, like motor PWM period.
+		, writeWord
+	};
+
+	/// Constructor. Creates read of register 0.
+	constexpr MspCommand() = default;
+
+	/// Constructor.
+	/// @param kind - kind of register access.
+	/// @param registerNumber - number of register (command number).
+	/// @param payload - value to write, ignored by reads.
+	constexpr MspCommand(Kind kind, quint16 registerNumber, quint16 payload = 0)
+		: mKind(kind)
+		, mRegisterNumber(registerNumber)
+		, mPayload(payload)
+	{
+	}
+
+	/// Creates read of 16-bit register.
+	static constexpr MspCommand readWord(quint16 registerNumber)
+	{
+		return MspCommand(Kind::readWord, registerNumber);
+	}
+
+	/// Creates read of 32-bit register.
+	static constexpr MspCommand readLong(quint16 registerNumber)
+	{
+		return MspCommand(Kind::readLong, registerNumber);
+	}
+
+	/// Creates write of 8-bit value. Signed values are written as their two's complement byte.
+	static constexpr MspCommand writeByte(quint16 registerNumber, int value)
+	{
+		return MspCommand(Kind::writeByte, registerNumber, static_cast<quint8>(value));
+	}
+
+	/// Creates write of 16-bit value.
+	static constexpr MspCommand writeWord(quint16 registerNumber, int value)
+	{
+		return MspCommand(Kind::writeWord, registerNumber, static_cast<quint16>(value));
+	}
+
+	/// Returns kind of register access.
+	constexpr Kind kind() const
+	{
+		return mKind;
+	}
+
+	/// Returns true if command reads a register.
+	constexpr bool isRead() const
+	{
+		return mKind == Kind::readWord || mKind == Kind::readLong;
+	}
+
+	/// Returns number of register (command number).
+	constexpr quint16 registerNumber() const
+	{
+		return mRegisterNumber;
+	}
+
+	/// Returns value to write, 8-bit for byte writes.
+	constexpr quint16 payload() const
+	{
+		return mPayload;
+	}
+
+	/// Returns command in legacy byte format used in traces: register number (little endian) followed by 0 bytes
+	/// of payload for word read, 1 byte for byte write and long read and 2 bytes for word write.
+	QByteArray toByteArray() const;
+
+	/// Parses command from legacy byte format, kind is determined by size and by "isRead" since long reads and byte
+	/// writes have the same size.
+	static MspCommand fromByteArray(const QByteArray &data, bool isRead);
+
+	friend constexpr bool operator==(const MspCommand &left, const MspCommand &right)
+	{
+		return left.mKind == right.mKind && left.mRegisterNumber == right.mRegisterNumber
+				&& left.mPayload == right.mPayload;
+	}
+
+private:
+	Kind mKind = Kind::readWord;
+	quint16 mRegisterNumber = 0;
+	quint16 mPayload = 0;
+};
+
+}
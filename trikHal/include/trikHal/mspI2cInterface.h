@@ -14,7 +14,9 @@
 
 #pragma once
 
-#include <QtCore/QByteArray>
+#include <QtCore/QString>
+
+#include "mspBatchOperation.h"
 
 namespace trikHal {
 
@@ -24,11 +26,15 @@ class MspI2cInterface
 public:
 	virtual ~MspI2cInterface() {}
 
-	/// Send data to a device.
-	virtual void send(const QByteArray &data) = 0;
+	/// Executes write command.
+	virtual void send(const MspCommand &command) = 0;
+
+	/// Executes read command and returns the result.
+	virtual int read(const MspCommand &command) = 0;
 
-	/// Reads data by given I2C command number and returns the result.
-	virtual int read(const QByteArray &data) = 0;
+	/// Executes a list of register reads and writes as one combined bus transaction (or as few transactions as
+	/// possible), in given order. Results of reads are stored into corresponding operations.
+	virtual void transaction(MspBatch &batch) = 0;
 
 	/// Establish connection with MSP over I2C bus.
 	virtual bool connect(const QString &devicePath, int deviceId) = 0;
@@ -14,7 +14,7 @@
 
 #pragma once
 
-#include <QtCore/QByteArray>
+#include "mspBatchOperation.h"
 
 namespace trikHal {
 
@@ -24,11 +24,19 @@ class MspUsbInterface
 public:
 	virtual ~MspUsbInterface() {}
 
-	/// Send data to MSP.
-	virtual void send(const QByteArray &data) = 0;
+	/// Executes write command.
+	virtual void send(const MspCommand &command) = 0;
 
-	/// Reads data by given MSP command number and returns the result.
-	virtual int read(const QByteArray &data) = 0;
+	/// Executes read command and returns the result.
+	virtual int read(const MspCommand &command) = 0;
+
+	/// Executes a list of register reads and writes keeping several requests in flight on USB link, in given
+	/// order. Results of reads are stored into corresponding operations.
+	virtual void transaction(MspBatch &batch) = 0;
+
+	/// Advances operations that take long time on device side and are not waited for in "read", like ranging of
+	/// URM04 sensors. Shall be called periodically.
+	virtual void poll() = 0;
 
 	/// Establish connection with MSP over USB bus.
 	virtual bool connect() = 0;
@@ -34,6 +34,10 @@ public:
 	/// Write data to a file using UTF-8 encoding.
 	virtual void write(const QString &data) = 0;
 
+	/// Write integer value to a file in decimal form, replacing previous file contents. Intended for sysfs
+	/// attributes, so implementation may skip the write if the value is the same as the one written last time.
+	virtual void write(int value) = 0;
+
 	/// Returns name of a file.
 	virtual QString fileName() const = 0;
 };
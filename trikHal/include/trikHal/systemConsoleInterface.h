@@ -14,6 +14,8 @@
 
 #pragma once
 
+#include <functional>
+
 #include <QtCore/QStringList>
 
 namespace trikHal {
@@ -27,6 +29,11 @@ public:
 	/// Executes given command on a system console. Returns return code of a command.
 	virtual int system(const QString &command) = 0;
 
+	/// Executes given command on a system console without waiting for it to finish.
+	/// @param callback - called with return code of a command when it finishes. May be called in another thread.
+	virtual void systemAsync(const QString &command
+			, const std::function<void(int)> &callback = std::function<void(int)>()) = 0;
+
 	/// Asynchronously starts given process with given arguments.
 	/// @returns true, if process was started successfully.
 	virtual bool startProcess(const QString &processName, const QStringList &arguments) = 0;
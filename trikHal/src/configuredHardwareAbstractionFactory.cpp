@@ -0,0 +1,98 @@
+/* Copyright 2016 CyberTech Labs Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License. */
+
+
+#include "hardwareAbstractionFactory.h"
+
+#include <trikKernel/configurer.h>
+#include <trikKernel/exceptions/malformedConfigException.h>
+
+#include <QsLog.h>
+
+#include "src/simulation/simulationHardwareAbstraction.h"
+
+using namespace trikHal;
+
+namespace {
+
+/// Returns value of an attribute of a device, or default value if it is not configured.
+QString attribute(const trikKernel::Configurer &configurer, const QString &device, const QString &name
+		, const QString &defaultValue)
+{
+	try {
+		return configurer.attributeByDevice(device, name);
+	} catch (trikKernel::MalformedConfigException &) {
+		return defaultValue;
+	}
+}
+
+/// Reads integer attribute of "simulation" element, hexadecimal values with "0x" prefix are allowed.
+int simulationParameter(const trikKernel::Configurer &configurer, const QString &name, int defaultValue)
+{
+	bool ok = false;
+	const int value = attribute(configurer, "simulation", name, QString()).toInt(&ok, 0);
+	return ok ? value : defaultValue;
+}
+
+simulation::SimulationParameters simulationParameters(const trikKernel::Configurer &configurer)
+{
+	simulation::SimulationParameters parameters;
+	parameters.mspLatency = simulationParameter(configurer, "mspLatency", parameters.mspLatency);
+	parameters.mspJitter = simulationParameter(configurer, "mspJitter", parameters.mspJitter);
+	parameters.encoderTicksPerSecond = simulationParameter(configurer, "encoderTicksPerSecond"
+			, parameters.encoderTicksPerSecond);
+	parameters.vectorSensorRate = simulationParameter(configurer, "vectorSensorRate", parameters.vectorSensorRate);
+	parameters.vectorSensorAmplitude = simulationParameter(configurer, "vectorSensorAmplitude"
+			, parameters.vectorSensorAmplitude);
+	parameters.vectorSensorPeriod = simulationParameter(configurer, "vectorSensorPeriod"
+			, parameters.vectorSensorPeriod);
+
+	// Pairs of encoder and motor registers in "(encoder;motor)" format.
+	for (const QString &pair : attribute(configurer, "simulation", "encoderMotors", QString()).split(")")) {
+		const QStringList registers = pair.trimmed().mid(1).split(";");
+		if (registers.size() == 2) {
+			parameters.encoderMotors.insert(registers[0].toInt(nullptr, 0), registers[1].toInt(nullptr, 0));
+		}
+	}
+
+	for (const QString &sensor : {QString("accelerometer"), QString("gyroscope")}) {
+		const QString deviceFile = attribute(configurer, sensor, "deviceFile", QString());
+		if (!deviceFile.isEmpty()) {
+			parameters.vectorSensorFiles.append(deviceFile);
+		}
+	}
+
+	return parameters;
+}
+
+}
+
+QSharedPointer<HardwareAbstractionInterface> HardwareAbstractionFactory::create(
+		const trikKernel::Configurer &configurer)
+{
+	const QString type = attribute(configurer, "hardwareAbstraction", "type", "default");
+	if (type == "simulation") {
+		QLOG_INFO() << "Using simulated hardware";
+		return QSharedPointer<simulation::SimulationHardwareAbstraction>::create(simulationParameters(configurer));
+	} else if (type == "record") {
+		return createRecording(attribute(configurer, "hardwareAbstraction", "traceFile", "trace.bin"));
+	} else if (type == "replay") {
+		return createReplay(attribute(configurer, "hardwareAbstraction", "traceFile", "trace.bin")
+				, attribute(configurer, "hardwareAbstraction", "realTime", "true") == "true");
+	} else if (type != "default") {
+		QLOG_ERROR() << "Unknown hardware abstraction type" << type << ", using default one";
+	}
+
+	return create();
+}
@@ -0,0 +1,51 @@
+/* Copyright 2016 CyberTech Labs Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License. */
+
+
+#include "mspCommand.h"
+
+using namespace trikHal;
+
+QByteArray MspCommand::toByteArray() const
+{
+	const int payloadSize = mKind == Kind::readWord ? 0 : mKind == Kind::writeWord ? 2 : 1;
+	QByteArray result(2 + payloadSize, '\0');
+	result[0] = static_cast<char>(mRegisterNumber & 0xFF);
+	result[1] = static_cast<char>((mRegisterNumber >> 8) & 0xFF);
+	if (payloadSize > 0) {
+		result[2] = static_cast<char>(mPayload & 0xFF);
+	}
+
+	if (payloadSize > 1) {
+		result[3] = static_cast<char>((mPayload >> 8) & 0xFF);
+	}
+
+	return result;
+}
+
+MspCommand MspCommand::fromByteArray(const QByteArray &data, bool isRead)
+{
+	if (data.size() < 2) {
+		return MspCommand();
+	}
+
+	const quint16 registerNumber = static_cast<quint8>(data[0]) | (static_cast<quint8>(data[1]) << 8);
+	if (data.size() == 2) {
+		return readWord(registerNumber);
+	} else if (data.size() == 3) {
+		return isRead ? readLong(registerNumber) : writeByte(registerNumber, static_cast<quint8>(data[2]));
+	} else {
+		return writeWord(registerNumber, static_cast<quint8>(data[2]) | (static_cast<quint8>(data[3]) << 8));
+	}
+}
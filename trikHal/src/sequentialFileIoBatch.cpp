@@ -0,0 +1,57 @@
+/* Copyright 2016 CyberTech Labs Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License. */
+
+
+#include "sequentialFileIoBatch.h"
+
+using namespace trikHal;
+
+void SequentialFileIoBatch::write(OutputDeviceFileInterface &file, int value)
+{
+	mOperations.append({&file, nullptr, value, ReadCallback()});
+}
+
+void SequentialFileIoBatch::read(InputDeviceFileInterface &file, int count, const ReadCallback &onCompleted)
+{
+	mOperations.append({nullptr, &file, count, onCompleted});
+}
+
+void SequentialFileIoBatch::submit()
+{
+	// Callbacks may queue operations for the next submit, so queue is detached first.
+	QVector<Operation> operations;
+	operations.swap(mOperations);
+
+	QVector<int> results(operations.size(), 0);
+	QVector<QVector<int>> values(operations.size());
+	for (const Operation &operation : operations) {
+		if (operation.outputFile) {
+			operation.outputFile->write(operation.value);
+		}
+	}
+
+	for (int i = 0; i < operations.size(); ++i) {
+		const Operation &operation = operations[i];
+		if (operation.inputFile) {
+			values[i].fill(0, operation.value);
+			results[i] = operation.inputFile->readIntegers(values[i].data(), values[i].size());
+		}
+	}
+
+	for (int i = 0; i < operations.size(); ++i) {
+		if (operations[i].onCompleted) {
+			operations[i].onCompleted(results[i], values[i]);
+		}
+	}
+}
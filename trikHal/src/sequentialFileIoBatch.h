@@ -0,0 +1,46 @@
+/* Copyright 2016 CyberTech Labs Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License. */
+
+
+#pragma once
+
+#include <QtCore/QVector>
+
+#include "fileIoBatchInterface.h"
+
+namespace trikHal {
+
+/// Batch that executes queued operations one by one using device file interfaces, one system call per operation.
+/// Works with any device file implementation, used where batched kernel I/O is not available.
+class SequentialFileIoBatch : public FileIoBatchInterface
+{
+public:
+	void write(OutputDeviceFileInterface &file, int value) override;
+	void read(InputDeviceFileInterface &file, int count, const ReadCallback &onCompleted) override;
+	void submit() override;
+
+private:
+	/// Queued operation, either read or write.
+	struct Operation {
+		OutputDeviceFileInterface *outputFile;
+		InputDeviceFileInterface *inputFile;
+		int value;
+		ReadCallback onCompleted;
+	};
+
+	/// Operations queued since last submit().
+	QVector<Operation> mOperations;
+};
+
+}
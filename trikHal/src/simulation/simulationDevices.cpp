@@ -0,0 +1,270 @@
+/* Copyright 2016 CyberTech Labs Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License. */
+
+
+#include "simulationDevices.h"
+
+#include <QtCore/QThread>
+#include <QtCore/qmath.h>
+
+#include <QsLog.h>
+
+using namespace trikHal;
+using namespace trikHal::simulation;
+
+/// Event types and codes of Linux input subsystem used by vector sensors.
+static const int evSyn = 0;
+static const int evAbs = 3;
+static const int absX = 0;
+static const int synReport = 0;
+
+SimulatedMspRegisters::SimulatedMspRegisters(const SimulationParameters &parameters)
+	: mParameters(parameters)
+	, mLatency(parameters.mspLatency, qMax(parameters.mspJitter, 1))
+{
+	for (const int motorRegister : parameters.encoderMotors) {
+		mMotors.insert(motorRegister, Motor());
+	}
+
+	mClock.start();
+}
+
+void SimulatedMspRegisters::send(const MspCommand &command)
+{
+	QMutexLocker locker(&mMutex);
+	sendLocked(command);
+}
+
+int SimulatedMspRegisters::read(const MspCommand &command)
+{
+	simulateLatency();
+
+	QMutexLocker locker(&mMutex);
+	return readLocked(command);
+}
+
+void SimulatedMspRegisters::transaction(MspBatch &batch)
+{
+	simulateLatency();
+
+	QMutexLocker locker(&mMutex);
+	for (MspBatchOperation &operation : batch) {
+		if (operation.command.isRead()) {
+			operation.result = readLocked(operation.command);
+		} else {
+			sendLocked(operation.command);
+		}
+	}
+}
+
+void SimulatedMspRegisters::sendLocked(const MspCommand &command)
+{
+	const int reg = command.registerNumber();
+	if (mMotors.contains(reg) && command.kind() == MspCommand::Kind::writeByte) {
+		Motor &motor = mMotors[reg];
+		integrate(motor);
+		motor.power = static_cast<qint8>(command.payload());
+	} else if (mParameters.encoderMotors.contains(reg)) {
+		// Writing to encoder register resets it.
+		Motor &motor = mMotors[mParameters.encoderMotors.value(reg)];
+		integrate(motor);
+		motor.position = 0;
+	}
+}
+
+int SimulatedMspRegisters::readLocked(const MspCommand &command)
+{
+	const int reg = command.registerNumber();
+	if (!mParameters.encoderMotors.contains(reg)) {
+		return 0;
+	}
+
+	Motor &motor = mMotors[mParameters.encoderMotors.value(reg)];
+	integrate(motor);
+	return static_cast<int>(motor.position);
+}
+
+void SimulatedMspRegisters::integrate(Motor &motor)
+{
+	const qint64 now = mClock.nsecsElapsed() / 1000;
+	motor.position += static_cast<double>(motor.power) / 100 * mParameters.encoderTicksPerSecond
+			* (now - motor.lastUpdate) / 1000000;
+	motor.lastUpdate = now;
+}
+
+void SimulatedMspRegisters::simulateLatency()
+{
+	if (mParameters.mspLatency <= 0 && mParameters.mspJitter <= 0) {
+		return;
+	}
+
+	double latency = mParameters.mspLatency;
+	if (mParameters.mspJitter > 0) {
+		QMutexLocker locker(&mMutex);
+		latency = mLatency(mRandom);
+	}
+
+	if (latency > 0) {
+		QThread::usleep(static_cast<unsigned long>(latency));
+	}
+}
+
+SimulationMspI2c::SimulationMspI2c(SimulatedMspRegisters &registers)
+	: mRegisters(registers)
+{
+}
+
+void SimulationMspI2c::send(const MspCommand &command)
+{
+	mRegisters.send(command);
+}
+
+int SimulationMspI2c::read(const MspCommand &command)
+{
+	return mRegisters.read(command);
+}
+
+void SimulationMspI2c::transaction(MspBatch &batch)
+{
+	mRegisters.transaction(batch);
+}
+
+bool SimulationMspI2c::connect(const QString &devicePath, int deviceId)
+{
+	QLOG_INFO() << "Connecting to simulated MSP I2C bus" << devicePath << deviceId;
+	return true;
+}
+
+void SimulationMspI2c::disconnect()
+{
+}
+
+SimulationMspUsb::SimulationMspUsb(SimulatedMspRegisters &registers)
+	: mRegisters(registers)
+{
+}
+
+void SimulationMspUsb::send(const MspCommand &command)
+{
+	mRegisters.send(command);
+}
+
+int SimulationMspUsb::read(const MspCommand &command)
+{
+	return mRegisters.read(command);
+}
+
+void SimulationMspUsb::transaction(MspBatch &batch)
+{
+	mRegisters.transaction(batch);
+}
+
+void SimulationMspUsb::poll()
+{
+}
+
+bool SimulationMspUsb::connect()
+{
+	QLOG_INFO() << "Connecting to simulated MSP USB bus";
+	return true;
+}
+
+void SimulationMspUsb::disconnect()
+{
+}
+
+SimulationVectorEventFile::SimulationVectorEventFile(const QString &fileName, const SimulationParameters &parameters
+		, QThread &thread)
+	: mFileName(fileName)
+	, mRate(qMax(parameters.vectorSensorRate, 1))
+	, mAmplitude(parameters.vectorSensorAmplitude)
+	, mPeriod(qMax(parameters.vectorSensorPeriod, 1))
+	, mTimer(this)
+{
+	mTimer.setTimerType(Qt::PreciseTimer);
+	connect(&mTimer, SIGNAL(timeout()), this, SLOT(emitSamples()));
+	moveToThread(&thread);
+}
+
+bool SimulationVectorEventFile::open()
+{
+	QLOG_INFO() << "Opening simulated event file" << mFileName;
+	mOpened = true;
+	QMetaObject::invokeMethod(this, "start", Qt::QueuedConnection);
+	return true;
+}
+
+bool SimulationVectorEventFile::close()
+{
+	mOpened = false;
+	QMetaObject::invokeMethod(this, "stop", Qt::QueuedConnection);
+	return true;
+}
+
+void SimulationVectorEventFile::cancelWaiting()
+{
+}
+
+QString SimulationVectorEventFile::fileName() const
+{
+	return mFileName;
+}
+
+bool SimulationVectorEventFile::isOpened() const
+{
+	return mOpened;
+}
+
+void SimulationVectorEventFile::start()
+{
+	mSamples = 0;
+	mClock.start();
+	mStartTime = trikKernel::Timestamp::now();
+	mTimer.start(qMax(1000 / mRate, 1));
+}
+
+void SimulationVectorEventFile::stop()
+{
+	mTimer.stop();
+}
+
+void SimulationVectorEventFile::emitSamples()
+{
+	const qint64 due = mClock.nsecsElapsed() / 1000 * mRate / 1000000;
+	if (due <= mSamples) {
+		return;
+	}
+
+	QVector<InputEvent> events;
+	events.reserve(static_cast<int>(due - mSamples) * 4);
+	for (; mSamples < due; ++mSamples) {
+		const qint64 time = mSamples * 1000000 / mRate;
+		const trikKernel::Timestamp eventTime(mStartTime.toNsec() + time * 1000);
+		const double phase = 2 * M_PI * static_cast<double>(time) / 1000 / mPeriod;
+		for (int axis = 0; axis < 3; ++axis) {
+			const int value = static_cast<int>(mAmplitude * qSin(phase + axis * 2 * M_PI / 3));
+			events.append({evAbs, absX + axis, value, eventTime});
+		}
+
+		events.append({evSyn, synReport, 0, eventTime});
+	}
+
+	emit newEvents(events);
+
+	if (receivers(SIGNAL(newEvent(int, int, int, trikKernel::Timestamp))) > 0) {
+		for (const InputEvent &event : events) {
+			emit newEvent(event.eventType, event.code, event.value, event.eventTime);
+		}
+	}
+}
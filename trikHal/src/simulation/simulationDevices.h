@@ -0,0 +1,170 @@
+/* Copyright 2016 CyberTech Labs Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License. */
+
+
+#pragma once
+
+#include <random>
+
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QHash>
+#include <QtCore/QMutex>
+#include <QtCore/QTimer>
+
+#include "mspI2cInterface.h"
+#include "mspUsbInterface.h"
+#include "eventFileInterface.h"
+
+#include "simulationParameters.h"
+
+class QThread;
+
+namespace trikHal {
+namespace simulation {
+
+/// Model of MSP registers shared by simulated I2C and USB buses. Encoder registers integrate power last written to
+/// matching motor registers, other registers read as 0. Every read or batch of reads takes random time according to
+/// configured latency distribution. Thread-safe.
+class SimulatedMspRegisters
+{
+public:
+	/// Constructor.
+	/// @param parameters - parameters of simulation.
+	explicit SimulatedMspRegisters(const SimulationParameters &parameters);
+
+	/// Processes register write: remembers power of a motor or resets an encoder.
+	void send(const MspCommand &command);
+
+	/// Returns value of a register after simulated bus latency.
+	int read(const MspCommand &command);
+
+	/// Executes batch with a single simulated latency for the whole batch.
+	void transaction(MspBatch &batch);
+
+private:
+	/// State of a simulated motor and encoder rotated by it.
+	struct Motor
+	{
+		int power = 0;
+		qint64 lastUpdate = 0;
+		double position = 0;
+	};
+
+	/// Processes register write, mutex shall be locked.
+	void sendLocked(const MspCommand &command);
+
+	/// Returns value of a register, mutex shall be locked.
+	int readLocked(const MspCommand &command);
+
+	/// Moves motor position according to its power and time passed since last update.
+	void integrate(Motor &motor);
+
+	/// Waits for randomly chosen bus latency.
+	void simulateLatency();
+
+	const SimulationParameters mParameters;
+
+	/// Maps motor register to its motor.
+	QHash<int, Motor> mMotors;
+
+	QElapsedTimer mClock;
+	std::mt19937 mRandom;
+	std::normal_distribution<double> mLatency;
+	QMutex mMutex;
+};
+
+/// Simulated MSP I2C bus.
+class SimulationMspI2c : public MspI2cInterface
+{
+public:
+	/// Constructor.
+	/// @param registers - shared model of MSP registers.
+	explicit SimulationMspI2c(SimulatedMspRegisters &registers);
+
+	void send(const MspCommand &command) override;
+	int read(const MspCommand &command) override;
+	void transaction(MspBatch &batch) override;
+	bool connect(const QString &devicePath, int deviceId) override;
+	void disconnect() override;
+
+private:
+	SimulatedMspRegisters &mRegisters;
+};
+
+/// Simulated MSP USB bus.
+class SimulationMspUsb : public MspUsbInterface
+{
+public:
+	/// Constructor.
+	/// @param registers - shared model of MSP registers.
+	explicit SimulationMspUsb(SimulatedMspRegisters &registers);
+
+	void send(const MspCommand &command) override;
+	int read(const MspCommand &command) override;
+	void transaction(MspBatch &batch) override;
+	void poll() override;
+	bool connect() override;
+	void disconnect() override;
+
+private:
+	SimulatedMspRegisters &mRegisters;
+};
+
+/// Event file of a simulated vector sensor. Emits X, Y and Z axes of a sine wave, shifted by a third of a period from
+/// each other, at configured rate. Samples that became due while event loop was busy are emitted as one batch.
+class SimulationVectorEventFile : public EventFileInterface
+{
+	Q_OBJECT
+
+public:
+	/// Constructor.
+	/// @param fileName - name of an event file.
+	/// @param parameters - parameters of simulation.
+	/// @param thread - background thread where events will be emitted.
+	SimulationVectorEventFile(const QString &fileName, const SimulationParameters &parameters, QThread &thread);
+
+	bool open() override;
+	bool close() override;
+	void cancelWaiting() override;
+	QString fileName() const override;
+	bool isOpened() const override;
+
+private slots:
+	void start();
+	void stop();
+	void emitSamples();
+
+private:
+	const QString mFileName;
+	const int mRate;
+	const int mAmplitude;
+	const int mPeriod;
+
+	/// Timer that wakes up event file to emit samples.
+	QTimer mTimer;
+
+	/// Timer started when event file is opened.
+	QElapsedTimer mClock;
+
+	/// Time when event file was opened, samples are stamped relative to it.
+	trikKernel::Timestamp mStartTime;
+
+	/// Number of samples emitted since event file was opened.
+	qint64 mSamples = 0;
+
+	bool mOpened = false;
+};
+
+}
+}
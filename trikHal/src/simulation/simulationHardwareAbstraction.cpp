@@ -0,0 +1,90 @@
+/* Copyright 2016 CyberTech Labs Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License. */
+
+
+#include "simulationHardwareAbstraction.h"
+
+#include "src/stub/stubSystemConsole.h"
+#include "src/stub/stubEventFile.h"
+#include "src/stub/stubFifo.h"
+#include "src/stub/stubInputDeviceFile.h"
+#include "src/stub/stubOutputDeviceFile.h"
+#include "src/sequentialFileIoBatch.h"
+
+#include "simulationDevices.h"
+
+using namespace trikHal;
+using namespace trikHal::simulation;
+
+SimulationHardwareAbstraction::SimulationHardwareAbstraction(const SimulationParameters &parameters)
+	: mParameters(parameters)
+	, mRegisters(new SimulatedMspRegisters(parameters))
+	, mI2c(new SimulationMspI2c(*mRegisters))
+	, mUsb(new SimulationMspUsb(*mRegisters))
+	, mSystemConsole(new stub::StubSystemConsole())
+{
+}
+
+SimulationHardwareAbstraction::~SimulationHardwareAbstraction()
+{
+}
+
+MspI2cInterface &SimulationHardwareAbstraction::mspI2c()
+{
+	return *mI2c;
+}
+
+MspUsbInterface &SimulationHardwareAbstraction::mspUsb()
+{
+	return *mUsb;
+}
+
+SystemConsoleInterface &SimulationHardwareAbstraction::systemConsole()
+{
+	return *mSystemConsole;
+}
+
+void SimulationHardwareAbstraction::setIoReactorEnabled(bool enabled)
+{
+	Q_UNUSED(enabled);
+}
+
+EventFileInterface *SimulationHardwareAbstraction::createEventFile(const QString &fileName, QThread &thread) const
+{
+	if (mParameters.vectorSensorFiles.contains(fileName)) {
+		return new SimulationVectorEventFile(fileName, mParameters, thread);
+	}
+
+	return new stub::StubEventFile(fileName);
+}
+
+FifoInterface *SimulationHardwareAbstraction::createFifo(const QString &fileName) const
+{
+	return new stub::StubFifo(fileName);
+}
+
+InputDeviceFileInterface *SimulationHardwareAbstraction::createInputDeviceFile(const QString &fileName) const
+{
+	return new stub::StubInputDeviceFile(fileName);
+}
+
+OutputDeviceFileInterface *SimulationHardwareAbstraction::createOutputDeviceFile(const QString &fileName) const
+{
+	return new stub::StubOutputDeviceFile(fileName);
+}
+
+FileIoBatchInterface *SimulationHardwareAbstraction::createFileIoBatch() const
+{
+	return new SequentialFileIoBatch();
+}
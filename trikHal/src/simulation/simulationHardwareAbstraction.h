@@ -0,0 +1,64 @@
+/* Copyright 2016 CyberTech Labs Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License. */
+
+
+#pragma once
+
+#include <QtCore/QScopedPointer>
+
+#include "hardwareAbstractionInterface.h"
+
+#include "simulationParameters.h"
+
+namespace trikHal {
+namespace simulation {
+
+class SimulatedMspRegisters;
+
+/// Hardware abstraction that simulates robot hardware for load testing without a robot. MSP buses have configurable
+/// latency and encoders follow motors, vector sensor event files emit synthetic waveforms. Other devices are stubs.
+class SimulationHardwareAbstraction : public HardwareAbstractionInterface
+{
+public:
+	/// Constructor.
+	/// @param parameters - parameters of simulation.
+	explicit SimulationHardwareAbstraction(const SimulationParameters &parameters);
+
+	~SimulationHardwareAbstraction() override;
+
+	MspI2cInterface &mspI2c() override;
+	MspUsbInterface &mspUsb() override;
+	SystemConsoleInterface &systemConsole() override;
+
+	void setIoReactorEnabled(bool enabled) override;
+
+	EventFileInterface *createEventFile(const QString &fileName, QThread &thread) const override;
+	FifoInterface *createFifo(const QString &fileName) const override;
+	InputDeviceFileInterface *createInputDeviceFile(const QString &fileName) const override;
+	OutputDeviceFileInterface *createOutputDeviceFile(const QString &fileName) const override;
+	FileIoBatchInterface *createFileIoBatch() const override;
+
+private:
+	const SimulationParameters mParameters;
+
+	/// Model of MSP registers, shared by both buses.
+	QScopedPointer<SimulatedMspRegisters> mRegisters;
+
+	QScopedPointer<MspI2cInterface> mI2c;
+	QScopedPointer<MspUsbInterface> mUsb;
+	QScopedPointer<SystemConsoleInterface> mSystemConsole;
+};
+
+}
+}
@@ -0,0 +1,53 @@
+/* Copyright 2016 CyberTech Labs Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License. */
+
+
+#pragma once
+
+#include <QtCore/QHash>
+#include <QtCore/QStringList>
+
+namespace trikHal {
+namespace simulation {
+
+/// Parameters of simulated hardware.
+struct SimulationParameters
+{
+	/// Mean latency of MSP register read or batch of reads, in microseconds.
+	int mspLatency = 0;
+
+	/// Standard deviation of MSP read latency, in microseconds.
+	int mspJitter = 0;
+
+	/// Maps MSP register of an encoder to MSP register of a motor which rotates it.
+	QHash<int, int> encoderMotors;
+
+	/// Encoder ticks per second when matching motor runs at full power.
+	int encoderTicksPerSecond = 1000;
+
+	/// Event files of vector sensors (accelerometer, gyroscope) which shall emit synthetic waveforms.
+	QStringList vectorSensorFiles;
+
+	/// Rate of vector sensor samples, in Hz.
+	int vectorSensorRate = 100;
+
+	/// Amplitude of vector sensor waveform, in raw sensor units.
+	int vectorSensorAmplitude = 1000;
+
+	/// Period of vector sensor waveform, in milliseconds.
+	int vectorSensorPeriod = 1000;
+};
+
+}
+}
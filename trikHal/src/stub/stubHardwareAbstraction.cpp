@@ -21,6 +21,7 @@
 #include "stubInputDeviceFile.h"
 #include "stubOutputDeviceFile.h"
 #include "stubFifo.h"
+#include "src/sequentialFileIoBatch.h"
 
 using namespace trikHal;
 using namespace trikHal::stub;
@@ -57,6 +58,11 @@ EventFileInterface *StubHardwareAbstraction::createEventFile(const QString &file
 	return new StubEventFile(fileName);
 }
 
+void StubHardwareAbstraction::setIoReactorEnabled(bool enabled)
+{
+	Q_UNUSED(enabled)
+}
+
 FifoInterface *StubHardwareAbstraction::createFifo(const QString &fileName) const
 {
 	return new StubFifo(fileName);
@@ -71,3 +77,8 @@ OutputDeviceFileInterface *StubHardwareAbstraction::createOutputDeviceFile(const
 {
 	return new StubOutputDeviceFile(fileName);
 }
+
+FileIoBatchInterface *StubHardwareAbstraction::createFileIoBatch() const
+{
+	return new SequentialFileIoBatch();
+}
@@ -32,10 +32,13 @@ public:
 	MspUsbInterface &mspUsb() override;
 	SystemConsoleInterface &systemConsole() override;
 
+	void setIoReactorEnabled(bool enabled) override;
+
 	EventFileInterface *createEventFile(const QString &fileName, QThread &thread) const override;
 	FifoInterface *createFifo(const QString &fileName) const override;
 	InputDeviceFileInterface *createInputDeviceFile(const QString &fileName) const override;
 	OutputDeviceFileInterface *createOutputDeviceFile(const QString &fileName) const override;
+	FileIoBatchInterface *createFileIoBatch() const override;
 
 private:
 	QScopedPointer<MspI2cInterface> mMspI2cBus;
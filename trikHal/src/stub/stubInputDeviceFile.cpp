@@ -43,3 +43,11 @@ void StubInputDeviceFile::reset()
 {
 	QLOG_INFO() << "Resetting stub input device file" << mFile.fileName();
 }
+
+int StubInputDeviceFile::readIntegers(int *values, int count)
+{
+	Q_UNUSED(values);
+	Q_UNUSED(count);
+	QLOG_INFO() << "Reading integers from stub input device file" << mFile.fileName();
+	return 0;
+}
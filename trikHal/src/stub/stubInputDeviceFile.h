@@ -34,6 +34,7 @@ public:
 	void close() override;
 	QTextStream &stream() override;
 	void reset() override;
+	int readIntegers(int *values, int count) override;
 
 private:
 	QFile mFile;
@@ -16,19 +16,32 @@
 
 #include <QsLog.h>
 
+using namespace trikHal;
 using namespace trikHal::stub;
 
-void StubMspI2C::send(const QByteArray &data)
+void StubMspI2C::send(const MspCommand &command)
 {
-	QLOG_INFO() << "Sending thru MSP I2C stub" << data;
+	QLOG_INFO() << "Sending thru MSP I2C stub, register" << command.registerNumber() << "value" << command.payload();
 }
 
-int StubMspI2C::read(const QByteArray &data)
+int StubMspI2C::read(const MspCommand &command)
 {
-	QLOG_INFO() << "Reading from MSP I2C stub" << data;
+	QLOG_INFO() << "Reading from MSP I2C stub, register" << command.registerNumber();
 	return 0;
 }
 
+void StubMspI2C::transaction(MspBatch &batch)
+{
+	QLOG_INFO() << "Executing batch of" << batch.size() << "operations thru MSP I2C stub";
+	for (MspBatchOperation &operation : batch) {
+		if (operation.command.isRead()) {
+			operation.result = read(operation.command);
+		} else {
+			send(operation.command);
+		}
+	}
+}
+
 bool StubMspI2C::connect(const QString &devicePath, int deviceId)
 {
 	QLOG_INFO() << "Connecting to MSP I2C stub, devicePath:" << devicePath << "deviceId" << deviceId;
@@ -23,8 +23,9 @@ namespace stub {
 class StubMspI2C : public MspI2cInterface
 {
 public:
-	void send(const QByteArray &data) override;
-	int read(const QByteArray &data) override;
+	void send(const MspCommand &command) override;
+	int read(const MspCommand &command) override;
+	void transaction(MspBatch &batch) override;
 	bool connect(const QString &devicePath, int deviceId) override;
 	void disconnect() override;
 };
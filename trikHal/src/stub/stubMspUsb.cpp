@@ -18,17 +18,33 @@
 
 using namespace trikHal::stub;
 
-void StubMspUsb::send(const QByteArray &data)
+void StubMspUsb::send(const MspCommand &command)
 {
-	QLOG_INFO() << "Sending thru MSP USB stub" << data;
+	QLOG_INFO() << "Sending thru MSP USB stub, register" << command.registerNumber() << "value" << command.payload();
 }
 
-int StubMspUsb::read(const QByteArray &data)
+int StubMspUsb::read(const MspCommand &command)
 {
-	QLOG_INFO() << "Reading from MSP USB stub" << data;
+	QLOG_INFO() << "Reading from MSP USB stub, register" << command.registerNumber();
 	return 0;
 }
 
+void StubMspUsb::transaction(MspBatch &batch)
+{
+	QLOG_INFO() << "Executing batch of" << batch.size() << "operations thru MSP USB stub";
+	for (MspBatchOperation &operation : batch) {
+		if (operation.command.isRead()) {
+			operation.result = read(operation.command);
+		} else {
+			send(operation.command);
+		}
+	}
+}
+
+void StubMspUsb::poll()
+{
+}
+
 bool StubMspUsb::connect()
 {
 	QLOG_INFO() << "Connecting to MSP USB stub";
@@ -23,8 +23,10 @@ namespace stub {
 class StubMspUsb : public MspUsbInterface
 {
 public:
-	void send(const QByteArray &data) override;
-	int read(const QByteArray &data) override;
+	void send(const MspCommand &command) override;
+	int read(const MspCommand &command) override;
+	void transaction(MspBatch &batch) override;
+	void poll() override;
 	bool connect() override;
 	void disconnect() override;
 };
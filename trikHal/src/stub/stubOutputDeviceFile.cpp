@@ -39,6 +39,11 @@ void StubOutputDeviceFile::write(const QString &data)
 	QLOG_INFO() << "Writing to stub output device file" << mFile.fileName() << ":" << data;
 }
 
+void StubOutputDeviceFile::write(int value)
+{
+	QLOG_INFO() << "Writing to stub output device file" << mFile.fileName() << ":" << value;
+}
+
 QString StubOutputDeviceFile::fileName() const
 {
 	return mFile.fileName();
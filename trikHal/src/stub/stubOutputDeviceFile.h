@@ -33,6 +33,7 @@ public:
 	bool open() override;
 	void close() override;
 	void write(const QString &data) override;
+	void write(int value) override;
 	QString fileName() const override;
 
 private:
@@ -28,6 +28,14 @@ int StubSystemConsole::system(const QString &command)
 	return 0;
 }
 
+void StubSystemConsole::systemAsync(const QString &command, const std::function<void(int)> &callback)
+{
+	QLOG_INFO() << "Calling stub system console asynchronously with command:" << command;
+	if (callback) {
+		callback(0);
+	}
+}
+
 bool StubSystemConsole::startProcess(const QString &processName, const QStringList &arguments)
 {
 	QLOG_INFO() << "Stub asked to start process" << processName << "with arguments" << arguments;
@@ -24,6 +24,8 @@ class StubSystemConsole : public SystemConsoleInterface
 {
 public:
 	int system(const QString &command) override;
+	void systemAsync(const QString &command
+			, const std::function<void(int)> &callback = std::function<void(int)>()) override;
 	bool startProcess(const QString &processName, const QStringList &arguments) override;
 	bool startProcessSynchronously(const QString &processName, const QStringList &arguments
 			, QString * const output = nullptr) override;
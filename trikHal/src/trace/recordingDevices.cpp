@@ -0,0 +1,279 @@
+/* Copyright 2016 CyberTech Labs Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License. */
+
+
+#include "recordingDevices.h"
+
+#include <QtCore/QThread>
+
+#include "traceWriter.h"
+
+using namespace trikHal;
+using namespace trikHal::trace;
+
+namespace {
+
+/// Records register reads and writes of a batch executed on MSP bus. Whole batch duration is attributed to its first
+/// operation.
+void recordBatch(TraceWriter &writer, quint16 channel, const MspBatch &batch, quint64 start, quint32 duration)
+{
+	for (const MspBatchOperation &operation : batch) {
+		if (operation.command.isRead()) {
+			writer.write(TraceRecordType::mspRead, channel, start, duration, operation.result
+					, operation.command.toByteArray());
+		} else {
+			writer.write(TraceRecordType::mspSend, channel, start, duration, 0, operation.command.toByteArray());
+		}
+
+		duration = 0;
+	}
+}
+
+}
+
+RecordingMspI2c::RecordingMspI2c(MspI2cInterface &bus, TraceWriter &writer)
+	: mBus(bus)
+	, mWriter(writer)
+	, mChannel(writer.channel(channels::mspI2c))
+{
+}
+
+void RecordingMspI2c::send(const MspCommand &command)
+{
+	const quint64 start = mWriter.now();
+	mBus.send(command);
+	mWriter.write(TraceRecordType::mspSend, mChannel, start, mWriter.now() - start, 0, command.toByteArray());
+}
+
+int RecordingMspI2c::read(const MspCommand &command)
+{
+	const quint64 start = mWriter.now();
+	const int result = mBus.read(command);
+	mWriter.write(TraceRecordType::mspRead, mChannel, start, mWriter.now() - start, result, command.toByteArray());
+	return result;
+}
+
+void RecordingMspI2c::transaction(MspBatch &batch)
+{
+	const quint64 start = mWriter.now();
+	mBus.transaction(batch);
+	recordBatch(mWriter, mChannel, batch, start, mWriter.now() - start);
+}
+
+bool RecordingMspI2c::connect(const QString &devicePath, int deviceId)
+{
+	return mBus.connect(devicePath, deviceId);
+}
+
+void RecordingMspI2c::disconnect()
+{
+	mBus.disconnect();
+}
+
+RecordingMspUsb::RecordingMspUsb(MspUsbInterface &bus, TraceWriter &writer)
+	: mBus(bus)
+	, mWriter(writer)
+	, mChannel(writer.channel(channels::mspUsb))
+{
+}
+
+void RecordingMspUsb::send(const MspCommand &command)
+{
+	const quint64 start = mWriter.now();
+	mBus.send(command);
+	mWriter.write(TraceRecordType::mspSend, mChannel, start, mWriter.now() - start, 0, command.toByteArray());
+}
+
+int RecordingMspUsb::read(const MspCommand &command)
+{
+	const quint64 start = mWriter.now();
+	const int result = mBus.read(command);
+	mWriter.write(TraceRecordType::mspRead, mChannel, start, mWriter.now() - start, result, command.toByteArray());
+	return result;
+}
+
+void RecordingMspUsb::transaction(MspBatch &batch)
+{
+	const quint64 start = mWriter.now();
+	mBus.transaction(batch);
+	recordBatch(mWriter, mChannel, batch, start, mWriter.now() - start);
+}
+
+void RecordingMspUsb::poll()
+{
+	mBus.poll();
+}
+
+bool RecordingMspUsb::connect()
+{
+	return mBus.connect();
+}
+
+void RecordingMspUsb::disconnect()
+{
+	mBus.disconnect();
+}
+
+RecordingEventFile::RecordingEventFile(EventFileInterface *eventFile, QThread &thread, TraceWriter &writer)
+	: mEventFile(eventFile)
+	, mWriter(writer)
+	, mChannel(writer.channel(channels::eventFile(eventFile->fileName())))
+{
+	moveToThread(&thread);
+
+	// Real event file emits its signals in the same thread, so it is safe to record and retranslate them directly.
+	QObject::connect(mEventFile.data(), SIGNAL(newEvents(QVector<trikHal::InputEvent>))
+			, this, SLOT(onNewEvents(QVector<trikHal::InputEvent>)), Qt::DirectConnection);
+}
+
+bool RecordingEventFile::open()
+{
+	return mEventFile->open();
+}
+
+bool RecordingEventFile::close()
+{
+	return mEventFile->close();
+}
+
+void RecordingEventFile::cancelWaiting()
+{
+	mEventFile->cancelWaiting();
+}
+
+QString RecordingEventFile::fileName() const
+{
+	return mEventFile->fileName();
+}
+
+bool RecordingEventFile::isOpened() const
+{
+	return mEventFile->isOpened();
+}
+
+void RecordingEventFile::onNewEvents(const QVector<InputEvent> &events)
+{
+	mWriter.write(TraceRecordType::events, mChannel, mWriter.now(), 0, events.size(), packEvents(events));
+
+	emit newEvents(events);
+
+	if (receivers(SIGNAL(newEvent(int, int, int, trikKernel::Timestamp))) > 0) {
+		for (const InputEvent &event : events) {
+			emit newEvent(event.eventType, event.code, event.value, event.eventTime);
+		}
+	}
+}
+
+RecordingFifo::RecordingFifo(FifoInterface *fifo, TraceWriter &writer)
+	: mFifo(fifo)
+	, mWriter(writer)
+	, mChannel(writer.channel(channels::fifo(fifo->fileName())))
+{
+	QObject::connect(mFifo.data(), SIGNAL(newLine(QByteArray)), this, SLOT(onNewLine(QByteArray))
+			, Qt::DirectConnection);
+	QObject::connect(mFifo.data(), SIGNAL(readError()), this, SIGNAL(readError()), Qt::DirectConnection);
+}
+
+bool RecordingFifo::open()
+{
+	return mFifo->open();
+}
+
+bool RecordingFifo::close()
+{
+	return mFifo->close();
+}
+
+QString RecordingFifo::fileName()
+{
+	return mFifo->fileName();
+}
+
+void RecordingFifo::onNewLine(const QByteArray &line)
+{
+	mWriter.write(TraceRecordType::fifoLine, mChannel, mWriter.now(), 0, 0, line);
+	emit newLine(line);
+}
+
+RecordingInputDeviceFile::RecordingInputDeviceFile(InputDeviceFileInterface *file, const QString &fileName
+		, TraceWriter &writer)
+	: mFile(file)
+	, mWriter(writer)
+	, mChannel(writer.channel(channels::inputDeviceFile(fileName)))
+{
+}
+
+bool RecordingInputDeviceFile::open()
+{
+	return mFile->open();
+}
+
+void RecordingInputDeviceFile::close()
+{
+	mFile->close();
+}
+
+QTextStream &RecordingInputDeviceFile::stream()
+{
+	return mFile->stream();
+}
+
+void RecordingInputDeviceFile::reset()
+{
+	mFile->reset();
+}
+
+int RecordingInputDeviceFile::readIntegers(int *values, int count)
+{
+	const quint64 start = mWriter.now();
+	const int result = mFile->readIntegers(values, count);
+	mWriter.write(TraceRecordType::inputRead, mChannel, start, mWriter.now() - start, result
+			, packIntegers(values, qMax(result, 0)));
+
+	return result;
+}
+
+RecordingOutputDeviceFile::RecordingOutputDeviceFile(OutputDeviceFileInterface *file, TraceWriter &writer)
+	: mFile(file)
+	, mWriter(writer)
+	, mChannel(writer.channel(channels::outputDeviceFile(file->fileName())))
+{
+}
+
+bool RecordingOutputDeviceFile::open()
+{
+	return mFile->open();
+}
+
+void RecordingOutputDeviceFile::close()
+{
+	mFile->close();
+}
+
+void RecordingOutputDeviceFile::write(const QString &data)
+{
+	mFile->write(data);
+	mWriter.write(TraceRecordType::outputWrite, mChannel, mWriter.now(), 0, 0, data.toUtf8());
+}
+
+void RecordingOutputDeviceFile::write(int value)
+{
+	mFile->write(value);
+	mWriter.write(TraceRecordType::outputWrite, mChannel, mWriter.now(), 0, value, QByteArray::number(value));
+}
+
+QString RecordingOutputDeviceFile::fileName() const
+{
+	return mFile->fileName();
+}
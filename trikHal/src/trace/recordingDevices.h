@@ -0,0 +1,172 @@
+/* Copyright 2016 CyberTech Labs Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License. */
+
+
+#pragma once
+
+#include <QtCore/QScopedPointer>
+
+#include "mspI2cInterface.h"
+#include "mspUsbInterface.h"
+#include "eventFileInterface.h"
+#include "fifoInterface.h"
+#include "inputDeviceFileInterface.h"
+#include "outputDeviceFileInterface.h"
+
+class QThread;
+
+namespace trikHal {
+namespace trace {
+
+class TraceWriter;
+
+/// MSP I2C bus that passes all calls to real bus and records register reads and writes.
+class RecordingMspI2c : public MspI2cInterface
+{
+public:
+	/// Constructor.
+	/// @param bus - real bus.
+	/// @param writer - trace writer.
+	RecordingMspI2c(MspI2cInterface &bus, TraceWriter &writer);
+
+	void send(const MspCommand &command) override;
+	int read(const MspCommand &command) override;
+	void transaction(MspBatch &batch) override;
+	bool connect(const QString &devicePath, int deviceId) override;
+	void disconnect() override;
+
+private:
+	MspI2cInterface &mBus;
+	TraceWriter &mWriter;
+	const quint16 mChannel;
+};
+
+/// MSP USB bus that passes all calls to real bus and records register reads and writes.
+class RecordingMspUsb : public MspUsbInterface
+{
+public:
+	/// Constructor.
+	/// @param bus - real bus.
+	/// @param writer - trace writer.
+	RecordingMspUsb(MspUsbInterface &bus, TraceWriter &writer);
+
+	void send(const MspCommand &command) override;
+	int read(const MspCommand &command) override;
+	void transaction(MspBatch &batch) override;
+	void poll() override;
+	bool connect() override;
+	void disconnect() override;
+
+private:
+	MspUsbInterface &mBus;
+	TraceWriter &mWriter;
+	const quint16 mChannel;
+};
+
+/// Event file that retranslates events of real event file and records them.
+class RecordingEventFile : public EventFileInterface
+{
+	Q_OBJECT
+
+public:
+	/// Constructor.
+	/// @param eventFile - real event file, takes ownership.
+	/// @param thread - background thread where real event file emits its events.
+	/// @param writer - trace writer.
+	RecordingEventFile(EventFileInterface *eventFile, QThread &thread, TraceWriter &writer);
+
+	bool open() override;
+	bool close() override;
+	void cancelWaiting() override;
+	QString fileName() const override;
+	bool isOpened() const override;
+
+private slots:
+	void onNewEvents(const QVector<trikHal::InputEvent> &events);
+
+private:
+	QScopedPointer<EventFileInterface> mEventFile;
+	TraceWriter &mWriter;
+	const quint16 mChannel;
+};
+
+/// FIFO that retranslates lines of real FIFO and records them.
+class RecordingFifo : public FifoInterface
+{
+	Q_OBJECT
+
+public:
+	/// Constructor.
+	/// @param fifo - real FIFO, takes ownership.
+	/// @param writer - trace writer.
+	RecordingFifo(FifoInterface *fifo, TraceWriter &writer);
+
+	bool open() override;
+	bool close() override;
+	QString fileName() override;
+
+private slots:
+	void onNewLine(const QByteArray &line);
+
+private:
+	QScopedPointer<FifoInterface> mFifo;
+	TraceWriter &mWriter;
+	const quint16 mChannel;
+};
+
+/// Input device file that passes all calls to real file and records integers read by readIntegers().
+class RecordingInputDeviceFile : public InputDeviceFileInterface
+{
+public:
+	/// Constructor.
+	/// @param file - real file, takes ownership.
+	/// @param fileName - name of a file.
+	/// @param writer - trace writer.
+	RecordingInputDeviceFile(InputDeviceFileInterface *file, const QString &fileName, TraceWriter &writer);
+
+	bool open() override;
+	void close() override;
+	QTextStream &stream() override;
+	void reset() override;
+	int readIntegers(int *values, int count) override;
+
+private:
+	QScopedPointer<InputDeviceFileInterface> mFile;
+	TraceWriter &mWriter;
+	const quint16 mChannel;
+};
+
+/// Output device file that passes all calls to real file and records writes.
+class RecordingOutputDeviceFile : public OutputDeviceFileInterface
+{
+public:
+	/// Constructor.
+	/// @param file - real file, takes ownership.
+	/// @param writer - trace writer.
+	RecordingOutputDeviceFile(OutputDeviceFileInterface *file, TraceWriter &writer);
+
+	bool open() override;
+	void close() override;
+	void write(const QString &data) override;
+	void write(int value) override;
+	QString fileName() const override;
+
+private:
+	QScopedPointer<OutputDeviceFileInterface> mFile;
+	TraceWriter &mWriter;
+	const quint16 mChannel;
+};
+
+}
+}
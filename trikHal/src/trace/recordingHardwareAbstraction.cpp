@@ -0,0 +1,84 @@
+/* Copyright 2016 CyberTech Labs Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License. */
+
+
+#include "recordingHardwareAbstraction.h"
+
+#include "src/sequentialFileIoBatch.h"
+
+#include "recordingDevices.h"
+#include "traceWriter.h"
+
+using namespace trikHal;
+using namespace trikHal::trace;
+
+RecordingHardwareAbstraction::RecordingHardwareAbstraction(
+		const QSharedPointer<HardwareAbstractionInterface> &hardwareAbstraction
+		, const QString &traceFileName)
+	: mHardwareAbstraction(hardwareAbstraction)
+	, mWriter(new TraceWriter(traceFileName))
+	, mI2c(new RecordingMspI2c(hardwareAbstraction->mspI2c(), *mWriter))
+	, mUsb(new RecordingMspUsb(hardwareAbstraction->mspUsb(), *mWriter))
+{
+}
+
+RecordingHardwareAbstraction::~RecordingHardwareAbstraction()
+{
+}
+
+MspI2cInterface &RecordingHardwareAbstraction::mspI2c()
+{
+	return *mI2c;
+}
+
+MspUsbInterface &RecordingHardwareAbstraction::mspUsb()
+{
+	return *mUsb;
+}
+
+SystemConsoleInterface &RecordingHardwareAbstraction::systemConsole()
+{
+	return mHardwareAbstraction->systemConsole();
+}
+
+void RecordingHardwareAbstraction::setIoReactorEnabled(bool enabled)
+{
+	mHardwareAbstraction->setIoReactorEnabled(enabled);
+}
+
+EventFileInterface *RecordingHardwareAbstraction::createEventFile(const QString &fileName, QThread &thread) const
+{
+	return new RecordingEventFile(mHardwareAbstraction->createEventFile(fileName, thread), thread, *mWriter);
+}
+
+FifoInterface *RecordingHardwareAbstraction::createFifo(const QString &fileName) const
+{
+	return new RecordingFifo(mHardwareAbstraction->createFifo(fileName), *mWriter);
+}
+
+InputDeviceFileInterface *RecordingHardwareAbstraction::createInputDeviceFile(const QString &fileName) const
+{
+	return new RecordingInputDeviceFile(mHardwareAbstraction->createInputDeviceFile(fileName), fileName, *mWriter);
+}
+
+OutputDeviceFileInterface *RecordingHardwareAbstraction::createOutputDeviceFile(const QString &fileName) const
+{
+	return new RecordingOutputDeviceFile(mHardwareAbstraction->createOutputDeviceFile(fileName), *mWriter);
+}
+
+FileIoBatchInterface *RecordingHardwareAbstraction::createFileIoBatch() const
+{
+	// Goes through recording device files, so batched accesses are recorded one by one.
+	return new SequentialFileIoBatch();
+}
@@ -0,0 +1,68 @@
+/* Copyright 2016 CyberTech Labs Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License. */
+
+
+#pragma once
+
+#include <QtCore/QScopedPointer>
+#include <QtCore/QSharedPointer>
+
+#include "hardwareAbstractionInterface.h"
+
+namespace trikHal {
+namespace trace {
+
+class TraceWriter;
+
+/// Hardware abstraction that wraps another one and records all communication with hardware to a binary trace file:
+/// MSP register reads and writes, events, FIFO lines and device file reads and writes. System console is not recorded.
+class RecordingHardwareAbstraction : public HardwareAbstractionInterface
+{
+public:
+	/// Constructor.
+	/// @param hardwareAbstraction - hardware abstraction that actually communicates with hardware.
+	/// @param traceFileName - name of a trace file.
+	RecordingHardwareAbstraction(const QSharedPointer<HardwareAbstractionInterface> &hardwareAbstraction
+			, const QString &traceFileName);
+
+	~RecordingHardwareAbstraction() override;
+
+	MspI2cInterface &mspI2c() override;
+	MspUsbInterface &mspUsb() override;
+	SystemConsoleInterface &systemConsole() override;
+
+	void setIoReactorEnabled(bool enabled) override;
+
+	EventFileInterface *createEventFile(const QString &fileName, QThread &thread) const override;
+	FifoInterface *createFifo(const QString &fileName) const override;
+	InputDeviceFileInterface *createInputDeviceFile(const QString &fileName) const override;
+	OutputDeviceFileInterface *createOutputDeviceFile(const QString &fileName) const override;
+	FileIoBatchInterface *createFileIoBatch() const override;
+
+private:
+	/// Wrapped hardware abstraction.
+	QSharedPointer<HardwareAbstractionInterface> mHardwareAbstraction;
+
+	/// Writer of a trace, shared by all devices.
+	QScopedPointer<TraceWriter> mWriter;
+
+	/// Recording wrapper for I2C bus.
+	QScopedPointer<MspI2cInterface> mI2c;
+
+	/// Recording wrapper for USB bus.
+	QScopedPointer<MspUsbInterface> mUsb;
+};
+
+}
+}
@@ -0,0 +1,325 @@
+/* Copyright 2016 CyberTech Labs Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License. */
+
+
+#include "replayDevices.h"
+
+#include <QtCore/QThread>
+
+using namespace trikHal;
+using namespace trikHal::trace;
+
+/// Returns key of recorded reads of a register read by a given command.
+static quint32 readKey(const MspCommand &command)
+{
+	return static_cast<quint32>(command.kind()) << 16 | command.registerNumber();
+}
+
+ReplayMspRegisters::ReplayMspRegisters(const QVector<TraceRecord> &records, bool realTime)
+	: mRealTime(realTime)
+{
+	for (const TraceRecord &record : records) {
+		if (record.type == TraceRecordType::mspRead) {
+			RegisterReads &reads = mReads[readKey(MspCommand::fromByteArray(record.data, true))];
+			reads.values.append(record.value);
+			reads.durations.append(record.duration);
+		}
+	}
+}
+
+int ReplayMspRegisters::read(const MspCommand &command)
+{
+	int value = 0;
+	quint32 duration = 0;
+
+	{
+		QMutexLocker locker(&mMutex);
+		auto reads = mReads.find(readKey(command));
+		if (reads == mReads.end()) {
+			return 0;
+		}
+
+		value = reads->values[reads->position];
+		duration = reads->durations[reads->position];
+		if (reads->position < reads->values.size() - 1) {
+			++reads->position;
+		}
+	}
+
+	if (mRealTime && duration > 0) {
+		QThread::usleep(duration);
+	}
+
+	return value;
+}
+
+void ReplayMspRegisters::transaction(MspBatch &batch)
+{
+	for (MspBatchOperation &operation : batch) {
+		if (operation.command.isRead()) {
+			operation.result = read(operation.command);
+		}
+	}
+}
+
+ReplayMspI2c::ReplayMspI2c(const QVector<TraceRecord> &records, bool realTime)
+	: mRegisters(records, realTime)
+{
+}
+
+void ReplayMspI2c::send(const MspCommand &command)
+{
+	Q_UNUSED(command);
+}
+
+int ReplayMspI2c::read(const MspCommand &command)
+{
+	return mRegisters.read(command);
+}
+
+void ReplayMspI2c::transaction(MspBatch &batch)
+{
+	mRegisters.transaction(batch);
+}
+
+bool ReplayMspI2c::connect(const QString &devicePath, int deviceId)
+{
+	Q_UNUSED(devicePath);
+	Q_UNUSED(deviceId);
+	return true;
+}
+
+void ReplayMspI2c::disconnect()
+{
+}
+
+ReplayMspUsb::ReplayMspUsb(const QVector<TraceRecord> &records, bool realTime)
+	: mRegisters(records, realTime)
+{
+}
+
+void ReplayMspUsb::send(const MspCommand &command)
+{
+	Q_UNUSED(command);
+}
+
+int ReplayMspUsb::read(const MspCommand &command)
+{
+	return mRegisters.read(command);
+}
+
+void ReplayMspUsb::transaction(MspBatch &batch)
+{
+	mRegisters.transaction(batch);
+}
+
+void ReplayMspUsb::poll()
+{
+}
+
+bool ReplayMspUsb::connect()
+{
+	return true;
+}
+
+void ReplayMspUsb::disconnect()
+{
+}
+
+TracePlayer::TracePlayer(const QVector<TraceRecord> &records, bool realTime, const QElapsedTimer &clock
+		, const std::function<void(const TraceRecord &)> &play, QObject *parent)
+	: QObject(parent)
+	, mRecords(records)
+	, mRealTime(realTime)
+	, mClock(clock)
+	, mPlay(play)
+	, mTimer(this)
+{
+	mTimer.setSingleShot(true);
+	connect(&mTimer, SIGNAL(timeout()), this, SLOT(playNext()));
+}
+
+void TracePlayer::start()
+{
+	mTimer.start(0);
+}
+
+void TracePlayer::stop()
+{
+	mTimer.stop();
+}
+
+void TracePlayer::playNext()
+{
+	while (mPosition < mRecords.size()) {
+		if (mRealTime) {
+			const qint64 delay = static_cast<qint64>(mRecords[mPosition].timestamp / 1000) - mClock.elapsed();
+			if (delay > 0) {
+				mTimer.start(static_cast<int>(delay));
+				return;
+			}
+		}
+
+		mPlay(mRecords[mPosition]);
+		++mPosition;
+
+		if (!mRealTime) {
+			// Returning to event loop after each record to let consumers process it.
+			mTimer.start(0);
+			return;
+		}
+	}
+}
+
+ReplayEventFile::ReplayEventFile(const QString &fileName, const QVector<TraceRecord> &records, bool realTime
+		, const QElapsedTimer &clock, QThread &thread)
+	: mFileName(fileName)
+{
+	mPlayer = new TracePlayer(records, realTime, clock, [this](const TraceRecord &record) {
+		const QVector<InputEvent> events = unpackEvents(record.data);
+		emit newEvents(events);
+		if (receivers(SIGNAL(newEvent(int, int, int, trikKernel::Timestamp))) > 0) {
+			for (const InputEvent &event : events) {
+				emit newEvent(event.eventType, event.code, event.value, event.eventTime);
+			}
+		}
+	}, this);
+
+	moveToThread(&thread);
+}
+
+bool ReplayEventFile::open()
+{
+	mOpened = true;
+	QMetaObject::invokeMethod(mPlayer, "start", Qt::QueuedConnection);
+	return true;
+}
+
+bool ReplayEventFile::close()
+{
+	mOpened = false;
+	QMetaObject::invokeMethod(mPlayer, "stop", Qt::QueuedConnection);
+	return true;
+}
+
+void ReplayEventFile::cancelWaiting()
+{
+}
+
+QString ReplayEventFile::fileName() const
+{
+	return mFileName;
+}
+
+bool ReplayEventFile::isOpened() const
+{
+	return mOpened;
+}
+
+ReplayFifo::ReplayFifo(const QString &fileName, const QVector<TraceRecord> &records, bool realTime
+		, const QElapsedTimer &clock)
+	: mFileName(fileName)
+{
+	mPlayer = new TracePlayer(records, realTime, clock, [this](const TraceRecord &record) {
+		emit newLine(record.data);
+	}, this);
+}
+
+bool ReplayFifo::open()
+{
+	QMetaObject::invokeMethod(mPlayer, "start", Qt::QueuedConnection);
+	return true;
+}
+
+bool ReplayFifo::close()
+{
+	QMetaObject::invokeMethod(mPlayer, "stop", Qt::QueuedConnection);
+	return true;
+}
+
+QString ReplayFifo::fileName()
+{
+	return mFileName;
+}
+
+ReplayInputDeviceFile::ReplayInputDeviceFile(const QVector<TraceRecord> &records)
+	: mRecords(records)
+	, mStream("")
+{
+}
+
+bool ReplayInputDeviceFile::open()
+{
+	return true;
+}
+
+void ReplayInputDeviceFile::close()
+{
+}
+
+QTextStream &ReplayInputDeviceFile::stream()
+{
+	return mStream;
+}
+
+void ReplayInputDeviceFile::reset()
+{
+}
+
+int ReplayInputDeviceFile::readIntegers(int *values, int count)
+{
+	if (mRecords.isEmpty()) {
+		return 0;
+	}
+
+	const TraceRecord &record = mRecords[mPosition];
+	if (mPosition < mRecords.size() - 1) {
+		++mPosition;
+	}
+
+	if (record.value < 0) {
+		return record.value;
+	}
+
+	return unpackIntegers(record.data, values, qMin(count, static_cast<int>(record.value)));
+}
+
+ReplayOutputDeviceFile::ReplayOutputDeviceFile(const QString &fileName)
+	: mFileName(fileName)
+{
+}
+
+bool ReplayOutputDeviceFile::open()
+{
+	return true;
+}
+
+void ReplayOutputDeviceFile::close()
+{
+}
+
+void ReplayOutputDeviceFile::write(const QString &data)
+{
+	Q_UNUSED(data);
+}
+
+void ReplayOutputDeviceFile::write(int value)
+{
+	Q_UNUSED(value);
+}
+
+QString ReplayOutputDeviceFile::fileName() const
+{
+	return mFileName;
+}
@@ -0,0 +1,235 @@
+/* Copyright 2016 CyberTech Labs Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License. */
+
+
+#pragma once
+
+#include <functional>
+
+#include <QtCore/QHash>
+#include <QtCore/QMutex>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QTimer>
+#include <QtCore/QTextStream>
+
+#include "mspI2cInterface.h"
+#include "mspUsbInterface.h"
+#include "eventFileInterface.h"
+#include "fifoInterface.h"
+#include "inputDeviceFileInterface.h"
+#include "outputDeviceFileInterface.h"
+
+#include "traceFormat.h"
+
+class QThread;
+
+namespace trikHal {
+namespace trace {
+
+/// Recorded results of MSP register reads. Each register returns its recorded values in order of recording, the last
+/// one is repeated when recording is exhausted. Thread-safe.
+class ReplayMspRegisters
+{
+public:
+	/// Constructor.
+	/// @param records - records of MSP bus channel.
+	/// @param realTime - if true, each read takes as much time as it took during recording.
+	ReplayMspRegisters(const QVector<TraceRecord> &records, bool realTime);
+
+	/// Returns next recorded value of a register, or 0 if it was never read during recording.
+	int read(const MspCommand &command);
+
+	/// Reads all registers of a batch, other operations are ignored.
+	void transaction(MspBatch &batch);
+
+private:
+	/// Recorded reads of one register.
+	struct RegisterReads
+	{
+		QVector<qint32> values;
+		QVector<quint32> durations;
+		int position = 0;
+	};
+
+	/// Recorded reads by kind and number of register.
+	QHash<quint32, RegisterReads> mReads;
+	const bool mRealTime;
+	QMutex mMutex;
+};
+
+/// MSP I2C bus that replays recorded register reads and ignores writes.
+class ReplayMspI2c : public MspI2cInterface
+{
+public:
+	/// Constructor.
+	/// @param records - records of MSP I2C bus.
+	/// @param realTime - if true, reads take as much time as during recording.
+	ReplayMspI2c(const QVector<TraceRecord> &records, bool realTime);
+
+	void send(const MspCommand &command) override;
+	int read(const MspCommand &command) override;
+	void transaction(MspBatch &batch) override;
+	bool connect(const QString &devicePath, int deviceId) override;
+	void disconnect() override;
+
+private:
+	ReplayMspRegisters mRegisters;
+};
+
+/// MSP USB bus that replays recorded register reads and ignores writes.
+class ReplayMspUsb : public MspUsbInterface
+{
+public:
+	/// Constructor.
+	/// @param records - records of MSP USB bus.
+	/// @param realTime - if true, reads take as much time as during recording.
+	ReplayMspUsb(const QVector<TraceRecord> &records, bool realTime);
+
+	void send(const MspCommand &command) override;
+	int read(const MspCommand &command) override;
+	void transaction(MspBatch &batch) override;
+	void poll() override;
+	bool connect() override;
+	void disconnect() override;
+
+private:
+	ReplayMspRegisters mRegisters;
+};
+
+/// Plays records of asynchronous device (event file or FIFO) in the thread it lives in, either at their original
+/// time relative to the beginning of replay or as fast as event loop allows.
+class TracePlayer : public QObject
+{
+	Q_OBJECT
+
+public:
+	/// Constructor.
+	/// @param records - records to play.
+	/// @param realTime - true to keep original timing.
+	/// @param clock - timer started at the beginning of replay.
+	/// @param play - called for each record when its time comes.
+	/// @param parent - device that owns this player, player lives in its thread.
+	TracePlayer(const QVector<TraceRecord> &records, bool realTime, const QElapsedTimer &clock
+			, const std::function<void(const TraceRecord &)> &play, QObject *parent);
+
+public slots:
+	/// Starts or resumes playing.
+	void start();
+
+	/// Pauses playing.
+	void stop();
+
+private slots:
+	void playNext();
+
+private:
+	const QVector<TraceRecord> mRecords;
+	const bool mRealTime;
+	const QElapsedTimer &mClock;
+	const std::function<void(const TraceRecord &)> mPlay;
+	QTimer mTimer;
+	int mPosition = 0;
+};
+
+/// Event file that emits recorded events.
+class ReplayEventFile : public EventFileInterface
+{
+	Q_OBJECT
+
+public:
+	/// Constructor.
+	/// @param fileName - name of an event file.
+	/// @param records - records of this event file.
+	/// @param realTime - true to emit events at their original time.
+	/// @param clock - timer started at the beginning of replay.
+	/// @param thread - background thread where events will be emitted.
+	ReplayEventFile(const QString &fileName, const QVector<TraceRecord> &records, bool realTime
+			, const QElapsedTimer &clock, QThread &thread);
+
+	bool open() override;
+	bool close() override;
+	void cancelWaiting() override;
+	QString fileName() const override;
+	bool isOpened() const override;
+
+private:
+	const QString mFileName;
+	TracePlayer *mPlayer;  // Has ownership.
+	bool mOpened = false;
+};
+
+/// FIFO that emits recorded lines.
+class ReplayFifo : public FifoInterface
+{
+	Q_OBJECT
+
+public:
+	/// Constructor.
+	/// @param fileName - name of a FIFO.
+	/// @param records - records of this FIFO.
+	/// @param realTime - true to emit lines at their original time.
+	/// @param clock - timer started at the beginning of replay.
+	ReplayFifo(const QString &fileName, const QVector<TraceRecord> &records, bool realTime
+			, const QElapsedTimer &clock);
+
+	bool open() override;
+	bool close() override;
+	QString fileName() override;
+
+private:
+	const QString mFileName;
+	TracePlayer *mPlayer;  // Has ownership.
+};
+
+/// Input device file that returns recorded integers in order of recording, repeating the last read when recording
+/// is exhausted.
+class ReplayInputDeviceFile : public InputDeviceFileInterface
+{
+public:
+	/// Constructor.
+	/// @param records - records of this file.
+	explicit ReplayInputDeviceFile(const QVector<TraceRecord> &records);
+
+	bool open() override;
+	void close() override;
+	QTextStream &stream() override;
+	void reset() override;
+	int readIntegers(int *values, int count) override;
+
+private:
+	const QVector<TraceRecord> mRecords;
+	int mPosition = 0;
+	QTextStream mStream;
+};
+
+/// Output device file that ignores all writes.
+class ReplayOutputDeviceFile : public OutputDeviceFileInterface
+{
+public:
+	/// Constructor.
+	/// @param fileName - name of a file.
+	explicit ReplayOutputDeviceFile(const QString &fileName);
+
+	bool open() override;
+	void close() override;
+	void write(const QString &data) override;
+	void write(int value) override;
+	QString fileName() const override;
+
+private:
+	const QString mFileName;
+};
+
+}
+}
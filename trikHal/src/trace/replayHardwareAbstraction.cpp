@@ -0,0 +1,85 @@
+/* Copyright 2016 CyberTech Labs Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License. */
+
+
+#include "replayHardwareAbstraction.h"
+
+#include "src/stub/stubSystemConsole.h"
+#include "src/sequentialFileIoBatch.h"
+
+#include "replayDevices.h"
+#include "traceReader.h"
+
+using namespace trikHal;
+using namespace trikHal::trace;
+
+ReplayHardwareAbstraction::ReplayHardwareAbstraction(const QString &traceFileName, bool realTime)
+	: mTrace(new TraceReader(traceFileName))
+	, mRealTime(realTime)
+	, mI2c(new ReplayMspI2c(mTrace->records(channels::mspI2c), realTime))
+	, mUsb(new ReplayMspUsb(mTrace->records(channels::mspUsb), realTime))
+	, mSystemConsole(new stub::StubSystemConsole())
+{
+	mClock.start();
+}
+
+ReplayHardwareAbstraction::~ReplayHardwareAbstraction()
+{
+}
+
+MspI2cInterface &ReplayHardwareAbstraction::mspI2c()
+{
+	return *mI2c;
+}
+
+MspUsbInterface &ReplayHardwareAbstraction::mspUsb()
+{
+	return *mUsb;
+}
+
+SystemConsoleInterface &ReplayHardwareAbstraction::systemConsole()
+{
+	return *mSystemConsole;
+}
+
+void ReplayHardwareAbstraction::setIoReactorEnabled(bool enabled)
+{
+	Q_UNUSED(enabled);
+}
+
+EventFileInterface *ReplayHardwareAbstraction::createEventFile(const QString &fileName, QThread &thread) const
+{
+	return new ReplayEventFile(fileName, mTrace->records(channels::eventFile(fileName)), mRealTime, mClock
+			, thread);
+}
+
+FifoInterface *ReplayHardwareAbstraction::createFifo(const QString &fileName) const
+{
+	return new ReplayFifo(fileName, mTrace->records(channels::fifo(fileName)), mRealTime, mClock);
+}
+
+InputDeviceFileInterface *ReplayHardwareAbstraction::createInputDeviceFile(const QString &fileName) const
+{
+	return new ReplayInputDeviceFile(mTrace->records(channels::inputDeviceFile(fileName)));
+}
+
+OutputDeviceFileInterface *ReplayHardwareAbstraction::createOutputDeviceFile(const QString &fileName) const
+{
+	return new ReplayOutputDeviceFile(fileName);
+}
+
+FileIoBatchInterface *ReplayHardwareAbstraction::createFileIoBatch() const
+{
+	return new SequentialFileIoBatch();
+}
@@ -0,0 +1,70 @@
+/* Copyright 2016 CyberTech Labs Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License. */
+
+
+#pragma once
+
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QScopedPointer>
+
+#include "hardwareAbstractionInterface.h"
+
+namespace trikHal {
+namespace trace {
+
+class TraceReader;
+
+/// Hardware abstraction that plays back a trace recorded by RecordingHardwareAbstraction, so robot session can be
+/// reproduced without a robot. Register reads and device file reads return recorded values, events and FIFO lines are
+/// emitted at their original time or as fast as possible, all writes are ignored. Devices that are absent in a trace
+/// behave like stubs.
+class ReplayHardwareAbstraction : public HardwareAbstractionInterface
+{
+public:
+	/// Constructor.
+	/// @param traceFileName - name of a trace file.
+	/// @param realTime - true to reproduce original timing of a session, false to replay as fast as possible.
+	ReplayHardwareAbstraction(const QString &traceFileName, bool realTime);
+
+	~ReplayHardwareAbstraction() override;
+
+	MspI2cInterface &mspI2c() override;
+	MspUsbInterface &mspUsb() override;
+	SystemConsoleInterface &systemConsole() override;
+
+	void setIoReactorEnabled(bool enabled) override;
+
+	EventFileInterface *createEventFile(const QString &fileName, QThread &thread) const override;
+	FifoInterface *createFifo(const QString &fileName) const override;
+	InputDeviceFileInterface *createInputDeviceFile(const QString &fileName) const override;
+	OutputDeviceFileInterface *createOutputDeviceFile(const QString &fileName) const override;
+	FileIoBatchInterface *createFileIoBatch() const override;
+
+private:
+	/// Loaded trace.
+	QScopedPointer<TraceReader> mTrace;
+
+	/// True if original timing shall be reproduced.
+	const bool mRealTime;
+
+	/// Timer started at the beginning of replay, corresponds to the beginning of recording.
+	QElapsedTimer mClock;
+
+	QScopedPointer<MspI2cInterface> mI2c;
+	QScopedPointer<MspUsbInterface> mUsb;
+	QScopedPointer<SystemConsoleInterface> mSystemConsole;
+};
+
+}
+}
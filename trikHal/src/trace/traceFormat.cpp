@@ -0,0 +1,92 @@
+/* Copyright 2016 CyberTech Labs Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License. */
+
+
+#include "traceFormat.h"
+
+using namespace trikHal;
+using namespace trikHal::trace;
+
+QDataStream &trikHal::trace::operator<<(QDataStream &stream, const TraceRecord &record)
+{
+	stream << static_cast<quint8>(record.type) << record.channel << record.timestamp << record.duration
+			<< record.value << record.data;
+
+	return stream;
+}
+
+QDataStream &trikHal::trace::operator>>(QDataStream &stream, TraceRecord &record)
+{
+	quint8 type = 0;
+	stream >> type >> record.channel >> record.timestamp >> record.duration >> record.value >> record.data;
+	record.type = static_cast<TraceRecordType>(type);
+
+	return stream;
+}
+
+QByteArray trikHal::trace::packEvents(const QVector<InputEvent> &events)
+{
+	QByteArray result;
+	QDataStream stream(&result, QIODevice::WriteOnly);
+	for (const InputEvent &event : events) {
+		stream << static_cast<qint32>(event.eventType) << static_cast<qint32>(event.code)
+				<< static_cast<qint32>(event.value) << event.eventTime.toNsec();
+	}
+
+	return result;
+}
+
+QVector<InputEvent> trikHal::trace::unpackEvents(const QByteArray &data)
+{
+	QVector<InputEvent> result;
+	QDataStream stream(data);
+	while (!stream.atEnd()) {
+		qint32 eventType = 0;
+		qint32 code = 0;
+		qint32 value = 0;
+		qint64 time = 0;
+		stream >> eventType >> code >> value >> time;
+		if (stream.status() != QDataStream::Ok) {
+			break;
+		}
+
+		result.append({eventType, code, value, trikKernel::Timestamp(time)});
+	}
+
+	return result;
+}
+
+QByteArray trikHal::trace::packIntegers(const int *values, int count)
+{
+	QByteArray result;
+	QDataStream stream(&result, QIODevice::WriteOnly);
+	for (int i = 0; i < count; ++i) {
+		stream << static_cast<qint32>(values[i]);
+	}
+
+	return result;
+}
+
+int trikHal::trace::unpackIntegers(const QByteArray &data, int *values, int count)
+{
+	QDataStream stream(data);
+	int unpacked = 0;
+	while (unpacked < count && !stream.atEnd()) {
+		qint32 value = 0;
+		stream >> value;
+		values[unpacked++] = value;
+	}
+
+	return unpacked;
+}
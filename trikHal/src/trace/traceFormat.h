@@ -0,0 +1,126 @@
+/* Copyright 2016 CyberTech Labs Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License. */
+
+
+#pragma once
+
+#include <QtCore/QByteArray>
+#include <QtCore/QDataStream>
+#include <QtCore/QVector>
+#include <QtCore/QString>
+
+#include "eventFileInterface.h"
+
+namespace trikHal {
+namespace trace {
+
+/// Kinds of records in a hardware trace.
+enum class TraceRecordType : quint8
+{
+	/// Declares a channel: "channel" field is an identifier of a channel, "data" is its UTF-8 name. Channel is a
+	/// device that communicates with hardware, like MSP bus or event file. Always precedes other records of a channel.
+	channel
+
+	/// Register read from MSP bus: "data" is a command, "value" is the result.
+	, mspRead
+
+	/// Register write to MSP bus: "data" is a command.
+	, mspSend
+
+	/// Batch of events read from an event file: "data" contains packed events, see packEvents().
+	, events
+
+	/// Line read from FIFO: "data" is a line without separator.
+	, fifoLine
+
+	/// Integers read from input device file: "value" is a count of parsed integers or -1 on error, "data" contains
+	/// packed integers, see packIntegers().
+	, inputRead
+
+	/// Write to output device file: "data" is what was written.
+	, outputWrite
+};
+
+/// One record of a hardware trace.
+struct TraceRecord
+{
+	/// Kind of a record.
+	TraceRecordType type;
+
+	/// Identifier of a channel (device) this record belongs to.
+	quint16 channel;
+
+	/// Time of an operation, in microseconds since the beginning of recording.
+	quint64 timestamp;
+
+	/// Duration of a synchronous operation (like MSP register read) in microseconds, 0 for asynchronous ones.
+	quint32 duration;
+
+	/// Integer payload, meaning depends on record type.
+	qint32 value;
+
+	/// Binary payload, meaning depends on record type.
+	QByteArray data;
+};
+
+/// Magic number at the beginning of a trace file.
+static const quint32 traceMagic = 0x54524b54;
+
+/// Version of trace format, trace files of other versions can not be replayed.
+static const quint16 traceVersion = 2;
+
+/// Names of channels of devices, the same for recording and replay.
+namespace channels {
+
+/// MSP I2C bus.
+static const char * const mspI2c = "mspI2c";
+
+/// MSP USB bus.
+static const char * const mspUsb = "mspUsb";
+
+/// Event file with given name.
+inline QString eventFile(const QString &fileName) { return "event:" + fileName; }
+
+/// FIFO with given name.
+inline QString fifo(const QString &fileName) { return "fifo:" + fileName; }
+
+/// Input device file with given name.
+inline QString inputDeviceFile(const QString &fileName) { return "input:" + fileName; }
+
+/// Output device file with given name.
+inline QString outputDeviceFile(const QString &fileName) { return "output:" + fileName; }
+
+}
+
+/// Writes a record to a stream.
+QDataStream &operator<<(QDataStream &stream, const TraceRecord &record);
+
+/// Reads a record from a stream.
+QDataStream &operator>>(QDataStream &stream, TraceRecord &record);
+
+/// Packs a batch of events into binary payload of "events" record.
+QByteArray packEvents(const QVector<InputEvent> &events);
+
+/// Unpacks events packed by packEvents().
+QVector<InputEvent> unpackEvents(const QByteArray &data);
+
+/// Packs integers into binary payload of "inputRead" record.
+QByteArray packIntegers(const int *values, int count);
+
+/// Unpacks integers packed by packIntegers() into given array, no more than "count" of them.
+/// @returns number of unpacked integers.
+int unpackIntegers(const QByteArray &data, int *values, int count);
+
+}
+}
@@ -0,0 +1,67 @@
+/* Copyright 2016 CyberTech Labs Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License. */
+
+
+#include "traceReader.h"
+
+#include <QtCore/QFile>
+#include <QtCore/QDataStream>
+
+#include <QsLog.h>
+
+using namespace trikHal::trace;
+
+TraceReader::TraceReader(const QString &fileName)
+{
+	QFile file(fileName);
+	if (!file.open(QIODevice::ReadOnly)) {
+		QLOG_ERROR() << "Failed to open hardware trace file" << fileName;
+		return;
+	}
+
+	QDataStream stream(&file);
+	quint32 magic = 0;
+	quint16 version = 0;
+	stream >> magic >> version;
+	if (magic != traceMagic || version != traceVersion) {
+		QLOG_ERROR() << fileName << "is not a hardware trace file or has unsupported version" << version;
+		return;
+	}
+
+	QHash<quint16, QString> channelNames;
+	int count = 0;
+	while (!stream.atEnd()) {
+		TraceRecord record;
+		stream >> record;
+		if (stream.status() != QDataStream::Ok) {
+			// Trace of a crashed session may be truncated, using what was read so far.
+			QLOG_WARN() << "Hardware trace file" << fileName << "is truncated";
+			break;
+		}
+
+		if (record.type == TraceRecordType::channel) {
+			channelNames.insert(record.channel, QString::fromUtf8(record.data));
+		} else if (channelNames.contains(record.channel)) {
+			mChannels[channelNames.value(record.channel)].append(record);
+			++count;
+		}
+	}
+
+	QLOG_INFO() << "Loaded" << count << "records of" << channelNames.size() << "devices from hardware trace" << fileName;
+}
+
+QVector<TraceRecord> TraceReader::records(const QString &channelName) const
+{
+	return mChannels.value(channelName);
+}
@@ -0,0 +1,44 @@
+/* Copyright 2016 CyberTech Labs Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License. */
+
+
+#pragma once
+
+#include <QtCore/QHash>
+#include <QtCore/QString>
+#include <QtCore/QVector>
+
+#include "traceFormat.h"
+
+namespace trikHal {
+namespace trace {
+
+/// Loads hardware trace file into memory and splits it by channels.
+class TraceReader
+{
+public:
+	/// Constructor. Reads whole trace file, on failure trace is empty.
+	/// @param fileName - name of a trace file.
+	explicit TraceReader(const QString &fileName);
+
+	/// Returns records of a channel with given name in order of recording, or empty list if there is no such channel.
+	QVector<TraceRecord> records(const QString &channelName) const;
+
+private:
+	/// Records of each channel by channel name.
+	QHash<QString, QVector<TraceRecord>> mChannels;
+};
+
+}
+}
@@ -0,0 +1,71 @@
+/* Copyright 2016 CyberTech Labs Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License. */
+
+
+#include "traceWriter.h"
+
+#include <QtCore/QMutexLocker>
+
+#include <QsLog.h>
+
+using namespace trikHal::trace;
+
+TraceWriter::TraceWriter(const QString &fileName)
+	: mFile(fileName)
+{
+	if (!mFile.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+		QLOG_ERROR() << "Failed to open hardware trace file" << fileName << "for writing";
+	} else {
+		QLOG_INFO() << "Recording hardware trace to" << fileName;
+		mStream.setDevice(&mFile);
+		mStream << traceMagic << traceVersion;
+	}
+
+	mTimer.start();
+}
+
+TraceWriter::~TraceWriter()
+{
+	mFile.close();
+}
+
+quint16 TraceWriter::channel(const QString &name)
+{
+	QMutexLocker locker(&mMutex);
+	if (mChannels.contains(name)) {
+		return mChannels.value(name);
+	}
+
+	const quint16 id = static_cast<quint16>(mChannels.size());
+	mChannels.insert(name, id);
+	if (mFile.isOpen()) {
+		mStream << TraceRecord{TraceRecordType::channel, id, now(), 0, 0, name.toUtf8()};
+	}
+
+	return id;
+}
+
+quint64 TraceWriter::now() const
+{
+	return static_cast<quint64>(mTimer.nsecsElapsed() / 1000);
+}
+
+void TraceWriter::write(TraceRecordType type, quint16 channel, quint64 timestamp, quint32 duration, qint32 value
+		, const QByteArray &data)
+{
+	QMutexLocker locker(&mMutex);
+	if (mFile.isOpen()) {
+		mStream << TraceRecord{type, channel, timestamp, duration, value, data};
+	}
+}
@@ -0,0 +1,67 @@
+/* Copyright 2016 CyberTech Labs Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License. */
+
+
+#pragma once
+
+#include <QtCore/QFile>
+#include <QtCore/QDataStream>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QHash>
+#include <QtCore/QMutex>
+
+#include "traceFormat.h"
+
+namespace trikHal {
+namespace trace {
+
+/// Writes hardware trace file. Thread-safe, devices living in different threads share one writer.
+class TraceWriter
+{
+public:
+	/// Constructor. Opens trace file, on failure writer silently ignores all records.
+	/// @param fileName - name of a trace file, existing file will be overwritten.
+	explicit TraceWriter(const QString &fileName);
+
+	~TraceWriter();
+
+	/// Returns identifier of a channel with given name, declares a new channel in a trace if needed.
+	quint16 channel(const QString &name);
+
+	/// Returns current time in microseconds since the beginning of recording, to be used as record timestamp.
+	quint64 now() const;
+
+	/// Appends a record to a trace.
+	void write(TraceRecordType type, quint16 channel, quint64 timestamp, quint32 duration, qint32 value
+			, const QByteArray &data = QByteArray());
+
+private:
+	/// Trace file.
+	QFile mFile;
+
+	/// Stream used to serialize records into a file.
+	QDataStream mStream;
+
+	/// Timer started at the beginning of recording.
+	QElapsedTimer mTimer;
+
+	/// Identifiers of already declared channels by their names.
+	QHash<QString, quint16> mChannels;
+
+	/// Guards file and channels.
+	QMutex mMutex;
+};
+
+}
+}
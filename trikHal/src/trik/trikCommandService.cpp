@@ -0,0 +1,276 @@
+/* Copyright 2016 CyberTech Labs Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License. */
+
+
+#include "trikCommandService.h"
+
+#include <errno.h>
+#include <signal.h>
+#include <spawn.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+
+#include <QtCore/QByteArray>
+#include <QtCore/QMutexLocker>
+#include <QtCore/QWaitCondition>
+
+#include <QsLog.h>
+
+extern char **environ;
+
+using namespace trikHal::trik;
+
+/// Shell function that runs a command in a subshell with input detached from our socket and descriptor 3 closed, and
+/// reports its exit code to descriptor 3. Exit code is reported even if the command calls "exit".
+static const char helperPrologue[] = "__trik_run() { ( eval \"$2\" 3>&- ) < /dev/null; echo \"$1 $?\" >&3; }\n";
+
+/// Time in milliseconds to wait for reader thread and helper shell to finish on shutdown.
+static const int shutdownTimeout = 1000;
+
+/// Quotes a string for shell, so it is passed as is.
+static QString quoted(const QString &string)
+{
+	QString result = string;
+	result.replace("'", "'\\''");
+	return "'" + result + "'";
+}
+
+/// Writes whole buffer to a socket.
+static bool writeAll(int socket, const QByteArray &data)
+{
+	int written = 0;
+	while (written < data.size()) {
+		const ssize_t result = ::send(socket, data.constData() + written, data.size() - written, MSG_NOSIGNAL);
+		if (result > 0) {
+			written += result;
+		} else if (result < 0 && errno != EINTR) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/// Waits for a process to exit for at most given time in milliseconds, kills it if it is still running.
+static void waitOrKill(pid_t pid, int timeout)
+{
+	const int step = 10;
+	for (int waited = 0; waited < timeout; waited += step) {
+		const pid_t result = waitpid(pid, nullptr, WNOHANG);
+		if (result == pid || (result < 0 && errno != EINTR)) {
+			return;
+		}
+
+		usleep(step * 1000);
+	}
+
+	QLOG_WARN() << "Command service shell does not exit, killing it";
+	kill(pid, SIGKILL);
+	while (waitpid(pid, nullptr, 0) < 0 && errno == EINTR) {
+	}
+}
+
+TrikCommandService::TrikCommandService()
+{
+}
+
+TrikCommandService::~TrikCommandService()
+{
+	if (mSocket != -1) {
+		// Helper shell exits when it sees end of its input, then reader thread gets end of file. Commands that are
+		// still running keep their end of the socket open, so reading is interrupted if they do not finish in time.
+		::shutdown(mSocket, SHUT_WR);
+		if (!wait(shutdownTimeout)) {
+			QLOG_WARN() << "Commands are still running, stopping command service without their exit codes";
+			::shutdown(mSocket, SHUT_RDWR);
+			wait();
+		}
+
+		waitOrKill(mHelperPid, shutdownTimeout);
+		::close(mSocket);
+	}
+}
+
+bool TrikCommandService::launch()
+{
+	int sockets[2];
+	if (socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, sockets) != 0) {
+		QLOG_ERROR() << "Failed to create socketpair for command service:" << strerror(errno);
+		return false;
+	}
+
+	posix_spawn_file_actions_t actions;
+	posix_spawn_file_actions_init(&actions);
+	posix_spawn_file_actions_adddup2(&actions, sockets[1], 0);
+	posix_spawn_file_actions_adddup2(&actions, sockets[1], 3);
+
+	posix_spawnattr_t attributes;
+	posix_spawnattr_init(&attributes);
+	sigset_t signalMask;
+	sigemptyset(&signalMask);
+	posix_spawnattr_setsigmask(&attributes, &signalMask);
+	short flags = POSIX_SPAWN_SETSIGMASK;
+#ifdef POSIX_SPAWN_USEVFORK
+	flags |= POSIX_SPAWN_USEVFORK;
+#endif
+	posix_spawnattr_setflags(&attributes, flags);
+
+	char shell[] = "sh";
+	char fromStdin[] = "-s";
+	char *arguments[] = {shell, fromStdin, nullptr};
+
+	const int result = posix_spawn(&mHelperPid, "/bin/sh", &actions, &attributes, arguments, environ);
+
+	posix_spawnattr_destroy(&attributes);
+	posix_spawn_file_actions_destroy(&actions);
+	::close(sockets[1]);
+
+	if (result != 0) {
+		QLOG_ERROR() << "Failed to spawn command service shell:" << strerror(result);
+		::close(sockets[0]);
+		return false;
+	}
+
+	mSocket = sockets[0];
+	if (!writeAll(mSocket, QByteArray(helperPrologue))) {
+		QLOG_ERROR() << "Failed to initialize command service shell:" << strerror(errno);
+		return false;
+	}
+
+	mAvailable = true;
+	start();
+
+	QLOG_INFO() << "Command service shell started, pid" << mHelperPid;
+	return true;
+}
+
+bool TrikCommandService::isAvailable() const
+{
+	QMutexLocker locker(&mMutex);
+	return mAvailable;
+}
+
+int TrikCommandService::execute(const QString &command)
+{
+	QMutex mutex;
+	QWaitCondition finished;
+	bool done = false;
+	int exitCode = -1;
+
+	QMutexLocker locker(&mutex);
+	const bool sent = executeAsync(command, [&](int code) {
+		QMutexLocker callbackLocker(&mutex);
+		exitCode = code;
+		done = true;
+		finished.wakeAll();
+	});
+
+	if (!sent) {
+		return -1;
+	}
+
+	while (!done) {
+		finished.wait(&mutex);
+	}
+
+	return exitCode;
+}
+
+bool TrikCommandService::executeAsync(const QString &command, const std::function<void(int)> &callback)
+{
+	QMutexLocker locker(&mMutex);
+	if (!mAvailable) {
+		return false;
+	}
+
+	const quint64 id = mNextId++;
+	mCallbacks.insert(id, callback);
+
+	const QByteArray request = QString("__trik_run %1 %2 &\n").arg(id).arg(quoted(command)).toUtf8();
+	if (!writeAll(mSocket, request)) {
+		QLOG_ERROR() << "Failed to send command to command service shell:" << strerror(errno);
+		mCallbacks.remove(id);
+		return false;
+	}
+
+	return true;
+}
+
+QString TrikCommandService::commandLine(const QString &program, const QStringList &arguments)
+{
+	QString result = "exec " + quoted(program);
+	for (const QString &argument : arguments) {
+		result += " " + quoted(argument);
+	}
+
+	return result;
+}
+
+void TrikCommandService::run()
+{
+	QByteArray pending;
+	char buffer[256];
+
+	forever {
+		const ssize_t size = ::read(mSocket, buffer, sizeof(buffer));
+		if (size < 0 && errno == EINTR) {
+			continue;
+		}
+
+		if (size <= 0) {
+			break;
+		}
+
+		pending.append(buffer, static_cast<int>(size));
+
+		int lineEnd = -1;
+		while ((lineEnd = pending.indexOf('\n')) != -1) {
+			const QList<QByteArray> reply = pending.left(lineEnd).split(' ');
+			pending.remove(0, lineEnd + 1);
+
+			if (reply.size() != 2) {
+				QLOG_WARN() << "Malformed reply from command service shell";
+				continue;
+			}
+
+			QMutexLocker locker(&mMutex);
+			const std::function<void(int)> callback = mCallbacks.take(reply[0].toULongLong());
+			locker.unlock();
+
+			if (callback) {
+				callback(reply[1].toInt());
+			}
+		}
+	}
+
+	QLOG_INFO() << "Command service shell has finished";
+	failPending();
+}
+
+void TrikCommandService::failPending()
+{
+	QMutexLocker locker(&mMutex);
+	mAvailable = false;
+	const QHash<quint64, std::function<void(int)>> callbacks = mCallbacks;
+	mCallbacks.clear();
+	locker.unlock();
+
+	for (const std::function<void(int)> &callback : callbacks) {
+		if (callback) {
+			callback(-1);
+		}
+	}
+}
@@ -0,0 +1,88 @@
+/* Copyright 2016 CyberTech Labs Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License. */
+
+
+#pragma once
+
+#include <functional>
+
+#include <sys/types.h>
+
+#include <QtCore/QThread>
+#include <QtCore/QHash>
+#include <QtCore/QMutex>
+#include <QtCore/QStringList>
+
+namespace trikHal {
+namespace trik {
+
+/// Executes shell commands without forking the runtime process. At startup a small resident shell is spawned with
+/// posix_spawn() and connected by a socketpair, every command is sent to it and runs in a subshell forked from that
+/// shell, so big multithreaded runtime process is never copied. Exit codes are reported back by the shell and read
+/// by this thread, which calls completion callbacks.
+class TrikCommandService : public QThread
+{
+public:
+	TrikCommandService();
+
+	/// Terminates helper shell and waits for this thread to finish. Commands that are still running are not killed,
+	/// but waiting for them is bounded: their callbacks are called with -1 if they do not finish in time.
+	~TrikCommandService() override;
+
+	/// Spawns helper shell and starts reading its replies. Returns false if helper can not be started.
+	bool launch();
+
+	/// Returns true if helper shell is running and can execute commands.
+	bool isAvailable() const;
+
+	/// Executes command and waits for it to finish. Returns exit code of a command or -1 if helper has failed.
+	int execute(const QString &command);
+
+	/// Starts command and returns immediately.
+	/// @param callback - called with exit code of a command when it finishes, or with -1 if helper has failed.
+	///        Called in the thread of this service, so it shall be short and thread-safe.
+	/// @returns false if command was not sent to helper, callback will not be called then.
+	bool executeAsync(const QString &command, const std::function<void(int)> &callback);
+
+	/// Returns command that executes given program with given arguments, quoted for shell.
+	static QString commandLine(const QString &program, const QStringList &arguments);
+
+protected:
+	void run() override;
+
+private:
+	/// Calls pending callbacks with -1 and marks helper as unavailable.
+	void failPending();
+
+	/// Our end of a socketpair connected to helper shell, -1 if helper is not running.
+	int mSocket = -1;
+
+	/// Process id of helper shell.
+	pid_t mHelperPid = -1;
+
+	/// Identifier of next request.
+	quint64 mNextId = 1;
+
+	/// Completion callbacks of commands that are still running, by request identifiers.
+	QHash<quint64, std::function<void(int)>> mCallbacks;
+
+	/// True while helper shell is running.
+	bool mAvailable = false;
+
+	/// Guards callbacks, request identifiers and socket writes.
+	mutable QMutex mMutex;
+};
+
+}
+}
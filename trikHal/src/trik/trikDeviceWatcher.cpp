@@ -0,0 +1,87 @@
+/* Copyright 2016 CyberTech Labs Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License. */
+
+
+#include "trikDeviceWatcher.h"
+
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/inotify.h>
+
+#include <QtCore/QFileInfo>
+#include <QtCore/QSocketNotifier>
+
+#include <QsLog.h>
+
+using namespace trikHal::trik;
+
+TrikDeviceWatcher::TrikDeviceWatcher(const QString &fileName)
+	: mFileName(QFileInfo(fileName).fileName().toLocal8Bit())
+{
+	mInotifyDescriptor = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+	if (mInotifyDescriptor == -1) {
+		QLOG_WARN() << "inotify is not available:" << strerror(errno);
+		return;
+	}
+
+	const QByteArray directory = QFileInfo(fileName).absolutePath().toLocal8Bit();
+	if (inotify_add_watch(mInotifyDescriptor, directory.constData(), IN_CREATE | IN_ATTRIB | IN_MOVED_TO) == -1) {
+		QLOG_WARN() << "Can not watch" << directory << ":" << strerror(errno);
+		::close(mInotifyDescriptor);
+		mInotifyDescriptor = -1;
+		return;
+	}
+
+	mSocketNotifier.reset(new QSocketNotifier(mInotifyDescriptor, QSocketNotifier::Read));
+	connect(mSocketNotifier.data(), SIGNAL(activated(int)), this, SLOT(readNotifications()));
+}
+
+TrikDeviceWatcher::~TrikDeviceWatcher()
+{
+	mSocketNotifier.reset();
+	if (mInotifyDescriptor != -1) {
+		::close(mInotifyDescriptor);
+	}
+}
+
+bool TrikDeviceWatcher::isValid() const
+{
+	return mInotifyDescriptor != -1;
+}
+
+void TrikDeviceWatcher::readNotifications()
+{
+	char buffer[4096] __attribute__((aligned(__alignof__(struct inotify_event))));
+	bool isRelevant = false;
+	ssize_t size = 0;
+
+	while ((size = ::read(mInotifyDescriptor, buffer, sizeof(buffer))) > 0) {
+		for (char *position = buffer; position < buffer + size; ) {
+			const struct inotify_event * const event = reinterpret_cast<const struct inotify_event *>(position);
+			if (event->mask & IN_Q_OVERFLOW) {
+				// Some notifications are lost, watched file may be among them.
+				isRelevant = true;
+			} else if (event->len > 0 && mFileName == event->name) {
+				isRelevant = true;
+			}
+
+			position += sizeof(struct inotify_event) + event->len;
+		}
+	}
+
+	if (isRelevant) {
+		emit changed();
+	}
+}
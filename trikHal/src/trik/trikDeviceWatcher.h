@@ -0,0 +1,65 @@
+/* Copyright 2016 CyberTech Labs Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License. */
+
+
+#pragma once
+
+#include <QtCore/QObject>
+#include <QtCore/QByteArray>
+#include <QtCore/QScopedPointer>
+
+class QSocketNotifier;
+
+namespace trikHal {
+namespace trik {
+
+/// Watches for appearance of a device file using inotify on its directory, so waiting for a driver or udev to create
+/// a file does not need polling. Notifications are processed in a thread where watcher is created.
+class TrikDeviceWatcher : public QObject
+{
+	Q_OBJECT
+
+public:
+	/// Constructor. Starts watching immediately, so a file created after construction will not be missed.
+	/// @param fileName - file name (with path, relative or absolute) of a device file to wait for.
+	explicit TrikDeviceWatcher(const QString &fileName);
+
+	~TrikDeviceWatcher() override;
+
+	/// Returns true if inotify watch is established. If not (for example, directory does not exist yet), clients
+	/// shall fall back to polling.
+	bool isValid() const;
+
+signals:
+	/// Emitted when watched file is created, moved into its directory or its attributes are changed (udev sets
+	/// permissions after creating a node). File may still be not ready to be opened.
+	void changed();
+
+private slots:
+	/// Reads pending notifications and emits "changed" if some of them are related to watched file.
+	void readNotifications();
+
+private:
+	/// Name of a watched file without path, as reported by inotify.
+	QByteArray mFileName;
+
+	/// Descriptor of inotify instance, -1 if watch can not be established.
+	int mInotifyDescriptor = -1;
+
+	/// Socket notifier that wakes up watcher when there are notifications.
+	QScopedPointer<QSocketNotifier> mSocketNotifier;
+};
+
+}
+}
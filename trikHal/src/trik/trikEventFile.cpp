@@ -16,6 +16,8 @@
 
 #include <unistd.h>
 #include <fcntl.h>
+#include <time.h>
+#include <sys/ioctl.h>
 #include <linux/input.h>
 
 #include <QtCore/QFileInfo>
@@ -25,19 +27,35 @@
 #include <QtCore/QSocketNotifier>
 
 #include <QsLog.h>
-#include <trikKernel/timeVal.h>
+#include <trikKernel/timestamp.h>
+
+#include "trikDeviceWatcher.h"
+#include "trikIoReactor.h"
 
 using namespace trikHal::trik;
 
-TrikEventFile::TrikEventFile(const QString &fileName, QThread &thread)
+/// Maximal number of events read from event file by one system call.
+static const int eventsPerRead = 64;
+
+/// Time to wait for a driver to create event file, in milliseconds.
+static const int openTimeout = 2000;
+
+/// Interval of attempts to open event file when its directory can not be watched, in milliseconds.
+static const int checkInterval = 100;
+
+TrikEventFile::TrikEventFile(const QString &fileName, QThread &thread, TrikIoReactor *reactor)
 	: mFileName(fileName)
 	, mThread(thread)
+	, mReactor(reactor)
 {
 	moveToThread(&thread);
 }
 
 TrikEventFile::~TrikEventFile()
 {
+	if (mReactor && mEventFileDescriptor != -1) {
+		mReactor->unwatch(mEventFileDescriptor);
+	}
 }
 
 bool TrikEventFile::open()
@@ -46,15 +64,27 @@ bool TrikEventFile::open()
 
 	tryOpenEventFile();
 	if (mEventFileDescriptor == -1) {
-		// Give driver some time to create event file.
+		// Give driver some time to create event file. Watcher wakes us up as soon as the file appears, slots are
+		// called directly since this object may live in a thread that is not started yet.
 		mInitWaitingLoop.reset(new QEventLoop());
+		TrikDeviceWatcher watcher(mFileName);
 		QTimer checkTimer;
-		QObject::connect(&checkTimer, SIGNAL(timeout()), this, SLOT(tryOpenEventFile()));
-		checkTimer.start(100);
-
-		QTimer::singleShot(2000, mInitWaitingLoop.data(), SLOT(quit()));
-
-		mInitWaitingLoop->exec();
+		if (watcher.isValid()) {
+			QObject::connect(&watcher, SIGNAL(changed()), this, SLOT(tryOpenEventFile()), Qt::DirectConnection);
+		} else {
+			QObject::connect(&checkTimer, SIGNAL(timeout()), this, SLOT(tryOpenEventFile()), Qt::DirectConnection);
+			checkTimer.start(checkInterval);
+		}
+
+		QTimer::singleShot(openTimeout, mInitWaitingLoop.data(), SLOT(quit()));
+
+		// File may be created between the first attempt and watch setup.
+		tryOpenEventFile();
+		if (mEventFileDescriptor == -1) {
+			mInitWaitingLoop->exec();
+		}
+
+		mInitWaitingLoop.reset();
 	}
 
 	if (mEventFileDescriptor == -1) {
@@ -62,6 +92,14 @@ bool TrikEventFile::open()
 		return false;
 	}
 
+	if (mReactor) {
+		if (mReactor->watch(mEventFileDescriptor, [this]() { readEvents(); })) {
+			return true;
+		}
+
+		QLOG_WARN() << "Falling back to socket notifier for" << mFileName;
+	}
+
 	mSocketNotifier.reset(new QSocketNotifier(mEventFileDescriptor, QSocketNotifier::Read));
 	mSocketNotifier->moveToThread(&mThread);
 
@@ -78,6 +116,17 @@ void TrikEventFile::tryOpenEventFile()
 
 	mEventFileDescriptor = ::open(mFileName.toStdString().c_str(), O_SYNC | O_NONBLOCK, O_RDONLY);
 
+	if (mEventFileDescriptor != -1) {
+		// Make kernel stamp events by monotonic clock, by default it uses real time clock that jumps with NTP.
+#ifdef EVIOCSCLOCKID
+		int clockId = CLOCK_MONOTONIC;
+		mHasMonotonicTimestamps = ioctl(mEventFileDescriptor, EVIOCSCLOCKID, &clockId) == 0;
+#endif
+		if (!mHasMonotonicTimestamps) {
+			QLOG_WARN() << "Can not switch" << mFileName << "to monotonic clock, using time of reading instead";
+		}
+	}
+
 	if (mEventFileDescriptor != -1 && !mInitWaitingLoop.isNull() && mInitWaitingLoop->isRunning()) {
 		mInitWaitingLoop->quit();
 	}
@@ -94,6 +143,10 @@ bool TrikEventFile::close()
 		mSocketNotifier->setEnabled(false);
 	}
 
+	if (mReactor) {
+		mReactor->unwatch(mEventFileDescriptor);
+	}
+
 	if (::close(mEventFileDescriptor) != 0) {
 		QLOG_ERROR() << QString("%1: close failed: %2").arg(mFileName).arg(strerror(errno));
 		return false;
@@ -105,7 +158,9 @@ bool TrikEventFile::close()
 
 void TrikEventFile::cancelWaiting()
 {
-	mInitWaitingLoop->quit();
+	if (!mInitWaitingLoop.isNull()) {
+		mInitWaitingLoop->quit();
+	}
 }
 
 QString TrikEventFile::fileName() const
@@ -115,23 +170,50 @@ QString TrikEventFile::fileName() const
 
 void TrikEventFile::readFile()
 {
-	struct input_event event;
-	int size = 0;
-
 	mSocketNotifier->setEnabled(false);
+	readEvents();
+	mSocketNotifier->setEnabled(true);
+}
 
-	while ((size = ::read(mEventFileDescriptor, reinterpret_cast<char *>(&event), sizeof(event)))
-			== static_cast<int>(sizeof(event)))
-	{
-		trikKernel::TimeVal eventTime(event.time.tv_sec, event.time.tv_usec);
-		emit newEvent(event.type, event.code, event.value, eventTime);
+void TrikEventFile::readEvents()
+{
+	struct input_event events[eventsPerRead];
+	QVector<InputEvent> batch;
+	int size = 0;
+	const trikKernel::Timestamp readTime = trikKernel::Timestamp::now();
+
+	while ((size = ::read(mEventFileDescriptor, reinterpret_cast<char *>(events), sizeof(events))) > 0) {
+		const int count = size / static_cast<int>(sizeof(struct input_event));
+		for (int i = 0; i < count; ++i) {
+			batch.append({events[i].type, events[i].code, events[i].value, mHasMonotonicTimestamps
+					? trikKernel::Timestamp::fromTimeval(events[i].time.tv_sec, events[i].time.tv_usec)
+					: readTime});
+		}
+
+		if (size % static_cast<int>(sizeof(struct input_event)) != 0) {
+			QLOG_ERROR() << "incomplete data read from" << mFileName;
+			break;
+		}
+
+		if (size < static_cast<int>(sizeof(events))) {
+			// Event file is drained, no need to make one more system call to find it out.
+			break;
+		}
 	}
 
-	if (0 <= size && size < static_cast<int>(sizeof(event))) {
+	if (size == 0) {
 		QLOG_ERROR() << "incomplete data read from" << mFileName;
 	}
 
-	mSocketNotifier->setEnabled(true);
+	if (!batch.isEmpty()) {
+		emit newEvents(batch);
+
+		if (receivers(SIGNAL(newEvent(int, int, int, trikKernel::Timestamp))) > 0) {
+			for (const InputEvent &event : batch) {
+				emit newEvent(event.eventType, event.code, event.value, event.eventTime);
+			}
+		}
+	}
 }
 
 bool TrikEventFile::isOpened() const
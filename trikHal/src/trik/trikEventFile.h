@@ -24,6 +24,8 @@ class QSocketNotifier;
 namespace trikHal {
 namespace trik {
 
+class TrikIoReactor;
+
 /// Real implementation of event file.
 class TrikEventFile : public EventFileInterface
 {
@@ -33,7 +35,8 @@ public:
 	/// Constructor.
 	/// @param fileName - file name (with path, relative or absolute) of an event file.
 	/// @param thread - background thread where all socket events will be processed.
-	TrikEventFile(const QString &fileName, QThread &thread);
+	/// @param reactor - I/O reactor that watches file descriptor instead of socket notifier in "thread", if not null.
+	TrikEventFile(const QString &fileName, QThread &thread, TrikIoReactor *reactor = nullptr);
 
 	~TrikEventFile() override;
 
@@ -51,9 +54,15 @@ private slots:
 	void readFile();
 
 private:
+	/// Reads all available events and emits them.
+	void readEvents();
+
 	/// Low-level file descriptor for event file.
 	int mEventFileDescriptor = -1;
 
+	/// True if kernel stamps events from this file by monotonic clock.
+	bool mHasMonotonicTimestamps = false;
+
 	/// File name of an event file.
 	const QString mFileName;
 
@@ -66,6 +75,9 @@ private:
 
 	/// Socket notifer that is used to listen for events in a file.
 	QScopedPointer<QSocketNotifier> mSocketNotifier;
+
+	/// I/O reactor that is used to listen for events instead of socket notifier, if not null. Does not have ownership.
+	TrikIoReactor *mReactor;
 };
 
 }
@@ -19,15 +19,17 @@
 #include <errno.h>
 
 #include <QtCore/QSocketNotifier>
-#include <QtCore/QStringList>
 
 #include <QsLog.h>
 
+#include "trikIoReactor.h"
+
 using namespace trikHal::trik;
 
-TrikFifo::TrikFifo(const QString &fileName)
+TrikFifo::TrikFifo(const QString &fileName, TrikIoReactor *reactor)
 	: mFileName(fileName)
 	, mFileDescriptor(-1)
+	, mReactor(reactor)
 {
 }
 
@@ -45,6 +47,21 @@ bool TrikFifo::open()
 		return false;
 	}
 
+	// Open blocks until writer appears, but reads shall not block, to be able to drain FIFO completely.
+	fcntl(mFileDescriptor, F_SETFL, fcntl(mFileDescriptor, F_GETFL) | O_NONBLOCK);
+
+	mBuffer.clear();
+
+	if (mReactor && mReactor->watch(mFileDescriptor, [this]() {
+			if (!readData()) {
+				mReactor->unwatch(mFileDescriptor);
+			}
+		}))
+	{
+		QLOG_INFO() << "Opened FIFO file" << mFileName;
+		return true;
+	}
+
 	mSocketNotifier.reset(new QSocketNotifier(mFileDescriptor, QSocketNotifier::Read));
 
 	connect(mSocketNotifier.data(), SIGNAL(activated(int)), this, SLOT(readFile()));
@@ -56,35 +73,51 @@ bool TrikFifo::open()
 
 void TrikFifo::readFile()
 {
-	char data[4000] = {0};
-
 	mSocketNotifier->setEnabled(false);
 
-	if (::read(mFileDescriptor, &data, 4000) < 0) {
-		QLOG_ERROR() << "FIFO read failed: " << strerror(errno);
-		emit readError();
-		return;
+	if (readData()) {
+		mSocketNotifier->setEnabled(true);
 	}
+}
 
-	mBuffer += data;
-
-	if (mBuffer.contains("\n")) {
-		QStringList lines = mBuffer.split('\n', QString::KeepEmptyParts);
-
-		mBuffer = lines.last();
-		lines.removeLast();
+bool TrikFifo::readData()
+{
+	forever {
+		int freeSpace = 0;
+		char * const region = mBuffer.writeRegion(freeSpace);
+		const ssize_t size = ::read(mFileDescriptor, region, freeSpace);
+		if (size < 0) {
+			if (errno == EAGAIN || errno == EINTR) {
+				break;
+			}
+
+			QLOG_ERROR() << "FIFO read failed: " << strerror(errno);
+			emit readError();
+			return false;
+		}
 
-		for (const QString &line : lines) {
-			emit newData(line);
+		mBuffer.commitWrite(size);
+		if (size < freeSpace) {
+			// FIFO is drained (or writer closed it).
+			break;
 		}
 	}
 
-	mSocketNotifier->setEnabled(true);
+	QByteArray line;
+	while (mBuffer.takeLine(line)) {
+		emit newLine(line);
+	}
+
+	return true;
 }
 
 bool TrikFifo::close()
 {
 	if (mFileDescriptor != -1) {
+		if (mReactor) {
+			mReactor->unwatch(mFileDescriptor);
+		}
+
 		bool result = ::close(mFileDescriptor) == 0;
 		mFileDescriptor = -1;
 		return result;
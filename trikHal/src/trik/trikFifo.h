@@ -16,6 +16,8 @@
 
 #include <QtCore/QScopedPointer>
 
+#include <trikKernel/lineBuffer.h>
+
 #include "fifoInterface.h"
 
 class QSocketNotifier;
@@ -23,6 +25,8 @@ class QSocketNotifier;
 namespace trikHal {
 namespace trik {
 
+class TrikIoReactor;
+
 /// Real implementation of FIFO.
 class TrikFifo : public FifoInterface
 {
@@ -31,7 +35,8 @@ class TrikFifo : public FifoInterface
 public:
 	/// Constructor.
 	/// @param fileName - name of a FIFO file.
-	TrikFifo(const QString &fileName);
+	/// @param reactor - I/O reactor that watches file descriptor instead of socket notifier, if not null.
+	TrikFifo(const QString &fileName, TrikIoReactor *reactor = nullptr);
 
 	~TrikFifo() override;
 
@@ -44,6 +49,9 @@ private slots:
 	void readFile();
 
 private:
+	/// Reads available data and emits complete lines. Returns false on read error.
+	bool readData();
+
 	/// Name of a FIFO file.
 	const QString mFileName;
 
@@ -53,8 +61,11 @@ private:
 	/// Notifier for FIFO file that emits a signal when something is changed in it.
 	QScopedPointer<QSocketNotifier> mSocketNotifier;
 
-	/// Buffer with current line being read from FIFO.
-	QString mBuffer;
+	/// Buffer with data read from FIFO, holds incomplete line between reads.
+	trikKernel::LineBuffer mBuffer;
+
+	/// I/O reactor that is used to listen for data instead of socket notifier, if not null. Does not have ownership.
+	TrikIoReactor *mReactor;
 };
 
 }
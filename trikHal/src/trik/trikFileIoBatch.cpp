@@ -0,0 +1,199 @@
+/* Copyright 2016 CyberTech Labs Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License. */
+
+
+#include "trikFileIoBatch.h"
+
+#include <errno.h>
+#include <string.h>
+
+#include <QtCore/QMutexLocker>
+
+#include <QsLog.h>
+
+#include "trikOutputDeviceFile.h"
+
+using namespace trikHal::trik;
+
+TrikFileIoBatch::TrikFileIoBatch(const QSharedPointer<TrikIoUring> &ring)
+	: mRing(ring)
+{
+}
+
+bool TrikFileIoBatch::isValid() const
+{
+	return mRing && mRing->isValid();
+}
+
+void TrikFileIoBatch::write(OutputDeviceFileInterface &file, int value)
+{
+	Operation operation;
+	operation.outputFile = &file;
+	operation.value = value;
+	mOperations.append(operation);
+}
+
+void TrikFileIoBatch::read(InputDeviceFileInterface &file, int count, const ReadCallback &onCompleted)
+{
+	Operation operation;
+	operation.inputFile = &file;
+	operation.value = count;
+	operation.onCompleted = onCompleted;
+	mOperations.append(operation);
+}
+
+void TrikFileIoBatch::submit()
+{
+	// Callbacks may queue operations for the next submit, so queue is detached first.
+	QVector<Operation> operations;
+	operations.swap(mOperations);
+
+	// Writes go to io_uring only if all of them can and each file is written once. Otherwise direct writes would be
+	// reordered with linked ones, and repeated writes to a file could not be skipped by comparing with its last value.
+	bool writesToRing = !mRing.isNull();
+	for (int i = 0; i < operations.size() && writesToRing; ++i) {
+		OutputDeviceFileInterface * const outputFile = operations[i].outputFile;
+		if (!outputFile) {
+			continue;
+		}
+
+		const TrikOutputDeviceFile * const file = dynamic_cast<TrikOutputDeviceFile *>(outputFile);
+		writesToRing = file && file->isSysfsAttribute() && file->fileDescriptor() != -1;
+		for (int j = 0; j < i && writesToRing; ++j) {
+			writesToRing = operations[j].outputFile != outputFile;
+		}
+	}
+
+	QVector<int> writes;
+	QVector<int> reads;
+	for (int i = 0; i < operations.size() && mRing; ++i) {
+		Operation &operation = operations[i];
+		if (operation.outputFile) {
+			if (!writesToRing) {
+				continue;
+			}
+
+			TrikOutputDeviceFile * const file = static_cast<TrikOutputDeviceFile *>(operation.outputFile);
+
+			operation.size = file->formatValue(operation.value, operation.buffer, sizeof(operation.buffer));
+			if (operation.size == 0) {
+				// File already contains this value, direct write will skip it without a system call.
+				continue;
+			}
+
+			operation.fileDescriptor = file->fileDescriptor();
+			writes.append(i);
+		} else {
+			TrikInputDeviceFile * const file = dynamic_cast<TrikInputDeviceFile *>(operation.inputFile);
+			if (!file || file->fileDescriptor() == -1) {
+				continue;
+			}
+
+			operation.fileDescriptor = file->fileDescriptor();
+			reads.append(i);
+		}
+	}
+
+	if (writes.size() + reads.size() > 1) {
+		QMutexLocker locker(&mRing->mutex());
+		submitToRing(operations, writes, reads);
+	}
+
+	for (Operation &operation : operations) {
+		if (operation.outputFile) {
+			if (!operation.completed || operation.result == -ECANCELED) {
+				// Not handled by io_uring or cancelled because previous linked write has failed.
+				operation.outputFile->write(operation.value);
+			} else {
+				if (operation.result != operation.size) {
+					QLOG_ERROR() << "Failed to write to output device file" << operation.outputFile->fileName()
+							<< ":" << strerror(-operation.result);
+				}
+
+				static_cast<TrikOutputDeviceFile *>(operation.outputFile)->onValueWritten(operation.value
+						, operation.result == operation.size);
+			}
+		}
+	}
+
+	for (Operation &operation : operations) {
+		if (!operation.inputFile) {
+			continue;
+		}
+
+		QVector<int> values(operation.value, 0);
+		int parsed = -1;
+		if (!operation.completed) {
+			parsed = operation.inputFile->readIntegers(values.data(), values.size());
+		} else if (operation.result >= 0) {
+			parsed = TrikInputDeviceFile::parseIntegers(operation.buffer, operation.result, values.data()
+					, values.size());
+		} else {
+			QLOG_ERROR() << "Failed to read input device file:" << strerror(-operation.result);
+		}
+
+		if (operation.onCompleted) {
+			operation.onCompleted(parsed, values);
+		}
+	}
+}
+
+void TrikFileIoBatch::submitToRing(QVector<Operation> &operations, const QVector<int> &writes
+		, const QVector<int> &reads)
+{
+	if (!mRing->isValid()) {
+		return;
+	}
+
+	for (int i = 0; i < writes.size(); ++i) {
+		if (mRing->prepared() == mRing->capacity() && !submitPrepared(operations)) {
+			return;
+		}
+
+		// Link can not span submissions, order is kept there by waiting for completion of the previous one.
+		const bool linkNext = i + 1 < writes.size() && mRing->prepared() + 1 < mRing->capacity();
+		Operation &operation = operations[writes[i]];
+		mRing->prepareWrite(operation.fileDescriptor, operation.buffer, operation.size
+				, static_cast<quint64>(writes[i]), linkNext);
+	}
+
+	for (const int index : reads) {
+		if (mRing->prepared() == mRing->capacity() && !submitPrepared(operations)) {
+			return;
+		}
+
+		Operation &operation = operations[index];
+		mRing->prepareRead(operation.fileDescriptor, operation.buffer, sizeof(operation.buffer)
+				, static_cast<quint64>(index));
+	}
+
+	if (mRing->prepared() > 0) {
+		submitPrepared(operations);
+	}
+}
+
+bool TrikFileIoBatch::submitPrepared(QVector<Operation> &operations)
+{
+	const bool submitted = mRing->submitAndWait([&operations](quint64 index, int result) {
+		Operation &operation = operations[static_cast<int>(index)];
+		operation.result = result;
+		operation.completed = true;
+	});
+
+	if (!submitted) {
+		QLOG_ERROR() << "io_uring submission failed, falling back to direct device file access";
+	}
+
+	return submitted;
+}
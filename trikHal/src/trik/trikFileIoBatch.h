@@ -0,0 +1,92 @@
+/* Copyright 2016 CyberTech Labs Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License. */
+
+
+#pragma once
+
+#include <QtCore/QSharedPointer>
+#include <QtCore/QVector>
+
+#include "fileIoBatchInterface.h"
+
+#include "trikInputDeviceFile.h"
+#include "trikIoUring.h"
+
+namespace trikHal {
+namespace trik {
+
+/// Batch of device file reads and writes that is submitted to kernel with one io_uring system call. Writes go to
+/// io_uring only for sysfs attributes, ordinary files need truncation after a write. Operations that can not be
+/// handled by io_uring (other implementations of device file interfaces, FIFOs, ordinary files) and batches with a
+/// single operation are executed directly through file interfaces. Writes go to io_uring only when all writes of a
+/// batch can and each file is written once, so that their order and skipping of unchanged values are the same as with
+/// direct execution.
+class TrikFileIoBatch : public FileIoBatchInterface
+{
+public:
+	/// Constructor.
+	/// @param ring - io_uring instance, shared by all batches of hardware abstraction.
+	explicit TrikFileIoBatch(const QSharedPointer<TrikIoUring> &ring);
+
+	/// Returns true if io_uring is set up and batch can be submitted with one system call.
+	bool isValid() const;
+
+	void write(OutputDeviceFileInterface &file, int value) override;
+	void read(InputDeviceFileInterface &file, int count, const ReadCallback &onCompleted) override;
+	void submit() override;
+
+private:
+	/// Queued operation, either read or write.
+	struct Operation {
+		OutputDeviceFileInterface *outputFile = nullptr;
+		InputDeviceFileInterface *inputFile = nullptr;
+
+		/// Value to write or number of integers to read.
+		int value = 0;
+
+		ReadCallback onCompleted;
+
+		/// Descriptor for io_uring, -1 if operation is executed directly through file interface.
+		int fileDescriptor = -1;
+
+		/// Formatted value for writes, raw file contents for reads.
+		char buffer[TrikInputDeviceFile::readBufferSize];
+
+		/// Size of formatted value for writes.
+		int size = 0;
+
+		/// Number of transferred bytes or negated errno for io_uring operations.
+		int result = 0;
+
+		/// True if io_uring reported completion of this operation.
+		bool completed = false;
+	};
+
+	/// Prepares given operations in io_uring, writes first, and submits them, splitting into several submissions if
+	/// ring is too small. Consecutive writes are linked to keep their order. Shall be called with ring mutex held.
+	void submitToRing(QVector<Operation> &operations, const QVector<int> &writes, const QVector<int> &reads);
+
+	/// Submits prepared io_uring operations and stores their results. Returns false if submission fails, incomplete
+	/// operations are executed directly then.
+	bool submitPrepared(QVector<Operation> &operations);
+
+	/// Shared io_uring instance.
+	QSharedPointer<TrikIoUring> mRing;
+
+	/// Operations queued since last submit().
+	QVector<Operation> mOperations;
+};
+
+}
+}
@@ -21,15 +21,29 @@
 #include "trikInputDeviceFile.h"
 #include "trikOutputDeviceFile.h"
 #include "trikFifo.h"
+#include "trikFileIoBatch.h"
+#include "src/sequentialFileIoBatch.h"
+#include "trikIoReactor.h"
+#include "trikIoUring.h"
+
+#include <QsLog.h>
 
 using namespace trikHal;
 using namespace trikHal::trik;
 
+/// Maximal number of file I/O batch operations submitted to io_uring with one system call, larger batches are split.
+static const int ioUringEntries = 32;
+
 TrikHardwareAbstraction::TrikHardwareAbstraction()
 	: mI2c(new TrikMspI2c())
 	, mUsb(new TrikMspUsb())
 	, mSystemConsole(new TrikSystemConsole())
+	, mIoUring(new TrikIoUring(ioUringEntries))
 {
+	QLOG_INFO() << "io_uring is" << (mIoUring->isValid() ? "supported" : "not supported") << "by kernel";
+	if (!mIoUring->isValid()) {
+		mIoUring.reset();
+	}
 }
 
 TrikHardwareAbstraction::~TrikHardwareAbstraction()
@@ -51,14 +65,23 @@ SystemConsoleInterface &TrikHardwareAbstraction::systemConsole()
 	return *mSystemConsole.data();
 }
 
+void TrikHardwareAbstraction::setIoReactorEnabled(bool enabled)
+{
+	if (enabled && !mIoReactor) {
+		mIoReactor.reset(new TrikIoReactor());
+	} else if (!enabled && mIoReactor) {
+		QLOG_WARN() << "I/O reactor can not be disabled when it is already used";
+	}
+}
+
 EventFileInterface *TrikHardwareAbstraction::createEventFile(const QString &fileName, QThread &thread) const
 {
-	return new TrikEventFile(fileName, thread);
+	return new TrikEventFile(fileName, thread, mIoReactor.data());
 }
 
 FifoInterface *TrikHardwareAbstraction::createFifo(const QString &fileName) const
 {
-	return new TrikFifo(fileName);
+	return new TrikFifo(fileName, mIoReactor.data());
 }
 
 InputDeviceFileInterface *TrikHardwareAbstraction::createInputDeviceFile(const QString &fileName) const
@@ -70,3 +93,12 @@ OutputDeviceFileInterface *TrikHardwareAbstraction::createOutputDeviceFile(const
 {
 	return new TrikOutputDeviceFile(fileName);
 }
+
+FileIoBatchInterface *TrikHardwareAbstraction::createFileIoBatch() const
+{
+	if (mIoUring) {
+		return new TrikFileIoBatch(mIoUring);
+	}
+
+	return new SequentialFileIoBatch();
+}
@@ -17,10 +17,14 @@
 #include "hardwareAbstractionInterface.h"
 
 #include <QtCore/QScopedPointer>
+#include <QtCore/QSharedPointer>
 
 namespace trikHal {
 namespace trik {
 
+class TrikIoReactor;
+class TrikIoUring;
+
 /// Hardware abstraction layer for a real robot.
 class TrikHardwareAbstraction : public HardwareAbstractionInterface
 {
@@ -32,10 +36,13 @@ public:
 	MspUsbInterface &mspUsb() override;
 	SystemConsoleInterface &systemConsole() override;
 
+	void setIoReactorEnabled(bool enabled) override;
+
 	EventFileInterface *createEventFile(const QString &fileName, QThread &thread) const override;
 	FifoInterface *createFifo(const QString &fileName) const override;
 	InputDeviceFileInterface *createInputDeviceFile(const QString &fileName) const override;
 	OutputDeviceFileInterface *createOutputDeviceFile(const QString &fileName) const override;
+	FileIoBatchInterface *createFileIoBatch() const override;
 
 private:
 	/// I2C bus communicator.
@@ -46,6 +53,12 @@ private:
 
 	/// System console abstraction.
 	QScopedPointer<SystemConsoleInterface> mSystemConsole;
+
+	/// I/O reactor for event files and FIFOs, null if disabled.
+	QScopedPointer<TrikIoReactor> mIoReactor;
+
+	/// io_uring instance shared by all file I/O batches, null if kernel does not support io_uring.
+	QSharedPointer<TrikIoUring> mIoUring;
 };
 
 }
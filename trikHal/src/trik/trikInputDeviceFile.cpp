@@ -14,6 +14,9 @@
 
 #include "trikInputDeviceFile.h"
 
+#include <unistd.h>
+#include <errno.h>
+
 #include <QsLog.h>
 
 using namespace trikHal::trik;
@@ -52,3 +55,54 @@ void TrikInputDeviceFile::reset()
 {
 	mStream.seek(0);
 }
+
+int TrikInputDeviceFile::readIntegers(int *values, int count)
+{
+	const int descriptor = mFile.handle();
+	if (descriptor == -1) {
+		return -1;
+	}
+
+	char buffer[readBufferSize];
+	ssize_t size = 0;
+	do {
+		size = pread(descriptor, buffer, sizeof(buffer), 0);
+	} while (size == -1 && errno == EINTR);
+
+	if (size < 0) {
+		QLOG_ERROR() << "Failed to read input device file" << mFile.fileName();
+		return -1;
+	}
+
+	return parseIntegers(buffer, static_cast<int>(size), values, count);
+}
+
+int TrikInputDeviceFile::fileDescriptor() const
+{
+	return mFile.handle();
+}
+
+int TrikInputDeviceFile::parseIntegers(const char *data, int size, int *values, int count)
+{
+	int parsed = 0;
+	int position = 0;
+	while (parsed < count && position < size) {
+		const bool negative = data[position] == '-';
+		const int digitsStart = negative ? position + 1 : position;
+		if (digitsStart >= size || data[digitsStart] < '0' || data[digitsStart] > '9') {
+			++position;
+			continue;
+		}
+
+		int value = 0;
+		position = digitsStart;
+		while (position < size && data[position] >= '0' && data[position] <= '9') {
+			value = value * 10 + (data[position] - '0');
+			++position;
+		}
+
+		values[parsed++] = negative ? -value : value;
+	}
+
+	return parsed;
+}
@@ -34,6 +34,17 @@ public:
 	void close() override;
 	QTextStream &stream() override;
 	void reset() override;
+	int readIntegers(int *values, int count) override;
+
+	/// Returns descriptor of opened file for batched reads, -1 if file is not opened.
+	int fileDescriptor() const;
+
+	/// Parses integers from raw file contents, as readIntegers() does.
+	/// @returns number of parsed integers.
+	static int parseIntegers(const char *data, int size, int *values, int count);
+
+	/// Size of a buffer for readIntegers(), sysfs attributes we read are much shorter.
+	static const int readBufferSize = 64;
 
 private:
 	/// Underlying file.
@@ -0,0 +1,141 @@
+/* Copyright 2016 CyberTech Labs Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License. */
+
+#include "trikIoReactor.h"
+
+#include <unistd.h>
+#include <errno.h>
+#include <string.h>
+#include <stdint.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+
+#include <QsLog.h>
+
+using namespace trikHal::trik;
+
+/// Maximal number of descriptor events processed by one epoll_wait call.
+static const int maxEvents = 16;
+
+TrikIoReactor::TrikIoReactor()
+	: mLock(QMutex::Recursive)
+{
+	mEpollDescriptor = epoll_create1(EPOLL_CLOEXEC);
+	mWakeUpDescriptor = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+	if (mEpollDescriptor == -1 || mWakeUpDescriptor == -1) {
+		QLOG_ERROR() << "Failed to create I/O reactor:" << strerror(errno);
+		return;
+	}
+
+	struct epoll_event event;
+	memset(&event, 0, sizeof(event));
+	event.events = EPOLLIN;
+	event.data.fd = mWakeUpDescriptor;
+	epoll_ctl(mEpollDescriptor, EPOLL_CTL_ADD, mWakeUpDescriptor, &event);
+
+	setObjectName("I/O reactor");
+	start();
+	QLOG_INFO() << "I/O reactor started";
+}
+
+TrikIoReactor::~TrikIoReactor()
+{
+	if (isRunning()) {
+		mLock.lock();
+		mStopping = true;
+		mLock.unlock();
+		wakeUp();
+		wait();
+	}
+
+	if (mWakeUpDescriptor != -1) {
+		::close(mWakeUpDescriptor);
+	}
+
+	if (mEpollDescriptor != -1) {
+		::close(mEpollDescriptor);
+	}
+}
+
+bool TrikIoReactor::watch(int fileDescriptor, const std::function<void()> &handler)
+{
+	if (mEpollDescriptor == -1) {
+		return false;
+	}
+
+	QMutexLocker lock(&mLock);
+	struct epoll_event event;
+	memset(&event, 0, sizeof(event));
+	event.events = EPOLLIN;
+	event.data.fd = fileDescriptor;
+	if (epoll_ctl(mEpollDescriptor, EPOLL_CTL_ADD, fileDescriptor, &event) != 0) {
+		QLOG_ERROR() << "I/O reactor can not watch descriptor" << fileDescriptor << ":" << strerror(errno);
+		return false;
+	}
+
+	mHandlers.insert(fileDescriptor, handler);
+	return true;
+}
+
+void TrikIoReactor::unwatch(int fileDescriptor)
+{
+	QMutexLocker lock(&mLock);
+	if (mHandlers.remove(fileDescriptor) > 0) {
+		epoll_ctl(mEpollDescriptor, EPOLL_CTL_DEL, fileDescriptor, nullptr);
+	}
+}
+
+void TrikIoReactor::run()
+{
+	struct epoll_event events[maxEvents];
+	forever {
+		const int count = epoll_wait(mEpollDescriptor, events, maxEvents, -1);
+		if (count < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+
+			QLOG_ERROR() << "I/O reactor failed:" << strerror(errno);
+			return;
+		}
+
+		QMutexLocker lock(&mLock);
+		if (mStopping) {
+			return;
+		}
+
+		for (int i = 0; i < count; ++i) {
+			const int fileDescriptor = events[i].data.fd;
+			if (fileDescriptor == mWakeUpDescriptor) {
+				uint64_t value = 0;
+				const ssize_t result = ::read(mWakeUpDescriptor, &value, sizeof(value));
+				Q_UNUSED(result);
+				continue;
+			}
+
+			// Descriptor may be unwatched by a handler called earlier in this loop.
+			const auto handler = mHandlers.value(fileDescriptor);
+			if (handler) {
+				handler();
+			}
+		}
+	}
+}
+
+void TrikIoReactor::wakeUp()
+{
+	const uint64_t value = 1;
+	const ssize_t result = ::write(mWakeUpDescriptor, &value, sizeof(value));
+	Q_UNUSED(result);
+}
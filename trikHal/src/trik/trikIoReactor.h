@@ -0,0 +1,71 @@
+/* Copyright 2016 CyberTech Labs Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License. */
+
+#pragma once
+
+#include <functional>
+
+#include <QtCore/QThread>
+#include <QtCore/QHash>
+#include <QtCore/QMutex>
+
+namespace trikHal {
+namespace trik {
+
+/// Single thread that watches file descriptors of event files and FIFOs using epoll and calls their handlers, instead
+/// of a socket notifier in a thread of each device. Handlers are called in reactor thread, so they shall only read
+/// data and emit signals, receivers in other threads get them through queued connections.
+class TrikIoReactor : public QThread
+{
+public:
+	TrikIoReactor();
+
+	/// Stops reactor thread and waits for it to finish.
+	~TrikIoReactor() override;
+
+	/// Starts watching given descriptor for incoming data. Returns false if descriptor can not be watched.
+	/// @param fileDescriptor - descriptor to watch, must remain opened until "unwatch" is called.
+	/// @param handler - function that is called in reactor thread when there is data to read. Descriptor is watched
+	///        in level-triggered mode, so handler will be called again if it does not read all available data.
+	bool watch(int fileDescriptor, const std::function<void()> &handler);
+
+	/// Stops watching given descriptor. When it returns, handler is not running and will not be called again.
+	void unwatch(int fileDescriptor);
+
+protected:
+	void run() override;
+
+private:
+	/// Wakes up reactor thread.
+	void wakeUp();
+
+	/// epoll instance descriptor.
+	int mEpollDescriptor = -1;
+
+	/// eventfd descriptor used to wake reactor thread up when it shall stop.
+	int mWakeUpDescriptor = -1;
+
+	/// Flag that reactor shall stop.
+	bool mStopping = false;
+
+	/// Handlers of watched descriptors.
+	QHash<int, std::function<void()>> mHandlers;
+
+	/// Guards handlers and is held while a handler runs, so "unwatch" waits for running handler. Recursive, since
+	/// handler may unwatch its own descriptor.
+	QMutex mLock;
+};
+
+}
+}
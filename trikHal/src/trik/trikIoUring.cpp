@@ -0,0 +1,321 @@
+/* Copyright 2016 CyberTech Labs Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License. */
+
+
+#include "trikIoUring.h"
+
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+
+#if defined(__has_include)
+	#if __has_include(<linux/io_uring.h>)
+		#include <linux/io_uring.h>
+		#define TRIK_HAS_IO_URING
+	#endif
+#endif
+
+#include <QsLog.h>
+
+using namespace trikHal::trik;
+
+/// Number of attempts to wait for consumed operations after io_uring_enter() failure.
+static const int recoveryAttempts = 3;
+
+TrikIoUring::TrikIoUring(unsigned entries)
+	: mEntries(entries)
+{
+	setup();
+}
+
+#if defined(TRIK_HAS_IO_URING) && defined(__NR_io_uring_setup) && defined(__NR_io_uring_enter)
+
+void TrikIoUring::setup()
+{
+	struct io_uring_params parameters;
+	memset(&parameters, 0, sizeof(parameters));
+	mRingDescriptor = static_cast<int>(syscall(__NR_io_uring_setup, mEntries, &parameters));
+	if (mRingDescriptor == -1) {
+		return;
+	}
+
+	mSubmissionRingSize = parameters.sq_off.array + parameters.sq_entries * sizeof(unsigned);
+	mCompletionRingSize = parameters.cq_off.cqes + parameters.cq_entries * sizeof(struct io_uring_cqe);
+	const bool singleMapping = parameters.features & IORING_FEAT_SINGLE_MMAP;
+	if (singleMapping) {
+		mSubmissionRingSize = qMax(mSubmissionRingSize, mCompletionRingSize);
+	}
+
+	mSubmissionRing = mmap(nullptr, mSubmissionRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE
+			, mRingDescriptor, IORING_OFF_SQ_RING);
+	if (mSubmissionRing == MAP_FAILED) {
+		mSubmissionRing = nullptr;
+		release();
+		return;
+	}
+
+	if (singleMapping) {
+		mCompletionRing = mSubmissionRing;
+		mCompletionRingSize = 0;
+	} else {
+		mCompletionRing = mmap(nullptr, mCompletionRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE
+				, mRingDescriptor, IORING_OFF_CQ_RING);
+		if (mCompletionRing == MAP_FAILED) {
+			mCompletionRing = nullptr;
+			release();
+			return;
+		}
+	}
+
+	mSubmissionEntriesSize = parameters.sq_entries * sizeof(struct io_uring_sqe);
+	mSubmissionEntries = mmap(nullptr, mSubmissionEntriesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE
+			, mRingDescriptor, IORING_OFF_SQES);
+	if (mSubmissionEntries == MAP_FAILED) {
+		mSubmissionEntries = nullptr;
+		release();
+		return;
+	}
+
+	char * const submissionRing = static_cast<char *>(mSubmissionRing);
+	mSubmissionTail = reinterpret_cast<unsigned *>(submissionRing + parameters.sq_off.tail);
+	mSubmissionMask = *reinterpret_cast<unsigned *>(submissionRing + parameters.sq_off.ring_mask);
+	mSubmissionArray = reinterpret_cast<unsigned *>(submissionRing + parameters.sq_off.array);
+	mSubmissionEntriesCount = parameters.sq_entries;
+
+	char * const completionRing = static_cast<char *>(mCompletionRing);
+	mCompletionHead = reinterpret_cast<unsigned *>(completionRing + parameters.cq_off.head);
+	mCompletionTail = reinterpret_cast<unsigned *>(completionRing + parameters.cq_off.tail);
+	mCompletionMask = *reinterpret_cast<unsigned *>(completionRing + parameters.cq_off.ring_mask);
+	mCompletionEntries = completionRing + parameters.cq_off.cqes;
+
+	mLocalTail = *mSubmissionTail;
+	mPrepared = 0;
+	mBuffers.resize(static_cast<int>(mSubmissionEntriesCount));
+}
+
+bool TrikIoUring::prepare(int opcode, int fileDescriptor, const void *buffer, int size, quint64 userData
+		, bool linkNext)
+{
+	if (!isValid() || mPrepared == capacity()) {
+		return false;
+	}
+
+	const unsigned index = mLocalTail & mSubmissionMask;
+	struct iovec &iov = mBuffers[static_cast<int>(index)];
+	iov.iov_base = const_cast<void *>(buffer);
+	iov.iov_len = static_cast<size_t>(size);
+
+	struct io_uring_sqe &entry = static_cast<struct io_uring_sqe *>(mSubmissionEntries)[index];
+	memset(&entry, 0, sizeof(entry));
+	entry.opcode = static_cast<__u8>(opcode);
+	entry.flags = linkNext ? IOSQE_IO_LINK : 0;
+	entry.fd = fileDescriptor;
+	entry.off = 0;
+	entry.addr = reinterpret_cast<__u64>(&iov);
+	entry.len = 1;
+	entry.user_data = userData;
+
+	mSubmissionArray[index] = index;
+	++mLocalTail;
+	++mPrepared;
+	return true;
+}
+
+bool TrikIoUring::prepareRead(int fileDescriptor, void *buffer, int size, quint64 userData)
+{
+	return prepare(IORING_OP_READV, fileDescriptor, buffer, size, userData, false);
+}
+
+bool TrikIoUring::prepareWrite(int fileDescriptor, const void *buffer, int size, quint64 userData, bool linkNext)
+{
+	return prepare(IORING_OP_WRITEV, fileDescriptor, buffer, size, userData, linkNext);
+}
+
+bool TrikIoUring::submitAndWait(const std::function<void(quint64 userData, int result)> &onCompleted)
+{
+	if (!isValid()) {
+		return false;
+	}
+
+	// Kernel reads the tail only after entries are filled.
+	__atomic_store_n(mSubmissionTail, mLocalTail, __ATOMIC_RELEASE);
+
+	int toSubmit = mPrepared;
+	int toComplete = mPrepared;
+	mPrepared = 0;
+
+	while (toComplete > 0) {
+		++mSystemCalls;
+		const long result = syscall(__NR_io_uring_enter, mRingDescriptor, toSubmit, 1, IORING_ENTER_GETEVENTS
+				, nullptr, 0);
+		if (result < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+
+			QLOG_ERROR() << "io_uring_enter failed:" << strerror(errno);
+			recover(toComplete - toSubmit, onCompleted);
+			return false;
+		}
+
+		toSubmit -= qMin(toSubmit, static_cast<int>(result));
+		toComplete -= reap(onCompleted);
+	}
+
+	return true;
+}
+
+int TrikIoUring::reap(const std::function<void(quint64 userData, int result)> &onCompleted)
+{
+	struct io_uring_cqe * const completions = static_cast<struct io_uring_cqe *>(mCompletionEntries);
+	unsigned head = *mCompletionHead;
+	const unsigned tail = __atomic_load_n(mCompletionTail, __ATOMIC_ACQUIRE);
+	int reaped = 0;
+	for (; head != tail; ++head) {
+		const struct io_uring_cqe &completion = completions[head & mCompletionMask];
+		++reaped;
+		onCompleted(completion.user_data, completion.res);
+	}
+
+	__atomic_store_n(mCompletionHead, head, __ATOMIC_RELEASE);
+	return reaped;
+}
+
+void TrikIoUring::recover(int inFlight, const std::function<void(quint64 userData, int result)> &onCompleted)
+{
+	inFlight -= reap(onCompleted);
+	for (int attempt = 0; inFlight > 0 && attempt < recoveryAttempts; ++attempt) {
+		++mSystemCalls;
+		const long result = syscall(__NR_io_uring_enter, mRingDescriptor, 0, inFlight, IORING_ENTER_GETEVENTS
+				, nullptr, 0);
+		if (result < 0 && errno != EINTR) {
+			break;
+		}
+
+		inFlight -= reap(onCompleted);
+	}
+
+	release();
+	setup();
+	if (!isValid()) {
+		QLOG_ERROR() << "Failed to set up io_uring again:" << strerror(errno);
+	}
+}
+
+#else
+
+void TrikIoUring::setup()
+{
+}
+
+bool TrikIoUring::prepare(int opcode, int fileDescriptor, const void *buffer, int size, quint64 userData
+		, bool linkNext)
+{
+	Q_UNUSED(opcode)
+	Q_UNUSED(fileDescriptor)
+	Q_UNUSED(buffer)
+	Q_UNUSED(size)
+	Q_UNUSED(userData)
+	Q_UNUSED(linkNext)
+	return false;
+}
+
+bool TrikIoUring::prepareRead(int fileDescriptor, void *buffer, int size, quint64 userData)
+{
+	return prepare(0, fileDescriptor, buffer, size, userData, false);
+}
+
+bool TrikIoUring::prepareWrite(int fileDescriptor, const void *buffer, int size, quint64 userData, bool linkNext)
+{
+	return prepare(0, fileDescriptor, buffer, size, userData, linkNext);
+}
+
+bool TrikIoUring::submitAndWait(const std::function<void(quint64 userData, int result)> &onCompleted)
+{
+	Q_UNUSED(onCompleted)
+	return false;
+}
+
+int TrikIoUring::reap(const std::function<void(quint64 userData, int result)> &onCompleted)
+{
+	Q_UNUSED(onCompleted)
+	return 0;
+}
+
+void TrikIoUring::recover(int inFlight, const std::function<void(quint64 userData, int result)> &onCompleted)
+{
+	Q_UNUSED(inFlight)
+	Q_UNUSED(onCompleted)
+}
+
+#endif
+
+TrikIoUring::~TrikIoUring()
+{
+	release();
+}
+
+bool TrikIoUring::isValid() const
+{
+	return mRingDescriptor != -1;
+}
+
+int TrikIoUring::capacity() const
+{
+	return static_cast<int>(mSubmissionEntriesCount);
+}
+
+int TrikIoUring::prepared() const
+{
+	return mPrepared;
+}
+
+quint64 TrikIoUring::systemCalls() const
+{
+	return mSystemCalls;
+}
+
+QMutex &TrikIoUring::mutex()
+{
+	return mMutex;
+}
+
+void TrikIoUring::release()
+{
+	if (mSubmissionEntries) {
+		munmap(mSubmissionEntries, mSubmissionEntriesSize);
+		mSubmissionEntries = nullptr;
+	}
+
+	if (mCompletionRing && mCompletionRing != mSubmissionRing) {
+		munmap(mCompletionRing, mCompletionRingSize);
+	}
+
+	mCompletionRing = nullptr;
+
+	if (mSubmissionRing) {
+		munmap(mSubmissionRing, mSubmissionRingSize);
+		mSubmissionRing = nullptr;
+	}
+
+	if (mRingDescriptor != -1) {
+		::close(mRingDescriptor);
+		mRingDescriptor = -1;
+	}
+
+	mSubmissionEntriesCount = 0;
+	mPrepared = 0;
+}
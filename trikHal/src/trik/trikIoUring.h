@@ -0,0 +1,127 @@
+/* Copyright 2016 CyberTech Labs Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License. */
+
+
+#pragma once
+
+#include <functional>
+
+#include <sys/uio.h>
+
+#include <QtCore/QMutex>
+#include <QtCore/QVector>
+
+namespace trikHal {
+namespace trik {
+
+/// Minimal io_uring instance on top of raw system calls. Used to submit a batch of positioned file reads and writes
+/// with one system call and wait for all of them. Kernels older than 5.1 do not support it, see isValid().
+/// Instance is not thread-safe, users that share it shall hold mutex() while preparing and submitting operations.
+class TrikIoUring
+{
+public:
+	/// Constructor. Sets up submission and completion queues.
+	/// @param entries - maximal number of operations submitted at once.
+	explicit TrikIoUring(unsigned entries);
+
+	~TrikIoUring();
+
+	/// Returns true if io_uring is supported by kernel and queues are set up.
+	bool isValid() const;
+
+	/// Returns maximal number of operations that can be prepared before submit.
+	int capacity() const;
+
+	/// Returns number of operations prepared since last submit.
+	int prepared() const;
+
+	/// Prepares read of up to "size" bytes at offset 0 of a file. Returns false if submission queue is full.
+	/// @param userData - value passed back to completion handler.
+	bool prepareRead(int fileDescriptor, void *buffer, int size, quint64 userData);
+
+	/// Prepares write of "size" bytes at offset 0 of a file. Returns false if submission queue is full.
+	/// @param userData - value passed back to completion handler.
+	/// @param linkNext - if true, next prepared operation starts only after this one succeeds, otherwise it is
+	///        completed with -ECANCELED.
+	bool prepareWrite(int fileDescriptor, const void *buffer, int size, quint64 userData, bool linkNext = false);
+
+	/// Submits all prepared operations with one system call and waits for their completion.
+	/// @param onCompleted - called for each completed operation with its user data and result, which is number of
+	///        transferred bytes or negated errno.
+	/// @returns false if operations can not be submitted, completion handler is not called for them then. Ring is
+	///        set up anew after a failure, see isValid().
+	bool submitAndWait(const std::function<void(quint64 userData, int result)> &onCompleted);
+
+	/// Returns number of io_uring_enter() system calls made so far, for diagnostics and benchmarks.
+	quint64 systemCalls() const;
+
+	/// Guards the ring when it is shared by several users.
+	QMutex &mutex();
+
+private:
+	/// Sets up submission and completion queues, isValid() is false if it fails.
+	void setup();
+
+	/// Fills next submission queue entry.
+	bool prepare(int opcode, int fileDescriptor, const void *buffer, int size, quint64 userData, bool linkNext);
+
+	/// Passes all available completions to a handler. Returns number of reaped completions.
+	int reap(const std::function<void(quint64 userData, int result)> &onCompleted);
+
+	/// Brings ring to a clean state after failed io_uring_enter(): waits for operations that kernel has already
+	/// consumed, since they refer to caller's buffers, then sets up the ring anew to drop unconsumed entries.
+	void recover(int inFlight, const std::function<void(quint64 userData, int result)> &onCompleted);
+
+	/// Unmaps queues and closes io_uring descriptor.
+	void release();
+
+	/// Requested number of submission queue entries.
+	const unsigned mEntries;
+
+	int mRingDescriptor = -1;
+
+	void *mSubmissionRing = nullptr;
+	size_t mSubmissionRingSize = 0;
+	void *mCompletionRing = nullptr;
+	size_t mCompletionRingSize = 0;
+	void *mSubmissionEntries = nullptr;
+	size_t mSubmissionEntriesSize = 0;
+
+	unsigned *mSubmissionTail = nullptr;
+	unsigned mSubmissionMask = 0;
+	unsigned *mSubmissionArray = nullptr;
+	unsigned mSubmissionEntriesCount = 0;
+
+	unsigned *mCompletionHead = nullptr;
+	unsigned *mCompletionTail = nullptr;
+	unsigned mCompletionMask = 0;
+	void *mCompletionEntries = nullptr;
+
+	/// Tail of submission queue including prepared but not yet submitted entries.
+	unsigned mLocalTail = 0;
+
+	/// Number of prepared but not yet submitted entries.
+	int mPrepared = 0;
+
+	/// Number of io_uring_enter() system calls made so far.
+	quint64 mSystemCalls = 0;
+
+	/// Buffer descriptors for prepared operations, indexed like submission queue entries.
+	QVector<struct iovec> mBuffers;
+
+	QMutex mMutex;
+};
+
+}
+}
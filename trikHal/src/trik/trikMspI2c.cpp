@@ -14,7 +14,9 @@
 
 #include "trikMspI2c.h"
 
+#include <errno.h>
 #include <fcntl.h>
+#include <string.h>
 #include <sys/ioctl.h>
 #include <linux/i2c-dev.h>
 #include <linux/i2c.h>
@@ -22,8 +24,12 @@
 
 #include <QsLog.h>
 
+using namespace trikHal;
 using namespace trikHal::trik;
 
+/// Each operation takes at most two messages: register number write and data read.
+static const int maxOperationsPerTransaction = I2C_RDWR_IOCTL_MAX_MSGS / 2;
+
 static inline __s32 i2c_smbus_access(int file, char read_write, __u8 command
 		, int size, union i2c_smbus_data *data)
 {
@@ -88,26 +94,120 @@ TrikMspI2c::~TrikMspI2c()
 	disconnect();
 }
 
-void TrikMspI2c::send(const QByteArray &data)
+void TrikMspI2c::send(const MspCommand &command)
 {
-	if (data.size() == 3) {
-		i2c_smbus_write_byte_data(mDeviceFileDescriptor, data[0], data[2]);
+	const __u8 registerNumber = static_cast<__u8>(command.registerNumber());
+	if (command.kind() == MspCommand::Kind::writeByte) {
+		i2c_smbus_write_byte_data(mDeviceFileDescriptor, registerNumber, static_cast<__u8>(command.payload()));
 	} else {
-		i2c_smbus_write_word_data(mDeviceFileDescriptor, data[0], data[2] | (data[3] << 8));
+		i2c_smbus_write_word_data(mDeviceFileDescriptor, registerNumber, command.payload());
 	}
 }
 
-int TrikMspI2c::read(const QByteArray &data)
+int TrikMspI2c::read(const MspCommand &command)
 {
-	if (data.size() == 2) {
-		return i2c_smbus_read_word_data(mDeviceFileDescriptor, data[0]);
+	const __u8 registerNumber = static_cast<__u8>(command.registerNumber());
+	if (command.kind() == MspCommand::Kind::readWord) {
+		return i2c_smbus_read_word_data(mDeviceFileDescriptor, registerNumber);
 	} else {
 		__u8 buffer[4] = {0};
-		i2c_smbus_read_i2c_block_data(mDeviceFileDescriptor, data[0], 4, buffer);
+		i2c_smbus_read_i2c_block_data(mDeviceFileDescriptor, registerNumber, 4, buffer);
 		return buffer[3] << 24 | buffer[2] <<  16 | buffer[1] << 8 | buffer[0];
 	}
 }
 
+void TrikMspI2c::transaction(MspBatch &batch)
+{
+	int current = 0;
+	while (current < batch.size()) {
+		const int count = qMin(maxOperationsPerTransaction, batch.size() - current);
+		if (!mCombinedTransactionsSupported || !executeCombined(batch, current, count)) {
+			for (int i = current; i < current + count; ++i) {
+				execute(batch[i]);
+			}
+		}
+
+		current += count;
+	}
+}
+
+void TrikMspI2c::execute(MspBatchOperation &operation)
+{
+	if (operation.command.isRead()) {
+		operation.result = read(operation.command);
+	} else {
+		send(operation.command);
+	}
+}
+
+bool TrikMspI2c::executeCombined(MspBatch &batch, int first, int count)
+{
+	struct i2c_msg messages[I2C_RDWR_IOCTL_MAX_MSGS];
+	__u8 outBuffers[maxOperationsPerTransaction][3] = {{0}};
+	__u8 inBuffers[maxOperationsPerTransaction][4] = {{0}};
+	int messagesCount = 0;
+
+	for (int i = 0; i < count; ++i) {
+		const MspCommand &command = batch[first + i].command;
+		outBuffers[i][0] = static_cast<__u8>(command.registerNumber());
+
+		struct i2c_msg &request = messages[messagesCount++];
+		request.addr = mDeviceId;
+		request.flags = 0;
+		request.buf = outBuffers[i];
+
+		if (!command.isRead()) {
+			outBuffers[i][1] = static_cast<__u8>(command.payload() & 0xFF);
+			if (command.kind() == MspCommand::Kind::writeByte) {
+				request.len = 2;
+			} else {
+				outBuffers[i][2] = static_cast<__u8>(command.payload() >> 8);
+				request.len = 3;
+			}
+		} else {
+			request.len = 1;
+
+			struct i2c_msg &response = messages[messagesCount++];
+			response.addr = mDeviceId;
+			response.flags = I2C_M_RD;
+			response.len = command.kind() == MspCommand::Kind::readWord ? 2 : 4;
+			response.buf = inBuffers[i];
+		}
+	}
+
+	struct i2c_rdwr_ioctl_data transaction;
+	transaction.msgs = messages;
+	transaction.nmsgs = messagesCount;
+
+	if (ioctl(mDeviceFileDescriptor, I2C_RDWR, &transaction) < 0) {
+		const int error = errno;
+		if (error == EOPNOTSUPP || error == EINVAL || error == ENOTTY || error == ENOSYS) {
+			// Adapter can not do combined transactions at all, no point in trying again.
+			QLOG_WARN() << "Combined I2C transactions are not supported:" << strerror(error)
+					<< ", falling back to separate register accesses";
+			mCombinedTransactionsSupported = false;
+		} else {
+			// NACK or bus glitch, only this batch is executed by separate accesses.
+			QLOG_WARN() << "Combined I2C transaction failed:" << strerror(error)
+					<< ", retrying it as separate register accesses";
+		}
+
+		return false;
+	}
+
+	for (int i = 0; i < count; ++i) {
+		MspBatchOperation &operation = batch[first + i];
+		if (operation.command.isRead()) {
+			const __u8 * const buffer = inBuffers[i];
+			operation.result = operation.command.kind() == MspCommand::Kind::readWord
+					? buffer[1] << 8 | buffer[0]
+					: buffer[3] << 24 | buffer[2] << 16 | buffer[1] << 8 | buffer[0];
+		}
+	}
+
+	return true;
+}
+
 bool TrikMspI2c::connect(const QString &devicePath, int deviceId)
 {
 	mDeviceFileDescriptor = open(devicePath.toStdString().c_str(), O_RDWR);
@@ -121,6 +221,16 @@ bool TrikMspI2c::connect(const QString &devicePath, int deviceId)
 		return false;
 	}
 
+	mDeviceId = deviceId;
+
+	unsigned long functionality = 0;
+	mCombinedTransactionsSupported = ioctl(mDeviceFileDescriptor, I2C_FUNCS, &functionality) == 0
+			&& (functionality & I2C_FUNC_I2C);
+
+	if (!mCombinedTransactionsSupported) {
+		QLOG_INFO() << "I2C adapter does not support combined transactions, batches will be split";
+	}
+
 	return true;
 }
 
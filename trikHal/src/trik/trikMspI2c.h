@@ -26,14 +26,29 @@ public:
 	TrikMspI2c() = default;
 	~TrikMspI2c() override;
 
-	void send(const QByteArray &data) override;
-	int read(const QByteArray &data) override;
+	void send(const MspCommand &command) override;
+	int read(const MspCommand &command) override;
+	void transaction(MspBatch &batch) override;
 	bool connect(const QString &devicePath, int deviceId) override;
 	void disconnect() override;
 
 private:
+	/// Executes given operation with separate SMBus call.
+	void execute(MspBatchOperation &operation);
+
+	/// Executes up to I2C_RDWR_IOCTL_MAX_MSGS / 2 operations starting from "first" as one combined I2C_RDWR
+	/// transaction. Returns false if transaction failed, batch shall be executed by separate accesses then. Combined
+	/// transactions are disabled for good only if adapter reports that it does not support them.
+	bool executeCombined(MspBatch &batch, int first, int count);
+
 	/// Low-level descriptor of I2C device file.
 	int mDeviceFileDescriptor = -1;
+
+	/// Address of MSP on I2C bus, needed for combined transactions.
+	int mDeviceId = 0;
+
+	/// True if I2C adapter supports plain I2C messages and so can execute combined I2C_RDWR transactions.
+	bool mCombinedTransactionsSupported = false;
 };
 
 }
@@ -25,14 +25,61 @@ TrikMspUsb::~TrikMspUsb()
 {
 }
 
-void TrikMspUsb::send(const QByteArray &data)
+void TrikMspUsb::send(const MspCommand &command)
 {
-	send_USBMSP(data);
+	send_USBMSP(command);
 }
 
-int TrikMspUsb::read(const QByteArray &data)
+int TrikMspUsb::read(const MspCommand &command)
 {
-	return read_USBMSP(data);
+	return read_USBMSP(command);
+}
+
+void TrikMspUsb::transaction(MspBatch &batch)
+{
+	// Fixed buffers so that a tick does not touch the heap, longer runs of reads are flushed in parts.
+	MspCommand reads[MAX_READ_PLANS];
+	uint32_t results[MAX_READ_PLANS];
+	int readCount = 0;
+	int firstRead = 0;
+
+	// Consecutive reads are pipelined, writes break the pipeline since reads after them may depend on them.
+	const auto flushReads = [&]() {
+		if (readCount == 0) {
+			return;
+		}
+
+		read_USBMSP_batch(reads, results, readCount);
+		for (int i = 0; i < readCount; ++i) {
+			batch[firstRead + i].result = results[i];
+		}
+
+		readCount = 0;
+	};
+
+	for (int i = 0; i < batch.size(); ++i) {
+		if (!batch[i].command.isRead()) {
+			flushReads();
+			send_USBMSP(batch[i].command);
+		} else {
+			if (readCount == MAX_READ_PLANS) {
+				flushReads();
+			}
+
+			if (readCount == 0) {
+				firstRead = i;
+			}
+
+			reads[readCount++] = batch[i].command;
+		}
+	}
+
+	flushReads();
+}
+
+void TrikMspUsb::poll()
+{
+	poll_URM04();
 }
 
 bool TrikMspUsb::connect()
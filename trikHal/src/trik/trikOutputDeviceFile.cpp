@@ -14,42 +14,136 @@
 
 #include "trikOutputDeviceFile.h"
 
+#include <fcntl.h>
+#include <unistd.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <sys/stat.h>
+#include <sys/vfs.h>
+#include <linux/magic.h>
+
+#include <QtCore/QByteArray>
+
 #include <QsLog.h>
 
 using namespace trikHal::trik;
 
 TrikOutputDeviceFile::TrikOutputDeviceFile(const QString &fileName)
-	: mFile(fileName)
+	: mFileName(fileName)
+{
+}
+
+TrikOutputDeviceFile::~TrikOutputDeviceFile()
 {
+	close();
 }
 
 bool TrikOutputDeviceFile::open()
 {
-	QLOG_INFO() << "Opening output device file" << mFile.fileName();
+	QLOG_INFO() << "Opening output device file" << mFileName;
+
+	close();
 
-	if (!mFile.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Unbuffered | QIODevice::Text)) {
-		QLOG_ERROR() << "File" << mFile.fileName() << " failed to open for writing";
+	mFileDescriptor = ::open(mFileName.toLocal8Bit().constData(), O_WRONLY | O_TRUNC | O_CLOEXEC);
+	if (mFileDescriptor == -1) {
+		QLOG_ERROR() << "File" << mFileName << " failed to open for writing:" << strerror(errno);
 		return false;
 	}
 
+	struct stat fileInfo;
+	mSeekable = fstat(mFileDescriptor, &fileInfo) == 0 && S_ISREG(fileInfo.st_mode);
+
+	// Sysfs attribute takes the whole value from one write, but ordinary file keeps the tail of a longer old value.
+	struct statfs fileSystemInfo;
+	mSysfsAttribute = mSeekable && fstatfs(mFileDescriptor, &fileSystemInfo) == 0
+			&& fileSystemInfo.f_type == SYSFS_MAGIC;
+	mTruncate = mSeekable && !mSysfsAttribute;
+	mHasLastValue = false;
+
 	return true;
 }
 
 void TrikOutputDeviceFile::close()
 {
-	if (mFile.isOpen()) {
-		QLOG_INFO() << "Closing output device file" << mFile.fileName();
-		mFile.close();
+	if (mFileDescriptor != -1) {
+		QLOG_INFO() << "Closing output device file" << mFileName;
+		::close(mFileDescriptor);
+		mFileDescriptor = -1;
 	}
+
+	mHasLastValue = false;
 }
 
 void TrikOutputDeviceFile::write(const QString &data)
 {
-	mFile.write(data.toUtf8());
-	mFile.flush();
+	const QByteArray bytes = data.toUtf8();
+	writeRaw(bytes.constData(), bytes.size());
+
+	// Arbitrary data may be anything, so we do not know what value is in a file now.
+	mHasLastValue = false;
+}
+
+void TrikOutputDeviceFile::write(int value)
+{
+	char buffer[16];
+	const int size = formatValue(value, buffer, sizeof(buffer));
+	if (size > 0) {
+		onValueWritten(value, writeRaw(buffer, size));
+	}
 }
 
 QString TrikOutputDeviceFile::fileName() const
 {
-	return mFile.fileName();
+	return mFileName;
+}
+
+int TrikOutputDeviceFile::fileDescriptor() const
+{
+	return mFileDescriptor;
+}
+
+bool TrikOutputDeviceFile::isSeekable() const
+{
+	return mSeekable;
+}
+
+bool TrikOutputDeviceFile::isSysfsAttribute() const
+{
+	return mSysfsAttribute;
+}
+
+int TrikOutputDeviceFile::formatValue(int value, char *buffer, int size) const
+{
+	if (mHasLastValue && mLastValue == value) {
+		return 0;
+	}
+
+	return snprintf(buffer, static_cast<size_t>(size), "%d", value);
+}
+
+void TrikOutputDeviceFile::onValueWritten(int value, bool success)
+{
+	mHasLastValue = success;
+	mLastValue = value;
+}
+
+bool TrikOutputDeviceFile::writeRaw(const char *data, int size)
+{
+	if (mFileDescriptor == -1) {
+		QLOG_ERROR() << "Trying to write to output device file" << mFileName << "which is not opened";
+		return false;
+	}
+
+	ssize_t result = 0;
+	do {
+		result = mSeekable ? pwrite(mFileDescriptor, data, size, 0) : ::write(mFileDescriptor, data, size);
+	} while (result == -1 && errno == EINTR);
+
+	if (result != size || (mTruncate && ftruncate(mFileDescriptor, size) != 0)) {
+		QLOG_ERROR() << "Failed to write to output device file" << mFileName << ":" << strerror(errno);
+		return false;
+	}
+
+	return true;
 }
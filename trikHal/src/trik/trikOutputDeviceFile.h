@@ -15,14 +15,14 @@
 #pragma once
 
 #include <QtCore/QString>
-#include <QtCore/QFile>
 
 #include "outputDeviceFileInterface.h"
 
 namespace trikHal {
 namespace trik {
 
-/// Real implementation for output device file (a file to which we can only write).
+/// Real implementation for output device file (a file to which we can only write). Keeps raw file descriptor
+/// open and writes sysfs attributes with one pwrite() at offset 0, skipping integer writes that do not change value.
 class TrikOutputDeviceFile : public OutputDeviceFileInterface
 {
 public:
@@ -30,14 +30,56 @@ public:
 	/// @param fileName - name of a device file .
 	TrikOutputDeviceFile(const QString &fileName);
 
+	~TrikOutputDeviceFile() override;
+
 	bool open() override;
 	void close() override;
 	void write(const QString &data) override;
+	void write(int value) override;
 	QString fileName() const override;
 
+	/// Returns descriptor of opened file for batched writes, -1 if file is not opened.
+	int fileDescriptor() const;
+
+	/// Returns true if file supports positioned writes.
+	bool isSeekable() const;
+
+	/// Returns true if file is a sysfs attribute that takes the whole value from one write at offset 0, only such
+	/// files are written in batches.
+	bool isSysfsAttribute() const;
+
+	/// Formats integer value for a write that will be done bypassing this object.
+	/// @returns size of formatted value or 0 if a file already contains this value and write can be skipped.
+	int formatValue(int value, char *buffer, int size) const;
+
+	/// Reports result of a write of an integer value done bypassing this object.
+	void onValueWritten(int value, bool success);
+
 private:
-	/// Underlying file.
-	QFile mFile;
+	/// Writes given bytes to a file with one system call, at offset 0 for seekable files. Returns true on success.
+	bool writeRaw(const char *data, int size);
+
+	/// Name of underlying file.
+	const QString mFileName;
+
+	/// Descriptor of underlying file, -1 if file is not opened.
+	int mFileDescriptor = -1;
+
+	/// True if file supports positioned writes (sysfs attribute or regular file), false for FIFOs and
+	/// character devices.
+	bool mSeekable = false;
+
+	/// True if file is a sysfs attribute.
+	bool mSysfsAttribute = false;
+
+	/// True if file is an ordinary file, not sysfs attribute, so it shall be truncated after a write.
+	bool mTruncate = false;
+
+	/// True if mLastValue holds the value that was written to a file last time.
+	bool mHasLastValue = false;
+
+	/// Integer value written to a file last time.
+	int mLastValue = 0;
 };
 
 }
@@ -14,21 +14,67 @@
 
 #include "trikSystemConsole.h"
 
+#include <thread>
+
 #include <QtCore/QString>
 #include <QtCore/QProcess>
 #include <QtCore/QFileInfo>
 
 #include <QsLog.h>
 
+#include "trikCommandService.h"
+
 using namespace trikHal::trik;
 
+TrikSystemConsole::TrikSystemConsole()
+	: mCommandService(new TrikCommandService())
+{
+	if (!mCommandService->launch()) {
+		QLOG_WARN() << "Command service is not available, commands will be executed by forking runtime process";
+	}
+}
+
+TrikSystemConsole::~TrikSystemConsole()
+{
+}
+
 int TrikSystemConsole::system(const QString &command)
 {
+	if (mCommandService->isAvailable()) {
+		return mCommandService->execute(command);
+	}
+
 	return ::system(command.toStdString().c_str());
 }
 
+void TrikSystemConsole::systemAsync(const QString &command, const std::function<void(int)> &callback)
+{
+	if (mCommandService->executeAsync(command, callback)) {
+		return;
+	}
+
+	std::thread([command, callback]() {
+		const int result = ::system(command.toStdString().c_str());
+		if (callback) {
+			callback(result);
+		}
+	}).detach();
+}
+
 bool TrikSystemConsole::startProcess(const QString &processName, const QStringList &arguments)
 {
+	const QString command = TrikCommandService::commandLine(processName, arguments);
+	const auto onFinished = [processName](int result) {
+		// Shell reports 126 and 127 if a program can not be executed or is not found.
+		if (result == 126 || result == 127) {
+			QLOG_ERROR() << "Failed to start process" << processName;
+		}
+	};
+
+	if (mCommandService->executeAsync(command, onFinished)) {
+		return true;
+	}
+
 	return QProcess::startDetached(processName, arguments);
 }
 
@@ -14,19 +14,35 @@
 
 #pragma once
 
+#include <QtCore/QScopedPointer>
+
 #include "systemConsoleInterface.h"
 
 namespace trikHal {
 namespace trik {
 
-/// Real implementation of system console.
+class TrikCommandService;
+
+/// Real implementation of system console. Commands and detached processes are started by command service, so runtime
+/// process is not forked; ::system() is used as a fallback if command service is not available.
 class TrikSystemConsole : public SystemConsoleInterface
 {
 public:
+	/// Constructor. Starts command service.
+	TrikSystemConsole();
+
+	~TrikSystemConsole() override;
+
 	int system(const QString &command) override;
+	void systemAsync(const QString &command
+			, const std::function<void(int)> &callback = std::function<void(int)>()) override;
 	bool startProcess(const QString &processName, const QStringList &arguments) override;
 	bool startProcessSynchronously(const QString &processName, const QStringList &arguments
 			, QString * const output = nullptr) override;
+
+private:
+	/// Helper that executes commands without forking runtime process.
+	QScopedPointer<TrikCommandService> mCommandService;
 };
 
 }
@@ -408,6 +408,15 @@
 #define MCP3424_GAIN4		0x0002
 #define MCP3424_GAIN8		0x0003
 
+/// Version control registers. VVPROT is present only in firmware that supports binary protocol, it is read before
+/// being written, so older firmware never receives writes to it.
+#define VVVER			0x00
+#define VVPROT			0x01
+
+/// Wire protocols of USB MSP430 link (values of VVPROT register)
+#define PROTOCOL_ASCII		0x00
+#define PROTOCOL_BINARY		0x01
+
 /// Software PWM registers
 #define SPPCTL			0x00
 #define SPPDUT			0x01
@@ -451,6 +460,14 @@
 
 #define RECV_PACK_LEN		0x12
 
+/// Binary packet format: start byte, packet length, device address, function, register address,
+/// register value (4 bytes, little endian, only for write requests and responses), CRC-8 of all bytes but start
+#define BIN_START		0xA5
+#define BIN_READ_PACK_LEN	0x06
+#define BIN_WRITE_PACK_LEN	0x0A
+#define BIN_RECV_PACK_LEN	0x0A
+#define BIN_CRC_POLY		0x07
+
 /// Errors for response
 #define NO_ERROR		0x00
 #define DEVICE_ERROR		0x01
@@ -458,6 +475,19 @@
 
 #define TIME_OUT		0xFFFF
 
+/// URM04 ranging
+#define URM04_MEASURE_TIME	400	// Time from trigger to measured distance, ms
+#define URM04_FIRST_ADDR	0x11	// First URM04 address on RS-485 bus
+#define URM04_ADDRS		0x10	// Number of URM04 addresses on RS-485 bus
+#define URM04_USARTS		0x07	// Number of USARTs (USART1 - USART7)
+#define URM04_TRIG_LEN		0x06	// Length of URM04 trigger and read commands
+#define URM04_REPLY_LEN		0x08	// Length of URM04 reply
+#define URM04_IDLE_TIME		2000	// Time without reads after which sensor is no longer measured, ms
+
+/// States of URM04 ranging on USART
+#define URM04_IDLE		0x00
+#define URM04_MEASURING		0x01
+
 /// Alternative functions of devices
 #define ALT_NOTHING		0x00
 #define ALT_ANALOG		0x01
@@ -23,22 +23,28 @@
 #include <fcntl.h>
 #include <errno.h>
 #include <termios.h>
+#include <time.h>
 
-#include <QtCore/QByteArray>
 #include <QtCore/QString>
 #include <QtCore/QObject>
-#include <QtCore/QThread>
+#include <QtCore/QVector>
 
 #include <QsLog.h>
 
 #include "usbMSP430Defines.h"
 #include "usbMSP430Interface.h"
+#include "usbMSP430Transport.h"
 
 volatile uint16_t mper;			// Global PWM motor period
 volatile uint16_t sper;			// Global software PWM period
 int usb_out_descr;			// Input/Output USB device descriptor
 struct termios usb_tty;			// Struct for termio parameters, MUST BE GLOBAL!!!
 volatile uint8_t alt_func_flag;		// Alternate function switch flag for devices
+volatile uint8_t usb_protocol;		// Negotiated wire protocol (ASCII or binary)
+uint32_t shadow_regs[SHADOW_DEVICES][SHADOW_REGS];	// Last values written to configuration registers
+uint16_t shadow_valid[SHADOW_DEVICES];	// Bit masks of shadow registers holding actual values
+uint8_t dev_alt_func[SHADOW_DEVICES];	// Alternative functions devices are switched to
+URM04Channel urm04_channels[URM04_USARTS];	// URM04 ranging state of USARTs
 uint8_t addr_table_i2c_usb[84] =	// Correspondence address table (between I2C and USB device addresses)
 		{0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
 		0, 0, 0, 0, 0, 0, MOTOR1, MOTOR2, MOTOR3, MOTOR4,
@@ -50,15 +56,6 @@ uint8_t addr_table_i2c_usb[84] =	// Correspondence address table (between I2C an
 		SPWM8, SPWM9, SPWM10, SPWM11, SPWM12, SPWM13, SPWM14, I2C1, I2C2, I2C3,
 		I2C4, I2C5, I2C6, I2C7};
 
-/// Delays class
-class Sleeper : public QThread
-{
-public:
-	static void usleep(unsigned long usecs){QThread::usleep(usecs);}
-	static void msleep(unsigned long msecs){QThread::msleep(msecs);}
-	static void sleep(unsigned long secs){QThread::sleep(secs);}
-};
-
 /// Extract number from packet
 uint32_t hex2num(char *string
 		, uint16_t pos
@@ -82,6 +79,11 @@ void makeWriteRegPacket(char *msp_packet
 			, uint8_t reg_addr
 			, uint32_t reg_val)
 {
+	if (usb_protocol == PROTOCOL_BINARY)
+	{
+		makeWriteRegBinaryPacket(reinterpret_cast<uint8_t *>(msp_packet), dev_addr, reg_addr, reg_val);
+		return;
+	}
 	uint8_t crc = (0xFF - (dev_addr + WRITE_FUNC + reg_addr + uint8_t(reg_val & 0xFF)
 					+ uint8_t((reg_val >> 8) & 0xFF)
 					+ uint8_t((reg_val >> 16) & 0xFF)
@@ -94,12 +96,107 @@ void makeReadRegPacket(char *msp_packet
 			, uint8_t dev_addr
 			, uint8_t reg_addr)
 {
+	if (usb_protocol == PROTOCOL_BINARY)
+	{
+		makeReadRegBinaryPacket(reinterpret_cast<uint8_t *>(msp_packet), dev_addr, reg_addr);
+		return;
+	}
 	uint8_t crc = (0xFF - (dev_addr + READ_FUNC + reg_addr) + 1) & 0xFF;	// Checksum
 	sprintf(msp_packet, ":%02X%02X%02X%02X\n", dev_addr, READ_FUNC, reg_addr, crc);
 }
 
+/// Calculate CRC-8 used by binary packets
+uint8_t crc8(const uint8_t *data
+		, uint16_t len)
+{
+	uint8_t crc = 0;
+	for (uint16_t i = 0; i < len; i++)
+	{
+		crc ^= data[i];
+		for (uint8_t bit = 0; bit < 8; bit++)
+		{
+			crc = (crc & 0x80) ? uint8_t((crc << 1) ^ BIN_CRC_POLY) : uint8_t(crc << 1);
+		}
+	}
+	return crc;
+}
+
+/// Make binary write register packet
+uint16_t makeWriteRegBinaryPacket(uint8_t *msp_packet
+			, uint8_t dev_addr
+			, uint8_t reg_addr
+			, uint32_t reg_val)
+{
+	msp_packet[0] = BIN_START;
+	msp_packet[1] = BIN_WRITE_PACK_LEN;
+	msp_packet[2] = dev_addr;
+	msp_packet[3] = WRITE_FUNC;
+	msp_packet[4] = reg_addr;
+	msp_packet[5] = reg_val & 0xFF;
+	msp_packet[6] = (reg_val >> 8) & 0xFF;
+	msp_packet[7] = (reg_val >> 16) & 0xFF;
+	msp_packet[8] = (reg_val >> 24) & 0xFF;
+	msp_packet[9] = crc8(msp_packet + 1, BIN_WRITE_PACK_LEN - 2);
+	return BIN_WRITE_PACK_LEN;
+}
+
+/// Make binary read register packet
+uint16_t makeReadRegBinaryPacket(uint8_t *msp_packet
+			, uint8_t dev_addr
+			, uint8_t reg_addr)
+{
+	msp_packet[0] = BIN_START;
+	msp_packet[1] = BIN_READ_PACK_LEN;
+	msp_packet[2] = dev_addr;
+	msp_packet[3] = READ_FUNC;
+	msp_packet[4] = reg_addr;
+	msp_packet[5] = crc8(msp_packet + 1, BIN_READ_PACK_LEN - 2);
+	return BIN_READ_PACK_LEN;
+}
+
+/// Function for decoding received binary packet
+uint32_t decodeReceivedBinaryPacket(const uint8_t *msp_packet
+				, uint16_t packet_len
+				, uint8_t &dev_addr
+				, uint8_t &func_code
+				, uint8_t &reg_addr
+				, uint32_t &reg_val)
+{
+	if (msp_packet[0] != BIN_START)			// Start condition error
+	{
+		return START_ERROR;
+	}
+	if ((packet_len != BIN_RECV_PACK_LEN) || (msp_packet[1] != BIN_RECV_PACK_LEN))	// Incorrect packet length
+	{
+		return LENGTH_ERROR;
+	}
+	if (crc8(msp_packet + 1, BIN_RECV_PACK_LEN - 2) != msp_packet[BIN_RECV_PACK_LEN - 1])	// Check CRC
+	{
+		return CRC_ERROR;
+	}
+	dev_addr = msp_packet[2];			// Get device address
+	func_code = msp_packet[3];			// Get function
+	reg_addr = msp_packet[4];			// Get register address
+	reg_val = uint32_t(msp_packet[5])
+			| (uint32_t(msp_packet[6]) << 8)
+			| (uint32_t(msp_packet[7]) << 16)
+			| (uint32_t(msp_packet[8]) << 24);	// Get register value
+	return NO_ERROR;
+}
+
+/// Returns length of a packet in current wire protocol
+uint16_t packetLength(const char *msp_packet)
+{
+	if (uint8_t(msp_packet[0]) == BIN_START)
+	{
+		return uint8_t(msp_packet[1]);
+	}
+	return strlen(msp_packet);
+}
+
 /// Function for decoding received packet
 uint32_t decodeReceivedPacket(char *msp_packet
+				, uint16_t packet_len
 				, uint8_t &dev_addr
 				, uint8_t &func_code
 				, uint8_t &reg_addr
@@ -107,11 +204,16 @@ uint32_t decodeReceivedPacket(char *msp_packet
 {
 	uint8_t crc1 = 0;				// Received cheksum
 	uint8_t crc2 = 0;				// Calculated checksum
+	if (uint8_t(msp_packet[0]) == BIN_START)	// Binary packet
+	{
+		return decodeReceivedBinaryPacket(reinterpret_cast<uint8_t *>(msp_packet), packet_len
+				, dev_addr, func_code, reg_addr, reg_val);
+	}
 	if (msp_packet[0] != ':')			// Start condition error
 	{
 		return START_ERROR;
 	}
-	if ((strlen(msp_packet) != RECV_PACK_LEN))	// Incorrect packet length
+	if ((packet_len != RECV_PACK_LEN) || (strnlen(msp_packet, packet_len) != RECV_PACK_LEN))	// Incorrect length
 	{
 		return LENGTH_ERROR;
 	}
@@ -172,54 +274,63 @@ uint32_t init_USBTTYDevice()
 
 /// Send USB packet
 uint32_t sendUSBPacket(char *in_msp_packet
-			, char *out_msp_packet)
+			, char *out_msp_packet
+			, uint16_t *out_length)
 {
-	uint32_t tout = 0;	    // Timeout counter
-	uint32_t n_written = 0;	    // Number of written bytes
-	int32_t n_read = 0;	    // Number of read bytes
-	size_t n_write = 0;	    // Number to write bytes
-	char s1[MAX_STRING_LENGTH]; // Temp string
+	return exchangeUSBPackets(usb_out_descr, &in_msp_packet, &out_msp_packet, 1, out_length);
+}
 
-	if (usb_out_descr < 0)
+/// Try to switch MSP430 to binary protocol
+uint32_t negotiate_protocol_USBMSP()
+{
+	char s1[MAX_STRING_LENGTH];		    // Temp string variable
+	char s2[MAX_STRING_LENGTH];		    // Temp string variable
+	uint8_t devaddr = 0;			    // Returned device address
+	uint8_t funccode = 0;			    // Returned function code
+	uint8_t regaddr = 0;			    // Returned register address
+	uint32_t regval = UINT32_MAX;		    // Returned register value
+	uint16_t received = 0;			    // Number of received bytes
+
+	usb_protocol = PROTOCOL_ASCII;
+
+	// VVPROT register is an extension of newer firmware. Older firmware does not have it and answers to its read
+	// with an error or does not answer at all, so the register is written only if firmware has shown that it
+	// knows it, and nothing unknown is ever written to older firmware.
+	makeReadRegPacket(s1, VERSIONCTRL, VVPROT);
+	if ((sendUSBPacket(s1, s2, &received) != NO_ERROR)
+			|| (decodeReceivedPacket(s2, received, devaddr, funccode, regaddr, regval) != NO_ERROR)
+			|| (devaddr != VERSIONCTRL) || (funccode != READ_FUNC) || (regaddr != VVPROT)
+			|| ((regval != PROTOCOL_ASCII) && (regval != PROTOCOL_BINARY)))
 	{
-		QLOG_ERROR() << "Error device descriptor" << errno << " : " << strerror (errno);
-		return DEVICE_ERROR;
+		QLOG_INFO() << "USB MSP430 firmware does not support protocol selection, using ASCII protocol";
+		return NO_ERROR;
 	}
 
-	// Write packet
-	n_write = strlen(in_msp_packet);
-	strcpy(s1, in_msp_packet);
-	n_written = write(usb_out_descr, s1, n_write);
-	if (n_written != strlen(s1))
+	// Ask firmware to switch protocol, it acknowledges request in old protocol
+	makeWriteRegPacket(s1, VERSIONCTRL, VVPROT, PROTOCOL_BINARY);
+	if ((sendUSBPacket(s1, s2, &received) != NO_ERROR)
+			|| (decodeReceivedPacket(s2, received, devaddr, funccode, regaddr, regval) != NO_ERROR)
+			|| (devaddr != VERSIONCTRL) || (regaddr != VVPROT) || (regval != PROTOCOL_BINARY))
 	{
-		QLOG_ERROR() << "Error writing: " << strerror(errno);
-		return PACKET_ERROR;
+		QLOG_INFO() << "USB MSP430 firmware does not support binary protocol, using ASCII one";
+		return NO_ERROR;
 	}
-	tcflush(usb_out_descr, TCOFLUSH);
-
-
-	// Read packet
-	memset (&s1, '\0', MAX_STRING_LENGTH);
-	do
-	{
-		n_read = read(usb_out_descr, &s1, MAX_STRING_LENGTH);
-		tout ++;
-	} while ((n_read < RECV_PACK_LEN) && (tout < TIME_OUT));
-	tcflush(usb_out_descr, TCIFLUSH);
 
-	if ((n_read != RECV_PACK_LEN) || (tout == TIME_OUT))
+	// Make sure that binary link actually works
+	usb_protocol = PROTOCOL_BINARY;
+	makeReadRegPacket(s1, VERSIONCTRL, VVPROT);
+	if ((sendUSBPacket(s1, s2, &received) != NO_ERROR)
+			|| (decodeReceivedPacket(s2, received, devaddr, funccode, regaddr, regval) != NO_ERROR)
+			|| (devaddr != VERSIONCTRL) || (regaddr != VVPROT) || (regval != PROTOCOL_BINARY))
 	{
-		QLOG_ERROR() << "Error reading: " << strerror(errno);
-		out_msp_packet[0] = 0x00;
-		out_msp_packet[1] = 0x00;
+		QLOG_WARN() << "USB MSP430 binary protocol check failed, falling back to ASCII one";
+		makeWriteRegPacket(s1, VERSIONCTRL, VVPROT, PROTOCOL_ASCII);
+		sendUSBPacket(s1, s1);
+		usb_protocol = PROTOCOL_ASCII;
 		return PACKET_ERROR;
 	}
-	else
-	{
-		s1[18] = 0x00;
-		strncpy(out_msp_packet, s1, n_read + 1);
-	}
 
+	QLOG_INFO() << "Using binary protocol for USB MSP430";
 	return NO_ERROR;
 }
 
@@ -442,9 +553,16 @@ uint32_t connect_USBMSP()
 		return DEVICE_ERROR;
 	}
 
+	// Device configuration is unknown after reconnect
+	invalidate_shadow_regs();
+	reset_URM04();
+
 	// Init USB STTY device with serial port parameters
 	init_USBTTYDevice();
 
+	// Use compact binary packets if firmware supports them
+	negotiate_protocol_USBMSP();
+
 	// Init servo motors
 	init_servomotors_USBMSP();
 
@@ -478,12 +596,15 @@ uint32_t disconnect_USBMSP()
 		return DEVICE_ERROR;
 	}
 	close(usb_out_descr);
+	usb_protocol = PROTOCOL_ASCII;
+	invalidate_shadow_regs();
+	reset_URM04();
 
 	return NO_ERROR;
 }
 
 /// Motor power control function
-uint32_t power_Motor(QByteArray const &i2c_data)
+uint32_t power_Motor(trikHal::MspCommand const &command)
 {
 	uint16_t mdut;				    // Motor PWM duty
 	uint16_t mctl;				    // Motor control register
@@ -491,9 +612,8 @@ uint32_t power_Motor(QByteArray const &i2c_data)
 	uint16_t sctl;				    // Software PWM control register
 	int8_t mtmp;				    // Temp variable
 	char s1[MAX_STRING_LENGTH];		    // Temp string variable
-	const int8_t reg_value = i2c_data[2];	    // Register value
-	const uint16_t dev_address = (uint16_t)i2c_data[0] +
-		((uint16_t)i2c_data[1] << 8);	    // Device address
+	const int8_t reg_value = command.payload();		// Register value
+	const uint16_t dev_address = command.registerNumber();	// Device address
 
 	// Power motors
 	if ((dev_address == i2cMOT1) || (dev_address == i2cMOT2) ||
@@ -559,13 +679,13 @@ uint32_t power_Motor(QByteArray const &i2c_data)
 		{
 		}
 
+		switch_alt_func(addr_table_i2c_usb[dev_address], ALT_SERVO);
 		makeWriteRegPacket(s1, addr_table_i2c_usb[dev_address], SPPPER, sper);
 		sendUSBPacket(s1, s1);
 		makeWriteRegPacket(s1, addr_table_i2c_usb[dev_address], SPPDUT, sdut);
 		sendUSBPacket(s1, s1);
 		makeWriteRegPacket(s1, addr_table_i2c_usb[dev_address], SPPCTL, sctl);
 		sendUSBPacket(s1, s1);
-		alt_func_flag = ALT_SERVO;
 	}
 	else
 	{
@@ -576,12 +696,11 @@ uint32_t power_Motor(QByteArray const &i2c_data)
 }
 
 /// Set motor frequency function
-uint32_t freq_Motor(QByteArray const &i2c_data)
+uint32_t freq_Motor(trikHal::MspCommand const &command)
 {
 	char s1[MAX_STRING_LENGTH];					// Temp string variable
-	const uint16_t reg_value = ((i2c_data[3] << 8) | i2c_data[2]);	// Register value
-	const uint16_t dev_address = (uint16_t)i2c_data[0] +
-		((uint16_t)i2c_data[1] << 8);	    // Device address
+	const uint16_t reg_value = command.payload();			// Register value
+	const uint16_t dev_address = command.registerNumber();	// Device address
 
 	if ((dev_address == i2cPWMMOT1) || (dev_address == i2cPWMMOT2) ||
 			(dev_address == i2cPWMMOT3) || (dev_address == i2cPWMMOT4))
@@ -609,12 +728,11 @@ uint32_t freq_Motor(QByteArray const &i2c_data)
 }
 
 /// Reset encoder function
-uint32_t reset_Encoder(QByteArray const &i2c_data)
+uint32_t reset_Encoder(trikHal::MspCommand const &command)
 {
 	char s1[MAX_STRING_LENGTH];		    // Temp string variable
-	const uint8_t reg_value = i2c_data[2];	    // Register value
-	const uint16_t dev_address = (uint16_t)i2c_data[0] +
-		((uint16_t)i2c_data[1] << 8);	    // Device address
+	const uint8_t reg_value = command.payload();		// Register value
+	const uint16_t dev_address = command.registerNumber();	// Device address
 
 	if ((dev_address == i2cENC1) || (dev_address == i2cENC2)
 		||	(dev_address == i2cENC3) || (dev_address == i2cENC4))
@@ -625,12 +743,13 @@ uint32_t reset_Encoder(QByteArray const &i2c_data)
 			|| (alt_func_flag == ALT_DHTXX) || (alt_func_flag == ALT_ANALOG))
 		{
 		}
+		switch_alt_func(addr_table_i2c_usb[dev_address], ALT_ENC);
 		makeWriteRegPacket(s1, addr_table_i2c_usb[dev_address],
 				   EECTL, ENC_ENABLE + ENC_2WIRES + ENC_PUPEN + ENC_FALL);
 		sendUSBPacket(s1, s1);
+		update_shadow_reg(addr_table_i2c_usb[dev_address], EECTL, ENC_ENABLE + ENC_2WIRES + ENC_PUPEN + ENC_FALL);
 		makeWriteRegPacket(s1, addr_table_i2c_usb[dev_address], EEVAL, reg_value);
 		sendUSBPacket(s1, s1);
-		alt_func_flag = ALT_ENC;
 	}
 	else
 	{
@@ -640,134 +759,57 @@ uint32_t reset_Encoder(QByteArray const &i2c_data)
 	return NO_ERROR;
 }
 
-/// Read encoder function
-uint32_t read_Encoder(QByteArray const &i2c_data)
+/// Forget all shadow register values
+void invalidate_shadow_regs()
 {
-	char s1[MAX_STRING_LENGTH];		    // Temp string variable
-	char s2[MAX_STRING_LENGTH];		    // Temp string variable
-	uint32_t errcode;			    // Returned error code
-	Q_UNUSED(errcode);
-	uint8_t devaddr;			    // Returned device address
-	uint8_t funccode;			    // Returned function code
-	uint8_t regaddr;			    // Returned register address
-	uint32_t regval=UINT32_MAX;		    // Returned register value
-	uint16_t tmout = 0;			    // Reading timeout
-	const uint16_t dev_address = (uint16_t)i2c_data[0] +
-		((uint16_t)i2c_data[1] << 8);	    // Device address
-
-	if ((dev_address == i2cENC1) || (dev_address == i2cENC2)
-		||  (dev_address == i2cENC3) || (dev_address == i2cENC4))
-	{
-		if ((alt_func_flag == ALT_NOTHING) || (alt_func_flag == ALT_SERVO)
-			|| (alt_func_flag == ALT_I2C) || (alt_func_flag == ALT_USART)
-			|| (alt_func_flag == ALT_DHTXX) || (alt_func_flag == ALT_ANALOG))
-		{
-		}
-		makeWriteRegPacket(s1, addr_table_i2c_usb[dev_address],
-					EECTL, ENC_ENABLE + ENC_2WIRES + ENC_PUPEN + ENC_FALL);
-		sendUSBPacket(s1, s1);
-		do
-		{
-			makeReadRegPacket(s1, addr_table_i2c_usb[dev_address], EEVAL);
-			errcode = sendUSBPacket(s1, s2);
-			errcode = decodeReceivedPacket(s2, devaddr, funccode, regaddr, regval);
-			tmout ++;
-		} while (((devaddr != addr_table_i2c_usb[dev_address]) || (regaddr != EEVAL)) && (tmout < TIME_OUT));
-		alt_func_flag = ALT_ENC;
-		// qDebug() << "Dev address (read_encoder): " << dev_address << " " << regval;
-		return regval;
-	}
-	else
-	{
-		return DEV_ADDR_ERROR;
-	}
-
-	return NO_ERROR;
+	memset(shadow_valid, 0, sizeof(shadow_valid));
+	memset(dev_alt_func, ALT_NOTHING, sizeof(dev_alt_func));
 }
 
-/// Init I2C + USART + URM04
-uint32_t init_URM04(uint8_t i2c_addr, uint8_t usart_addr)
+/// Check if configuration register already holds given value
+bool shadow_reg_matches(uint8_t dev_addr
+			, uint8_t reg_addr
+			, uint32_t reg_val)
 {
-	char s1[MAX_STRING_LENGTH];		    // Temp string variable
-	makeWriteRegPacket(s1, i2c_addr, IICTL, I2C_ENABLE);
-	sendUSBPacket(s1, s1);
-	makeWriteRegPacket(s1, usart_addr, UUSPD, 19200);
-	sendUSBPacket(s1, s1);
-	makeWriteRegPacket(s1, usart_addr, UUCTL, USART_EN+USART_8BITS+USART_RS485+USART_INVRTS+USART_RXEN+USART_TXEN);
-	sendUSBPacket(s1, s1);
-	return NO_ERROR;
+	return (reg_addr < SHADOW_REGS)
+			&& (shadow_valid[dev_addr] & (1 << reg_addr))
+			&& (shadow_regs[dev_addr][reg_addr] == reg_val);
 }
 
-/// Read URM04 distance function
-uint32_t read_URM04_dist(uint8_t dev_addr, uint8_t urm04_addr)
+/// Remember value written to configuration register
+void update_shadow_reg(uint8_t dev_addr
+			, uint8_t reg_addr
+			, uint32_t reg_val)
 {
-	char s1[MAX_STRING_LENGTH];		    // Temp string variable
-	char s2[MAX_STRING_LENGTH];		    // Temp string variable
-	uint8_t crc1;			    // URM04 CRC
-	uint32_t errcode;			    // Returned error code
-	Q_UNUSED(errcode);
-	uint8_t devaddr;			    // Returned device address
-	uint8_t funccode;			    // Returned function code
-	uint8_t regaddr;			    // Returned register address
-	uint32_t regval=UINT32_MAX;		    // Returned register value
-	uint16_t tmout = 0;			    // Reading timeout
-	uint8_t crc_a = 0x55 + 0xAA + urm04_addr + 0x00 + 0x01;
-	uint8_t crc_b = 0x55 + 0xAA + urm04_addr + 0x00 + 0x02;
-	uint8_t pack1[6] = {0x55, 0xAA, urm04_addr, 0x00, 0x01, crc_a};
-	uint8_t pack2[6] = {0x55, 0xAA, urm04_addr, 0x00, 0x02, crc_b};
-	uint8_t buf1[8] = {0};
-	// Trigger device
-	for (int i = 0; i < 6; i++)
+	if (reg_addr < SHADOW_REGS)
 	{
-		makeWriteRegPacket(s1, dev_addr, UUDAT, pack1[i]);
-		sendUSBPacket(s1, s1);
+		shadow_regs[dev_addr][reg_addr] = reg_val;
+		shadow_valid[dev_addr] |= (1 << reg_addr);
 	}
-	// Wait about 400 ms
-	Sleeper::msleep(400);
-	// Read distance
-	for (int i = 0; i < 6; i++)
-	{
-		makeWriteRegPacket(s1, dev_addr, UUDAT, pack2[i]);
-		sendUSBPacket(s1, s1);
-	}
-	for (int i = 0; i < 8; i++)
-	{
-		do
-		{
-			makeReadRegPacket(s1, dev_addr, UUDAT);
-			errcode = sendUSBPacket(s1, s2);
-			errcode = decodeReceivedPacket(s2, devaddr, funccode, regaddr, regval);
-			tmout ++;
-		} while (((devaddr != dev_addr) || (regaddr != UUDAT)) && (tmout < TIME_OUT));
-		buf1[i] = regval;
-	}
-	crc1 = buf1[0] + buf1[1] + buf1[2] + buf1[3] + buf1[4] + buf1[5] + buf1[6];
-	if (crc1 != buf1[7])
+}
+
+/// Switch alternative function of a device, its shadow registers are invalidated if function changes
+void switch_alt_func(uint8_t dev_addr
+			, uint8_t alt_func)
+{
+	if (alt_func == ALT_NOTHING)		// Device has no alternative functions
 	{
-		// qDebug() << "URM04 CRC ERROR!";
-		return URM04_ERROR;
+		return;
 	}
-	else
+	alt_func_flag = alt_func;
+	if (alt_func != dev_alt_func[dev_addr])
 	{
-		// qDebug() << "Distance: " << (uint32_t)(buf1[5] << 8) + (uint32_t)buf1[6];
-		return (uint32_t)(buf1[5] << 8) + (uint32_t)buf1[6];
+		// Other devices keep their configuration, only this one is reconfigured by firmware
+		shadow_valid[dev_addr] = 0;
+		dev_alt_func[dev_addr] = alt_func;
 	}
 }
 
-/// Read sensor function
-uint32_t read_Sensor(QByteArray const &i2c_data)
+/// Make plan of reading analog, I2C or DHTxx sensor
+bool makeSensorReadPlan(trikHal::MspCommand const &command
+			, ReadPlan &plan)
 {
-	char s1[MAX_STRING_LENGTH];		    // Temp string variable
-	char s2[MAX_STRING_LENGTH];		    // Temp string variable
-	uint32_t errcode;			    // Returned error code
-	Q_UNUSED(errcode);
-	uint8_t devaddr;			    // Returned device address
-	uint8_t funccode;			    // Returned function code
-	uint8_t regaddr;			    // Returned register address
-	uint32_t regval=UINT32_MAX;		    // Returned register value
-	uint16_t tmout = 0;			    // Reading timeout
-	const uint16_t dev_address = (uint16_t)i2c_data[0] +
-		((uint16_t)i2c_data[1] << 8);	    // Device address
+	const uint16_t dev_address = command.registerNumber();	// Device address
 
 	// Analog sensors
 	if ((dev_address == i2cSENS1)
@@ -778,33 +820,19 @@ uint32_t read_Sensor(QByteArray const &i2c_data)
 			|| (dev_address == i2cSENS6)
 			|| (dev_address == i2cBATT))
 	{
-		if ((alt_func_flag == ALT_NOTHING)
-				|| (alt_func_flag == ALT_SERVO)
-				|| (alt_func_flag == ALT_I2C)
-				|| (alt_func_flag == ALT_USART)
-				|| (alt_func_flag == ALT_DHTXX))
-		{
-		}
-
-		makeWriteRegPacket(s1, addr_table_i2c_usb[dev_address], SSCTL, SENS_ENABLE + SENS_READ);
-		sendUSBPacket(s1, s1);
-		makeWriteRegPacket(s1, addr_table_i2c_usb[dev_address], SSIDX, ANALOG_INP);
-		sendUSBPacket(s1, s1);
-		do
-		{
-			makeReadRegPacket(s1, addr_table_i2c_usb[dev_address], SSVAL);
-			errcode = sendUSBPacket(s1, s2);
-			errcode = decodeReceivedPacket(s2, devaddr, funccode, regaddr, regval);
-			tmout ++;
-		} while (((devaddr != addr_table_i2c_usb[dev_address]) || (regaddr != SSVAL)) && (tmout < TIME_OUT));
-
-		alt_func_flag = ALT_ANALOG;
-		// qDebug() << "Dev address (analog_sensor): " << dev_address << " " << regval;
-		// qDebug() << "Dev address (analog_sensor): " << addr_table_i2c_usb[dev_address] << " " << regval;
-		return regval;
+		plan.dev_addr = addr_table_i2c_usb[dev_address];
+		plan.conf_count = 2;
+		plan.conf_regs[0] = SSCTL;
+		plan.conf_vals[0] = SENS_ENABLE + SENS_READ;
+		plan.conf_regs[1] = SSIDX;
+		plan.conf_vals[1] = ANALOG_INP;
+		plan.value_reg = SSVAL;
+		// Battery voltage input has no alternative functions
+		plan.alt_func = (dev_address == i2cBATT) ? ALT_NOTHING : ALT_ANALOG;
+		return true;
 	}
 	// I2C sensors
-	else if ((dev_address == i2cTEMP1)
+	if ((dev_address == i2cTEMP1)
 			|| (dev_address == i2cTEMP2)
 			|| (dev_address == i2cTEMP3)
 			|| (dev_address == i2cW1)
@@ -812,150 +840,408 @@ uint32_t read_Sensor(QByteArray const &i2c_data)
 			|| (dev_address == i2cW3)
 			|| (dev_address == i2cW4))
 	{
-		if ((alt_func_flag == ALT_NOTHING)
-				|| (alt_func_flag == ALT_SERVO)
-				|| (alt_func_flag == ALT_ANALOG)
-				|| (alt_func_flag == ALT_ENC)
-				|| (alt_func_flag == ALT_USART)
-				|| (alt_func_flag == ALT_DHTXX))
-		{
-		}
+		plan.dev_addr = addr_table_i2c_usb[dev_address];
+		plan.conf_count = 1;
+		plan.conf_regs[0] = IICTL;
+		plan.conf_vals[0] = I2C_ENABLE + I2C_SENS;
+		plan.value_reg = IIVAL;
+		plan.alt_func = ALT_I2C;
+		return true;
+	}
+	// DHT11 and DHT22 sensors (temperature and humidity)
+	uint16_t first_address = 0;
+	uint32_t sensor_type = 0;
+	if ((dev_address >= TEMP_DHT11_1) && (dev_address <= TEMP_DHT11_14))
+	{
+		first_address = TEMP_DHT11_1;
+		sensor_type = DHTXX_TEMP;
+	}
+	else if ((dev_address >= HUM_DHT11_1) && (dev_address <= HUM_DHT11_14))
+	{
+		first_address = HUM_DHT11_1;
+		sensor_type = DHTXX_HUM;
+	}
+	else if ((dev_address >= TEMP_DHT22_1) && (dev_address <= TEMP_DHT22_14))
+	{
+		first_address = TEMP_DHT22_1;
+		sensor_type = DHTXX_TEMP;
+	}
+	else if ((dev_address >= HUM_DHT22_1) && (dev_address <= HUM_DHT22_14))
+	{
+		first_address = HUM_DHT22_1;
+		sensor_type = DHTXX_HUM;
+	}
+	else
+	{
+		return false;
+	}
+	plan.dev_addr = dev_address - first_address + SENSOR1;
+	plan.conf_count = 2;
+	plan.conf_regs[0] = SSCTL;
+	plan.conf_vals[0] = SENS_ENABLE + SENS_READ;
+	plan.conf_regs[1] = SSIDX;
+	plan.conf_vals[1] = sensor_type;
+	plan.value_reg = SSVAL;
+	plan.alt_func = ALT_DHTXX;
+	return true;
+}
 
-		makeWriteRegPacket(s1, addr_table_i2c_usb[dev_address], IICTL, I2C_ENABLE + I2C_SENS);
-		sendUSBPacket(s1, s1);
-		do
-		{
-			makeReadRegPacket(s1, addr_table_i2c_usb[dev_address], IIVAL);
-			errcode = sendUSBPacket(s1, s2);
-			errcode = decodeReceivedPacket(s2, devaddr, funccode, regaddr, regval);
-			tmout ++;
-		} while (((devaddr != addr_table_i2c_usb[dev_address]) || (regaddr != IIVAL)) && (tmout < TIME_OUT));
-
-		alt_func_flag = ALT_I2C;
-		// qDebug() << "Dev address (i2c_sensor): " << dev_address << " " << regval;
-		return regval;
+/// Make plan of reading encoder
+bool makeEncoderReadPlan(trikHal::MspCommand const &command
+			, ReadPlan &plan)
+{
+	const uint16_t dev_address = command.registerNumber();	// Device address
+
+	if ((dev_address == i2cENC1) || (dev_address == i2cENC2)
+		||  (dev_address == i2cENC3) || (dev_address == i2cENC4))
+	{
+		plan.dev_addr = addr_table_i2c_usb[dev_address];
+		plan.conf_count = 1;
+		plan.conf_regs[0] = EECTL;
+		plan.conf_vals[0] = ENC_ENABLE + ENC_2WIRES + ENC_PUPEN + ENC_FALL;
+		plan.value_reg = EEVAL;
+		plan.alt_func = ALT_ENC;
+		return true;
 	}
-	// DHT11 sensors (temperature)
-	else if ((dev_address >= TEMP_DHT11_1) && (dev_address <= TEMP_DHT11_14))
+	return false;
+}
+
+/// Execute read plans in pipelined exchanges of up to MAX_READ_PLANS plans
+uint32_t executeReadPlans(ReadPlan const *plans
+			, uint16_t count
+			, uint32_t *results)
+{
+	PacketBuffer packets[MAX_READ_PLANS * (MAX_CONF_REGS + 1)];	// Requests, replaced by replies after exchange
+	char *packet_ptrs[MAX_READ_PLANS * (MAX_CONF_REGS + 1)];	// Pointers to packets
+	uint16_t lengths[MAX_READ_PLANS * (MAX_CONF_REGS + 1)];		// Numbers of received bytes
+	uint16_t value_packets[MAX_READ_PLANS];			// Indexes of value register read packets
+	uint16_t packet_count = 0;				// Number of packets
+	uint8_t devaddr;					// Returned device address
+	uint8_t funccode;					// Returned function code
+	uint8_t regaddr;					// Returned register address
+	uint32_t regval;					// Returned register value
+
+	if (count == 0)
 	{
-		if ((alt_func_flag == ALT_NOTHING)
-				|| (alt_func_flag == ALT_SERVO)
-				|| (alt_func_flag == ALT_ANALOG)
-				|| (alt_func_flag == ALT_ENC)
-				|| (alt_func_flag == ALT_USART)
-				|| (alt_func_flag == ALT_I2C))
+		return NO_ERROR;
+	}
+	if (count > MAX_READ_PLANS)
+	{
+		const uint32_t errcode = executeReadPlans(plans, MAX_READ_PLANS, results);
+		const uint32_t rest_errcode = executeReadPlans(plans + MAX_READ_PLANS, count - MAX_READ_PLANS
+				, results + MAX_READ_PLANS);
+		return (errcode != NO_ERROR) ? errcode : rest_errcode;
+	}
+	for (uint16_t i = 0; i < count; i++)
+	{
+		switch_alt_func(plans[i].dev_addr, plans[i].alt_func);
+		for (uint8_t j = 0; j < plans[i].conf_count; j++)
 		{
+			// Configuration is written only if it differs from what device already has
+			if (shadow_reg_matches(plans[i].dev_addr, plans[i].conf_regs[j], plans[i].conf_vals[j]))
+			{
+				continue;
+			}
+			update_shadow_reg(plans[i].dev_addr, plans[i].conf_regs[j], plans[i].conf_vals[j]);
+			makeWriteRegPacket(packets[packet_count].data, plans[i].dev_addr, plans[i].conf_regs[j]
+					, plans[i].conf_vals[j]);
+			packet_ptrs[packet_count] = packets[packet_count].data;
+			packet_count++;
 		}
+		makeReadRegPacket(packets[packet_count].data, plans[i].dev_addr, plans[i].value_reg);
+		packet_ptrs[packet_count] = packets[packet_count].data;
+		value_packets[i] = packet_count;
+		packet_count++;
+	}
 
-		makeWriteRegPacket(s1, (dev_address-TEMP_DHT11_1+SENSOR1), SSCTL, SENS_ENABLE + SENS_READ);
-		sendUSBPacket(s1, s1);
-		makeWriteRegPacket(s1, (dev_address-TEMP_DHT11_1+SENSOR1), SSIDX, DHTXX_TEMP);
-		sendUSBPacket(s1, s1);
+	const uint32_t errcode = exchangeUSBPackets(usb_out_descr, packet_ptrs, packet_ptrs, packet_count, lengths);
+	if (errcode != NO_ERROR)
+	{
+		// Not known which writes have reached device
+		invalidate_shadow_regs();
+	}
 
-		do
+	for (uint16_t i = 0; i < count; i++)
+	{
+		results[i] = UINT32_MAX;
+		if ((decodeReceivedPacket(packets[value_packets[i]].data, lengths[value_packets[i]]
+				, devaddr, funccode, regaddr, regval) == NO_ERROR)
+				&& (devaddr == plans[i].dev_addr) && (regaddr == plans[i].value_reg))
 		{
-			makeReadRegPacket(s1, (dev_address-TEMP_DHT11_1+SENSOR1), SSVAL);
-			errcode = sendUSBPacket(s1, s2);
-			errcode = decodeReceivedPacket(s2, devaddr, funccode, regaddr, regval);
-			tmout ++;
-		} while (((devaddr != (dev_address-TEMP_DHT11_1+SENSOR1)) || (regaddr != SSVAL)) && (tmout < TIME_OUT));
-
-		alt_func_flag = ALT_DHTXX;
-		// qDebug() << "Dev address (dht11_temperature): " << dev_address << " " << regval;
-		// qDebug() << "Dev address (dht11_temperature): " << (dev_address-TEMP_DHT11_1+SENSOR1) << " " << regval;
-		return regval;
+			results[i] = regval;
+		}
 	}
-	// DHT11 sensors (humidity)
-	else if ((dev_address >= HUM_DHT11_1) && (dev_address <= HUM_DHT11_14))
+	return errcode;
+}
+
+/// Read several sensors and encoders in pipelined exchanges
+uint32_t read_USBMSP_batch(trikHal::MspCommand const *commands
+			, uint32_t *results
+			, uint16_t count)
+{
+	ReadPlan plans[MAX_READ_PLANS];				// Plans of reads that can be pipelined
+	uint16_t plan_indexes[MAX_READ_PLANS];			// Indexes of pipelined reads in batch
+	uint32_t plan_results[MAX_READ_PLANS];			// Results of pipelined reads
+	uint16_t plan_count = 0;				// Number of planned reads
+	uint32_t errcode = NO_ERROR;				// First error of exchanges
+
+	for (uint16_t i = 0; i <= count; i++)
 	{
-		if ((alt_func_flag == ALT_NOTHING)
-				|| (alt_func_flag == ALT_SERVO)
-				|| (alt_func_flag == ALT_ANALOG)
-				|| (alt_func_flag == ALT_ENC)
-				|| (alt_func_flag == ALT_USART)
-				|| (alt_func_flag == ALT_I2C))
+		// Planned reads are executed when there are enough of them for an exchange and after the last command
+		if ((plan_count == MAX_READ_PLANS) || ((i == count) && (plan_count > 0)))
 		{
+			const uint32_t exchange_errcode = executeReadPlans(plans, plan_count, plan_results);
+			if (errcode == NO_ERROR)
+			{
+				errcode = exchange_errcode;
+			}
+			for (uint16_t j = 0; j < plan_count; j++)
+			{
+				results[plan_indexes[j]] = plan_results[j];
+			}
+			plan_count = 0;
+		}
+		if (i == count)
+		{
+			break;
 		}
 
-		makeWriteRegPacket(s1, (dev_address-HUM_DHT11_1+SENSOR1), SSCTL, SENS_ENABLE + SENS_READ);
-		sendUSBPacket(s1, s1);
-		makeWriteRegPacket(s1, (dev_address-HUM_DHT11_1+SENSOR1), SSIDX, DHTXX_HUM);
-		sendUSBPacket(s1, s1);
-
-		do
+		const bool planned = (commands[i].kind() == trikHal::MspCommand::Kind::readWord)
+				? makeSensorReadPlan(commands[i], plans[plan_count])
+				: makeEncoderReadPlan(commands[i], plans[plan_count]);
+		if (planned)
 		{
-			makeReadRegPacket(s1, (dev_address-HUM_DHT11_1+SENSOR1), SSVAL);
-			errcode = sendUSBPacket(s1, s2);
-			errcode = decodeReceivedPacket(s2, devaddr, funccode, regaddr, regval);
-			tmout ++;
-		} while (((devaddr != (dev_address-HUM_DHT11_1+SENSOR1)) || (regaddr != SSVAL)) && (tmout < TIME_OUT));
-		alt_func_flag = ALT_DHTXX;
-		// qDebug() << "Dev address (dht11_humidity): " << dev_address << " " << regval;
-		// qDebug() << "Dev address (dht11_humidity): " << (dev_address-HUM_DHT11_1+SENSOR1) << " " << regval;
-		return regval;
-	}
-	// DHT22 sensors (temperature)
-	else if ((dev_address >= TEMP_DHT22_1) && (dev_address <= TEMP_DHT22_14))
-	{
-		if ((alt_func_flag == ALT_NOTHING)
-				|| (alt_func_flag == ALT_SERVO)
-				|| (alt_func_flag == ALT_ANALOG)
-				|| (alt_func_flag == ALT_ENC)
-				|| (alt_func_flag == ALT_USART)
-				|| (alt_func_flag == ALT_I2C))
+			plan_indexes[plan_count] = i;
+			plan_count++;
+		}
+		else
 		{
+			// URM04 and unknown devices are read one by one
+			results[i] = read_USBMSP(commands[i]);
 		}
+	}
+	return errcode;
+}
+
+/// Read encoder function
+uint32_t read_Encoder(trikHal::MspCommand const &command)
+{
+	ReadPlan plan;
+	if (!makeEncoderReadPlan(command, plan))
+	{
+		return DEV_ADDR_ERROR;
+	}
+
+	uint32_t regval = UINT32_MAX;
+	executeReadPlans(&plan, 1, &regval);
+	// qDebug() << "Dev address (read_encoder): " << plan.dev_addr << " " << regval;
+	return regval;
+}
 
-		makeWriteRegPacket(s1, (dev_address-TEMP_DHT22_1+SENSOR1), SSCTL, SENS_ENABLE + SENS_READ);
+/// Init I2C + USART + URM04
+uint32_t init_URM04(uint8_t i2c_addr, uint8_t usart_addr)
+{
+	char s1[MAX_STRING_LENGTH];		    // Temp string variable
+	const uint32_t usart_ctl = USART_EN+USART_8BITS+USART_RS485+USART_INVRTS+USART_RXEN+USART_TXEN;
+	switch_alt_func(usart_addr, ALT_USART);
+	if (!shadow_reg_matches(i2c_addr, IICTL, I2C_ENABLE))
+	{
+		makeWriteRegPacket(s1, i2c_addr, IICTL, I2C_ENABLE);
 		sendUSBPacket(s1, s1);
-		makeWriteRegPacket(s1, (dev_address-TEMP_DHT22_1+SENSOR1), SSIDX, DHTXX_TEMP);
+		update_shadow_reg(i2c_addr, IICTL, I2C_ENABLE);
+	}
+	if (!shadow_reg_matches(usart_addr, UUSPD, 19200))
+	{
+		makeWriteRegPacket(s1, usart_addr, UUSPD, 19200);
 		sendUSBPacket(s1, s1);
+		update_shadow_reg(usart_addr, UUSPD, 19200);
+	}
+	if (!shadow_reg_matches(usart_addr, UUCTL, usart_ctl))
+	{
+		makeWriteRegPacket(s1, usart_addr, UUCTL, usart_ctl);
+		sendUSBPacket(s1, s1);
+		update_shadow_reg(usart_addr, UUCTL, usart_ctl);
+	}
+	return NO_ERROR;
+}
 
-		do
+/// Monotonic time in ms
+uint64_t monotonic_ms()
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+/// Forget all URM04 measurements and requests
+void reset_URM04()
+{
+	for (uint8_t i = 0; i < URM04_USARTS; i++)
+	{
+		urm04_channels[i].state = URM04_IDLE;
+		urm04_channels[i].urm04_addr = URM04_FIRST_ADDR;
+		urm04_channels[i].requested = 0;
+		urm04_channels[i].measured = 0;
+		urm04_channels[i].deadline = 0;
+		for (uint8_t j = 0; j < URM04_ADDRS; j++)
 		{
-			makeReadRegPacket(s1, (dev_address-TEMP_DHT22_1+SENSOR1), SSVAL);
-			errcode = sendUSBPacket(s1, s2);
-			errcode = decodeReceivedPacket(s2, devaddr, funccode, regaddr, regval);
-			tmout ++;
-		} while (((devaddr != (dev_address-TEMP_DHT22_1+SENSOR1)) || (regaddr != SSVAL)) && (tmout < TIME_OUT));
-
-		alt_func_flag = ALT_DHTXX;
-		// qDebug() << "Dev address (dht22_temperature): " << dev_address << " " << regval;
-		// qDebug() << "Dev address (dht22_temperature): " << (dev_address-TEMP_DHT22_1+SENSOR1) << " " << regval;
-		return regval;
+			urm04_channels[i].last_read[j] = 0;
+			urm04_channels[i].distance[j] = URM04_ERROR;
+		}
 	}
-	// DHT22 sensors (humidity)
-	else if ((dev_address >= HUM_DHT22_1) && (dev_address <= HUM_DHT22_14))
+}
+
+/// Append packets writing URM04 command byte by byte to USART data register
+void appendURM04Command(QVector<PacketBuffer> &packets
+			, uint8_t dev_addr
+			, uint8_t urm04_addr
+			, uint8_t command)
+{
+	const uint8_t crc = 0x55 + 0xAA + urm04_addr + 0x00 + command;
+	const uint8_t pack[URM04_TRIG_LEN] = {0x55, 0xAA, urm04_addr, 0x00, command, crc};
+	for (int i = 0; i < URM04_TRIG_LEN; i++)
 	{
-		if ((alt_func_flag == ALT_NOTHING)
-				|| (alt_func_flag == ALT_SERVO)
-				|| (alt_func_flag == ALT_ANALOG)
-				|| (alt_func_flag == ALT_ENC)
-				|| (alt_func_flag == ALT_USART)
-				|| (alt_func_flag == ALT_I2C))
+		packets.append(PacketBuffer());
+		makeWriteRegPacket(packets.last().data, dev_addr, UUDAT, pack[i]);
+	}
+}
+
+/// Advance URM04 ranging on all USARTs in one pipelined exchange
+uint32_t poll_URM04()
+{
+	QVector<PacketBuffer> packets;				// Requests, replaced by replies after exchange
+	QVector<char *> packet_ptrs;				// Pointers to packets
+	int reply_packets[URM04_USARTS];			// Index of first reply byte read packet, -1 if none
+	const uint64_t now = monotonic_ms();			// Current time
+	uint8_t devaddr;					// Returned device address
+	uint8_t funccode;					// Returned function code
+	uint8_t regaddr;					// Returned register address
+	uint32_t regval;					// Returned register value
+
+	for (uint8_t i = 0; i < URM04_USARTS; i++)
+	{
+		URM04Channel &channel = urm04_channels[i];
+		const uint8_t dev_addr = USART1 + i;
+		reply_packets[i] = -1;
+		for (uint8_t j = 0; j < URM04_ADDRS; j++)
 		{
+			// Sensor is not read anymore (or its port is deconfigured), stop measuring it
+			if ((channel.requested & (1 << j)) && (now - channel.last_read[j] > URM04_IDLE_TIME))
+			{
+				channel.requested &= ~(1 << j);
+				channel.measured &= ~(1 << j);
+			}
 		}
+		if ((channel.state == URM04_MEASURING) && (now >= channel.deadline))
+		{
+			// Measurement is finished, ask for distance and read reply
+			appendURM04Command(packets, dev_addr, channel.urm04_addr, 0x02);
+			reply_packets[i] = packets.size();
+			for (int j = 0; j < URM04_REPLY_LEN; j++)
+			{
+				packets.append(PacketBuffer());
+				makeReadRegPacket(packets.last().data, dev_addr, UUDAT);
+			}
+		}
+		else if ((channel.state == URM04_IDLE) && (channel.requested != 0))
+		{
+			// Trigger next requested sensor, round robin, sensors waiting for first measurement go first
+			const uint16_t waiting = channel.requested & ~channel.measured;
+			const uint16_t candidates = waiting ? waiting : channel.requested;
+			uint8_t index = channel.urm04_addr - URM04_FIRST_ADDR;
+			do
+			{
+				index = (index + 1) % URM04_ADDRS;
+			} while (!(candidates & (1 << index)));
+			channel.urm04_addr = URM04_FIRST_ADDR + index;
+			appendURM04Command(packets, dev_addr, channel.urm04_addr, 0x01);
+			channel.state = URM04_MEASURING;
+			channel.deadline = now + URM04_MEASURE_TIME;
+		}
+	}
 
-		makeWriteRegPacket(s1, (dev_address-HUM_DHT22_1+SENSOR1), SSCTL, SENS_ENABLE + SENS_READ);
-		sendUSBPacket(s1, s1);
-		makeWriteRegPacket(s1, (dev_address-HUM_DHT22_1+SENSOR1), SSIDX, DHTXX_HUM);
-		sendUSBPacket(s1, s1);
+	if (packets.isEmpty())
+	{
+		return NO_ERROR;
+	}
+	for (PacketBuffer &packet : packets)
+	{
+		packet_ptrs.append(packet.data);
+	}
+	QVector<uint16_t> lengths(packets.size());		// Numbers of received bytes
+	const uint32_t errcode = exchangeUSBPackets(usb_out_descr, packet_ptrs.data(), packet_ptrs.data()
+			, packet_ptrs.size(), lengths.data());
 
-		do
+	for (uint8_t i = 0; i < URM04_USARTS; i++)
+	{
+		if (reply_packets[i] < 0)
+		{
+			continue;
+		}
+		URM04Channel &channel = urm04_channels[i];
+		const uint8_t index = channel.urm04_addr - URM04_FIRST_ADDR;
+		uint8_t buf1[URM04_REPLY_LEN] = {0};
+		bool received = true;
+		for (int j = 0; j < URM04_REPLY_LEN; j++)
+		{
+			const int reply = reply_packets[i] + j;
+			if ((decodeReceivedPacket(packets[reply].data, lengths[reply], devaddr, funccode, regaddr, regval)
+					!= NO_ERROR) || (regaddr != UUDAT))
+			{
+				received = false;
+				break;
+			}
+			buf1[j] = regval;
+		}
+		const uint8_t crc1 = buf1[0] + buf1[1] + buf1[2] + buf1[3] + buf1[4] + buf1[5] + buf1[6];
+		if (!received || (crc1 != buf1[7]))
+		{
+			// qDebug() << "URM04 CRC ERROR!";
+			channel.distance[index] = URM04_ERROR;
+		}
+		else
 		{
-			makeReadRegPacket(s1, (dev_address-HUM_DHT22_1+SENSOR1), SSVAL);
-			errcode = sendUSBPacket(s1, s2);
-			errcode = decodeReceivedPacket(s2, devaddr, funccode, regaddr, regval);
-			tmout ++;
-		} while (((devaddr != (dev_address-HUM_DHT22_1+SENSOR1)) || (regaddr != SSVAL)) && (tmout < TIME_OUT));
-
-		alt_func_flag = ALT_DHTXX;
-		// qDebug() << "Dev address (dht22_humidity): " << dev_address << " " << regval;
-		// qDebug() << "Dev address (dht22_humidity): " << (dev_address-HUM_DHT22_1+SENSOR1) << " " << regval;;;
+			// qDebug() << "Distance: " << (uint32_t)(buf1[5] << 8) + (uint32_t)buf1[6];
+			channel.distance[index] = (uint32_t)(buf1[5] << 8) + (uint32_t)buf1[6];
+		}
+		channel.measured |= channel.requested & (1 << index);
+		channel.state = URM04_IDLE;
+	}
+	return errcode;
+}
+
+/// Read URM04 distance function
+uint32_t read_URM04_dist(uint8_t dev_addr, uint8_t urm04_addr)
+{
+	URM04Channel &channel = urm04_channels[dev_addr - USART1];
+	const uint8_t index = urm04_addr - URM04_FIRST_ADDR;
+	channel.requested |= (1 << index);
+	channel.last_read[index] = monotonic_ms();
+
+	// Measurement itself is advanced by periodic poll_URM04(), there is no distance until it lands
+	if (!(channel.measured & (1 << index)))
+	{
+		return URM04_ERROR;
+	}
+	return channel.distance[index];
+}
+
+/// Read sensor function
+uint32_t read_Sensor(trikHal::MspCommand const &command)
+{
+	ReadPlan plan;
+	if (makeSensorReadPlan(command, plan))
+	{
+		uint32_t regval = UINT32_MAX;
+		executeReadPlans(&plan, 1, &regval);
+		// qDebug() << "Dev address (sensor): " << plan.dev_addr << " " << regval;
 		return regval;
 	}
+
+	const uint16_t dev_address = command.registerNumber();	// Device address
+
 	// URM04 sensors
-	else if ((dev_address >= i2cU1_0x11) && (dev_address <= i2cU7_0x20))
+	if ((dev_address >= i2cU1_0x11) && (dev_address <= i2cU7_0x20))
 	{
 		if ((alt_func_flag == ALT_NOTHING)
 				|| (alt_func_flag == ALT_SERVO)
@@ -994,7 +1280,6 @@ uint32_t read_Sensor(QByteArray const &i2c_data)
 		{
 			init_URM04(I2C7, USART7);
 		}
-		alt_func_flag = ALT_USART;
 		// qDebug() << "Dev address (URM04_sensor): " << dev_address << " " << regval;
 		switch (dev_address)
 		{
@@ -1123,16 +1408,16 @@ uint32_t read_Sensor(QByteArray const &i2c_data)
 }
 
 /// Send data to MSP430 via USB
-uint32_t send_USBMSP(QByteArray const &i2c_data)
+uint32_t send_USBMSP(trikHal::MspCommand const &command)
 {
-	switch (i2c_data.size())
+	switch (command.kind())
 	{
-		case 3:
-			power_Motor(i2c_data);
-			reset_Encoder(i2c_data);
+		case trikHal::MspCommand::Kind::writeByte:
+			power_Motor(command);
+			reset_Encoder(command);
 			break;
-		case 4:
-			freq_Motor(i2c_data);
+		case trikHal::MspCommand::Kind::writeWord:
+			freq_Motor(command);
 			break;
 		default:
 			break;
@@ -1141,14 +1426,14 @@ uint32_t send_USBMSP(QByteArray const &i2c_data)
 }
 
 /// Read data from MSP430 via USB
-uint32_t read_USBMSP(QByteArray const &i2c_data)
+uint32_t read_USBMSP(trikHal::MspCommand const &command)
 {
-	switch (i2c_data.size())
+	switch (command.kind())
 	{
-		case 2:
-			return read_Sensor(i2c_data);
-		case 3:
-			return read_Encoder(i2c_data);
+		case trikHal::MspCommand::Kind::readWord:
+			return read_Sensor(command);
+		case trikHal::MspCommand::Kind::readLong:
+			return read_Encoder(command);
 		default:
 			return NO_ERROR;
 	}
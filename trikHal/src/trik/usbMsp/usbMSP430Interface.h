@@ -17,31 +17,106 @@
 
 #pragma once
 
+#include "mspCommand.h"
+#include <QtCore/QVector>
+
+#include "usbMSP430Defines.h"
+
+/// Maximal number of configuration registers written before reading device value
+#define MAX_CONF_REGS		2
+
+/// Maximal number of read plans executed in one pipelined exchange, longer lists are split
+#define MAX_READ_PLANS		16
+
+/// Plan of reading a value register of a device: configuration registers to write and register to read
+struct ReadPlan
+{
+	uint8_t dev_addr;			// USB device address
+	uint8_t conf_count;			// Number of configuration registers
+	uint8_t conf_regs[MAX_CONF_REGS];	// Configuration registers addresses
+	uint32_t conf_vals[MAX_CONF_REGS];	// Configuration registers values
+	uint8_t value_reg;			// Value register address
+	uint8_t alt_func;			// Alternative function device is switched to, ALT_NOTHING if none
+};
+
+/// Number of devices and registers per device in configuration shadow cache
+#define SHADOW_DEVICES		0x100
+#define SHADOW_REGS		0x10
+
+/// URM04 ranging on one USART, only one sensor of RS-485 bus is measured at a time
+struct URM04Channel
+{
+	uint8_t state;				// URM04_IDLE or URM04_MEASURING
+	uint8_t urm04_addr;			// Address of sensor being measured
+	uint16_t requested;			// Bit mask of sensors to measure, bit 0 is URM04_FIRST_ADDR
+	uint16_t measured;			// Bit mask of requested sensors which have been measured
+	uint64_t deadline;			// Time when measured distance is ready, ms
+	uint64_t last_read[URM04_ADDRS];	// Time of last read of each sensor, ms
+	uint32_t distance[URM04_ADDRS];		// Last measured distances, URM04_ERROR if measurement failed
+};
+
+/// Buffer for one packet, to keep packets in containers
+struct PacketBuffer
+{
+	char data[MAX_STRING_LENGTH];		// Packet data
+};
+
 /// Extract number from packet
 uint32_t hex2num(char *string				// Input string
 		, uint16_t pos				// Start position
 		, uint16_t numsize);			// Number size
 
-/// Make write register packet
+/// Make write register packet (ASCII or binary, depending on negotiated protocol)
 void makeWriteRegPacket(char *msp_packet		// Created packet string
 			, uint8_t dev_addr		// Device address
 			, uint8_t reg_addr		// Registers address to write
 			, uint32_t reg_val);		// Value to write
 
-/// Make read register packet
+/// Make read register packet (ASCII or binary, depending on negotiated protocol)
 void makeReadRegPacket(char *msp_packet			// Created packet string
 			, uint8_t dev_addr		// Device address
 			, uint8_t reg_addr);		// Register address to read
 
+/// Calculate CRC-8 used by binary packets
+uint8_t crc8(const uint8_t *data			// Data to calculate checksum of
+		, uint16_t len);			// Data length
+
+/// Make binary write register packet, returns packet length
+uint16_t makeWriteRegBinaryPacket(uint8_t *msp_packet	// Created packet
+			, uint8_t dev_addr		// Device address
+			, uint8_t reg_addr		// Registers address to write
+			, uint32_t reg_val);		// Value to write
+
+/// Make binary read register packet, returns packet length
+uint16_t makeReadRegBinaryPacket(uint8_t *msp_packet	// Created packet
+			, uint8_t dev_addr		// Device address
+			, uint8_t reg_addr);		// Register address to read
+
+/// Function for decoding received binary packet
+uint32_t decodeReceivedBinaryPacket(const uint8_t *msp_packet	// Input MSP430 USB binary packet
+				, uint16_t packet_len		// Number of received bytes
+				, uint8_t &dev_addr		// Decoded response device address
+				, uint8_t &func_code		// Decoded function number (read/write)
+				, uint8_t &reg_addr		// Decoded register address
+				, uint32_t &reg_val);		// Decoded register value
+
+/// Returns length of a packet in current wire protocol
+uint16_t packetLength(const char *msp_packet);		// Packet to measure
+
+/// Try to switch MSP430 to binary protocol, stay with ASCII one if firmware does not support it
+uint32_t negotiate_protocol_USBMSP();
+
 /// Init USB TTY device
 uint32_t init_USBTTYDevice();
 
 /// Send USB packet
 uint32_t sendUSBPacket(char *in_msp_packet		// Packet to send
-			, char *out_msp_packet);	// Received packet
+			, char *out_msp_packet		// Received packet
+			, uint16_t *out_length = nullptr);	// Number of received bytes, may be null
 
 /// Function for decoding received packet
 uint32_t decodeReceivedPacket(char *msp_packet		// Input MSP430 USB packet string
+				, uint16_t packet_len	// Number of received bytes
 				, uint8_t &dev_addr	// Decoded response device address
 				, uint8_t &func_code	// Decoded function number (read/write)
 				, uint8_t &reg_addr	// Decoded register address
@@ -66,24 +141,73 @@ uint32_t init_dhtxx_sensors_USBMSP();
 uint32_t init_i2c_sensors_USBMSP();
 
 /// Motor power control function
-uint32_t power_Motor(QByteArray const &i2c_data);
+uint32_t power_Motor(trikHal::MspCommand const &command);
 
 /// Set motor frequency function
-uint32_t freq_Motor(QByteArray const &i2c_data);
+uint32_t freq_Motor(trikHal::MspCommand const &command);
 
 /// Reset encoder function
-uint32_t reset_Encoder(QByteArray const &i2c_data);
+uint32_t reset_Encoder(trikHal::MspCommand const &command);
 
 /// Read encoder function
-uint32_t read_Encoder(QByteArray const &i2c_data);
+uint32_t read_Encoder(trikHal::MspCommand const &command);
+
+/// Forget all shadow register values, so configuration will be written to devices again
+void invalidate_shadow_regs();
+
+/// Check if configuration register is known to hold given value
+bool shadow_reg_matches(uint8_t dev_addr		// Device address
+			, uint8_t reg_addr		// Register address
+			, uint32_t reg_val);		// Register value
+
+/// Remember value written to configuration register
+void update_shadow_reg(uint8_t dev_addr			// Device address
+			, uint8_t reg_addr		// Register address
+			, uint32_t reg_val);		// Register value
+
+/// Switch alternative function of a device, only its shadow registers are invalidated if function changes.
+/// ALT_NOTHING means that device does not depend on alternative function, nothing is switched then
+void switch_alt_func(uint8_t dev_addr			// Device address
+			, uint8_t alt_func);		// New alternative function
+
+/// Make plan of reading analog, I2C or DHTxx sensor, returns false if sensor can not be read by plan
+bool makeSensorReadPlan(trikHal::MspCommand const &command	// Read command
+			, ReadPlan &plan);		// Created plan
+
+/// Make plan of reading encoder, returns false if encoder address is wrong
+bool makeEncoderReadPlan(trikHal::MspCommand const &command	// Read command
+			, ReadPlan &plan);		// Created plan
+
+/// Execute read plans in pipelined exchanges of up to MAX_READ_PLANS plans
+uint32_t executeReadPlans(ReadPlan const *plans		// Plans to execute
+			, uint16_t count		// Number of plans
+			, uint32_t *results);		// Read values, UINT32_MAX for failed reads
 
 /// Read sensor function
-uint32_t read_Sensor(QByteArray const &i2c_data);
+uint32_t read_Sensor(trikHal::MspCommand const &command);
 
 /// Init I2C + USART + URM04
 uint32_t init_URM04(uint8_t i2c_addr, uint8_t usart_addr);
 
-/// Read URM04 distance function
+/// Monotonic time in ms
+uint64_t monotonic_ms();
+
+/// Append packets writing URM04 command byte by byte to USART data register
+void appendURM04Command(QVector<PacketBuffer> &packets	// Packets to append to
+			, uint8_t dev_addr		// USART address
+			, uint8_t urm04_addr		// URM04 address on RS-485 bus
+			, uint8_t command);		// URM04 command
+
+/// Forget all URM04 measurements and requests
+void reset_URM04();
+
+/// Advance URM04 ranging: trigger requested sensors on idle USARTs and fetch distances of finished measurements.
+/// Never waits for measurement, so it shall be called periodically while URM04 sensors are used.
+uint32_t poll_URM04();
+
+/// Read URM04 distance function, returns last measured distance and requests new measurement. Never waits:
+/// returns URM04_ERROR until poll_URM04() fetches the first measurement of a sensor (or the first one after
+/// URM04_IDLE_TIME without reads)
 uint32_t read_URM04_dist(uint8_t dev_addr, uint8_t urm04_addr);
 
 /// Connect to USB MSP430 device
@@ -93,8 +217,13 @@ uint32_t connect_USBMSP();
 uint32_t disconnect_USBMSP();
 
 /// Send data to MSP430 via USB
-uint32_t send_USBMSP(QByteArray const &i2c_data);
+uint32_t send_USBMSP(trikHal::MspCommand const &command);
 
 /// Read data from MSP430 via USB
-uint32_t read_USBMSP(QByteArray const &i2c_data);
+uint32_t read_USBMSP(trikHal::MspCommand const &command);
+
+/// Read data from several devices in pipelined exchanges
+uint32_t read_USBMSP_batch(trikHal::MspCommand const *commands	// Read commands
+			, uint32_t *results		// Read values
+			, uint16_t count);		// Number of commands
 
@@ -0,0 +1,285 @@
+/* Copyright 2016 CyberTech Labs Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License. */
+
+#include "usbMSP430Transport.h"
+
+#include <ctype.h>
+#include <string.h>
+#include <errno.h>
+#include <poll.h>
+#include <unistd.h>
+#include <termios.h>
+
+#include <QtCore/QByteArray>
+
+#include <QsLog.h>
+
+#include "usbMSP430Defines.h"
+#include "usbMSP430Interface.h"
+
+namespace {
+
+/// States of reply receiver
+enum class ReceiveState
+{
+	waitStart
+	, asciiBody
+	, binaryLength
+	, binaryBody
+};
+
+/// Assembles reply packets from a stream of bytes coming from USB device. Packets with wrong length, unexpected
+/// characters or wrong checksum are dropped, and bytes following their start byte are scanned again, so receiver
+/// resynchronizes on the next start byte after lost or corrupted bytes.
+struct ReplyReceiver
+{
+	ReceiveState state = ReceiveState::waitStart;
+	char packet[MAX_STRING_LENGTH] = {0};
+	uint16_t received = 0;
+	uint16_t expected = 0;
+
+	/// Consumes one byte, returns true when a complete packet is assembled in "packet".
+	bool feed(uint8_t byte)
+	{
+		switch (accept(byte)) {
+		case Result::incomplete:
+			return false;
+		case Result::complete:
+			packet[received] = 0;
+			state = ReceiveState::waitStart;
+			return true;
+		case Result::invalid:
+			break;
+		}
+
+		// Start byte of dropped packet may have been garbage, so the next packet may start inside it.
+		char dropped[MAX_STRING_LENGTH];
+		const uint16_t droppedCount = received - 1;
+		memcpy(dropped, packet + 1, droppedCount);
+		state = ReceiveState::waitStart;
+		received = 0;
+		bool complete = false;
+		for (uint16_t i = 0; i < droppedCount; ++i) {
+			complete = feed(dropped[i]);
+		}
+
+		return complete;
+	}
+
+private:
+	/// Result of consuming one byte.
+	enum class Result
+	{
+		incomplete
+		, complete
+		, invalid
+	};
+
+	/// Appends byte to a packet being assembled and validates it.
+	Result accept(uint8_t byte)
+	{
+		if (state == ReceiveState::waitStart) {
+			if (byte == ':') {
+				expected = RECV_PACK_LEN;
+				state = ReceiveState::asciiBody;
+			} else if (byte == BIN_START) {
+				expected = BIN_RECV_PACK_LEN;
+				state = ReceiveState::binaryLength;
+			} else {
+				// Garbage between packets, skipping.
+				return Result::incomplete;
+			}
+
+			packet[0] = byte;
+			received = 1;
+			return Result::incomplete;
+		}
+
+		packet[received++] = byte;
+		switch (state) {
+		case ReceiveState::binaryLength:
+			// Replies to all requests have the same length.
+			if (byte != BIN_RECV_PACK_LEN) {
+				return Result::invalid;
+			}
+
+			state = ReceiveState::binaryBody;
+			return Result::incomplete;
+		case ReceiveState::binaryBody:
+			if (received < expected) {
+				return Result::incomplete;
+			}
+
+			return crc8(reinterpret_cast<uint8_t *>(packet) + 1, expected - 2) == byte
+					? Result::complete
+					: Result::invalid;
+		case ReceiveState::asciiBody:
+			if (received < expected) {
+				return isxdigit(byte) ? Result::incomplete : Result::invalid;
+			}
+
+			// CRC of ASCII packet is checked by decoder, it is cheap to recalculate there.
+			return byte == '\n' ? Result::complete : Result::invalid;
+		case ReceiveState::waitStart:
+			break;
+		}
+
+		return Result::invalid;
+	}
+};
+
+/// Extracts device and register address from a request or reply packet.
+void packetAddress(char *msp_packet, uint8_t &dev_addr, uint8_t &reg_addr)
+{
+	if (uint8_t(msp_packet[0]) == BIN_START) {
+		dev_addr = msp_packet[2];
+		reg_addr = msp_packet[4];
+	} else {
+		dev_addr = hex2num(msp_packet, 1, NUM_BYTE);
+		reg_addr = hex2num(msp_packet, 5, NUM_BYTE);
+	}
+}
+
+/// Writes the whole packet to non-blocking descriptor, waiting for it to become writable if needed.
+bool writePacket(int descr, const char *msp_packet)
+{
+	const uint16_t length = packetLength(msp_packet);
+	uint16_t written = 0;
+	while (written < length) {
+		const ssize_t result = write(descr, msp_packet + written, length - written);
+		if (result > 0) {
+			written += result;
+		} else if (result < 0 && (errno == EAGAIN || errno == EINTR)) {
+			struct pollfd descriptor = {descr, POLLOUT, 0};
+			if (poll(&descriptor, 1, REPLY_TIMEOUT) <= 0 && errno != EINTR) {
+				return false;
+			}
+		} else {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+}
+
+uint32_t exchangeUSBPackets(int descr
+			, char **in_msp_packets
+			, char **out_msp_packets
+			, uint16_t count
+			, uint16_t *out_lengths)
+{
+	if (descr < 0) {
+		QLOG_ERROR() << "Error device descriptor" << errno << " : " << strerror (errno);
+		return DEVICE_ERROR;
+	}
+
+	if (count > MAX_EXCHANGE_PACKETS) {
+		const uint32_t errcode = exchangeUSBPackets(descr, in_msp_packets, out_msp_packets, MAX_EXCHANGE_PACKETS
+				, out_lengths);
+		if (errcode != NO_ERROR) {
+			return errcode;
+		}
+
+		return exchangeUSBPackets(descr, in_msp_packets + MAX_EXCHANGE_PACKETS, out_msp_packets + MAX_EXCHANGE_PACKETS
+				, count - MAX_EXCHANGE_PACKETS, out_lengths ? out_lengths + MAX_EXCHANGE_PACKETS : nullptr);
+	}
+
+	uint8_t devAddresses[MAX_EXCHANGE_PACKETS];
+	uint8_t regAddresses[MAX_EXCHANGE_PACKETS];
+	bool answered[MAX_EXCHANGE_PACKETS] = {};
+	uint16_t sent = 0;
+	uint16_t answeredCount = 0;
+	ReplyReceiver receiver;
+	uint8_t chunk[RECV_CHUNK_LEN];
+
+	while (answeredCount < count) {
+		// Keep the pipeline full.
+		while (sent < count && sent - answeredCount < MAX_IN_FLIGHT) {
+			packetAddress(in_msp_packets[sent], devAddresses[sent], regAddresses[sent]);
+			if (!writePacket(descr, in_msp_packets[sent])) {
+				QLOG_ERROR() << "Error writing: " << strerror(errno);
+				return PACKET_ERROR;
+			}
+
+			out_msp_packets[sent][0] = 0x00;
+			out_msp_packets[sent][1] = 0x00;
+			if (out_lengths)
+			{
+				out_lengths[sent] = 0;
+			}
+			++sent;
+		}
+
+		struct pollfd descriptor = {descr, POLLIN, 0};
+		const int ready = poll(&descriptor, 1, REPLY_TIMEOUT);
+		if (ready < 0 && errno == EINTR) {
+			continue;
+		}
+
+		if (ready <= 0) {
+			QLOG_ERROR() << "Timeout while waiting for reply from USB MSP430," << count - answeredCount
+					<< "requests are not answered";
+
+			// Drop late replies, otherwise they will be mistaken for replies to next requests.
+			tcflush(descr, TCIFLUSH);
+			return PACKET_ERROR;
+		}
+
+		const ssize_t received = read(descr, chunk, RECV_CHUNK_LEN);
+		if (received < 0) {
+			if (errno == EAGAIN || errno == EINTR) {
+				continue;
+			}
+
+			QLOG_ERROR() << "Error reading: " << strerror(errno);
+			return PACKET_ERROR;
+		}
+
+		for (ssize_t i = 0; i < received; ++i) {
+			if (!receiver.feed(chunk[i])) {
+				continue;
+			}
+
+			uint8_t devAddress = 0;
+			uint8_t regAddress = 0;
+			packetAddress(receiver.packet, devAddress, regAddress);
+
+			bool matched = false;
+			for (uint16_t request = 0; request < sent; ++request) {
+				if (!answered[request] && devAddresses[request] == devAddress
+						&& regAddresses[request] == regAddress)
+				{
+					memcpy(out_msp_packets[request], receiver.packet, MAX_STRING_LENGTH);
+					if (out_lengths)
+					{
+						out_lengths[request] = receiver.received;
+					}
+
+					answered[request] = true;
+					++answeredCount;
+					matched = true;
+					break;
+				}
+			}
+
+			if (!matched) {
+				QLOG_WARN() << "Unexpected reply from USB MSP430, device" << devAddress << "register" << regAddress;
+			}
+		}
+	}
+
+	return NO_ERROR;
+}
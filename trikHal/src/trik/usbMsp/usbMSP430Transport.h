@@ -0,0 +1,39 @@
+/* Copyright 2016 CyberTech Labs Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License. */
+
+#pragma once
+
+#include <stdint.h>
+
+/// Maximal number of requests sent to MSP430 without waiting for a reply
+#define MAX_IN_FLIGHT		8
+
+/// Maximal number of packets tracked in one exchange, longer exchanges are split
+#define MAX_EXCHANGE_PACKETS	64
+
+/// Time to wait for next reply from MSP430, in milliseconds
+#define REPLY_TIMEOUT		100
+
+/// Size of a chunk read from USB device at once
+#define RECV_CHUNK_LEN		0x100
+
+/// Send packets to MSP430 keeping up to MAX_IN_FLIGHT of them in flight, and collect replies. Replies are matched
+/// to requests by device and register address, so they may come in any order. Works with both ASCII and binary
+/// packets, input and output arrays may be the same. Reply for a request that was not answered in time is
+/// left empty and its length is 0.
+uint32_t exchangeUSBPackets(int descr				// USB device descriptor
+			, char **in_msp_packets			// Packets to send
+			, char **out_msp_packets		// Received packets
+			, uint16_t count			// Number of packets
+			, uint16_t *out_lengths = nullptr);	// Numbers of received bytes of each reply, may be null
@@ -19,8 +19,11 @@ PUBLIC_HEADERS += \
 	$$PWD/include/trikHal/hardwareAbstractionInterface.h \
 	$$PWD/include/trikHal/hardwareAbstractionFactory.h \
 	$$PWD/include/trikHal/fifoInterface.h \
+	$$PWD/include/trikHal/fileIoBatchInterface.h \
 	$$PWD/include/trikHal/eventFileInterface.h \
 	$$PWD/include/trikHal/inputDeviceFileInterface.h \
+	$$PWD/include/trikHal/mspBatchOperation.h \
+	$$PWD/include/trikHal/mspCommand.h \
 	$$PWD/include/trikHal/mspI2cInterface.h \
 	$$PWD/include/trikHal/mspUsbInterface.h \
 	$$PWD/include/trikHal/outputDeviceFileInterface.h \
@@ -32,15 +35,22 @@ PUBLIC_HEADERS += \
 		$$PWD/src/trik/trikMspI2c.h \
 		$$PWD/src/trik/trikMspUsb.h \
 		$$PWD/src/trik/trikSystemConsole.h \
+		$$PWD/src/trik/trikCommandService.h \
+		$$PWD/src/trik/trikDeviceWatcher.h \
 		$$PWD/src/trik/trikEventFile.h \
 		$$PWD/src/trik/trikInputDeviceFile.h \
 		$$PWD/src/trik/trikOutputDeviceFile.h \
 		$$PWD/src/trik/trikFifo.h \
+		$$PWD/src/trik/trikFileIoBatch.h \
+		$$PWD/src/trik/trikIoUring.h \
+		$$PWD/src/trik/trikIoReactor.h \
 		$$PWD/src/trik/usbMsp/usbMSP430Interface.h \
 		$$PWD/src/trik/usbMsp/usbMSP430Defines.h \
+		$$PWD/src/trik/usbMsp/usbMSP430Transport.h \
 }
 
 HEADERS += \
+	$$PWD/src/sequentialFileIoBatch.h \
 	$$PWD/src/stub/stubHardwareAbstraction.h \
 	$$PWD/src/stub/stubMspI2c.h \
 	$$PWD/src/stub/stubMspUsb.h \
@@ -50,20 +60,42 @@ HEADERS += \
 	$$PWD/src/stub/stubOutputDeviceFile.h \
 	$$PWD/src/stub/stubFifo.h \
 
+HEADERS += \
+	$$PWD/src/simulation/simulationParameters.h \
+	$$PWD/src/simulation/simulationDevices.h \
+	$$PWD/src/simulation/simulationHardwareAbstraction.h \
+
+HEADERS += \
+	$$PWD/src/trace/traceFormat.h \
+	$$PWD/src/trace/traceWriter.h \
+	$$PWD/src/trace/traceReader.h \
+	$$PWD/src/trace/recordingDevices.h \
+	$$PWD/src/trace/recordingHardwareAbstraction.h \
+	$$PWD/src/trace/replayDevices.h \
+	$$PWD/src/trace/replayHardwareAbstraction.h \
+
 !win32 {
 	SOURCES += \
 		$$PWD/src/trik/trikHardwareAbstraction.cpp \
 		$$PWD/src/trik/trikMspI2c.cpp \
 		$$PWD/src/trik/trikMspUsb.cpp \
 		$$PWD/src/trik/trikSystemConsole.cpp \
+		$$PWD/src/trik/trikCommandService.cpp \
+		$$PWD/src/trik/trikDeviceWatcher.cpp \
 		$$PWD/src/trik/trikEventFile.cpp \
 		$$PWD/src/trik/trikInputDeviceFile.cpp \
 		$$PWD/src/trik/trikOutputDeviceFile.cpp \
 		$$PWD/src/trik/trikFifo.cpp \
+		$$PWD/src/trik/trikFileIoBatch.cpp \
+		$$PWD/src/trik/trikIoUring.cpp \
+		$$PWD/src/trik/trikIoReactor.cpp \
 		$$PWD/src/trik/usbMsp/usbMSP430Interface.cpp \
+		$$PWD/src/trik/usbMsp/usbMSP430Transport.cpp \
 }
 
 SOURCES += \
+	$$PWD/src/mspCommand.cpp \
+	$$PWD/src/sequentialFileIoBatch.cpp \
 	$$PWD/src/stub/stubHardwareAbstraction.cpp \
 	$$PWD/src/stub/stubMspI2c.cpp \
 	$$PWD/src/stub/stubMspUsb.cpp \
@@ -73,6 +105,21 @@ SOURCES += \
 	$$PWD/src/stub/stubOutputDeviceFile.cpp \
 	$$PWD/src/stub/stubFifo.cpp \
 
+SOURCES += \
+	$$PWD/src/configuredHardwareAbstractionFactory.cpp \
+	$$PWD/src/simulation/simulationDevices.cpp \
+	$$PWD/src/simulation/simulationHardwareAbstraction.cpp \
+
+SOURCES += \
+	$$PWD/src/trace/traceFormat.cpp \
+	$$PWD/src/trace/traceWriter.cpp \
+	$$PWD/src/trace/traceReader.cpp \
+	$$PWD/src/trace/recordingDevices.cpp \
+	$$PWD/src/trace/recordingHardwareAbstraction.cpp \
+	$$PWD/src/trace/replayDevices.cpp \
+	$$PWD/src/trace/replayHardwareAbstraction.cpp \
+	$$PWD/src/trace/traceHardwareAbstractionFactory.cpp \
+
 equals(ARCHITECTURE, arm) {
 	SOURCES += $$PWD/src/trik/hardwareAbstractionFactory.cpp
 } else {
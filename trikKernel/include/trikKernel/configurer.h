@@ -17,6 +17,7 @@
 #include <QtCore/QString>
 #include <QtCore/QStringList>
 #include <QtCore/QHash>
+#include <QtCore/QList>
 
 class QDomElement;
 
@@ -28,6 +29,16 @@ namespace trikKernel {
 class Configurer
 {
 public:
+	/// Init script with its ordering constraints.
+	struct InitScript {
+		/// Shell script text.
+		QString script;
+
+		/// True if script does not depend on other scripts and can be executed concurrently with neighbouring
+		/// parallel scripts. Non-parallel script waits for all scripts before it and blocks all scripts after it.
+		bool parallel = false;
+	};
+
 	/// Constructor.
 	/// @param systemConfig - file name (with path) of system config, absolute or relative to current directory.
 	/// @param modelConfig - file name (with path) of model config, absolute or relative to current directory.
@@ -52,6 +63,9 @@ public:
 	/// Returns init scripts defined in config files, first from system config then from model config.
 	QStringList initScripts() const;
 
+	/// Returns init scripts with their ordering constraints, in the same order as initScripts().
+	QList<InitScript> initScriptsWithOrdering() const;
+
 	/// Changes configuration by configuring given device on given port. Port must be listed in model-config.xml,
 	/// device shall be listed in system-config.xml, and device shall be able to be configured on a port
 	/// (it is also described in system-config.xml).
@@ -92,7 +106,7 @@ private:
 	void parseAdditionalConfigurations(const QDomElement &element);
 	void parseModelConfig(const QDomElement &element);
 
-	QStringList mInitScripts;
+	QList<InitScript> mInitScripts;
 
 	/// Maps device class name to its configuration.
 	QHash<QString, Device> mDevices;
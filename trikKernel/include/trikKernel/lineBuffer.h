@@ -0,0 +1,71 @@
+/* Copyright 2016 CyberTech Labs Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License. */
+
+#pragma once
+
+#include <QtCore/QByteArray>
+
+namespace trikKernel {
+
+/// Growable ring buffer of bytes that splits incoming data into lines separated by '\n'. Data can be read from a file
+/// descriptor directly into the buffer using "writeRegion" and "commitWrite", lines are found in place, each byte is
+/// scanned for separator only once.
+class LineBuffer
+{
+public:
+	/// Constructor.
+	/// @param initialCapacity - initial size of a buffer, it grows when there is no space for incoming data.
+	explicit LineBuffer(int initialCapacity = 4096);
+
+	/// Returns pointer to free space where next data shall be written and its size in "size" parameter. Free space
+	/// is contiguous, so it may be smaller than total free space of a buffer, but it is never empty --- buffer grows
+	/// if it is full.
+	char *writeRegion(int &size);
+
+	/// Marks first "size" bytes of a region returned by "writeRegion" as filled with data.
+	void commitWrite(int size);
+
+	/// Copies data to a buffer.
+	void append(const char *data, int size);
+
+	/// Extracts next complete line without separator into "line". Returns false if there is no complete line.
+	bool takeLine(QByteArray &line);
+
+	/// Returns number of bytes in a buffer, including incomplete line.
+	int size() const;
+
+	/// Returns current capacity of a buffer.
+	int capacity() const;
+
+	/// Drops all data.
+	void clear();
+
+private:
+	/// Reallocates buffer with twice the capacity, moving data to its beginning.
+	void grow();
+
+	/// Storage.
+	QByteArray mData;
+
+	/// Position of the first byte of data.
+	int mHead = 0;
+
+	/// Number of bytes of data.
+	int mSize = 0;
+
+	/// Number of bytes from head already checked for line separator.
+	int mScanned = 0;
+};
+
+}
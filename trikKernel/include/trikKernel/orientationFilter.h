@@ -0,0 +1,131 @@
+/* Copyright 2016 CyberTech Labs Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License. */
+
+
+#pragma once
+
+#include <QtCore/qglobal.h>
+
+#include "timestamp.h"
+
+namespace trikKernel {
+
+/// Estimates orientation of a rigid body from gyroscope and accelerometer readings (Madgwick filter without
+/// magnetometer). Gyroscope is integrated on each reading, accelerometer slowly pulls roll and pitch toward gravity
+/// direction, so gyroscope drift in roll and pitch is compensated. Heading (yaw) can not be observed by accelerometer,
+/// so its drift depends on gyroscope bias which is estimated by averaging gyroscope readings at rest.
+/// Not thread-safe, readings shall come from one thread.
+class OrientationFilter
+{
+public:
+	/// Orientation of a body relative to world frame (Z axis up) as a unit quaternion.
+	struct Quaternion
+	{
+		qreal w = 1.0;
+		qreal x = 0.0;
+		qreal y = 0.0;
+		qreal z = 0.0;
+	};
+
+	/// Orientation as Tait-Bryan angles in radians, applied in yaw, pitch, roll order.
+	struct EulerAngles
+	{
+		qreal roll = 0.0;
+		qreal pitch = 0.0;
+		qreal yaw = 0.0;
+	};
+
+	/// Constructor.
+	/// @param gain - weight of accelerometer correction, bigger values compensate gyroscope drift faster but let
+	///        linear accelerations disturb roll and pitch more.
+	explicit OrientationFilter(qreal gain = 0.05);
+
+	/// Sets weight of accelerometer correction.
+	void setGain(qreal gain);
+
+	/// Remembers accelerometer reading, it will be used on next gyroscope reading. Only direction matters, so units
+	/// may be arbitrary. Zero vector means that there is no valid reading.
+	void updateAccelerometer(qreal x, qreal y, qreal z);
+
+	/// Integrates gyroscope reading in radians per second since previous gyroscope reading. First reading after
+	/// construction or reset only remembers time. Readings after a pause longer than a second are treated the same
+	/// way, since rotation during the pause is unknown. While calibrating, readings are accumulated for bias
+	/// estimation and orientation is not changed.
+	void updateGyroscope(const Timestamp &time, qreal x, qreal y, qreal z);
+
+	/// Starts gyroscope bias calibration. Body shall be at rest until calibration is finished.
+	void startCalibration();
+
+	/// Finishes calibration, sets gyroscope bias to mean of readings received since calibration start, levels
+	/// orientation by last accelerometer reading and resets heading. Returns false and keeps previous bias if there
+	/// were no gyroscope readings.
+	bool finishCalibration();
+
+	/// Returns true if calibration is in progress.
+	bool isCalibrating() const;
+
+	/// Sets gyroscope bias in radians per second explicitly.
+	void setBias(qreal x, qreal y, qreal z);
+
+	/// Returns gyroscope bias in radians per second by axis, 0 is X, 1 is Y and 2 is Z.
+	qreal bias(int axis) const;
+
+	/// Returns current orientation.
+	Quaternion orientation() const;
+
+	/// Returns current orientation as Euler angles.
+	EulerAngles eulerAngles() const;
+
+	/// Returns yaw relative to the yaw at last heading reset, in radians from -pi to pi.
+	qreal heading() const;
+
+	/// Makes current yaw a zero heading.
+	void resetHeading();
+
+	/// Resets orientation to level by last accelerometer reading (or to identity if there is none) and resets
+	/// heading. Bias is kept.
+	void reset();
+
+	/// Converts quaternion to Euler angles.
+	static EulerAngles toEulerAngles(const Quaternion &quaternion);
+
+private:
+	/// Applies one filter step with gyroscope reading already corrected by bias.
+	void integrate(qreal dt, qreal gx, qreal gy, qreal gz);
+
+	qreal mGain;
+
+	Quaternion mOrientation;
+
+	/// Last accelerometer reading.
+	qreal mAccelerometer[3] = {0.0, 0.0, 0.0};
+
+	/// Gyroscope bias subtracted from each reading.
+	qreal mBias[3] = {0.0, 0.0, 0.0};
+
+	/// Time of previous gyroscope reading, meaningless if mHasGyroscopeTime is false.
+	Timestamp mGyroscopeTime;
+	bool mHasGyroscopeTime = false;
+
+	/// Yaw that corresponds to zero heading.
+	qreal mHeadingOffset = 0.0;
+
+	bool mCalibrating = false;
+
+	/// Sums of gyroscope readings on each axis and their number, accumulated during calibration.
+	qreal mCalibrationSum[3] = {0.0, 0.0, 0.0};
+	int mCalibrationCount = 0;
+};
+
+}
@@ -0,0 +1,105 @@
+/* Copyright 2016 CyberTech Labs Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License. */
+
+#pragma once
+
+#include <QtCore/QMutex>
+#include <QtCore/QVector>
+
+#include "timestamp.h"
+
+namespace trikKernel {
+
+/// Fixed-size ring buffer of timestamped sensor readings, each reading has one or more integer values (axes).
+/// When the buffer is full, new reading replaces the oldest one. Provides common filters over latest readings, so
+/// scripts do not need to keep and process readings themselves. Readings are appended by sensor thread and may be
+/// read from any thread.
+class SampleHistory
+{
+public:
+	/// Constructor.
+	/// @param capacity - maximal number of readings kept.
+	/// @param dimensions - number of values in one reading.
+	SampleHistory(int capacity, int dimensions = 1);
+
+	/// Appends a reading.
+	/// @param time - time of a reading.
+	/// @param values - array of "dimensions()" values.
+	void append(const Timestamp &time, const int *values);
+
+	/// Appends a reading of one-dimensional sensor. Other axes of a multi-dimensional history are set to 0.
+	void append(const Timestamp &time, int value);
+
+	/// Returns number of readings kept.
+	int size() const;
+
+	/// Returns maximal number of readings kept.
+	int capacity() const;
+
+	/// Returns number of values in one reading.
+	int dimensions() const;
+
+	/// Returns up to "count" latest readings, oldest first, values of one reading go one after another.
+	QVector<int> values(int count) const;
+
+	/// Returns times of up to "count" latest readings, oldest first.
+	QVector<Timestamp> times(int count) const;
+
+	/// Returns median of given axis over up to "window" latest readings, 0 if there are no readings. For even number
+	/// of readings upper median is returned, so the result is always one of the readings.
+	int median(int window, int axis = 0) const;
+
+	/// Returns moving average of given axis over up to "window" latest readings, 0 if there are no readings.
+	qreal average(int window, int axis = 0) const;
+
+	/// Returns minimum of given axis over up to "window" latest readings, 0 if there are no readings.
+	int minimum(int window, int axis = 0) const;
+
+	/// Returns maximum of given axis over up to "window" latest readings, 0 if there are no readings.
+	int maximum(int window, int axis = 0) const;
+
+	/// Returns exponential moving average of given axis over all kept readings, oldest first, with smoothing factor
+	/// "alpha" in (0; 1]: larger alpha gives more weight to recent readings. Returns 0 if there are no readings.
+	qreal exponential(qreal alpha, int axis = 0) const;
+
+	/// Drops all readings.
+	void clear();
+
+private:
+	/// Returns values of given axis of up to "window" latest readings, oldest first. Shall be called with mMutex
+	/// locked.
+	QVector<int> axisWindow(int window, int axis) const;
+
+	/// Returns index in storage of a reading "age" readings older than the latest one.
+	int indexOf(int age) const;
+
+	const int mCapacity;
+	const int mDimensions;
+
+	/// Values of readings, "mDimensions" values per reading.
+	QVector<int> mValues;
+
+	/// Times of readings in nanoseconds.
+	QVector<qint64> mTimes;
+
+	/// Index of a slot where next reading will be written.
+	int mHead = 0;
+
+	/// Number of readings kept.
+	int mSize = 0;
+
+	mutable QMutex mMutex;
+};
+
+}
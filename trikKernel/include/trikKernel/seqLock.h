@@ -0,0 +1,114 @@
+/* Copyright 2016 CyberTech Labs Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License. */
+
+#pragma once
+
+#include <atomic>
+#include <cstring>
+#include <type_traits>
+
+#include <QtCore/qglobal.h>
+
+namespace trikKernel {
+
+/// Holds a value of fixed-size plain data type written by one thread and read by many, without locks. Writer never
+/// waits, readers copy the value and retry if it was changed meanwhile, so a reader always gets a value that was
+/// actually written, never a mix of two. Intended for small sensor readings updated at event rate, for example,
+/// SeqLock<Point> reading;
+/// reading.set({10, 20});  // In writer thread.
+/// const Point point = reading.get();  // In any thread.
+/// Value is stored as atomic words, so there is no data race even when a read overlaps a write.
+template<typename T> class SeqLock
+{
+	static_assert(std::is_trivially_copyable<T>::value, "SeqLock can hold only trivially copyable types");
+
+public:
+	/// Constructor. Holds default-constructed value.
+	SeqLock()
+		: SeqLock(T())
+	{
+	}
+
+	/// Constructor. Holds given value.
+	explicit SeqLock(const T &value)
+	{
+		store(value);
+	}
+
+	/// Publishes new value. Wait-free, shall be called only from one writer thread at a time.
+	void set(const T &value)
+	{
+		const quint32 sequence = mSequence.load(std::memory_order_relaxed);
+		mSequence.store(sequence + 1, std::memory_order_relaxed);
+
+		// Odd sequence shall become visible before any word of the new value.
+		std::atomic_thread_fence(std::memory_order_release);
+		store(value);
+		mSequence.store(sequence + 2, std::memory_order_release);
+	}
+
+	/// Returns last published value. May be called from any thread, retries while a write is in progress.
+	T get() const
+	{
+		Word words[wordCount];
+		forever {
+			const quint32 sequence = mSequence.load(std::memory_order_acquire);
+			if (sequence & 1) {
+				// Writer is in the middle of an update, it takes just a few instructions.
+				continue;
+			}
+
+			for (int i = 0; i < wordCount; ++i) {
+				words[i] = mWords[i].load(std::memory_order_relaxed);
+			}
+
+			// Words shall be loaded before sequence is checked again.
+			std::atomic_thread_fence(std::memory_order_acquire);
+			if (mSequence.load(std::memory_order_relaxed) == sequence) {
+				break;
+			}
+		}
+
+		T value;
+		std::memcpy(&value, words, sizeof(T));
+		return value;
+	}
+
+	/// Returns number of values published by set(), so readers can cheaply check for a new value. Wraps around.
+	quint32 version() const
+	{
+		return mSequence.load(std::memory_order_acquire) / 2;
+	}
+
+private:
+	typedef quint32 Word;
+
+	/// Number of words needed to hold a value.
+	static const int wordCount = (sizeof(T) + sizeof(Word) - 1) / sizeof(Word);
+
+	/// Copies value to atomic words, padding is zeroed.
+	void store(const T &value)
+	{
+		Word words[wordCount] = {};
+		std::memcpy(words, &value, sizeof(T));
+		for (int i = 0; i < wordCount; ++i) {
+			mWords[i].store(words[i], std::memory_order_relaxed);
+		}
+	}
+
+	std::atomic<quint32> mSequence {0};
+	std::atomic<Word> mWords[wordCount];
+};
+
+}
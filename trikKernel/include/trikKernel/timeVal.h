@@ -16,7 +16,8 @@
 
 namespace trikKernel {
 
-/// Structure of a time value in a convenient format.
+/// Structure of a time value in a convenient format. Has 256 microseconds resolution and wraps in a few minutes,
+/// kept for compatibility, new code shall use Timestamp.
 class TimeVal
 {
 public:
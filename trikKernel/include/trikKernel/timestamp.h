@@ -0,0 +1,83 @@
+/* Copyright 2016 CyberTech Labs Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License. */
+
+
+#pragma once
+
+#include <QtCore/qglobal.h>
+
+namespace trikKernel {
+
+class TimeVal;
+
+/// Point in time of a monotonic clock (CLOCK_MONOTONIC on Linux) with nanosecond resolution. Does not jump with
+/// system time adjustments and does not wrap, so differences between timestamps are always meaningful.
+class Timestamp
+{
+public:
+	/// Constructor.
+	Timestamp() = default;
+
+	/// Constructor.
+	/// @param nsec - nanoseconds since an unspecified point in the past (boot time for CLOCK_MONOTONIC).
+	explicit Timestamp(qint64 nsec);
+
+	/// Returns current time of a monotonic clock.
+	static Timestamp now();
+
+	/// Creates timestamp from a time value in "struct timeval" format.
+	static Timestamp fromTimeval(qint64 sec, qint64 mcsec);
+
+	/// Returns time in nanoseconds.
+	qint64 toNsec() const;
+
+	/// Returns time in microseconds.
+	qint64 toMcSec() const;
+
+	/// Converts timestamp to legacy 256 microsecond resolution time value, for compatibility with older APIs.
+	TimeVal toTimeVal() const;
+
+	/// Returns time passed from "right" to "left".
+	friend Timestamp operator-(const Timestamp &left, const Timestamp &right);
+
+	/// Comparison operators.
+	friend bool operator==(const Timestamp &left, const Timestamp &right);
+	friend bool operator!=(const Timestamp &left, const Timestamp &right);
+	friend bool operator<(const Timestamp &left, const Timestamp &right);
+
+private:
+	qint64 mNsec = 0;
+};
+
+inline Timestamp operator-(const Timestamp &left, const Timestamp &right)
+{
+	return Timestamp(left.mNsec - right.mNsec);
+}
+
+inline bool operator==(const Timestamp &left, const Timestamp &right)
+{
+	return left.mNsec == right.mNsec;
+}
+
+inline bool operator!=(const Timestamp &left, const Timestamp &right)
+{
+	return left.mNsec != right.mNsec;
+}
+
+inline bool operator<(const Timestamp &left, const Timestamp &right)
+{
+	return left.mNsec < right.mNsec;
+}
+
+}
@@ -55,7 +55,14 @@ Configurer::Configurer(const QString &systemConfigFileName, const QString &model
 	parseSection("devicePorts", [this](const QDomElement &element) { parseDevicePorts(element); });
 	parseSection("deviceTypes", [this](const QDomElement &element) { parseDeviceTypes(element); });
 
-	parseSection("initScript", [this](const QDomElement &element) { parseInitScript(element); });
+	const QDomNodeList initScripts = systemConfig.elementsByTagName("initScript");
+	if (initScripts.isEmpty()) {
+		throw MalformedConfigException("'initScript' element shall appear at least once in config");
+	}
+
+	for (int i = 0; i < initScripts.size(); ++i) {
+		parseInitScript(initScripts.at(i).toElement());
+	}
 
 	parseAdditionalConfigurations(systemConfig);
 
@@ -181,6 +188,16 @@ QString Configurer::deviceClass(const QString &port) const
 }
 
 QStringList Configurer::initScripts() const
+{
+	QStringList result;
+	for (const InitScript &initScript : mInitScripts) {
+		result.append(initScript.script);
+	}
+
+	return result;
+}
+
+QList<Configurer::InitScript> Configurer::initScriptsWithOrdering() const
 {
 	return mInitScripts;
 }
@@ -270,7 +287,10 @@ void Configurer::parseDeviceTypes(const QDomElement &element)
 
 void Configurer::parseInitScript(const QDomElement &element)
 {
-	mInitScripts.append(element.text());
+	InitScript initScript;
+	initScript.script = element.text();
+	initScript.parallel = element.attribute("parallel", "false") == "true";
+	mInitScripts.append(initScript);
 }
 
 void Configurer::parseAdditionalConfigurations(const QDomElement &element)
@@ -0,0 +1,115 @@
+/* Copyright 2016 CyberTech Labs Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License. */
+
+#include "lineBuffer.h"
+
+#include <string.h>
+
+using namespace trikKernel;
+
+LineBuffer::LineBuffer(int initialCapacity)
+	: mData(qMax(initialCapacity, 1), Qt::Uninitialized)
+{
+}
+
+char *LineBuffer::writeRegion(int &size)
+{
+	if (mSize == mData.size()) {
+		grow();
+	}
+
+	const int tail = (mHead + mSize) % mData.size();
+	size = tail < mHead ? mHead - tail : mData.size() - tail;
+	return mData.data() + tail;
+}
+
+void LineBuffer::commitWrite(int size)
+{
+	mSize += size;
+}
+
+void LineBuffer::append(const char *data, int size)
+{
+	while (size > 0) {
+		int free = 0;
+		char * const region = writeRegion(free);
+		const int chunk = qMin(free, size);
+		memcpy(region, data, chunk);
+		commitWrite(chunk);
+		data += chunk;
+		size -= chunk;
+	}
+}
+
+bool LineBuffer::takeLine(QByteArray &line)
+{
+	const int capacity = mData.size();
+	const char * const data = mData.constData();
+
+	while (mScanned < mSize) {
+		// Scanning contiguous part of unscanned data.
+		const int start = (mHead + mScanned) % capacity;
+		const int length = qMin(mSize - mScanned, capacity - start);
+		const char * const separator = static_cast<const char *>(memchr(data + start, '\n', length));
+		if (!separator) {
+			mScanned += length;
+			continue;
+		}
+
+		const int lineLength = mScanned + static_cast<int>(separator - (data + start));
+		if (mHead + lineLength <= capacity) {
+			line = QByteArray(data + mHead, lineLength);
+		} else {
+			// Line is wrapped around the end of a buffer.
+			const int firstPart = capacity - mHead;
+			line.resize(lineLength);
+			memcpy(line.data(), data + mHead, firstPart);
+			memcpy(line.data() + firstPart, data, lineLength - firstPart);
+		}
+
+		mHead = (mHead + lineLength + 1) % capacity;
+		mSize -= lineLength + 1;
+		mScanned = 0;
+		return true;
+	}
+
+	return false;
+}
+
+int LineBuffer::size() const
+{
+	return mSize;
+}
+
+int LineBuffer::capacity() const
+{
+	return mData.size();
+}
+
+void LineBuffer::clear()
+{
+	mHead = 0;
+	mSize = 0;
+	mScanned = 0;
+}
+
+void LineBuffer::grow()
+{
+	QByteArray data(mData.size() * 2, Qt::Uninitialized);
+	const int firstPart = qMin(mSize, mData.size() - mHead);
+	memcpy(data.data(), mData.constData() + mHead, firstPart);
+	memcpy(data.data() + firstPart, mData.constData(), mSize - firstPart);
+	mData.swap(data);
+	mHead = 0;
+}
@@ -0,0 +1,217 @@
+/* Copyright 2016 CyberTech Labs Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License. */
+
+#include "orientationFilter.h"
+
+#include <cmath>
+
+#include <QtCore/qmath.h>
+
+using namespace trikKernel;
+
+/// Gyroscope readings that come later than this after previous one are not integrated, in nanoseconds.
+static const qint64 maxGyroscopePause = 1000000000;
+
+/// Brings angle to [-pi, pi] range.
+static qreal wrapAngle(qreal angle)
+{
+	return std::remainder(angle, 2 * M_PI);
+}
+
+OrientationFilter::OrientationFilter(qreal gain)
+	: mGain(gain)
+{
+}
+
+void OrientationFilter::setGain(qreal gain)
+{
+	mGain = gain;
+}
+
+void OrientationFilter::updateAccelerometer(qreal x, qreal y, qreal z)
+{
+	mAccelerometer[0] = x;
+	mAccelerometer[1] = y;
+	mAccelerometer[2] = z;
+}
+
+void OrientationFilter::updateGyroscope(const Timestamp &time, qreal x, qreal y, qreal z)
+{
+	if (mCalibrating) {
+		mCalibrationSum[0] += x;
+		mCalibrationSum[1] += y;
+		mCalibrationSum[2] += z;
+		++mCalibrationCount;
+		mGyroscopeTime = time;
+		mHasGyroscopeTime = true;
+		return;
+	}
+
+	const qint64 elapsed = (time - mGyroscopeTime).toNsec();
+	const bool integrable = mHasGyroscopeTime && elapsed > 0 && elapsed <= maxGyroscopePause;
+	mGyroscopeTime = time;
+	mHasGyroscopeTime = true;
+	if (integrable) {
+		integrate(elapsed / 1e9, x - mBias[0], y - mBias[1], z - mBias[2]);
+	}
+}
+
+void OrientationFilter::startCalibration()
+{
+	mCalibrating = true;
+	mCalibrationSum[0] = 0.0;
+	mCalibrationSum[1] = 0.0;
+	mCalibrationSum[2] = 0.0;
+	mCalibrationCount = 0;
+}
+
+bool OrientationFilter::finishCalibration()
+{
+	if (!mCalibrating) {
+		return false;
+	}
+
+	mCalibrating = false;
+	if (mCalibrationCount == 0) {
+		return false;
+	}
+
+	for (int axis = 0; axis < 3; ++axis) {
+		mBias[axis] = mCalibrationSum[axis] / mCalibrationCount;
+	}
+
+	reset();
+	return true;
+}
+
+bool OrientationFilter::isCalibrating() const
+{
+	return mCalibrating;
+}
+
+void OrientationFilter::setBias(qreal x, qreal y, qreal z)
+{
+	mBias[0] = x;
+	mBias[1] = y;
+	mBias[2] = z;
+}
+
+qreal OrientationFilter::bias(int axis) const
+{
+	return axis >= 0 && axis < 3 ? mBias[axis] : 0.0;
+}
+
+OrientationFilter::Quaternion OrientationFilter::orientation() const
+{
+	return mOrientation;
+}
+
+OrientationFilter::EulerAngles OrientationFilter::eulerAngles() const
+{
+	return toEulerAngles(mOrientation);
+}
+
+qreal OrientationFilter::heading() const
+{
+	return wrapAngle(eulerAngles().yaw - mHeadingOffset);
+}
+
+void OrientationFilter::resetHeading()
+{
+	mHeadingOffset = eulerAngles().yaw;
+}
+
+void OrientationFilter::reset()
+{
+	const qreal ax = mAccelerometer[0];
+	const qreal ay = mAccelerometer[1];
+	const qreal az = mAccelerometer[2];
+
+	mOrientation = Quaternion();
+	if (ax != 0.0 || ay != 0.0 || az != 0.0) {
+		// Level orientation with zero yaw, so that gravity is seen along measured direction.
+		const qreal halfRoll = std::atan2(ay, az) / 2;
+		const qreal halfPitch = std::atan2(-ax, std::sqrt(ay * ay + az * az)) / 2;
+		mOrientation.w = std::cos(halfRoll) * std::cos(halfPitch);
+		mOrientation.x = std::sin(halfRoll) * std::cos(halfPitch);
+		mOrientation.y = std::cos(halfRoll) * std::sin(halfPitch);
+		mOrientation.z = -std::sin(halfRoll) * std::sin(halfPitch);
+	}
+
+	mHeadingOffset = 0.0;
+	mHasGyroscopeTime = false;
+}
+
+OrientationFilter::EulerAngles OrientationFilter::toEulerAngles(const Quaternion &q)
+{
+	EulerAngles angles;
+	angles.roll = std::atan2(2 * (q.w * q.x + q.y * q.z), 1 - 2 * (q.x * q.x + q.y * q.y));
+	angles.pitch = std::asin(qBound<qreal>(-1.0, 2 * (q.w * q.y - q.z * q.x), 1.0));
+	angles.yaw = std::atan2(2 * (q.w * q.z + q.x * q.y), 1 - 2 * (q.y * q.y + q.z * q.z));
+	return angles;
+}
+
+void OrientationFilter::integrate(qreal dt, qreal gx, qreal gy, qreal gz)
+{
+	qreal q0 = mOrientation.w;
+	qreal q1 = mOrientation.x;
+	qreal q2 = mOrientation.y;
+	qreal q3 = mOrientation.z;
+
+	// Rate of change of quaternion from gyroscope.
+	qreal qDot0 = 0.5 * (-q1 * gx - q2 * gy - q3 * gz);
+	qreal qDot1 = 0.5 * (q0 * gx + q2 * gz - q3 * gy);
+	qreal qDot2 = 0.5 * (q0 * gy - q1 * gz + q3 * gx);
+	qreal qDot3 = 0.5 * (q0 * gz + q1 * gy - q2 * gx);
+
+	qreal ax = mAccelerometer[0];
+	qreal ay = mAccelerometer[1];
+	qreal az = mAccelerometer[2];
+	const qreal accelerometerNorm = std::sqrt(ax * ax + ay * ay + az * az);
+	if (accelerometerNorm > 0.0) {
+		ax /= accelerometerNorm;
+		ay /= accelerometerNorm;
+		az /= accelerometerNorm;
+
+		// Gradient descent step that rotates estimated gravity direction toward measured one.
+		const qreal q0q0 = q0 * q0;
+		const qreal q1q1 = q1 * q1;
+		const qreal q2q2 = q2 * q2;
+		const qreal q3q3 = q3 * q3;
+		qreal s0 = 4 * q0 * q2q2 + 2 * q2 * ax + 4 * q0 * q1q1 - 2 * q1 * ay;
+		qreal s1 = 4 * q1 * q3q3 - 2 * q3 * ax + 4 * q0q0 * q1 - 2 * q0 * ay - 4 * q1 + 8 * q1 * q1q1 + 8 * q1 * q2q2
+				+ 4 * q1 * az;
+		qreal s2 = 4 * q0q0 * q2 + 2 * q0 * ax + 4 * q2 * q3q3 - 2 * q3 * ay - 4 * q2 + 8 * q2 * q1q1 + 8 * q2 * q2q2
+				+ 4 * q2 * az;
+		qreal s3 = 4 * q1q1 * q3 - 2 * q1 * ax + 4 * q2q2 * q3 - 2 * q2 * ay;
+		const qreal stepNorm = std::sqrt(s0 * s0 + s1 * s1 + s2 * s2 + s3 * s3);
+		if (stepNorm > 0.0) {
+			qDot0 -= mGain * s0 / stepNorm;
+			qDot1 -= mGain * s1 / stepNorm;
+			qDot2 -= mGain * s2 / stepNorm;
+			qDot3 -= mGain * s3 / stepNorm;
+		}
+	}
+
+	q0 += qDot0 * dt;
+	q1 += qDot1 * dt;
+	q2 += qDot2 * dt;
+	q3 += qDot3 * dt;
+
+	const qreal norm = std::sqrt(q0 * q0 + q1 * q1 + q2 * q2 + q3 * q3);
+	mOrientation.w = q0 / norm;
+	mOrientation.x = q1 / norm;
+	mOrientation.y = q2 / norm;
+	mOrientation.z = q3 / norm;
+}
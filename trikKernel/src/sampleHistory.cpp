@@ -0,0 +1,182 @@
+/* Copyright 2016 CyberTech Labs Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License. */
+
+#include "sampleHistory.h"
+
+#include <algorithm>
+
+#include <QtCore/QMutexLocker>
+
+using namespace trikKernel;
+
+SampleHistory::SampleHistory(int capacity, int dimensions)
+	: mCapacity(qMax(capacity, 1))
+	, mDimensions(qMax(dimensions, 1))
+	, mValues(mCapacity * mDimensions, 0)
+	, mTimes(mCapacity, 0)
+{
+}
+
+void SampleHistory::append(const Timestamp &time, const int *values)
+{
+	QMutexLocker locker(&mMutex);
+	std::copy(values, values + mDimensions, mValues.begin() + mHead * mDimensions);
+	mTimes[mHead] = time.toNsec();
+	mHead = (mHead + 1) % mCapacity;
+	mSize = qMin(mSize + 1, mCapacity);
+}
+
+void SampleHistory::append(const Timestamp &time, int value)
+{
+	QMutexLocker locker(&mMutex);
+	const auto reading = mValues.begin() + mHead * mDimensions;
+	*reading = value;
+	std::fill(reading + 1, reading + mDimensions, 0);
+	mTimes[mHead] = time.toNsec();
+	mHead = (mHead + 1) % mCapacity;
+	mSize = qMin(mSize + 1, mCapacity);
+}
+
+int SampleHistory::size() const
+{
+	QMutexLocker locker(&mMutex);
+	return mSize;
+}
+
+int SampleHistory::capacity() const
+{
+	return mCapacity;
+}
+
+int SampleHistory::dimensions() const
+{
+	return mDimensions;
+}
+
+QVector<int> SampleHistory::values(int count) const
+{
+	QMutexLocker locker(&mMutex);
+	count = qBound(0, count, mSize);
+	QVector<int> result;
+	result.reserve(count * mDimensions);
+	for (int age = count - 1; age >= 0; --age) {
+		const int index = indexOf(age) * mDimensions;
+		for (int axis = 0; axis < mDimensions; ++axis) {
+			result << mValues[index + axis];
+		}
+	}
+
+	return result;
+}
+
+QVector<Timestamp> SampleHistory::times(int count) const
+{
+	QMutexLocker locker(&mMutex);
+	count = qBound(0, count, mSize);
+	QVector<Timestamp> result;
+	result.reserve(count);
+	for (int age = count - 1; age >= 0; --age) {
+		result << Timestamp(mTimes[indexOf(age)]);
+	}
+
+	return result;
+}
+
+int SampleHistory::median(int window, int axis) const
+{
+	QMutexLocker locker(&mMutex);
+	QVector<int> values = axisWindow(window, axis);
+	if (values.isEmpty()) {
+		return 0;
+	}
+
+	const auto middle = values.begin() + values.size() / 2;
+	std::nth_element(values.begin(), middle, values.end());
+	return *middle;
+}
+
+qreal SampleHistory::average(int window, int axis) const
+{
+	QMutexLocker locker(&mMutex);
+	const QVector<int> values = axisWindow(window, axis);
+	if (values.isEmpty()) {
+		return 0;
+	}
+
+	qint64 sum = 0;
+	for (const int value : values) {
+		sum += value;
+	}
+
+	return static_cast<qreal>(sum) / values.size();
+}
+
+int SampleHistory::minimum(int window, int axis) const
+{
+	QMutexLocker locker(&mMutex);
+	const QVector<int> values = axisWindow(window, axis);
+	return values.isEmpty() ? 0 : *std::min_element(values.begin(), values.end());
+}
+
+int SampleHistory::maximum(int window, int axis) const
+{
+	QMutexLocker locker(&mMutex);
+	const QVector<int> values = axisWindow(window, axis);
+	return values.isEmpty() ? 0 : *std::max_element(values.begin(), values.end());
+}
+
+qreal SampleHistory::exponential(qreal alpha, int axis) const
+{
+	QMutexLocker locker(&mMutex);
+	const QVector<int> values = axisWindow(mSize, axis);
+	if (values.isEmpty()) {
+		return 0;
+	}
+
+	alpha = qBound<qreal>(0, alpha, 1);
+	qreal result = values.first();
+	for (const int value : values) {
+		result += alpha * (value - result);
+	}
+
+	return result;
+}
+
+void SampleHistory::clear()
+{
+	QMutexLocker locker(&mMutex);
+	mHead = 0;
+	mSize = 0;
+}
+
+QVector<int> SampleHistory::axisWindow(int window, int axis) const
+{
+	if (axis < 0 || axis >= mDimensions) {
+		return {};
+	}
+
+	window = qBound(0, window, mSize);
+	QVector<int> result;
+	result.reserve(window);
+	for (int age = window - 1; age >= 0; --age) {
+		result << mValues[indexOf(age) * mDimensions + axis];
+	}
+
+	return result;
+}
+
+int SampleHistory::indexOf(int age) const
+{
+	return (mHead - 1 - age + mCapacity) % mCapacity;
+}
@@ -0,0 +1,55 @@
+/* Copyright 2016 CyberTech Labs Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License. */
+
+
+#include "timestamp.h"
+
+#include <chrono>
+
+#include "timeVal.h"
+
+using namespace trikKernel;
+
+Timestamp::Timestamp(qint64 nsec)
+	: mNsec(nsec)
+{
+}
+
+Timestamp Timestamp::now()
+{
+	// steady_clock is CLOCK_MONOTONIC on Linux, the same clock event files are switched to.
+	const auto sinceEpoch = std::chrono::steady_clock::now().time_since_epoch();
+	return Timestamp(std::chrono::duration_cast<std::chrono::nanoseconds>(sinceEpoch).count());
+}
+
+Timestamp Timestamp::fromTimeval(qint64 sec, qint64 mcsec)
+{
+	return Timestamp(sec * 1000000000 + mcsec * 1000);
+}
+
+qint64 Timestamp::toNsec() const
+{
+	return mNsec;
+}
+
+qint64 Timestamp::toMcSec() const
+{
+	return mNsec / 1000;
+}
+
+TimeVal Timestamp::toTimeVal() const
+{
+	const qint64 mcsec = toMcSec();
+	return TimeVal(static_cast<int>(mcsec / 1000000), static_cast<int>(mcsec % 1000000));
+}
@@ -24,11 +24,16 @@ HEADERS += \
 	$$PWD/include/trikKernel/deinitializationHelper.h \
 	$$PWD/include/trikKernel/differentOwnerPointer.h \
 	$$PWD/include/trikKernel/fileUtils.h \
+	$$PWD/include/trikKernel/lineBuffer.h \
 	$$PWD/include/trikKernel/loggingHelper.h \
+	$$PWD/include/trikKernel/orientationFilter.h \
 	$$PWD/include/trikKernel/commandLineParser.h \
 	$$PWD/include/trikKernel/paths.h \
 	$$PWD/include/trikKernel/rcReader.h \
+	$$PWD/include/trikKernel/sampleHistory.h \
+	$$PWD/include/trikKernel/seqLock.h \
 	$$PWD/include/trikKernel/synchronizedVar.h \
+	$$PWD/include/trikKernel/timestamp.h \
 	$$PWD/include/trikKernel/timeVal.h \
 	$$PWD/include/trikKernel/translationsHelper.h \
 	$$PWD/include/trikKernel/version.h \
@@ -45,8 +50,12 @@ SOURCES += \
 	$$PWD/src/debug.cpp \
 	$$PWD/src/deinitializationHelper.cpp \
 	$$PWD/src/fileUtils.cpp \
+	$$PWD/src/lineBuffer.cpp \
 	$$PWD/src/loggingHelper.cpp \
+	$$PWD/src/orientationFilter.cpp \
 	$$PWD/src/rcReader.cpp \
+	$$PWD/src/sampleHistory.cpp \
+	$$PWD/src/timestamp.cpp \
 	$$PWD/src/timeVal.cpp \
 	$$PWD/src/translationsHelper.cpp \
 	$$PWD/src/$$PLATFORM/coreDumping.cpp \
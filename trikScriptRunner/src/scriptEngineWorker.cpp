@@ -20,6 +20,7 @@
 
 #include <trikKernel/fileUtils.h>
 #include <trikKernel/paths.h>
+#include <trikKernel/timestamp.h>
 #include <trikKernel/timeVal.h>
 #include <trikControl/batteryInterface.h>
 #include <trikControl/colorSensorInterface.h>
@@ -28,9 +29,12 @@
 #include <trikControl/eventCodeInterface.h>
 #include <trikControl/eventDeviceInterface.h>
 #include <trikControl/eventInterface.h>
+#include <trikControl/historyInterface.h>
 #include <trikControl/lineSensorInterface.h>
+#include <trikControl/motorGroupInterface.h>
 #include <trikControl/motorInterface.h>
 #include <trikControl/objectSensorInterface.h>
+#include <trikControl/orientationInterface.h>
 #include <trikControl/soundSensorInterface.h>
 #include <trikControl/sensorInterface.h>
 #include <trikControl/vectorSensorInterface.h>
@@ -67,6 +71,7 @@ Q_DECLARE_METATYPE(Threading*)
 Q_DECLARE_METATYPE(VectorSensorInterface*)
 Q_DECLARE_METATYPE(QVector<int>)
 Q_DECLARE_METATYPE(trikKernel::TimeVal)
+Q_DECLARE_METATYPE(trikKernel::Timestamp)
 Q_DECLARE_METATYPE(QTimer*)
 
 QScriptValue print(QScriptContext *context, QScriptEngine *engine)
@@ -269,6 +274,24 @@ static void timeValFromScriptValue(const QScriptValue &object, trikKernel::TimeV
 	out = trikKernel::TimeVal(0, object.property("mcsec").toInt32());
 }
 
+/// Timestamp is presented to scripts as an object with time in microseconds ("mcsec" property, the same as for legacy
+/// TimeVal) and in nanoseconds ("nsec" property). Values are doubles, so they do not wrap.
+static QScriptValue timestampToScriptValue(QScriptEngine *engine, const trikKernel::Timestamp &in)
+{
+	QScriptValue obj = engine->newObject();
+	obj.setProperty("mcsec", static_cast<double>(in.toMcSec()));
+	obj.setProperty("nsec", static_cast<double>(in.toNsec()));
+	return obj;
+}
+
+static void timestampFromScriptValue(const QScriptValue &object, trikKernel::Timestamp &out)
+{
+	const QScriptValue nsec = object.property("nsec");
+	out = nsec.isNumber()
+			? trikKernel::Timestamp(static_cast<qint64>(nsec.toNumber()))
+			: trikKernel::Timestamp(static_cast<qint64>(object.property("mcsec").toNumber()) * 1000);
+}
+
 QScriptEngine * ScriptEngineWorker::createScriptEngine(bool supportThreads)
 {
 	QScriptEngine *engine = new QScriptEngine();
@@ -282,20 +305,25 @@ QScriptEngine * ScriptEngineWorker::createScriptEngine(bool supportThreads)
 	Scriptable<EventDeviceInterface>::registerMetatype(engine);
 	Scriptable<EventInterface>::registerMetatype(engine);
 	Scriptable<GamepadInterface>::registerMetatype(engine);
+	Scriptable<HistoryInterface>::registerMetatype(engine);
 	Scriptable<FifoInterface>::registerMetatype(engine);
 	Scriptable<KeysInterface>::registerMetatype(engine);
 	Scriptable<LedInterface>::registerMetatype(engine);
 	Scriptable<LineSensorInterface>::registerMetatype(engine);
 	Scriptable<MailboxInterface>::registerMetatype(engine);
+	Scriptable<MotorGroupInterface>::registerMetatype(engine);
 	Scriptable<MotorInterface>::registerMetatype(engine);
 	Scriptable<ObjectSensorInterface>::registerMetatype(engine);
+	Scriptable<OrientationInterface>::registerMetatype(engine);
 	Scriptable<SensorInterface>::registerMetatype(engine);
 	Scriptable<SoundSensorInterface>::registerMetatype(engine);
 	Scriptable<QTimer>::registerMetatype(engine);
 	qScriptRegisterMetaType(engine, timeValToScriptValue, timeValFromScriptValue);
+	qScriptRegisterMetaType(engine, timestampToScriptValue, timestampFromScriptValue);
 	Scriptable<VectorSensorInterface>::registerMetatype(engine);
 
 	qScriptRegisterSequenceMetaType<QVector<int>>(engine);
+	qScriptRegisterSequenceMetaType<QVector<qreal>>(engine);
 	qScriptRegisterSequenceMetaType<QStringList>(engine);
 
 	engine->globalObject().setProperty("brick", engine->newQObject(&mBrick));
@@ -16,14 +16,20 @@
 
 #include <QtCore/QDateTime>
 #include <QtCore/QCoreApplication>
-#include <QtCore/QProcess>
 #include <QtCore/QFileInfo>
 #include <QtCore/QStringList>
 
+#include <trikControl/brickInterface.h>
+
 #include <QsLog.h>
 
 using namespace trikScriptRunner;
 
+ScriptExecutionControl::ScriptExecutionControl(trikControl::BrickInterface &brick)
+	: mBrick(brick)
+{
+}
+
 ScriptExecutionControl::~ScriptExecutionControl()
 {
 	qDeleteAll(mTimers);
@@ -96,14 +102,7 @@ void ScriptExecutionControl::quit()
 
 void ScriptExecutionControl::system(const QString &command, bool synchronously)
 {
-	if (!synchronously) {
-		QStringList args{"-c", command};
-		QLOG_INFO() << "Running: " << "sh" << args;
-		QProcess::startDetached("sh", args);
-	} else {
-		QLOG_INFO() << "Running synchronously: " << command;
-		::system(command.toStdString().c_str());
-	}
+	mBrick.system(command, synchronously);
 }
 
 void ScriptExecutionControl::writeToFile(const QString &file, const QString &text)
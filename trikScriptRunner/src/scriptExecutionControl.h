@@ -18,6 +18,10 @@
 #include <QtCore/QTimer>
 #include <QtCore/QStringList>
 
+namespace trikControl {
+class BrickInterface;
+}
+
 namespace trikScriptRunner {
 
 /// Script execution controller, provides related functions to scripts.
@@ -26,6 +30,10 @@ class ScriptExecutionControl : public QObject
 	Q_OBJECT
 
 public:
+	/// Constructor.
+	/// @param brick - reference to a robot, used to execute system commands.
+	explicit ScriptExecutionControl(trikControl::BrickInterface &brick);
+
 	~ScriptExecutionControl() override;
 
 	/// Returns true if a script is in event-driven running mode, so it shall wait for events when script is executed.
@@ -85,6 +93,9 @@ private:
 	/// True, if a system is in event-driven running mode, so it shall wait for events when script is executed.
 	/// If it is false, script will exit immediately.
 	bool mInEventDrivenMode = false;
+
+	/// Reference to a robot, used to execute system commands.
+	trikControl::BrickInterface &mBrick;
 };
 
 }
@@ -28,7 +28,7 @@ TrikScriptRunner::TrikScriptRunner(trikControl::BrickInterface &brick
 		, trikNetwork::MailboxInterface * const mailbox
 		, trikNetwork::GamepadInterface * const gamepad
 		)
-	: mScriptController(new ScriptExecutionControl())
+	: mScriptController(new ScriptExecutionControl(brick))
 	, mScriptEngineWorker(new ScriptEngineWorker(brick, mailbox, gamepad, *mScriptController))
 	, mMaxScriptId(0)
 {
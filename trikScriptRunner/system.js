@@ -122,6 +122,21 @@ script.repeat = function(mscs, f) {
     timer.timeout.connect(f);
 }
 
+// Reads analog sensor, encoder or battery without waiting for MSP bus, "callback" is called with a reading when it
+// is ready. Several devices can be read this way at once while the script keeps running.
+script.readAsync = function(device, callback) {
+    var requestId;
+    var handler = function(id, value) {
+        if (id == requestId) {
+            device.readFinished.disconnect(handler);
+            callback(value);
+        }
+    };
+
+    device.readFinished.connect(handler);
+    requestId = device.readAsync();
+}
+
 brick.smile = function() {
     brick.display().showImage('media/trik_smile_normal.png');
 }